@@ -1,16 +1,38 @@
 #include "stdafx.h"
 #include <algorithm>
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <variant>
 #include <vector>
+#include "./../TowerDefense/async_file_writer.hpp"
 #include "./../TowerDefense/file_util.hpp"
+#include "./../TowerDefense/fixed_vector.hpp"
 #include "./../TowerDefense/globals.hpp"
 #include "./../TowerDefense/resource.h"
+#include "./../TowerDefense/spsc_queue.hpp"
+#include "./../TowerDefense/task_graph.hpp"
+#include "./../TowerDefense/triple_buffer.hpp"
+#include "./../TowerDefense/audio/wav_stream.hpp"
+#include "./../TowerDefense/graphics/camera.hpp"
+#include "./../TowerDefense/graphics/draw_list.hpp"
+#include "./../TowerDefense/graphics/graphics_DX.hpp"
+#include "./../TowerDefense/graphics/spatial_index.hpp"
+#include "./../TowerDefense/game/balance_runner.hpp"
+#include "./../TowerDefense/game/enemy.hpp"
+#include "./../TowerDefense/game/enemy_type.hpp"
 #include "./../TowerDefense/game/game_level.hpp"
 #include "./../TowerDefense/game/my_game.hpp"
+#include "./../TowerDefense/game/render_snapshot.hpp"
+#include "./../TowerDefense/game/simulation_host.hpp"
 #include "./../TowerDefense/game/shot.hpp"
+#include "./../TowerDefense/game/status_effects.hpp"
 #include "./../TowerDefense/game/tower.hpp"
 #include "./../TowerDefense/pathfinding/graph_node.hpp"
 #include "./../TowerDefense/pathfinding/grid.hpp"
@@ -92,6 +114,40 @@ public:
 		}
 	}
 
+	// Binary Input/Output test for graphs
+	// Checks that a graph written in the binary format reads back identically.
+	TEST_METHOD(Pathfinder_Graph_IO_Binary) {
+		try {
+			pathfinding::Grid my_grid {0, 1, 3, 3, {
+				{100, 100, 100, 100, 100},
+				{100, 20, 10, 20, 100},
+				{100, 15, 12, 15, 100},
+				{100, 25, 15, 20, -3},
+				{100, 100, 100, 100, 100}
+			}};
+			util::file::BinaryWriter writer {};
+			pathfinding::writeGrid(writer, my_grid);
+			util::file::BinaryReader reader {writer.getData().data(), writer.getData().size()};
+			pathfinding::Grid read_grid {};
+			pathfinding::readGrid(reader, read_grid);
+			Assert::IsTrue(reader.isAtEnd());
+			Assert::AreEqual(my_grid.getRows(), read_grid.getRows());
+			Assert::AreEqual(my_grid.getColumns(), read_grid.getColumns());
+			for (int i = 0; i < my_grid.getRows(); ++i) {
+				for (int j = 0; j < my_grid.getColumns(); ++j) {
+					Assert::AreEqual(my_grid.getNode(j, i).getWeight(), read_grid.getNode(j, i).getWeight());
+				}
+			}
+			Assert::AreEqual(0, read_grid.getStartNode()->getGameX());
+			Assert::AreEqual(1, read_grid.getStartNode()->getGameY());
+			Assert::AreEqual(3, read_grid.getGoalNode()->getGameX());
+			Assert::AreEqual(3, read_grid.getGoalNode()->getGameY());
+		}
+		catch (...) {
+			Assert::Fail(L"An unexpected exception occurred.");
+		}
+	}
+
 	// Get neighbors test for graphs
 	TEST_METHOD(Pathfinder_Graph_Neighbors) {
 		try {
@@ -165,6 +221,32 @@ public:
 		Assert::AreEqual(3, new_graph.getNode(0, 1).getWeight());
 	}
 
+	// Tests that a grid keeps track of the tiles that changed.
+	TEST_METHOD(Pathfinder_Grid_Changed_Tiles) {
+		auto new_graph = pathfinding::Grid {4, 5};
+		std::vector<int> changed_tiles {};
+		// A new grid has changed everywhere.
+		Assert::IsTrue(new_graph.takeChangedTiles(changed_tiles));
+		Assert::IsTrue(changed_tiles.empty());
+		Assert::IsFalse(new_graph.takeChangedTiles(changed_tiles));
+		new_graph.setBlockage(2, 3, true);
+		new_graph.setWeight(4, 0, 7);
+		Assert::IsTrue(new_graph.getNode(2, 3).isBlocked());
+		Assert::AreEqual(7, new_graph.getNode(4, 0).getWeight());
+		Assert::IsFalse(new_graph.takeChangedTiles(changed_tiles));
+		Assert::AreEqual(std::size_t {2}, changed_tiles.size());
+		Assert::AreEqual(3 * 5 + 2, changed_tiles[0]);
+		Assert::AreEqual(4, changed_tiles[1]);
+		// The changes are forgotten once taken.
+		changed_tiles.clear();
+		Assert::IsFalse(new_graph.takeChangedTiles(changed_tiles));
+		Assert::IsTrue(changed_tiles.empty());
+		new_graph.setWeight(0, 0, 2);
+		new_graph.clearGrid(1);
+		Assert::IsTrue(new_graph.takeChangedTiles(changed_tiles));
+		Assert::IsTrue(changed_tiles.empty());
+	}
+
 	// Tests Pathfinder::findPath
 	TEST_METHOD(Pathfinder_Pathfinder_Find_Path) {
 		auto terrain_graph_a = pathfinding::Grid {0, 0, 4, 4, {
@@ -369,6 +451,517 @@ public:
 					Assert::Fail(L"An exception occurred.");
 				}
 			}
+
+			TEST_METHOD(Datafile_Number_Parsing) {
+				try {
+					namespace ih_file = ih::util::file;
+					std::wistringstream s1 {L"1_000.5 +2.5 -7 12,345 "};
+					ih_file::DataFileParser p1 {s1};
+					Assert::AreEqual(L"1000.5"s, p1.getToken());
+					Assert::AreEqual(1000.5, p1.parseNumber());
+					Assert::AreEqual(1000, p1.parseNumber<int>());
+					Assert::IsTrue(p1.getNext());
+					Assert::AreEqual(2.5f, p1.parseNumber<float>());
+					Assert::IsTrue(p1.getNext());
+					Assert::AreEqual(-7LL, p1.parseNumber<long long>());
+					Assert::IsTrue(p1.getNext());
+					Assert::AreEqual(12345, p1.parseNumber<int>());
+				}
+				catch (const ih::util::file::DataFileException& e) {
+					Assert::Fail(e.what());
+				}
+				catch (...) {
+					Assert::Fail(L"An exception occurred.");
+				}
+			}
+
+			// Checks that a file is replaced through a temporary file and that a failed write
+			// leaves the original file intact (and is reported by the background writer).
+			// Checks that text survives being written as UTF-8 and read back (including characters
+			// that need surrogate pairs) and that invalid bytes are replaced.
+			TEST_METHOD(Datafile_Utf8_Round_Trip) {
+				namespace ih_file = ih::util::file;
+				const std::wstring my_text = L"Caf\u00e9,\u5854\u9632 \U0001F600 map"s;
+				const auto my_bytes = ih_file::encodeUtf8(my_text);
+				const std::string expected_prefix = "Caf\xc3\xa9,"s;
+				Assert::IsTrue(std::equal(expected_prefix.cbegin(), expected_prefix.cend(), my_bytes.cbegin()));
+				Assert::AreEqual(my_text, ih_file::decodeUtf8(my_bytes));
+				const std::vector<char> bad_bytes {'a', static_cast<char>(0xC3), 'b', static_cast<char>(0xFF)};
+				Assert::AreEqual(L"a\uFFFDb\uFFFD"s, ih_file::decodeUtf8(bad_bytes));
+			}
+
+			TEST_METHOD(Datafile_Atomic_Write) {
+				namespace ih_file = ih::util::file;
+				const std::wstring file_name {L"./test_resources/atomic_write_test.txt"};
+				const std::wstring temp_name {file_name + L".tmp"};
+				std::filesystem::remove_all(temp_name);
+				const std::vector<char> old_contents {'o', 'l', 'd'};
+				const std::vector<char> new_contents {'n', 'e', 'w', '!'};
+				std::vector<char> contents {};
+				Assert::IsTrue(ih_file::writeFileAtomically(file_name, old_contents));
+				Assert::IsTrue(ih_file::readWholeFile(file_name, contents));
+				Assert::IsTrue(contents == old_contents);
+				Assert::IsFalse(std::filesystem::exists(temp_name));
+				// A directory in the way of the temporary file makes every write fail.
+				std::filesystem::create_directory(temp_name);
+				Assert::IsFalse(ih_file::writeFileAtomically(file_name, new_contents));
+				Assert::IsTrue(ih_file::readWholeFile(file_name, contents));
+				Assert::IsTrue(contents == old_contents);
+				{
+					ih_file::AsyncFileWriter my_writer {};
+					my_writer.queueWrite(file_name, new_contents);
+					my_writer.waitForWrites();
+					const auto failed_writes = my_writer.takeFailedWrites();
+					Assert::IsTrue(failed_writes.size() == 1);
+					Assert::AreEqual(file_name, failed_writes.front());
+					// The failure is only reported once.
+					Assert::IsTrue(my_writer.flush());
+				}
+				std::filesystem::remove(temp_name);
+				Assert::IsTrue(ih_file::writeFileAtomically(file_name, new_contents));
+				Assert::IsTrue(ih_file::readWholeFile(file_name, contents));
+				Assert::IsTrue(contents == new_contents);
+				Assert::IsFalse(std::filesystem::exists(temp_name));
+			}
+		};
+
+		TEST_CLASS(Fixed_Vector) {
+		public:
+			// Checks that erasing items moves the later items forward.
+			TEST_METHOD(Fixed_Vector_Erase) {
+				ih::util::FixedVector<std::wstring, 4> my_vector {};
+				my_vector.push_back(L"A"s);
+				my_vector.push_back(L"B"s);
+				my_vector.push_back(L"C"s);
+				my_vector.push_back(L"D"s);
+				Assert::IsTrue(my_vector.full());
+				const auto after_b = my_vector.erase(my_vector.begin() + 1);
+				Assert::IsTrue(after_b == my_vector.begin() + 1);
+				Assert::IsTrue(my_vector.size() == 3);
+				Assert::AreEqual(L"A"s, my_vector[0]);
+				Assert::AreEqual(L"C"s, my_vector[1]);
+				Assert::AreEqual(L"D"s, my_vector[2]);
+				const auto my_copy = my_vector;
+				my_vector.erase(my_vector.begin(), my_vector.begin() + 2);
+				Assert::IsTrue(my_vector.size() == 1);
+				Assert::AreEqual(L"D"s, my_vector[0]);
+				// An empty range removes nothing.
+				my_vector.erase(my_vector.end(), my_vector.end());
+				Assert::IsTrue(my_vector.size() == 1);
+				my_vector.erase(my_vector.begin());
+				Assert::IsTrue(my_vector.empty());
+				// Copies are not affected.
+				Assert::IsTrue(my_copy.size() == 3);
+				Assert::AreEqual(L"C"s, my_copy[1]);
+			}
+		};
+
+		TEST_CLASS(Lock_Free) {
+		public:
+			// Checks that the queue keeps its items in order and refuses items once it is full.
+			TEST_METHOD(Lock_Free_Spsc_Queue_Order) {
+				ih::util::SpscQueue<int, 4> my_queue {};
+				int my_item = 0;
+				Assert::IsFalse(my_queue.tryPop(my_item));
+				// Go around the ring a few times.
+				for (int round = 0; round < 3; ++round) {
+					for (int i = 0; i < 4; ++i) {
+						Assert::IsTrue(my_queue.tryPush(round * 4 + i));
+					}
+					Assert::IsFalse(my_queue.tryPush(-1));
+					for (int i = 0; i < 4; ++i) {
+						Assert::IsTrue(my_queue.tryPop(my_item));
+						Assert::AreEqual(round * 4 + i, my_item);
+					}
+					Assert::IsFalse(my_queue.tryPop(my_item));
+				}
+			}
+
+			// Checks that every item pushed by one thread is popped in order by another.
+			TEST_METHOD(Lock_Free_Spsc_Queue_Threads) {
+				constexpr const int item_count = 100000;
+				ih::util::SpscQueue<int, 64> my_queue {};
+				std::thread producer {[&my_queue]() {
+					for (int i = 0; i < item_count; ++i) {
+						while (!my_queue.tryPush(i)) {
+							std::this_thread::yield();
+						}
+					}
+				}};
+				int next_item = 0;
+				bool in_order = true;
+				while (next_item < item_count) {
+					int my_item = 0;
+					if (my_queue.tryPop(my_item)) {
+						in_order = in_order && my_item == next_item;
+						++next_item;
+					}
+					else {
+						std::this_thread::yield();
+					}
+				}
+				producer.join();
+				Assert::IsTrue(in_order);
+			}
+
+			// Checks that the reader gets the newest published version and keeps it until a
+			// newer one is published.
+			TEST_METHOD(Lock_Free_Triple_Buffer_Latest) {
+				ih::util::TripleBuffer<int> my_buffer {};
+				my_buffer.getWriteBuffer() = 1;
+				my_buffer.publish();
+				my_buffer.getWriteBuffer() = 2;
+				my_buffer.publish();
+				// (The unpublished version is never read.)
+				my_buffer.getWriteBuffer() = 3;
+				Assert::AreEqual(2, my_buffer.getReadBuffer());
+				Assert::AreEqual(2, my_buffer.getReadBuffer());
+				my_buffer.publish();
+				Assert::AreEqual(3, my_buffer.getReadBuffer());
+			}
+
+			// Checks that a reader on another thread never sees a version older than one it has
+			// already seen and that it sees the last version.
+			TEST_METHOD(Lock_Free_Triple_Buffer_Threads) {
+				constexpr const int version_count = 100000;
+				ih::util::TripleBuffer<int> my_buffer {};
+				std::thread writer {[&my_buffer]() {
+					for (int i = 1; i <= version_count; ++i) {
+						my_buffer.getWriteBuffer() = i;
+						my_buffer.publish();
+					}
+				}};
+				int last_version = 0;
+				bool in_order = true;
+				while (last_version < version_count) {
+					const int my_version = my_buffer.getReadBuffer();
+					in_order = in_order && my_version >= last_version;
+					last_version = my_version;
+				}
+				writer.join();
+				Assert::IsTrue(in_order);
+			}
+		};
+
+		TEST_CLASS(Task_Graph) {
+		public:
+			// Checks that a task only runs after every task it depends on.
+			TEST_METHOD(Task_Graph_Dependency_Order) {
+				std::mutex order_mutex {};
+				std::vector<int> order {};
+				const auto record = [&order_mutex, &order](int task) {
+					return [&order_mutex, &order, task]() {
+						std::lock_guard<std::mutex> lock {order_mutex};
+						order.emplace_back(task);
+					};
+				};
+				ih::util::TaskGraph my_graph {};
+				const int first_task = my_graph.addTask(L"First", record(0));
+				const int left_task = my_graph.addTask(L"Left", record(1), {first_task});
+				const int right_task = my_graph.addTask(L"Right", record(2), {first_task});
+				my_graph.addTask(L"Last", record(3), {left_task, right_task});
+				my_graph.run(4);
+				Assert::AreEqual(std::size_t {4}, order.size());
+				Assert::AreEqual(0, order.front());
+				Assert::AreEqual(3, order.back());
+				for (const auto& my_timing : my_graph.getTimings()) {
+					Assert::IsTrue(my_timing.ran);
+				}
+			}
+
+			// Checks that the tasks depending on a failed task (directly or not) are skipped,
+			// that other tasks still run, and that the failure is rethrown.
+			TEST_METHOD(Task_Graph_Skip_Failed_Dependents) {
+				bool child_ran = false;
+				bool grandchild_ran = false;
+				bool other_ran = false;
+				ih::util::TaskGraph my_graph {};
+				const int failed_task = my_graph.addTask(L"Failed", []() {
+					throw std::runtime_error {"Task failed."};
+				});
+				const int child_task = my_graph.addTask(L"Child", [&child_ran]() {
+					child_ran = true;
+				}, {failed_task});
+				my_graph.addTask(L"Grandchild", [&grandchild_ran]() {
+					grandchild_ran = true;
+				}, {child_task});
+				my_graph.addTask(L"Other", [&other_ran]() {
+					other_ran = true;
+				});
+				Assert::ExpectException<std::runtime_error>([&my_graph]() {
+					my_graph.run(2);
+				});
+				Assert::IsFalse(child_ran);
+				Assert::IsFalse(grandchild_ran);
+				Assert::IsTrue(other_ran);
+				Assert::IsFalse(my_graph.getTimings().at(1).ran);
+				Assert::IsFalse(my_graph.getTimings().at(2).ran);
+				Assert::IsTrue(my_graph.getTimings().at(3).ran);
+			}
+		};
+
+		TEST_CLASS(Audio) {
+public:
+			// Checks that a song can be streamed through a ring buffer smaller than the song
+			// and that the stream starts over once the song ends.
+			TEST_METHOD(Audio_Wav_Stream) {
+				try {
+					constexpr const auto file_name {L"./test_resources/stream_test.wav"};
+					constexpr const std::uint32_t data_size = 4000;
+					{
+						std::ofstream wav_file {file_name, std::ios::binary | std::ios::trunc};
+						const auto write32 = [&wav_file](std::uint32_t value) {
+							wav_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+						};
+						const auto write16 = [&wav_file](std::uint16_t value) {
+							wav_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+						};
+						wav_file.write("RIFF", 4);
+						write32(4 + 24 + 8 + data_size);
+						wav_file.write("WAVEfmt ", 8);
+						write32(16);
+						write16(1);
+						write16(2);
+						write32(44100);
+						write32(44100 * 4);
+						write16(4);
+						write16(16);
+						wav_file.write("data", 4);
+						write32(data_size);
+						for (std::uint32_t i = 0; i < data_size; ++i) {
+							wav_file.put(static_cast<char>(i % 251));
+						}
+					}
+					ih::audio::WavStream my_stream {file_name, 0, 12 + 24 + 8 + data_size, 1000, 3};
+					Assert::AreEqual(std::uint16_t {2}, my_stream.getFormat().channels);
+					Assert::AreEqual(std::size_t {3000}, my_stream.getBufferSize());
+					std::vector<char> song_data {};
+					std::size_t block_size {0};
+					while (song_data.size() < 2 * data_size) {
+						while (const char* my_block = my_stream.readBlock(block_size)) {
+							song_data.insert(song_data.end(), my_block, my_block + block_size);
+						}
+						Assert::AreEqual(my_stream.getBlockCount(), my_stream.getBlocksInUse());
+						my_stream.releaseBlock();
+					}
+					for (std::uint32_t i = 0; i < 2 * data_size; ++i) {
+						Assert::AreEqual(static_cast<char>(i % data_size % 251), song_data.at(i));
+					}
+				}
+				catch (const std::runtime_error&) {
+					Assert::Fail(L"The song could not be streamed.");
+				}
+			}
+		};
+
+		TEST_CLASS(Level_Generation) {
+		public:
+			// Checks that a z-score table picks the same items that rerolling until the roll
+			// is at most the largest z-score would.
+			TEST_METHOD(Level_ZScore_Table) {
+				ih::game::ZScoreTable my_table {};
+				my_table.add(1.5, 2);
+				my_table.add(-1.0, 0);
+				my_table.add(0.0, 1);
+				Assert::AreEqual(3, my_table.size());
+				// P(X <= -1) = 0.159, P(X <= 0) = 0.5, and P(X <= 1.5) = 0.933 when X ~ N(0, 1).
+				Assert::AreEqual(0, my_table.draw(0.0, 1.0, 0.1));
+				Assert::AreEqual(1, my_table.draw(0.0, 1.0, 0.5));
+				Assert::AreEqual(2, my_table.draw(0.0, 1.0, 0.9));
+				// Rolls far beyond either end of the table.
+				Assert::AreEqual(2, my_table.draw(100.0, 1.0, 0.0));
+				Assert::AreEqual(0, my_table.draw(-100.0, 1.0, 0.99));
+				Assert::AreEqual(1, my_table.draw(-0.5, 0.0, 0.5));
+			}
+		};
+
+		TEST_CLASS(Draw_List) {
+		public:
+			// Checks that a recorded scene is sorted into layers and that towers sharing a
+			// shape and colors end up in the same batches.
+			TEST_METHOD(Draw_List_Record_And_Sort) {
+				ih::game::RenderSnapshot my_snapshot {};
+				my_snapshot.square_sw = 20.f;
+				my_snapshot.square_sh = 20.f;
+				ih::graphics::shapes::ShapeInstance my_sprite {};
+				my_sprite.shape = ih::graphics::shapes::ShapeTypes::Rectangle;
+				my_sprite.fill_color = ih::graphics::DrawColor {1.f, 0.f, 0.f, 1.f};
+				my_sprite.width_sw = 10.f;
+				my_sprite.height_sh = 10.f;
+				for (int i = 0; i < 3; ++i) {
+					ih::game::TowerSnapshot my_tower {};
+					my_tower.sprite = my_sprite;
+					my_tower.sprite.center_sx = 20.f * i;
+					my_tower.has_ammo_bar = true;
+					my_tower.shots_fired_fraction = 0.5f;
+					my_snapshot.towers.emplace_back(my_tower);
+				}
+				ih::game::EnemySnapshot my_enemy {};
+				my_enemy.sprite = my_sprite;
+				my_enemy.health_fraction = 0.5f;
+				my_snapshot.enemies.emplace_back(my_enemy);
+				ih::graphics::DrawList my_list {};
+				my_snapshot.record(my_list);
+				// Sprite, bar outline, empty bar, and filled bar for each tower; sprite,
+				// bar outline, and filled bar for the enemy.
+				Assert::AreEqual(std::size_t {15}, my_list.getCommands().size());
+				my_list.sort();
+				const auto& commands = my_list.getCommands();
+				for (std::size_t i = 1; i < commands.size(); ++i) {
+					Assert::IsTrue(commands[i - 1].layer <= commands[i].layer);
+				}
+				Assert::IsTrue(commands.front().layer == ih::graphics::DrawLayers::Towers);
+				Assert::IsTrue(commands.back().layer == ih::graphics::DrawLayers::Bar_Fills);
+				// Tower sprites, enemy sprite, bar outlines, empty bars, ammunition, and health.
+				Assert::AreEqual(std::size_t {6}, my_list.countBatches());
+				// Commands with the same state keep their recorded order.
+				Assert::AreEqual(0.f, commands[0].center_sx);
+				Assert::AreEqual(20.f, commands[1].center_sx);
+				Assert::AreEqual(40.f, commands[2].center_sx);
+			}
+
+			// Checks that zooming keeps the point under the mouse in place and that the
+			// spatial index finds the items near the visible part of the map.
+			TEST_METHOD(Draw_List_Camera_Culling) {
+				ih::graphics::Camera my_camera {};
+				my_camera.setMap(ih::graphics::DrawRect {0.f, 0.f, 400.f, 400.f}, 100, 100);
+				Assert::AreEqual(100, my_camera.getVisibleTiles().end_gx);
+				Assert::IsFalse(my_camera.isZoomed());
+				Assert::AreEqual(2, my_camera.getDetailBlockSize());
+				my_camera.zoomAt(4.f, 100.f, 100.f);
+				Assert::AreEqual(100.f, my_camera.toMapX(100.f), 0.001f);
+				Assert::AreEqual(100.f, my_camera.toScreenY(100.f), 0.001f);
+				Assert::AreEqual(1, my_camera.getDetailBlockSize());
+				const auto visible_tiles = my_camera.getVisibleTiles();
+				Assert::AreEqual(18, visible_tiles.min_gx);
+				Assert::AreEqual(44, visible_tiles.end_gx);
+				// Zooming out past the entire map is not allowed.
+				my_camera.zoomAt(0.01f, 0.f, 0.f);
+				Assert::AreEqual(1.f, my_camera.getZoom());
+				ih::graphics::SpatialIndex my_index {};
+				my_index.reset(ih::graphics::DrawRect {0.f, 0.f, 400.f, 400.f}, 16.f, 16.f);
+				for (int i = 0; i < 100; ++i) {
+					const float csx = 4.f * i;
+					my_index.add(ih::graphics::DrawRect {csx - 2.f, csx - 2.f, csx + 2.f, csx + 2.f});
+				}
+				my_index.build();
+				std::vector<std::uint32_t> found {};
+				my_index.query(ih::graphics::DrawRect {100.f, 100.f, 120.f, 120.f}, [&found](std::uint32_t i) {
+					found.emplace_back(i);
+				});
+				// Every item overlapping the rectangle is found, but far away items are not.
+				for (std::uint32_t i = 25; i <= 30; ++i) {
+					Assert::IsTrue(std::find(found.cbegin(), found.cend(), i) != found.cend());
+				}
+				Assert::IsTrue(found.size() < 20);
+			}
+		};
+
+		TEST_CLASS(Balance) {
+		public:
+			// Checks that placement scripts are read and that out-of-order towers are rejected.
+			TEST_METHOD(Balance_Placement_Script) {
+				const std::wstring script_text = L"[global]\nversion = 1\nchallenge_level = 2\nlast_level = 40\n"
+					L"[tower]\nname = \"Cheap Tower\"\nlevel = 1\nx = 3\ny = 4\n"
+					L"[tower]\nname = \"Sky Tower\"\nlevel = 5\nx = 7\ny = 2\n"s;
+				const auto my_script = ih::game::parsePlacementScript(script_text);
+				Assert::AreEqual(2, my_script.challenge_level);
+				Assert::AreEqual(40, my_script.last_level);
+				Assert::IsTrue(my_script.steps.size() == 2);
+				Assert::AreEqual(L"Cheap Tower"s, my_script.steps[0].tower_name);
+				Assert::AreEqual(3, my_script.steps[0].gx);
+				Assert::AreEqual(4, my_script.steps[0].gy);
+				Assert::AreEqual(L"Sky Tower"s, my_script.steps[1].tower_name);
+				Assert::AreEqual(5, my_script.steps[1].level);
+				const std::wstring bad_text = L"[global]\nversion = 1\nchallenge_level = 0\nlast_level = 10\n"
+					L"[tower]\nname = \"Wall\"\nlevel = 4\nx = 0\ny = 0\n"
+					L"[tower]\nname = \"Wall\"\nlevel = 2\nx = 1\ny = 0\n"s;
+				Assert::ExpectException<ih::util::file::DataFileException>([&bad_text]() {
+					ih::game::parsePlacementScript(bad_text);
+				});
+			}
+
+			// Checks that written placement scripts (with upgrades) read back the same.
+			TEST_METHOD(Balance_Placement_Script_Round_Trip) {
+				ih::game::PlacementScript my_script {};
+				my_script.challenge_level = 3;
+				my_script.last_level = 120;
+				my_script.steps.emplace_back(ih::game::PlacementStep {2, L"Splash Tower"s, 6, 9, 0});
+				my_script.steps.emplace_back(ih::game::PlacementStep {7, L""s, 6, 9, 2});
+				const auto read_script = ih::game::parsePlacementScript(ih::game::writePlacementScript(my_script));
+				Assert::AreEqual(3, read_script.challenge_level);
+				Assert::AreEqual(120, read_script.last_level);
+				Assert::IsTrue(read_script.steps.size() == 2);
+				Assert::AreEqual(L"Splash Tower"s, read_script.steps[0].tower_name);
+				Assert::AreEqual(0, read_script.steps[0].upgrade_option);
+				Assert::AreEqual(7, read_script.steps[1].level);
+				Assert::AreEqual(6, read_script.steps[1].gx);
+				Assert::AreEqual(9, read_script.steps[1].gy);
+				Assert::AreEqual(2, read_script.steps[1].upgrade_option);
+			}
+
+			// Checks that games played by the sessions of a simulation host (several at once, on
+			// sessions that are reused) turn out the same as the same games played one at a time.
+			TEST_METHOD(Balance_Sessions_Match_Sequential_Play) {
+				try {
+					// Game objects need the Direct2D factory for their geometry even though nothing is drawn.
+					ih::graphics::DX::DeviceResources2D my_resources {};
+					my_resources.createDeviceIndependentResources();
+					ih::game::MyGame my_game {&my_resources};
+					my_game.setHeadless(true);
+					my_game.load_config_data();
+					my_game.load_type_data();
+					my_game.load_level_templates();
+					ih::game::PlacementScript my_script {};
+					my_script.map_name = my_game.getDefaultMapName(ID_CHALLENGE_LEVEL_NORMAL);
+					my_script.challenge_level = ID_CHALLENGE_LEVEL_NORMAL - ID_CHALLENGE_LEVEL_EASY;
+					my_script.last_level = 3;
+					const auto& tower_name = my_game.getTowerType(0)->getName();
+					my_script.steps.emplace_back(ih::game::PlacementStep {1, tower_name, 2, 2, 0});
+					my_script.steps.emplace_back(ih::game::PlacementStep {1, tower_name, 4, 2, 0});
+					my_script.steps.emplace_back(ih::game::PlacementStep {2, tower_name, 6, 2, 0});
+					constexpr const int game_count = 4;
+					constexpr const int max_level_ticks = 216000;
+					std::vector<ih::game::BalanceGameResult> sequential_results {};
+					for (int i = 0; i < game_count; ++i) {
+						sequential_results.emplace_back(ih::game::playPlacementScript(my_game, my_script,
+							static_cast<std::uint64_t>(i + 1), max_level_ticks));
+					}
+					std::vector<ih::game::BalanceGameResult> session_results(game_count);
+					ih::game::SimulationHost my_host {my_game, 2};
+					const int jobs_failed = my_host.runJobs(game_count, [&](ih::game::MyGame& game, int job) {
+						session_results[job] = ih::game::playPlacementScript(game, my_script,
+							static_cast<std::uint64_t>(job + 1), max_level_ticks);
+						return true;
+					});
+					Assert::AreEqual(0, jobs_failed);
+					for (int i = 0; i < game_count; ++i) {
+						const auto& expected = sequential_results[i];
+						const auto& actual = session_results[i];
+						Assert::IsTrue(expected.seed == actual.seed);
+						Assert::AreEqual(expected.steps_skipped, actual.steps_skipped);
+						Assert::AreEqual(expected.stalled, actual.stalled);
+						Assert::AreEqual(expected.starting_health, actual.starting_health);
+						Assert::AreEqual(expected.health_left, actual.health_left);
+						Assert::IsTrue(expected.levels.size() == actual.levels.size());
+						for (std::size_t j = 0; j < expected.levels.size(); ++j) {
+							Assert::AreEqual(expected.levels[j].level, actual.levels[j].level);
+							Assert::AreEqual(expected.levels[j].won, actual.levels[j].won);
+							Assert::AreEqual(expected.levels[j].health_lost, actual.levels[j].health_lost);
+							Assert::AreEqual(expected.levels[j].money_before, actual.levels[j].money_before);
+							Assert::AreEqual(expected.levels[j].money_after, actual.levels[j].money_after);
+							Assert::IsTrue(expected.levels[j].score == actual.levels[j].score);
+							Assert::IsTrue(expected.levels[j].ticks == actual.levels[j].ticks);
+						}
+					}
+				}
+				catch (const ih::util::file::DataFileException& e) {
+					Assert::Fail(e.what());
+				}
+				catch (...) {
+					Assert::Fail(L"An exception occurred.");
+				}
+			}
 		};
 
 		TEST_CLASS(Main_Game) {
@@ -391,6 +984,12 @@ public:
 					Assert::IsTrue(my_game.getAllTowerTypes().size() > 0);
 					Assert::IsTrue(my_game.getAllShotTypes().size() > 0);
 					Assert::IsTrue(my_game.getAllEnemyTypes().size() > 0);
+					// Enemy type identifiers should match their positions in the list.
+					const auto& etypes = my_game.getAllEnemyTypes();
+					for (int i = 0; i < static_cast<int>(etypes.size()); ++i) {
+						Assert::AreEqual(i, etypes[i]->getTypeId());
+						Assert::IsTrue(my_game.getEnemyType(etypes[i]->getName()) == etypes[i].get());
+					}
 				}
 				catch (const ih::util::file::DataFileException& e) {
 					Assert::Fail(e.what());
@@ -400,6 +999,76 @@ public:
 				}
 			}
 			
+			TEST_METHOD(Main_Game_Share_Type_Data) {
+				try {
+					ih::game::MyGame my_game {nullptr};
+					initGame(my_game);
+					ih::game::MyGame my_session {nullptr};
+					my_session.load_config_data();
+					my_session.shareTypeData(my_game);
+					// The types themselves are shared rather than copied.
+					Assert::AreEqual(my_game.getAllEnemyTypes().size(), my_session.getAllEnemyTypes().size());
+					Assert::IsTrue(my_session.getEnemyType(0) == my_game.getEnemyType(0));
+					Assert::IsTrue(my_session.getTowerType(0) == my_game.getTowerType(0));
+					Assert::IsTrue(my_session.getShotType(L"Mega Missile") == my_game.getShotType(L"Mega Missile"));
+					// What each player has seen is still kept apart.
+					const auto& etype_name = my_game.getEnemyType(0)->getName();
+					my_session.setEnemyTypeAsSeen(etype_name);
+					Assert::IsTrue(my_session.isEnemyTypeSeen(0));
+					Assert::IsFalse(my_game.isEnemyTypeSeen(0));
+				}
+				catch (const ih::util::file::DataFileException& e) {
+					Assert::Fail(e.what());
+				}
+				catch (...) {
+					Assert::Fail(L"An exception occurred.");
+				}
+			}
+
+			// Checks that type data read back from the compiled type database matches the
+			// type data parsed from the data files.
+			TEST_METHOD(Main_Game_Type_Database) {
+				try {
+					ih::game::MyGame parsed_game {nullptr};
+					parsed_game.load_config_data();
+					parsed_game.compile_type_database();
+					Assert::IsTrue(std::filesystem::exists(parsed_game.getResourcesPath() + L"types.tddb"));
+					ih::game::MyGame cached_game {nullptr};
+					cached_game.load_config_data();
+					cached_game.load_type_data();
+					Assert::AreEqual(parsed_game.getHealthBuyCost(), cached_game.getHealthBuyCost());
+					const auto& parsed_enemies = parsed_game.getAllEnemyTypes();
+					const auto& cached_enemies = cached_game.getAllEnemyTypes();
+					Assert::AreEqual(parsed_enemies.size(), cached_enemies.size());
+					for (std::size_t i = 0; i < parsed_enemies.size(); ++i) {
+						Assert::AreEqual(parsed_enemies[i]->getName(), cached_enemies[i]->getName());
+						Assert::AreEqual(parsed_enemies[i]->getBaseHealth(), cached_enemies[i]->getBaseHealth());
+						Assert::AreEqual(parsed_enemies[i]->getBaseWalkingSpeed(), cached_enemies[i]->getBaseWalkingSpeed());
+						Assert::AreEqual(parsed_enemies[i]->getAverageInfluenceRating(),
+							cached_enemies[i]->getAverageInfluenceRating());
+					}
+					Assert::AreEqual(parsed_game.getAllShotTypes().size(), cached_game.getAllShotTypes().size());
+					for (const auto& parsed_shot : parsed_game.getAllShotTypes()) {
+						Assert::AreEqual(parsed_shot.second->getDamage(),
+							cached_game.getShotType(parsed_shot.first)->getDamage());
+					}
+					const auto& parsed_towers = parsed_game.getAllTowerTypes();
+					const auto& cached_towers = cached_game.getAllTowerTypes();
+					Assert::AreEqual(parsed_towers.size(), cached_towers.size());
+					for (std::size_t i = 0; i < parsed_towers.size(); ++i) {
+						Assert::AreEqual(parsed_towers[i]->getName(), cached_towers[i]->getName());
+						Assert::AreEqual(parsed_towers[i]->getFiringRange(), cached_towers[i]->getFiringRange());
+						Assert::AreEqual(parsed_towers[i]->getCost(), cached_towers[i]->getCost());
+					}
+				}
+				catch (const ih::util::file::DataFileException& e) {
+					Assert::Fail(e.what());
+				}
+				catch (...) {
+					Assert::Fail(L"An exception occurred.");
+				}
+			}
+
 			TEST_METHOD(Main_Game_Save_Load) {
 				try {
 					ih::game::MyGame my_game {nullptr};
@@ -429,6 +1098,63 @@ public:
 				}
 			}
 
+			TEST_METHOD(Main_Game_Binary_Save_Load) {
+				try {
+					constexpr const auto file_name {L"./test_resources/binary_save_test.dat"};
+					ih::game::MyGame my_game {nullptr};
+					this->initGame(my_game);
+					this->initGame2(my_game);
+					my_game.buyHealth();
+					const double old_cash = my_game.getPlayerCash();
+					const double old_diffi = my_game.getDifficulty();
+					const int old_health_buy_cost = my_game.getHealthBuyCost();
+					Assert::IsTrue(my_game.saveGameFile(file_name));
+					my_game.changePlayerCash(100);
+					my_game.buyHealth();
+					Assert::IsTrue(my_game.loadGameFile(file_name));
+					Assert::AreEqual(old_cash, my_game.getPlayerCash());
+					Assert::AreEqual(old_diffi, my_game.getDifficulty());
+					Assert::AreEqual(old_health_buy_cost, my_game.getHealthBuyCost());
+				}
+				catch (const ih::util::file::DataFileException& e) {
+					Assert::Fail(e.what());
+				}
+				catch (...) {
+					Assert::Fail(L"An exception occurred.");
+				}
+			}
+
+			// Checks that a purify buff cures only the first few harmful statuses and keeps the
+			// order of the rest.
+			TEST_METHOD(Main_Game_Purify_Buff) {
+				try {
+					// Enemies need the Direct2D factory for their geometry.
+					ih::graphics::DX::DeviceResources2D my_resources {};
+					my_resources.createDeviceIndependentResources();
+					ih::game::MyGame my_game {&my_resources};
+					initGame(my_game);
+					initGame2(my_game);
+					ih::game::Enemy my_enemy {&my_resources, my_game.getMap(), my_game.getEnemyType(0),
+						ih::graphics::Color {0.f, 0.f, 0.f, 1.f}, my_game.getMap(), 1, 1.0, 1, my_game.getPerfCounters()};
+					my_enemy.addStatus(ih::game::SlowEffect {1000.0, 0.5});
+					my_enemy.addStatus(ih::game::SpeedBoostEffect {1000, 1.5, 1.5, 1.5});
+					my_enemy.addStatus(ih::game::StunEffect {1000});
+					my_enemy.addStatus(ih::game::SlowEffect {2000.0, 0.25});
+					ih::game::PurifyBuff my_buff {std::vector<std::wstring> {}, 1.0, 1000, 2};
+					my_buff.apply(my_enemy);
+					const auto& my_statuses = my_enemy.getActiveStatuses();
+					Assert::IsTrue(my_statuses.size() == 2);
+					Assert::IsTrue(std::holds_alternative<ih::game::SpeedBoostEffect>(my_statuses[0]));
+					Assert::IsTrue(std::holds_alternative<ih::game::SlowEffect>(my_statuses[1]));
+				}
+				catch (const ih::util::file::DataFileException& e) {
+					Assert::Fail(e.what());
+				}
+				catch (...) {
+					Assert::Fail(L"An exception occurred.");
+				}
+			}
+
 			TEST_METHOD(Main_Game_Reset_State) {
 				try {
 					constexpr const auto tol = 0.0000005;
@@ -0,0 +1,116 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include "./targetver.hpp"
+#include <Windows.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./async_file_writer.hpp"
+#include "./profiler.hpp"
+
+namespace hoffman_isaiah {
+	namespace util::file {
+		bool writeFileAtomically(const std::wstring& file_name, const std::vector<char>& contents) {
+			const std::wstring temp_name {file_name + L".tmp"};
+			HANDLE temp_file = CreateFileW(temp_name.c_str(), GENERIC_WRITE, 0, nullptr,
+				CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (temp_file == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+			std::size_t bytes_written {0};
+			bool succeeded {true};
+			while (succeeded && bytes_written < contents.size()) {
+				const auto chunk_size = static_cast<DWORD>(std::min<std::size_t>(contents.size() - bytes_written, 1U << 30));
+				DWORD chunk_written {0};
+				succeeded = WriteFile(temp_file, contents.data() + bytes_written, chunk_size, &chunk_written, nullptr)
+					&& chunk_written == chunk_size;
+				bytes_written += chunk_written;
+			}
+			// The data must be on the disk before the rename; otherwise, a crash could leave
+			// the renamed file empty.
+			succeeded = succeeded && FlushFileBuffers(temp_file);
+			CloseHandle(temp_file);
+			if (!succeeded || !MoveFileExW(temp_name.c_str(), file_name.c_str(),
+				MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+				DeleteFileW(temp_name.c_str());
+				return false;
+			}
+			return true;
+		}
+
+		AsyncFileWriter::AsyncFileWriter() :
+			worker {&AsyncFileWriter::workerLoop, this} {
+		}
+
+		AsyncFileWriter::~AsyncFileWriter() noexcept {
+			{
+				std::lock_guard<std::mutex> lock {this->mutex};
+				this->is_stopping = true;
+			}
+			this->write_queued.notify_all();
+			this->worker.join();
+		}
+
+		void AsyncFileWriter::queueWrite(std::wstring file_name, std::vector<char> contents) {
+			{
+				std::lock_guard<std::mutex> lock {this->mutex};
+				const auto my_write = std::find_if(this->pending_writes.begin(), this->pending_writes.end(),
+					[&file_name](const auto& pending_write) {
+					return pending_write.first == file_name;
+				});
+				if (my_write != this->pending_writes.end()) {
+					my_write->second = std::move(contents);
+				}
+				else {
+					this->pending_writes.emplace_back(std::move(file_name), std::move(contents));
+				}
+			}
+			this->write_queued.notify_one();
+		}
+
+		void AsyncFileWriter::waitForWrites() {
+			std::unique_lock<std::mutex> lock {this->mutex};
+			this->write_finished.wait(lock, [this]() {
+				return this->pending_writes.empty() && !this->is_writing;
+			});
+		}
+
+		bool AsyncFileWriter::flush() {
+			this->waitForWrites();
+			return this->takeFailedWrites().empty();
+		}
+
+		std::vector<std::wstring> AsyncFileWriter::takeFailedWrites() {
+			std::lock_guard<std::mutex> lock {this->mutex};
+			std::vector<std::wstring> my_failures {};
+			my_failures.swap(this->failed_writes);
+			return my_failures;
+		}
+
+		void AsyncFileWriter::workerLoop() {
+			IH_PROFILE_THREAD_NAME("File writer");
+			std::unique_lock<std::mutex> lock {this->mutex};
+			while (true) {
+				this->write_queued.wait(lock, [this]() {
+					return !this->pending_writes.empty() || this->is_stopping;
+				});
+				// Queued writes are always finished before stopping so that no save is lost.
+				if (this->pending_writes.empty()) {
+					return;
+				}
+				auto my_write = std::move(this->pending_writes.front());
+				this->pending_writes.pop_front();
+				this->is_writing = true;
+				lock.unlock();
+				const bool succeeded = writeFileAtomically(my_write.first, my_write.second);
+				lock.lock();
+				this->is_writing = false;
+				if (!succeeded) {
+					this->failed_writes.emplace_back(std::move(my_write.first));
+				}
+				this->write_finished.notify_all();
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace hoffman_isaiah {
+	namespace util::file {
+		/// <summary>Replaces the contents of a file without ever leaving a partially written
+		/// file behind. The data is written to a temporary file, flushed to the disk, and
+		/// then moved over the original file.</summary>
+		/// <param name="file_name">The path of the file to replace.</param>
+		/// <param name="contents">The new contents of the file.</param>
+		/// <returns>True if the file was replaced; otherwise, false, in which case the
+		/// original file is unchanged.</returns>
+		bool writeFileAtomically(const std::wstring& file_name, const std::vector<char>& contents);
+
+		/// <summary>Writes files on a background thread so that the thread requesting the
+		/// write never waits on the disk. Each write replaces its file atomically.</summary>
+		class AsyncFileWriter {
+		public:
+			/// <summary>Starts the background thread.</summary>
+			AsyncFileWriter();
+			/// <summary>Finishes any queued writes and then stops the background thread.</summary>
+			~AsyncFileWriter() noexcept;
+			AsyncFileWriter(const AsyncFileWriter&) = delete;
+			AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+			/// <summary>Queues a file to be written. If a write to the same file is still waiting
+			/// to start, that write is replaced since only the newest contents matter.</summary>
+			/// <param name="file_name">The path of the file to write.</param>
+			/// <param name="contents">The contents to write to the file.</param>
+			void queueWrite(std::wstring file_name, std::vector<char> contents);
+			/// <summary>Queues a text file to be written. Each character is stored as a single
+			/// byte, which matches what std::wofstream does with the default locale.</summary>
+			/// <param name="file_name">The path of the file to write.</param>
+			/// <param name="text">The text to write to the file.</param>
+			void queueWrite(std::wstring file_name, const std::wstring& text) {
+				this->queueWrite(std::move(file_name), std::vector<char>(text.begin(), text.end()));
+			}
+			/// <summary>Waits until every queued write has finished. Failed writes are kept so that
+			/// they can still be reported.</summary>
+			void waitForWrites();
+			/// <summary>Waits until every queued write has finished.</summary>
+			/// <returns>False if any write failed since failed writes were last reported. (The
+			/// failures count as reported.)</returns>
+			bool flush();
+			/// <summary>Returns the files that failed to be written since failed writes were last
+			/// reported without waiting for queued writes. (The failures count as reported.)</summary>
+			/// <returns>The paths of the files that could not be written.</returns>
+			std::vector<std::wstring> takeFailedWrites();
+		protected:
+			/// <summary>Writes queued files until the writer is destroyed.</summary>
+			void workerLoop();
+		private:
+			/// <summary>Guards the queue and the writer's state.</summary>
+			std::mutex mutex {};
+			/// <summary>Signalled whenever a write is queued or the writer is stopping.</summary>
+			std::condition_variable write_queued {};
+			/// <summary>Signalled whenever the background thread finishes a write.</summary>
+			std::condition_variable write_finished {};
+			/// <summary>The files waiting to be written along with their contents.</summary>
+			std::deque<std::pair<std::wstring, std::vector<char>>> pending_writes {};
+			/// <summary>True while the background thread is writing a file.</summary>
+			bool is_writing {false};
+			/// <summary>The paths of the files that failed to be written since failed writes were
+			/// last reported.</summary>
+			std::vector<std::wstring> failed_writes {};
+			/// <summary>Set when the background thread should stop.</summary>
+			bool is_stopping {false};
+			/// <summary>The background thread. (Declared last so that the state above
+			/// exists before the thread starts.)</summary>
+			std::thread worker;
+		};
+	}
+}
\ No newline at end of file
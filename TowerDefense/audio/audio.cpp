@@ -4,29 +4,26 @@
 #include "./../targetver.hpp"
 #include <Windows.h>
 #include <xaudio2.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include "./../profiler.hpp"
+#include "./wav_stream.hpp"
 
 namespace hoffman_isaiah::audio {
 	std::unique_ptr<AudioResources> g_my_audio {nullptr};
 
-// Following preprocessor code adapted from official docs.
-#ifdef _XBOX // Big Endian
-	constexpr const auto fourccRIFF = 'RIFF';
-	constexpr const auto fourccDATA = 'data';
-	constexpr const auto fourccFMT = 'fmt ';
-	constexpr const auto fourccWAVE = 'WAVE';
-	constexpr const auto fourccXWMA = 'XWMA';
-	constexpr const auto fourccDPDS = 'dpds';
-#else // Little Endian
-	constexpr const auto fourccRIFF = 'FFIR';
-	constexpr const auto fourccDATA = 'atad';
-	constexpr const auto fourccFMT = ' tmf';
-	constexpr const auto fourccWAVE = 'EVAW';
-	constexpr const auto fourccXWMA = 'AMWX';
-	constexpr const auto fourccDPDS = 'sdpd';
-#endif
+	namespace {
+		/// <summary>How often the streaming thread checks whether the current song needs more data.
+		/// (This must be well under the length of audio held by a song's buffers.)</summary>
+		constexpr const auto streaming_interval = std::chrono::milliseconds {20};
+	}
+
 	bool AudioResources::initAudio() {
 		IXAudio2* raw_xaudio2 = nullptr;
 		HRESULT hr;
@@ -43,87 +40,37 @@ namespace hoffman_isaiah::audio {
 		return true;
 	}
 
-	void AudioResources::loadSong(std::wstring file_name) {
-		// Open file.
-		HANDLE my_file = CreateFile(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
-			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
-		try {
-			if (INVALID_HANDLE_VALUE == my_file
-				|| INVALID_SET_FILE_POINTER == SetFilePointer(my_file, 0, nullptr, FILE_BEGIN)) {
-				throw std::runtime_error {"Could not open file."};
-			}
-			// Code adapted from XAudio2 documentation (How to Load Audio Data Files in XAudio2)
-			// Locate RIFF chunk and check file type.
-			DWORD dw_chunk_size;
-			DWORD dw_chunk_position;
-			this->findChunk(my_file, audio::fourccRIFF, dw_chunk_size, dw_chunk_position);
-			DWORD file_type;
-			this->readChunk(my_file, &file_type, sizeof(DWORD), dw_chunk_position);
-			if (file_type != fourccWAVE) {
-				throw std::runtime_error {"Expected a WAV file."};
-			}
-			// Locate FORMAT chunk and and copy into structure.
-			WAVEFORMATEXTENSIBLE wfx {0};
-			wfx.Format.nSamplesPerSec = 44100;
-			wfx.Format.nChannels = 1;
-			wfx.Format.wFormatTag = WAVE_FORMAT_PCM;
-			this->findChunk(my_file, audio::fourccFMT, dw_chunk_size, dw_chunk_position);
-			this->readChunk(my_file, &wfx, dw_chunk_size, dw_chunk_position);
-			// Locate DATA chunk and read into buffer.
-			this->findChunk(my_file, audio::fourccDATA, dw_chunk_size, dw_chunk_position);
-			auto data_buffer = std::make_unique<BYTE[]>(dw_chunk_size);
-			this->readChunk(my_file, data_buffer.get(), dw_chunk_size, dw_chunk_position);
-			// Populate XAUDIO2_BUFFER
-			// (I couldn't get this to work directly with std::make_unique<>... It's probably
-			// simple; I just need to look it up later.)
-			std::unique_ptr<XAUDIO2_BUFFER, DeleteBuffer<XAUDIO2_BUFFER>> buffer {nullptr};
-			auto raw_buffer = new XAUDIO2_BUFFER;
-			buffer.reset(raw_buffer);
-			// The custom deleter will make sure this is deleted properly.
-			buffer->pAudioData = data_buffer.release();
-			buffer->LoopBegin = 0;
-			buffer->LoopCount = XAUDIO2_LOOP_INFINITE;
-			buffer->LoopLength = 0;
-			buffer->PlayBegin = 0;
-			buffer->PlayLength = 0;
-			buffer->pContext = nullptr;
-			buffer->AudioBytes = dw_chunk_size;
-			buffer->Flags = XAUDIO2_END_OF_STREAM;
-			// Rest is adapted from XAudio2 documentation (How to: Play a Sound with XAudio2)
-			// Create source voice.
-			IXAudio2SourceVoice* raw_source_voice;
-			HRESULT hr;
-			if (FAILED(hr = this->xaudio2->CreateSourceVoice(&raw_source_voice,
-				&wfx.Format))) {
-				throw std::runtime_error {"Could not create source voice."};
-			}
-			std::unique_ptr<IXAudio2SourceVoice, DestroyVoice<IXAudio2SourceVoice>> source_voice
-			{raw_source_voice};
-			// Submit audio buffer.
-			if (FAILED(hr = source_voice->SubmitSourceBuffer(buffer.get()))) {
-				throw std::runtime_error {"Could not provide buffer to source voice."};
-			}
-			// Transfer ownership.
-			this->song_buffers.push_back(std::move(buffer));
-			this->song_voices.push_back(std::move(source_voice));
-
-		}
-		catch (const std::runtime_error&) {
-			if (INVALID_HANDLE_VALUE == my_file || !my_file) {
-				CloseHandle(my_file);
-			}
-			throw;
+	void AudioResources::loadSong(std::unique_ptr<WavStream> song_stream) {
+		// Copy the format chunk into the structure that XAudio2 expects.
+		WAVEFORMATEXTENSIBLE wfx {0};
+		const auto& format_chunk = song_stream->getFormat().format_chunk;
+		std::memcpy(&wfx, format_chunk.data(), std::min(format_chunk.size(), sizeof(wfx)));
+		// Rest is adapted from XAudio2 documentation (How to: Play a Sound with XAudio2)
+		// Create source voice.
+		IXAudio2SourceVoice* raw_source_voice;
+		HRESULT hr;
+		if (FAILED(hr = this->xaudio2->CreateSourceVoice(&raw_source_voice,
+			&wfx.Format))) {
+			throw std::runtime_error {"Could not create source voice."};
 		}
-		CloseHandle(my_file);
+		std::unique_ptr<IXAudio2SourceVoice, DestroyVoice<IXAudio2SourceVoice>> source_voice
+		{raw_source_voice};
+		// Transfer ownership. (Audio data is only submitted once the song starts playing.)
+		std::lock_guard<std::mutex> lock {this->audio_mutex};
+		this->song_streams.push_back(std::move(song_stream));
+		this->song_voices.push_back(std::move(source_voice));
 	}
 
 	void AudioResources::playSong(int index) {
+		std::lock_guard<std::mutex> lock {this->audio_mutex};
 		if (this->current_song >= 0 && index != this->current_song) {
 			if (FAILED(this->song_voices.at(this->current_song)->Stop(0U))) {
 				throw std::runtime_error {"Failed to stop playing current song."};
 			}
 		}
 		this->current_song = index;
+		// Fill the song's buffers before starting so that it does not begin with a gap.
+		this->streamCurrentSong();
 		this->song_voices.at(index)->Start(0U);
 	}
 
@@ -147,65 +94,42 @@ namespace hoffman_isaiah::audio {
 		this->mute_music = true;
 	}
 
-	void AudioResources::findChunk(HANDLE my_file, DWORD fourcc, DWORD& chunk_size,
-		DWORD& chunk_data_position) const {
-		// Adapted from documentation for XAudio2 (How to Load Audio Data Files in XAudio2)
-		if (INVALID_SET_FILE_POINTER == SetFilePointer(my_file, 0, nullptr, FILE_BEGIN)) {
-			throw std::runtime_error {"Could not reset file pointer."};
+	void AudioResources::streamCurrentSong() {
+		if (this->current_song < 0) {
+			return;
 		}
-		DWORD dwChunkType;
-		DWORD dwChunkDataSize;
-		DWORD dwRIFFDataSize = 0;
-		DWORD dwFileType;
-		DWORD bytesRead = 0;
-		DWORD dwOffset = 0;
-		HRESULT hr = S_OK;
-		while (hr == S_OK) {
-			DWORD dwRead;
-			if (FALSE == ReadFile(my_file, &dwChunkType, sizeof(DWORD), &dwRead, NULL)) {
-				hr = HRESULT_FROM_WIN32(GetLastError());
-			}
-			if (FALSE == ReadFile(my_file, &dwChunkDataSize, sizeof(DWORD), &dwRead, NULL)) {
-				hr = HRESULT_FROM_WIN32(GetLastError());
-			}
-
-			switch (dwChunkType) {
-			case audio::fourccRIFF:
-				dwRIFFDataSize = dwChunkDataSize;
-				dwChunkDataSize = 4;
-				if (FALSE == ReadFile(my_file, &dwFileType, sizeof(DWORD), &dwRead, NULL)) {
-					hr = HRESULT_FROM_WIN32(GetLastError());
-				}
-				break;
-			default:
-				if (INVALID_SET_FILE_POINTER
-					== SetFilePointer(my_file, dwChunkDataSize, NULL, FILE_CURRENT)) {
-					throw std::runtime_error {"Could not reset file pointer."};
-				}
-				break;
-			}
-			dwOffset += sizeof(DWORD) * 2;
-			if (dwChunkType == fourcc) {
-				chunk_size = dwChunkDataSize;
-				chunk_data_position = dwOffset;
-				return;
-			}
-			dwOffset += dwChunkDataSize;
-			if (bytesRead >= dwRIFFDataSize) {
-				throw std::runtime_error {"Reached end of file before expected."};
+		auto& my_stream = *this->song_streams.at(this->current_song);
+		auto& my_voice = this->song_voices.at(this->current_song);
+		XAUDIO2_VOICE_STATE my_state {};
+		my_voice->GetState(&my_state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+		// The voice plays buffers in order, so any buffers it no longer has queued are done.
+		while (my_stream.getBlocksInUse() > my_state.BuffersQueued) {
+			my_stream.releaseBlock();
+		}
+		std::size_t block_size {0};
+		while (const char* my_block = my_stream.readBlock(block_size)) {
+			XAUDIO2_BUFFER my_buffer {0};
+			my_buffer.AudioBytes = static_cast<UINT32>(block_size);
+			my_buffer.pAudioData = reinterpret_cast<const BYTE*>(my_block);
+			my_buffer.Flags = my_stream.isFinished() ? XAUDIO2_END_OF_STREAM : 0U;
+			if (FAILED(my_voice->SubmitSourceBuffer(&my_buffer))) {
+				throw std::runtime_error {"Could not provide buffer to source voice."};
 			}
 		}
 	}
 
-	void AudioResources::readChunk(HANDLE my_file, void* buffer, DWORD buffer_size,
-		DWORD buffer_offset) const {
-		// Adapted from XAudio2 documentation (How to Load Audio Data Files in XAudio2)
-		if (INVALID_SET_FILE_POINTER == SetFilePointer(my_file, buffer_offset, nullptr, FILE_BEGIN)) {
-			throw std::runtime_error {"Could not change position of file pointer."};
-		}
-		DWORD dw_read;
-		if (FALSE == ReadFile(my_file, buffer, buffer_size, &dw_read, nullptr)) {
-			throw std::runtime_error {"File read operation failed."};
+	void AudioResources::streamingLoop() {
+		IH_PROFILE_THREAD_NAME("Audio streaming");
+		std::unique_lock<std::mutex> lock {this->audio_mutex};
+		while (!this->is_stopping) {
+			try {
+				this->streamCurrentSong();
+			}
+			catch (const std::runtime_error&) {
+				// The song cannot be read any further, so let it play out what it has.
+				this->current_song = -1;
+			}
+			this->stream_wakeup.wait_for(lock, streaming_interval);
 		}
 	}
 }
@@ -2,11 +2,15 @@
 #pragma comment(lib, "xaudio2.lib")
 #include "./../targetver.hpp"
 #include <xaudio2.h>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 #include "./../globals.hpp"
+#include "./wav_stream.hpp"
 
 // Created by: Isaiah Hoffman
 // Created on: March 10, 2022
@@ -20,25 +24,15 @@ namespace hoffman_isaiah {
 			}
 		};
 
-		// It probably shouldn't be a template as it was specifically made
-		// for deleting XAUDIO2_BUFFERs.
-		template <typename T>
-		struct DeleteBuffer {
-			void operator()(T* pT) {
-				delete[] pT->pAudioData;
-				pT->pAudioData = nullptr;
-				delete pT;
-			}
-		};
-
-		/// <summary>This class stores and manages all audio resources.</summary>
+		/// <summary>This class stores and manages all audio resources. Songs are streamed from
+		/// the disk by a background thread, so only a small buffer is kept for each song.</summary>
 		class AudioResources {
 		public:
 			AudioResources() :
 				xaudio2 {nullptr},
 				master_voice {nullptr},
+				song_streams {},
 				song_voices {},
-				song_buffers {},
 				current_song {-1},
 				music_volume {6},
 				mute_music {false} {
@@ -46,9 +40,16 @@ namespace hoffman_isaiah {
 				if (!this->initAudio()) {
 					throw std::runtime_error {"Initialization of audio failed."};
 				}
+				this->streaming_thread = std::thread {&AudioResources::streamingLoop, this};
 			}
 			// Make sure to stop playing any active music.
 			~AudioResources() {
+				{
+					std::lock_guard<std::mutex> lock {this->audio_mutex};
+					this->is_stopping = true;
+				}
+				this->stream_wakeup.notify_all();
+				this->streaming_thread.join();
 				for (auto& voice : this->song_voices) {
 					voice->Stop();
 					voice->FlushSourceBuffers();
@@ -60,10 +61,10 @@ namespace hoffman_isaiah {
 			AudioResources& operator=(const AudioResources&) = delete;
 			AudioResources& operator=(AudioResources&&) = delete;
 
-			/// <summary>Loads a song from the given file into a buffer. This method throws
-			/// an exception if the loading fails.</summary>
-			/// <param name="file_name">The name of the file to load.</param>
-			void loadSong(std::wstring file_name);
+			/// <summary>Prepares a song to be played. The song's audio data is read from the stream
+			/// as it plays. This method throws an exception if the loading fails.</summary>
+			/// <param name="song_stream">The stream to play the song from.</param>
+			void loadSong(std::unique_ptr<WavStream> song_stream);
 			/// <summary>Plays music from the preloaded songs. This method throws an
 			/// exception if the playing fails.</summary>
 			/// <param name="index">The index of the song based on the order the songs were loaded.</param>
@@ -87,31 +88,24 @@ namespace hoffman_isaiah {
 			/// <returns>True if the action succeeded otherwise false.</returns>
 			bool initAudio();
 
-			/// <summary>Finds a chunk in a .WAV file and stores the needed information.
-			/// This method throws an exception if an error occurs.</summary>
-			/// <param name="my_file">Handle to the file to read.</param>
-			/// <param name="fourcc">The code to search for, such as "riff", "fmt", or "data".</param>
-			/// <param name="chunk_size">Reference to a variable to store the chunk's size.</param>
-			/// <param name="chunk_data_position">Reference to a variable to store the location
-			/// of the chunk.</param>
-			void findChunk(HANDLE my_file, DWORD fourcc, DWORD& chunk_size, DWORD& chunk_data_position) const;
-			/// <summary>Reads the data associated with a data chunk's offset and size into
-			/// a buffer. An exception is thrown if an error occurs.</summary>
-			/// <param name="my_file">Handle to the file to read.</param>
-			/// <param name="buffer">The buffer to read into.</param>
-			/// <param name="buffer_size">The size of the buffer.</param>
-			/// <param name="buffer_offset">The offset to start reading from.</param>
-			void readChunk(HANDLE my_file, void* buffer, DWORD buffer_size, DWORD buffer_offset) const;
+			/// <summary>Reads more of the current song into every free buffer and hands the
+			/// buffers to the song's voice. (The caller must hold the audio mutex.)</summary>
+			void streamCurrentSong();
+			/// <summary>Keeps the current song's voice supplied with audio data until the audio
+			/// resources are destroyed.</summary>
+			void streamingLoop();
 
 			// Order dependency note: this should be released LAST.
 			/// <summary>Pointer to the XAudio2 engine.</summary>
 			std::unique_ptr<IXAudio2, winapi::ReleaseCOM<IXAudio2>> xaudio2;
 			/// <summary>Pointer to the XAudio2 master voice.</summary>
 			std::unique_ptr<IXAudio2MasteringVoice, DestroyVoice<IXAudio2MasteringVoice>> master_voice;
+			// Order dependency note: the voices read from the streams' buffers, so the
+			// streams must be released after the voices.
+			/// <summary>Stores the streams that the loaded songs are read from.</summary>
+			std::vector<std::unique_ptr<WavStream>> song_streams;
 			/// <summary>Pointer to the XAudio2 source voice used to play songs.</summary>
 			std::vector<std::unique_ptr<IXAudio2SourceVoice, DestroyVoice<IXAudio2SourceVoice>>> song_voices;
-			/// <summary>Stores the buffers containing the information of loaded songs.</summary>
-			std::vector<std::unique_ptr<XAUDIO2_BUFFER, DeleteBuffer<XAUDIO2_BUFFER>>> song_buffers;
 			/// <summary>Stores the current song being played (so it can be stopped later.)</summary>
 			int current_song;
 			/// <summary>The current volume of music based on the slider's position
@@ -119,6 +113,14 @@ namespace hoffman_isaiah {
 			int music_volume;
 			/// <summary>This is true if music should be muted.</summary>
 			bool mute_music;
+			/// <summary>Guards the songs and the current song against the streaming thread.</summary>
+			std::mutex audio_mutex {};
+			/// <summary>Wakes the streaming thread early, such as when a new song starts.</summary>
+			std::condition_variable stream_wakeup {};
+			/// <summary>Set when the streaming thread should stop.</summary>
+			bool is_stopping {false};
+			/// <summary>Reads songs from the disk as they play.</summary>
+			std::thread streaming_thread {};
 		};
 
 
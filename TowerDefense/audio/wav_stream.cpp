@@ -0,0 +1,158 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "./wav_stream.hpp"
+
+namespace hoffman_isaiah::audio {
+	namespace {
+		constexpr const auto fourcc_riff = makeFourCC('R', 'I', 'F', 'F');
+		constexpr const auto fourcc_wave = makeFourCC('W', 'A', 'V', 'E');
+		constexpr const auto fourcc_fmt = makeFourCC('f', 'm', 't', ' ');
+		constexpr const auto fourcc_data = makeFourCC('d', 'a', 't', 'a');
+		/// <summary>The size of a chunk header (the chunk's code and its size).</summary>
+		constexpr const std::uint64_t chunk_header_size = 8;
+		/// <summary>The size of the fields of WAVEFORMATEX up to and including wBitsPerSample.</summary>
+		constexpr const std::size_t pcm_format_size = 16;
+
+		/// <summary>Reads a little-endian integer from a buffer.</summary>
+		template <typename T>
+		T readLittleEndian(const char* bytes) noexcept {
+			T value {0};
+			for (std::size_t i = 0; i < sizeof(T); ++i) {
+				value |= static_cast<T>(static_cast<T>(static_cast<unsigned char>(bytes[i])) << (8 * i));
+			}
+			return value;
+		}
+	}
+
+	RiffReader::RiffReader(std::istream& source, std::uint64_t start, std::uint64_t file_size) :
+		file_start {start} {
+		char header[12];
+		source.seekg(static_cast<std::streamoff>(start));
+		if (file_size < sizeof(header) || !source.read(header, sizeof(header))
+			|| readLittleEndian<std::uint32_t>(header) != fourcc_riff) {
+			throw std::runtime_error {"Expected a RIFF file."};
+		}
+		this->form_type = readLittleEndian<std::uint32_t>(header + 8);
+		// (The size in the RIFF header is trusted only as far as the file actually extends.)
+		const std::uint64_t riff_end = std::min<std::uint64_t>(file_size,
+			readLittleEndian<std::uint32_t>(header + 4) + chunk_header_size);
+		std::uint64_t offset = sizeof(header);
+		while (offset < riff_end && riff_end - offset >= chunk_header_size) {
+			char chunk_header[chunk_header_size];
+			source.seekg(static_cast<std::streamoff>(start + offset));
+			if (!source.read(chunk_header, sizeof(chunk_header))) {
+				throw std::runtime_error {"Could not read a chunk header."};
+			}
+			RiffChunk my_chunk {};
+			my_chunk.id = readLittleEndian<std::uint32_t>(chunk_header);
+			my_chunk.data_size = readLittleEndian<std::uint32_t>(chunk_header + 4);
+			my_chunk.data_position = offset + chunk_header_size;
+			if (my_chunk.data_size > riff_end - my_chunk.data_position) {
+				throw std::runtime_error {"A chunk extends past the end of the file."};
+			}
+			this->chunks.emplace_back(my_chunk);
+			// Chunks are padded to an even number of bytes.
+			offset = my_chunk.data_position + my_chunk.data_size + (my_chunk.data_size & 1U);
+		}
+	}
+
+	const RiffChunk* RiffReader::findChunk(std::uint32_t id) const noexcept {
+		const auto it = std::find_if(this->chunks.begin(), this->chunks.end(), [id](const RiffChunk& my_chunk) {
+			return my_chunk.id == id;
+		});
+		return it == this->chunks.end() ? nullptr : &*it;
+	}
+
+	std::vector<char> RiffReader::readChunkData(std::istream& source, const RiffChunk& chunk) const {
+		std::vector<char> data(chunk.data_size);
+		source.seekg(static_cast<std::streamoff>(this->file_start + chunk.data_position));
+		if (!source.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+			throw std::runtime_error {"Could not read a chunk."};
+		}
+		return data;
+	}
+
+	WavStream::WavStream(const std::wstring& file_name, std::uint64_t file_start, std::uint64_t file_size,
+		std::size_t new_block_size, std::size_t new_block_count) :
+		source {std::filesystem::path {file_name}, std::ios::binary},
+		block_size {new_block_size},
+		block_count {std::max<std::size_t>(new_block_count, 1)} {
+		if (!this->source) {
+			throw std::runtime_error {"Could not open file."};
+		}
+		const RiffReader my_reader {this->source, file_start, file_size};
+		if (my_reader.getFormType() != fourcc_wave) {
+			throw std::runtime_error {"Expected a WAV file."};
+		}
+		const RiffChunk* format_chunk = my_reader.findChunk(fourcc_fmt);
+		const RiffChunk* data_chunk = my_reader.findChunk(fourcc_data);
+		if (!format_chunk || !data_chunk || format_chunk->data_size < pcm_format_size) {
+			throw std::runtime_error {"The WAV file is missing its format or its data."};
+		}
+		this->format.format_chunk = my_reader.readChunkData(this->source, *format_chunk);
+		const char* fmt = this->format.format_chunk.data();
+		this->format.format_tag = readLittleEndian<std::uint16_t>(fmt);
+		this->format.channels = readLittleEndian<std::uint16_t>(fmt + 2);
+		this->format.samples_per_second = readLittleEndian<std::uint32_t>(fmt + 4);
+		this->format.average_bytes_per_second = readLittleEndian<std::uint32_t>(fmt + 8);
+		this->format.block_align = readLittleEndian<std::uint16_t>(fmt + 12);
+		this->format.bits_per_sample = readLittleEndian<std::uint16_t>(fmt + 14);
+		if (this->format.block_align == 0) {
+			throw std::runtime_error {"The WAV file has an invalid format."};
+		}
+		// Blocks must hold whole samples; otherwise, the channels would be swapped partway through.
+		this->block_size -= this->block_size % this->format.block_align;
+		if (this->block_size == 0) {
+			this->block_size = this->format.block_align;
+		}
+		this->data_start = file_start + data_chunk->data_position;
+		this->data_size = data_chunk->data_size - data_chunk->data_size % this->format.block_align;
+		this->ring.resize(this->block_size * this->block_count);
+		this->rewind();
+	}
+
+	const char* WavStream::readBlock(std::size_t& new_block_size) {
+		if (this->blocks_in_use == this->block_count || this->data_size == 0) {
+			return nullptr;
+		}
+		if (this->data_read == this->data_size) {
+			if (!this->is_looping) {
+				return nullptr;
+			}
+			this->source.clear();
+			this->source.seekg(static_cast<std::streamoff>(this->data_start));
+			this->data_read = 0;
+		}
+		const std::size_t block_index = (this->first_block_in_use + this->blocks_in_use) % this->block_count;
+		char* my_block = this->ring.data() + block_index * this->block_size;
+		new_block_size = static_cast<std::size_t>(std::min<std::uint64_t>(this->block_size, this->data_size - this->data_read));
+		if (!this->source.read(my_block, static_cast<std::streamsize>(new_block_size))) {
+			throw std::runtime_error {"File read operation failed."};
+		}
+		this->data_read += new_block_size;
+		++this->blocks_in_use;
+		return my_block;
+	}
+
+	void WavStream::releaseBlock() noexcept {
+		if (this->blocks_in_use > 0) {
+			this->first_block_in_use = (this->first_block_in_use + 1) % this->block_count;
+			--this->blocks_in_use;
+		}
+	}
+
+	void WavStream::rewind() {
+		this->first_block_in_use = 0;
+		this->blocks_in_use = 0;
+		this->data_read = 0;
+		this->source.clear();
+		this->source.seekg(static_cast<std::streamoff>(this->data_start));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// (This file only uses the standard library so that it can be tested on any platform.)
+namespace hoffman_isaiah::audio {
+	/// <returns>The four-character code made of the given characters as it would be read
+	/// from a little-endian file.</returns>
+	constexpr std::uint32_t makeFourCC(char a, char b, char c, char d) noexcept {
+		return static_cast<std::uint32_t>(static_cast<unsigned char>(a))
+			| (static_cast<std::uint32_t>(static_cast<unsigned char>(b)) << 8)
+			| (static_cast<std::uint32_t>(static_cast<unsigned char>(c)) << 16)
+			| (static_cast<std::uint32_t>(static_cast<unsigned char>(d)) << 24);
+	}
+
+	/// <summary>Describes one chunk of a RIFF file.</summary>
+	struct RiffChunk {
+		/// <summary>The chunk's four-character code.</summary>
+		std::uint32_t id {0};
+		/// <summary>The position of the chunk's data relative to the start of the file.</summary>
+		std::uint64_t data_position {0};
+		/// <summary>The size of the chunk's data in bytes.</summary>
+		std::uint32_t data_size {0};
+	};
+
+	/// <summary>Reads the layout of a RIFF file. Only the chunk headers are read; the data
+	/// of each chunk is skipped so that large chunks are never loaded.</summary>
+	class RiffReader {
+	public:
+		/// <summary>Reads the headers of every chunk in a RIFF file. An exception is thrown
+		/// if the file is not a valid RIFF file.</summary>
+		/// <param name="source">The stream to read from.</param>
+		/// <param name="file_start">The position of the RIFF file within the stream.</param>
+		/// <param name="file_size">The size of the RIFF file in bytes.</param>
+		RiffReader(std::istream& source, std::uint64_t file_start, std::uint64_t file_size);
+		/// <param name="id">The four-character code of the chunk to find.</param>
+		/// <returns>The first chunk with the given code or nullptr if there is none.</returns>
+		const RiffChunk* findChunk(std::uint32_t id) const noexcept;
+		/// <summary>Reads the entire data of a chunk. (This should only be used for small chunks.)</summary>
+		/// <param name="source">The stream that the file was read from.</param>
+		/// <param name="chunk">The chunk to read.</param>
+		/// <returns>The chunk's data.</returns>
+		std::vector<char> readChunkData(std::istream& source, const RiffChunk& chunk) const;
+		// Getters
+		std::uint32_t getFormType() const noexcept {
+			return this->form_type;
+		}
+		const std::vector<RiffChunk>& getChunks() const noexcept {
+			return this->chunks;
+		}
+	private:
+		/// <summary>The position of the RIFF file within the stream.</summary>
+		std::uint64_t file_start;
+		/// <summary>The type of data stored in the file, such as "WAVE".</summary>
+		std::uint32_t form_type {0};
+		/// <summary>The chunks contained in the file.</summary>
+		std::vector<RiffChunk> chunks {};
+	};
+
+	/// <summary>The format of the audio data in a .WAV file.</summary>
+	struct WavFormat {
+		std::uint16_t format_tag {0};
+		std::uint16_t channels {0};
+		std::uint32_t samples_per_second {0};
+		std::uint32_t average_bytes_per_second {0};
+		/// <summary>The size of one sample for every channel.</summary>
+		std::uint16_t block_align {0};
+		std::uint16_t bits_per_sample {0};
+		/// <summary>The entire format chunk, which begins with a WAVEFORMATEX structure.</summary>
+		std::vector<char> format_chunk {};
+	};
+
+	/// <summary>Streams the audio data of a .WAV file through a fixed-size ring buffer. Blocks
+	/// of audio are only read from the disk once the player has room for them, so the memory
+	/// used does not depend on the length of the song.</summary>
+	/// <remarks>The player takes blocks with readBlock in order and must return them (also in
+	/// order) with releaseBlock once it has finished playing them.</remarks>
+	class WavStream {
+	public:
+		/// <summary>The default size of each block of the ring buffer in bytes.</summary>
+		static constexpr const std::size_t default_block_size = 64 * 1024;
+		/// <summary>The default number of blocks in the ring buffer.</summary>
+		static constexpr const std::size_t default_block_count = 4;
+
+		/// <summary>Opens a .WAV file for streaming. An exception is thrown if the file cannot
+		/// be read or is not a valid .WAV file.</summary>
+		/// <param name="file_name">The path of the file containing the .WAV file.</param>
+		/// <param name="file_start">The position of the .WAV file within the file. (This allows
+		/// songs to be streamed straight out of the resource pack.)</param>
+		/// <param name="file_size">The size of the .WAV file in bytes.</param>
+		/// <param name="block_size">The size of each block of the ring buffer. (This is rounded down
+		/// to a whole number of samples.)</param>
+		/// <param name="block_count">The number of blocks in the ring buffer.</param>
+		WavStream(const std::wstring& file_name, std::uint64_t file_start, std::uint64_t file_size,
+			std::size_t block_size = default_block_size, std::size_t block_count = default_block_count);
+		WavStream(const WavStream&) = delete;
+		WavStream& operator=(const WavStream&) = delete;
+		/// <summary>Reads the next block of audio data into a free block of the ring buffer.</summary>
+		/// <param name="block_size">Receives the number of bytes in the block.</param>
+		/// <returns>The start of the block or nullptr if every block is in use or the stream has
+		/// finished. (The block stays valid until it is released.)</returns>
+		const char* readBlock(std::size_t& block_size);
+		/// <summary>Frees the oldest block that is in use.</summary>
+		void releaseBlock() noexcept;
+		/// <summary>Frees every block and restarts the stream from the beginning of the song.</summary>
+		void rewind();
+		/// <param name="new_looping">Should the song start over once it ends?</param>
+		void setLooping(bool new_looping) noexcept {
+			this->is_looping = new_looping;
+		}
+		// Getters
+		const WavFormat& getFormat() const noexcept {
+			return this->format;
+		}
+		std::size_t getBlocksInUse() const noexcept {
+			return this->blocks_in_use;
+		}
+		std::size_t getBlockCount() const noexcept {
+			return this->block_count;
+		}
+		/// <returns>True if every block of a song that does not loop has been read.</returns>
+		bool isFinished() const noexcept {
+			return !this->is_looping && this->data_read == this->data_size;
+		}
+		/// <returns>The number of bytes used to buffer audio data.</returns>
+		std::size_t getBufferSize() const noexcept {
+			return this->ring.size();
+		}
+	private:
+		/// <summary>The file that the song is read from.</summary>
+		std::ifstream source;
+		/// <summary>The format of the audio data.</summary>
+		WavFormat format {};
+		/// <summary>The position of the audio data within the file.</summary>
+		std::uint64_t data_start {0};
+		/// <summary>The size of the audio data in bytes.</summary>
+		std::uint64_t data_size {0};
+		/// <summary>The number of bytes of audio data read since the song last started.</summary>
+		std::uint64_t data_read {0};
+		/// <summary>The size of each block in bytes.</summary>
+		std::size_t block_size;
+		/// <summary>The number of blocks in the ring buffer.</summary>
+		std::size_t block_count;
+		/// <summary>The ring buffer.</summary>
+		std::vector<char> ring {};
+		/// <summary>The index of the oldest block that is in use.</summary>
+		std::size_t first_block_in_use {0};
+		/// <summary>The number of blocks that the player has not released yet.</summary>
+		std::size_t blocks_in_use {0};
+		/// <summary>Should the song start over once it ends?</summary>
+		bool is_looping {true};
+	};
+}
\ No newline at end of file
@@ -1,8 +1,12 @@
 // File Author: Isaiah Hoffman
 // File Created: May 24, 2018
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <limits>
+#include <map>
 #include <utility>
 #include <vector>
 #include "./file_util.hpp"
@@ -13,8 +17,11 @@ using namespace std::literals::string_literals;
 namespace hoffman_isaiah {
 	namespace util::file {
 		DataFileParser::DataFileParser(std::wistream& is) :
-			data_file {is} {
-			this->lookahead = this->data_file.get();
+			DataFileParser {std::wstring {std::istreambuf_iterator<wchar_t> {is}, std::istreambuf_iterator<wchar_t> {}}} {
+		}
+
+		DataFileParser::DataFileParser(std::wstring file_contents) :
+			contents {std::move(file_contents)} {
 			if (!this->isValid()) {
 				throw DataFileException {L"Could not read data file."s, 0};
 			}
@@ -26,30 +33,29 @@ namespace hoffman_isaiah {
 				return false;
 			}
 			// Special case: optional commas
-			if (this->lookahead == L',') {
-				this->lookahead = this->data_file.get();
-				if (!this->isValid() || !this->skipOptional()) {
+			if (this->lookahead() == L',') {
+				if (!this->advance() || !this->skipOptional()) {
 					return false;
 				}
 			}
-			if (this->lookahead == L'<' || this->lookahead == L'>') {
-				this->token = this->lookahead;
+			if (this->lookahead() == L'<' || this->lookahead() == L'>') {
+				this->token = this->slice(this->position, this->position + 1);
 				this->token_type = TokenTypes::List;
 			}
-			else if (this->lookahead == L'{' || this->lookahead == L'}') {
-				this->token = this->lookahead;
+			else if (this->lookahead() == L'{' || this->lookahead() == L'}') {
+				this->token = this->slice(this->position, this->position + 1);
 				this->token_type = TokenTypes::Object;
 			}
-			else if (this->lookahead == L'"') {
+			else if (this->lookahead() == L'"') {
 				this->token_type = TokenTypes::String;
 				return this->readString();
 			}
-			else if (this->lookahead == L'[') {
+			else if (this->lookahead() == L'[') {
 				this->token_type = TokenTypes::Section;
 				return this->readSection();
 			}
-			else if ((this->lookahead >= L'0' && this->lookahead <= L'9')
-				|| (this->lookahead == L'+' || this->lookahead == L'-')) {
+			else if ((this->lookahead() >= L'0' && this->lookahead() <= L'9')
+				|| (this->lookahead() == L'+' || this->lookahead() == L'-')) {
 				this->token_type = TokenTypes::Number;
 				return this->readNumber();
 			}
@@ -57,31 +63,31 @@ namespace hoffman_isaiah {
 				this->token_type = TokenTypes::Identifier;
 				return this->readIdentifier();
 			}
-			this->lookahead = this->data_file.get();
-			return this->isValid();
+			return this->advance();
 		}
 
 		bool DataFileParser::skipOptional() noexcept {
-			while (this->lookahead == L' ' || this->lookahead == L'\t'
-				|| this->lookahead == L'\r' || this->lookahead == L'\n'
-				|| this->lookahead == L'#' || this->lookahead == L';') {
-				while (this->lookahead == L'#' || this->lookahead == L';') {
+			if (!this->isValid()) {
+				return false;
+			}
+			while (this->lookahead() == L' ' || this->lookahead() == L'\t'
+				|| this->lookahead() == L'\r' || this->lookahead() == L'\n'
+				|| this->lookahead() == L'#' || this->lookahead() == L';') {
+				while (this->lookahead() == L'#' || this->lookahead() == L';') {
 					// Skip comments
-					while (this->lookahead != L'\n') {
-						this->lookahead = this->data_file.get();
-						if (!this->isValid()) {
+					while (this->lookahead() != L'\n') {
+						if (!this->advance()) {
 							return false;
 						}
 					}
 				}
-				while (this->lookahead == L' ' || this->lookahead == L'\t'
-					|| this->lookahead == L'\r' || this->lookahead == L'\n') {
+				while (this->lookahead() == L' ' || this->lookahead() == L'\t'
+					|| this->lookahead() == L'\r' || this->lookahead() == L'\n') {
 					// Skip white-space
-					if (this->lookahead == L'\n') {
+					if (this->lookahead() == L'\n') {
 						++this->line_number;
 					}
-					this->lookahead = this->data_file.get();
-					if (!this->isValid()) {
+					if (!this->advance()) {
 						return false;
 					}
 				}
@@ -90,106 +96,284 @@ namespace hoffman_isaiah {
 		}
 
 		bool DataFileParser::readString() {
-			this->token = L"";
-			wchar_t prev = this->lookahead;
+			// Strings are referenced in place unless they contain an escape sequence.
+			const std::size_t first = this->position + 1;
+			bool in_place = true;
+			const auto finish_token = [this, first, &in_place]() noexcept {
+				this->token = in_place ? this->slice(first, this->position) : std::wstring_view {this->token_buffer};
+			};
+			wchar_t prev = this->lookahead();
 			while (true) {
-				prev = this->lookahead;
-				this->lookahead = this->data_file.get();
-				if (!this->isValid()) {
+				prev = this->lookahead();
+				if (!this->advance()) {
+					finish_token();
 					return false;
 				}
 				if (prev == L'\\') {
-					if (this->lookahead == L'\\' || this->lookahead == L'"'
-						|| this->lookahead == L'n') {
-						this->token.erase(this->token.end() - 1);
+					if (this->lookahead() == L'\\' || this->lookahead() == L'"'
+						|| this->lookahead() == L'n') {
+						if (in_place) {
+							this->token_buffer.assign(this->slice(first, this->position));
+							in_place = false;
+						}
+						this->token_buffer.pop_back();
 					}
-					if (this->lookahead == L'n') {
-						this->token += L'\n';
+					if (this->lookahead() == L'n') {
+						this->token_buffer += L'\n';
 						continue;
 					}
 				}
-				else if (this->lookahead == L'"') {
-					this->lookahead = this->data_file.get();
-					return this->isValid();
+				else if (this->lookahead() == L'"') {
+					finish_token();
+					return this->advance();
 				}
-				else if (this->lookahead == L'\n' || this->lookahead == L'\t') {
+				else if (this->lookahead() == L'\n' || this->lookahead() == L'\t') {
 					throw DataFileException {L"Newlines and tabs are unallowed inside strings.", this->getLine()};
 				}
-				this->token += this->lookahead;
+				if (!in_place) {
+					this->token_buffer += this->lookahead();
+				}
 			}
 		}
 
 		bool DataFileParser::readSection() {
-			this->token = L"";
-			while ((this->lookahead = data_file.get()) != L']') {
-				if (!this->isValid()) {
+			const std::size_t first = this->position + 1;
+			while (true) {
+				if (!this->advance()) {
+					this->token = this->slice(first, this->position);
 					return false;
 				}
-				if (this->lookahead != L'_' && !((this->lookahead >= L'a' && this->lookahead <= L'z')
-					|| (this->lookahead >= L'A' && this->lookahead <= L'Z')
-					|| (this->lookahead >= L'0' && this->lookahead <= L'9'))) {
-					throw DataFileException {L"Invalid character encountered: "s + this->lookahead
+				if (this->lookahead() == L']') {
+					break;
+				}
+				if (this->lookahead() != L'_' && !((this->lookahead() >= L'a' && this->lookahead() <= L'z')
+					|| (this->lookahead() >= L'A' && this->lookahead() <= L'Z')
+					|| (this->lookahead() >= L'0' && this->lookahead() <= L'9'))) {
+					throw DataFileException {L"Invalid character encountered: "s + this->lookahead()
 						+ L" in section header!"s, this->getLine()};
 				}
-				this->token += this->lookahead;
 			}
-			this->lookahead = this->data_file.get();
-			return this->isValid();
+			this->token = this->slice(first, this->position);
+			return this->advance();
 		}
 
 		bool DataFileParser::readNumber() {
-			this->token = this->lookahead;
+			// Numbers are referenced in place unless they contain separators.
+			const std::size_t first = this->position;
+			bool in_place = true;
+			const auto finish_token = [this, first, &in_place]() noexcept {
+				this->token = in_place ? this->slice(first, this->position) : std::wstring_view {this->token_buffer};
+			};
 			bool has_decimal_point = false;
 			while (true) {
-				this->lookahead = this->data_file.get();
-				if (!this->isValid()) {
+				if (!this->advance()) {
+					finish_token();
 					return false;
 				}
-				if (this->lookahead == L'_' || this->lookahead == L',') {
+				if (this->lookahead() == L'_' || this->lookahead() == L',') {
 					// Underscores and commas can be used as separators.
+					if (in_place) {
+						this->token_buffer.assign(this->slice(first, this->position));
+						in_place = false;
+					}
 					continue;
 				}
-				else if (this->lookahead == L'.' && !has_decimal_point) {
+				else if (this->lookahead() == L'.' && !has_decimal_point) {
 					has_decimal_point = true;
 				}
-				else if (this->lookahead == L'.') {
+				else if (this->lookahead() == L'.') {
 					throw DataFileException {L"A decimal point (.) cannot appear twice in a number."s,
 						this->getLine()};
 				}
-				else if (this->lookahead == L' ' || this->lookahead == L'\t'
-					|| this->lookahead == L'\r' || this->lookahead == L'\n'
-					|| this->lookahead == L'{' || this->lookahead == L'}'
-					|| this->lookahead == L'<' || this->lookahead == L'>'
-					|| this->lookahead == L'[' || this->lookahead == L']') {
+				else if (this->lookahead() == L' ' || this->lookahead() == L'\t'
+					|| this->lookahead() == L'\r' || this->lookahead() == L'\n'
+					|| this->lookahead() == L'{' || this->lookahead() == L'}'
+					|| this->lookahead() == L'<' || this->lookahead() == L'>'
+					|| this->lookahead() == L'[' || this->lookahead() == L']') {
+					finish_token();
 					return true;
 				}
-				else if (this->lookahead < L'0' || this->lookahead > L'9') {
-					throw DataFileException {L"Invalid character: "s + this->lookahead
+				else if (this->lookahead() < L'0' || this->lookahead() > L'9') {
+					throw DataFileException {L"Invalid character: "s + this->lookahead()
 						+ L" encountered in numeric literal!"s, this->getLine()};
 				}
-				this->token += this->lookahead;
+				if (!in_place) {
+					this->token_buffer += this->lookahead();
+				}
 			}
 		}
 
 		bool DataFileParser::readIdentifier() noexcept {
-			this->token = this->lookahead;
+			const std::size_t first = this->position;
 			while (true) {
-				this->lookahead = this->data_file.get();
-				if (!this->isValid()) {
+				if (!this->advance()) {
+					this->token = this->slice(first, this->position);
 					return false;
 				}
-				if (!((this->lookahead >= L'a' && this->lookahead <= L'z')
-					|| (this->lookahead >= L'A' && this->lookahead <= L'Z')
-					|| (this->lookahead >= L'0' && this->lookahead <= L'9')
-					|| this->lookahead == L'_' || this->lookahead == L'=')) {
+				if (!((this->lookahead() >= L'a' && this->lookahead() <= L'z')
+					|| (this->lookahead() >= L'A' && this->lookahead() <= L'Z')
+					|| (this->lookahead() >= L'0' && this->lookahead() <= L'9')
+					|| this->lookahead() == L'_' || this->lookahead() == L'=')) {
+					this->token = this->slice(first, this->position);
 					return true;
 				}
-				this->token += this->lookahead;
 			}
 		}
 
-		bool DataFileParser::isValid() const noexcept {
-			return !(this->data_file.bad() || this->data_file.fail());
+		bool readWholeFile(const std::wstring& file_name, std::vector<char>& contents) {
+			std::ifstream in_file {std::filesystem::path {file_name}, std::ios::binary | std::ios::ate};
+			if (in_file.fail() || in_file.bad()) {
+				return false;
+			}
+			const auto file_size = static_cast<std::size_t>(in_file.tellg());
+			contents.resize(file_size);
+			in_file.seekg(0);
+			// (One bulk read instead of many small ones; the blob is then parsed in place.)
+			return file_size == 0 || static_cast<bool>(in_file.read(contents.data(), static_cast<std::streamsize>(file_size)));
+		}
+
+		std::uint64_t hashBytes(const char* bytes, std::size_t count) noexcept {
+			std::uint64_t hash = 14695981039346656037ULL;
+			for (std::size_t i = 0; i < count; ++i) {
+				hash ^= static_cast<std::uint8_t>(bytes[i]);
+				hash *= 1099511628211ULL;
+			}
+			return hash;
+		}
+
+		std::vector<char> encodeUtf8(std::wstring_view text) {
+			std::vector<char> bytes {};
+			bytes.reserve(text.size());
+			for (std::size_t i = 0; i < text.size(); ++i) {
+				auto code_point = static_cast<std::uint32_t>(text[i]);
+				// (wchar_t is only 16 bits on Windows, so characters outside the BMP are surrogate pairs.)
+				if (code_point >= 0xD800 && code_point <= 0xDBFF && i + 1 < text.size()) {
+					const auto low_surrogate = static_cast<std::uint32_t>(text[i + 1]);
+					if (low_surrogate >= 0xDC00 && low_surrogate <= 0xDFFF) {
+						code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00);
+						++i;
+					}
+				}
+				if (code_point < 0x80) {
+					bytes.emplace_back(static_cast<char>(code_point));
+				}
+				else if (code_point < 0x800) {
+					bytes.emplace_back(static_cast<char>(0xC0 | (code_point >> 6)));
+					bytes.emplace_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+				}
+				else if (code_point < 0x10000) {
+					bytes.emplace_back(static_cast<char>(0xE0 | (code_point >> 12)));
+					bytes.emplace_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+					bytes.emplace_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+				}
+				else {
+					bytes.emplace_back(static_cast<char>(0xF0 | (code_point >> 18)));
+					bytes.emplace_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+					bytes.emplace_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+					bytes.emplace_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+				}
+			}
+			return bytes;
+		}
+
+		std::wstring decodeUtf8(const std::vector<char>& bytes) {
+			constexpr const wchar_t replacement_char = 0xFFFD;
+			std::wstring text {};
+			text.reserve(bytes.size());
+			std::size_t i = 0;
+			while (i < bytes.size()) {
+				const auto lead_byte = static_cast<std::uint8_t>(bytes[i]);
+				int continuation_count = 0;
+				std::uint32_t code_point = 0;
+				if (lead_byte < 0x80) {
+					code_point = lead_byte;
+				}
+				else if (lead_byte >= 0xC2 && lead_byte <= 0xDF) {
+					continuation_count = 1;
+					code_point = lead_byte & 0x1F;
+				}
+				else if (lead_byte >= 0xE0 && lead_byte <= 0xEF) {
+					continuation_count = 2;
+					code_point = lead_byte & 0x0F;
+				}
+				else if (lead_byte >= 0xF0 && lead_byte <= 0xF4) {
+					continuation_count = 3;
+					code_point = lead_byte & 0x07;
+				}
+				else {
+					text.push_back(replacement_char);
+					++i;
+					continue;
+				}
+				++i;
+				bool is_valid = true;
+				for (int j = 0; j < continuation_count; ++j, ++i) {
+					if (i >= bytes.size() || (static_cast<std::uint8_t>(bytes[i]) & 0xC0) != 0x80) {
+						is_valid = false;
+						break;
+					}
+					code_point = (code_point << 6) | (static_cast<std::uint8_t>(bytes[i]) & 0x3F);
+				}
+				// (Overlong encodings, surrogates, and values past U+10FFFF are not valid.)
+				constexpr const std::uint32_t min_code_points[] = {0, 0x80, 0x800, 0x10000};
+				if (!is_valid || code_point < min_code_points[continuation_count] || code_point > 0x10FFFF
+					|| (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+					text.push_back(replacement_char);
+				}
+				else if (code_point >= 0x10000 && sizeof(wchar_t) == 2) {
+					code_point -= 0x10000;
+					text.push_back(static_cast<wchar_t>(0xD800 + (code_point >> 10)));
+					text.push_back(static_cast<wchar_t>(0xDC00 + (code_point & 0x3FF)));
+				}
+				else {
+					text.push_back(static_cast<wchar_t>(code_point));
+				}
+			}
+			return text;
+		}
+
+		std::vector<char> buildSectionedFile(std::uint32_t magic, std::uint32_t version,
+			const std::vector<std::pair<std::uint32_t, BinaryWriter>>& sections) {
+			BinaryWriter writer {};
+			writer.write(magic);
+			writer.write(version);
+			writer.write(static_cast<std::uint32_t>(sections.size()));
+			auto section_offset = static_cast<std::uint32_t>(writer.getData().size()
+				+ sections.size() * 3 * sizeof(std::uint32_t));
+			for (const auto& section : sections) {
+				const auto section_size = static_cast<std::uint32_t>(section.second.getData().size());
+				writer.write(section.first);
+				writer.write(section_offset);
+				writer.write(section_size);
+				section_offset += section_size;
+			}
+			for (const auto& section : sections) {
+				writer.writeBytes(section.second.getData().data(), section.second.getData().size());
+			}
+			return writer.getData();
+		}
+
+		std::map<std::uint32_t, BinaryReader> readSectionedFile(const char* data, std::size_t size,
+			std::uint32_t magic, std::uint32_t max_version) {
+			BinaryReader reader {data, size};
+			if (reader.read<std::uint32_t>() != magic) {
+				throw DataFileException {L"The file is not in the expected format."s, 0};
+			}
+			if (reader.read<std::uint32_t>() > max_version) {
+				throw DataFileException {L"The file was made by a newer version of the game."s, 0};
+			}
+			std::map<std::uint32_t, BinaryReader> sections {};
+			const auto section_count = reader.read<std::uint32_t>();
+			for (std::uint32_t i = 0; i < section_count; ++i) {
+				const auto section_id = reader.read<std::uint32_t>();
+				const auto section_offset = reader.read<std::uint32_t>();
+				const auto section_size = reader.read<std::uint32_t>();
+				if (section_offset > size || section_size > size - section_offset) {
+					throw DataFileException {L"A section extends past the end of the file."s, 0};
+				}
+				sections.emplace(section_id, BinaryReader {data + section_offset, section_size});
+			}
+			return sections;
 		}
 	}
 }
\ No newline at end of file
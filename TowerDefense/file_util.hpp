@@ -1,7 +1,15 @@
  #pragma once
 // File Author: Isaiah Hoffman
 // File Created: May 24, 2018
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <map>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <iosfwd>
 #include <type_traits>
 #include <utility>
@@ -34,13 +42,24 @@ namespace hoffman_isaiah {
 			Identifier, Section, String, Number, List, Object
 		};
 
-		/// <summary>Lexical and syntactical analyzer that reads data files.</summary>
+		/// <summary>Lexical and syntactical analyzer that reads data files. The whole file is
+		/// read into memory up front, and tokens are views into that buffer wherever possible.</summary>
 		class DataFileParser {
 		public:
 			/// <summary>Initializes the parser with the given input stream. Note that
 			/// the parser has already read the first token when this constructor returns.</summary>
-			/// <param name="is">The input stream to read from.</param>
+			/// <param name="is">The input stream to read from. (It is read to the end.)</param>
 			DataFileParser(std::wistream& is);
+			/// <summary>Initializes the parser with the contents of a data file that has
+			/// already been read into memory.</summary>
+			/// <param name="file_contents">The text to parse.</param>
+			explicit DataFileParser(std::wstring file_contents);
+			// Tokens refer to the parser's own buffer, so the parser cannot be copied or moved.
+			DataFileParser(const DataFileParser&) = delete;
+			DataFileParser(DataFileParser&&) = delete;
+			DataFileParser& operator=(const DataFileParser&) = delete;
+			DataFileParser& operator=(DataFileParser&&) = delete;
+			~DataFileParser() noexcept = default;
 			/// <summary>Reads the next token and stores the value in the lexer.</summary>
 			/// <returns>False if a stream error occurs; otherwise, true. Note that EOF counts as a stream
 			/// error.</returns>
@@ -51,16 +70,17 @@ namespace hoffman_isaiah {
 			/// <param name="expected_type">The token type that is expected.</param>
 			/// <param name="expected_value">The token value that is expected.</param> 
 			/// <returns>True if the current token and type match the supplied expected values.</returns>
-			bool matchToken(TokenTypes expected_type, std::wstring expected_value) const noexcept {
+			bool matchToken(TokenTypes expected_type, std::wstring_view expected_value) const noexcept {
 				return this->matchTokenType(expected_type) && this->matchTokenValue(expected_value);
 			}
 			/// <summary>Checks if the current token matches the supplied values, and throws an
 			/// exception if they do not.</summary>
 			/// <param name="expected_type">The token type that is expected.</param>
 			/// <param name="expected_value">The token value that is expected.</param> 
-			void expectToken(TokenTypes expected_type, std::wstring expected_value) const {
+			void expectToken(TokenTypes expected_type, std::wstring_view expected_value_view) const {
 				using namespace std::literals::string_literals;
-				if (!this->matchToken(expected_type, expected_value)) {
+				if (!this->matchToken(expected_type, expected_value_view)) {
+					const std::wstring expected_value {expected_value_view};
 					switch (expected_type) {
 					case TokenTypes::Identifier:
 						throw DataFileException {L"Expected the following key/operator/identifier: "s + expected_value
@@ -84,8 +104,8 @@ namespace hoffman_isaiah {
 			/// <summary>Determines if the current token matches the supplied values.</summary>
 			/// <param name="expected_value">The token value that is expected.</param> 
 			/// <returns>True if the current token matches the supplied value.</returns>
-			bool matchTokenValue(std::wstring expected_value) const noexcept {
-				return this->getToken() == expected_value;
+			bool matchTokenValue(std::wstring_view expected_value) const noexcept {
+				return this->token == expected_value;
 			}
 			/// <summary>Determines if the current token matches the supplied values.</summary>
 			/// <param name="expected_type">The token type that is expected.</param>
@@ -97,7 +117,7 @@ namespace hoffman_isaiah {
 			/// this fails), and returns the value part of the key-value pair if successful.</summary>
 			/// <param name="expected_key">The expected value for the key-part of the key-value pair.</param>
 			/// <returns>The value part of the key-value pair.</returns>
-			std::pair<TokenTypes, std::wstring> readKeyValue(std::wstring expected_key) {
+			std::pair<TokenTypes, std::wstring> readKeyValue(std::wstring_view expected_key) {
 				using namespace std::literals::string_literals;
 				if (!this->getNext()) {
 					throw DataFileException {L"Data file stream is an invalid state. Maybe the file"s
@@ -132,17 +152,31 @@ namespace hoffman_isaiah {
 				if (!this->matchTokenType(TokenTypes::Number)) {
 					throw DataFileException {L"The current token is not a number.", this->getLine()};
 				}
-				if constexpr(std::is_same_v<T, double>) {
-					return std::stod(this->getToken());
-				}
-				else if constexpr(std::is_same_v<T, int>) {
-					return std::stoi(this->getToken());
-				}
-				else if constexpr (std::is_same_v<T, float>) {
-					return std::stof(this->getToken());
-				}
-				else if constexpr (std::is_same_v<T, long long>) {
-					return std::stoll(this->getToken());
+				if constexpr (std::is_same_v<T, double> || std::is_same_v<T, int>
+					|| std::is_same_v<T, float> || std::is_same_v<T, long long>) {
+					// Numeric tokens only contain ASCII characters, so they can be narrowed
+					// in place for std::from_chars (which only accepts char).
+					std::array<char, max_number_length> digits {};
+					std::wstring_view my_number = this->token;
+					if (!my_number.empty() && my_number.front() == L'+') {
+						// (std::from_chars does not accept a leading plus sign.)
+						my_number.remove_prefix(1);
+					}
+					if (my_number.size() > digits.size()) {
+						throw DataFileException {L"Numeric literal is too long: " + this->getToken(), this->getLine()};
+					}
+					std::transform(my_number.cbegin(), my_number.cend(), digits.begin(), [](wchar_t c) {
+						return static_cast<char>(c);
+					});
+					T value {};
+					const auto result = std::from_chars(digits.data(), digits.data() + my_number.size(), value);
+					if (result.ec == std::errc::invalid_argument) {
+						throw DataFileException {L"Invalid numeric literal: " + this->getToken(), this->getLine()};
+					}
+					else if (result.ec == std::errc::result_out_of_range) {
+						throw DataFileException {L"Numeric literal is out of range: " + this->getToken(), this->getLine()};
+					}
+					return value;
 				}
 				else {
 					// Strange rule doesn't allow me to just use "false" here...
@@ -156,11 +190,11 @@ namespace hoffman_isaiah {
 				if (!this->matchTokenType(TokenTypes::Identifier)) {
 					throw DataFileException {L"Expected an identifier.", this->getLine()};
 				}
-				else if (this->getToken() != L"True" && this->getToken() != L"False"
-					&& this->getToken() != L"true" && this->getToken() != L"false") {
+				else if (this->token != L"True" && this->token != L"False"
+					&& this->token != L"true" && this->token != L"false") {
 					throw DataFileException {L"Expected a boolean literal (`True` or `False`).", this->getLine()};
 				}
-				return this->getToken() == L"true" || this->getToken() == L"True";
+				return this->token == L"true" || this->token == L"True";
 			}
 			/// <summary>Attempts to read and parse a list from the input stream. Note that getNext()
 			/// or readKeyValuePair() should already have been called; this method expects the current
@@ -186,7 +220,7 @@ namespace hoffman_isaiah {
 							list_items.emplace_back(this->parseString());
 						}
 						else if (this->matchTokenType(TokenTypes::Identifier)) {
-							list_items.emplace_back(this->getToken());
+							list_items.emplace_back(this->token);
 						}
 						else {
 							throw DataFileException {L"Expected a string or an identifier within the list.", this->getLine()};
@@ -317,7 +351,11 @@ namespace hoffman_isaiah {
 			}
 
 			// Getters
-			std::wstring getToken() const noexcept {
+			std::wstring getToken() const {
+				return std::wstring {this->token};
+			}
+			/// <returns>A view of the current token. (This is only valid until the next call to getNext().)</returns>
+			std::wstring_view getTokenView() const noexcept {
 				return this->token;
 			}
 			TokenTypes getTokenType() const noexcept {
@@ -344,18 +382,232 @@ namespace hoffman_isaiah {
 			bool readIdentifier() noexcept;
 			/// <summary>Checks if the data stream is in a valid state.</summary>
 			/// <returns>True if the input stream is in a valid state; otherwise, false.</returns>
-			bool isValid() const noexcept;
+			bool isValid() const noexcept {
+				return this->position < this->contents.size();
+			}
+			/// <summary>Moves the lookahead to the next character.</summary>
+			/// <returns>False if the end of the input was reached; otherwise, true.</returns>
+			bool advance() noexcept {
+				++this->position;
+				return this->isValid();
+			}
+			/// <returns>The current lookahead character. (Only valid if isValid() is true.)</returns>
+			wchar_t lookahead() const noexcept {
+				return this->contents[this->position];
+			}
+			/// <param name="first">The index of the first character to include.</param>
+			/// <param name="last">The index one past the last character to include.</param>
+			/// <returns>A view of the given part of the input.</returns>
+			std::wstring_view slice(std::size_t first, std::size_t last) const noexcept {
+				return std::wstring_view {this->contents}.substr(first, last - first);
+			}
 		private:
-			/// <summary>The input stream being read.</summary>
-			std::wistream& data_file;
-			/// <summary>The current lookahead token.</summary>
-			wchar_t lookahead {L'\0'};
-			/// <summary>The current token being read by the lexer.</summary>
-			std::wstring token {L""};
+			/// <summary>The maximum number of characters in a numeric literal.</summary>
+			static constexpr const std::size_t max_number_length = 64;
+			/// <summary>The entire contents of the data file.</summary>
+			std::wstring contents;
+			/// <summary>The index of the current lookahead character in contents.</summary>
+			std::size_t position {0};
+			/// <summary>The current token being read by the lexer. This refers either to contents
+			/// or to token_buffer.</summary>
+			std::wstring_view token {};
+			/// <summary>Holds the current token when its value differs from its text in the file
+			/// (such as a string with escape sequences). The storage is reused between tokens.</summary>
+			std::wstring token_buffer {};
 			/// <summary>The type of token that is being read.</summary>
 			TokenTypes token_type {TokenTypes::Identifier};
 			/// <summary>The current line number the lexer is on.</summary>
 			int line_number {1};
 		};
+
+		/// <summary>Writes values into a binary buffer. Values are stored in the machine's native
+		/// (little-endian) byte order, and strings are stored as a length followed by UTF-16 code
+		/// units. Nothing in the output depends on where the buffer is later loaded.</summary>
+		class BinaryWriter {
+		public:
+			/// <summary>Appends a number, boolean, or enumeration constant to the buffer.</summary>
+			/// <param name="value">The value to write.</param>
+			template <typename T>
+			void write(T value) {
+				static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "Only numbers and enumerations can be written directly.");
+				if constexpr (std::is_enum_v<T>) {
+					this->write(static_cast<std::int32_t>(value));
+				}
+				else if constexpr (std::is_same_v<T, bool>) {
+					this->write(static_cast<std::uint8_t>(value ? 1 : 0));
+				}
+				else {
+					const auto old_size = this->data.size();
+					this->data.resize(old_size + sizeof(T));
+					std::memcpy(this->data.data() + old_size, &value, sizeof(T));
+				}
+			}
+			/// <summary>Appends a string to the buffer.</summary>
+			/// <param name="str">The string to write.</param>
+			void writeString(std::wstring_view str) {
+				this->write(static_cast<std::uint32_t>(str.size()));
+				for (const auto c : str) {
+					this->write(static_cast<std::uint16_t>(c));
+				}
+			}
+			/// <summary>Appends an unsigned integer using as few bytes as possible. (Each byte
+			/// stores 7 bits of the value; the high bit is set if more bytes follow.)</summary>
+			/// <param name="value">The value to write.</param>
+			void writeVarint(std::uint64_t value) {
+				while (value >= 0x80U) {
+					this->data.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+					value >>= 7;
+				}
+				this->data.push_back(static_cast<char>(value));
+			}
+			/// <summary>Appends a signed integer using as few bytes as possible. (Values close
+			/// to zero, whether positive or negative, use the fewest bytes.)</summary>
+			/// <param name="value">The value to write.</param>
+			void writeSignedVarint(std::int64_t value) {
+				// Zig-zag encoding: 0, -1, 1, -2, 2, ... => 0, 1, 2, 3, 4, ...
+				this->writeVarint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+			}
+			/// <summary>Appends raw bytes to the buffer.</summary>
+			/// <param name="bytes">The start of the bytes to append.</param>
+			/// <param name="count">The number of bytes to append.</param>
+			void writeBytes(const char* bytes, std::size_t count) {
+				this->data.insert(this->data.end(), bytes, bytes + count);
+			}
+			/// <summary>Appends a list of strings to the buffer.</summary>
+			/// <param name="strs">The strings to write.</param>
+			void writeStrings(const std::vector<std::wstring>& strs) {
+				this->write(static_cast<std::uint32_t>(strs.size()));
+				for (const auto& str : strs) {
+					this->writeString(str);
+				}
+			}
+			// Getters
+			const std::vector<char>& getData() const noexcept {
+				return this->data;
+			}
+		private:
+			/// <summary>The bytes written so far.</summary>
+			std::vector<char> data {};
+		};
+
+		/// <summary>Reads values from a buffer created by BinaryWriter. An exception is thrown
+		/// if the buffer ends before a value is fully read.</summary>
+		class BinaryReader {
+		public:
+			/// <param name="buffer">The start of the binary data. (The reader does not own the data.)</param>
+			/// <param name="buffer_size">The number of bytes of binary data.</param>
+			BinaryReader(const char* buffer, std::size_t buffer_size) noexcept :
+				data {buffer},
+				size {buffer_size} {
+			}
+			/// <returns>The next number, boolean, or enumeration constant in the buffer.</returns>
+			template <typename T>
+			T read() {
+				static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "Only numbers and enumerations can be read directly.");
+				if constexpr (std::is_enum_v<T>) {
+					return static_cast<T>(this->read<std::int32_t>());
+				}
+				else if constexpr (std::is_same_v<T, bool>) {
+					return this->read<std::uint8_t>() != 0;
+				}
+				else {
+					this->checkAvailable(sizeof(T));
+					T value {};
+					std::memcpy(&value, this->data + this->position, sizeof(T));
+					this->position += sizeof(T);
+					return value;
+				}
+			}
+			/// <returns>The next string in the buffer.</returns>
+			std::wstring readString() {
+				const auto length = this->read<std::uint32_t>();
+				this->checkAvailable(static_cast<std::size_t>(length) * sizeof(std::uint16_t));
+				std::wstring str(length, L'\0');
+				for (auto& c : str) {
+					c = static_cast<wchar_t>(this->read<std::uint16_t>());
+				}
+				return str;
+			}
+			/// <returns>The next unsigned integer written by BinaryWriter::writeVarint.</returns>
+			std::uint64_t readVarint() {
+				std::uint64_t value {0};
+				for (int shift = 0; shift < 64; shift += 7) {
+					const auto byte = this->read<std::uint8_t>();
+					value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+					if ((byte & 0x80U) == 0) {
+						return value;
+					}
+				}
+				throw DataFileException {L"Invalid variable-length integer in binary data.", 0};
+			}
+			/// <returns>The next signed integer written by BinaryWriter::writeSignedVarint.</returns>
+			std::int64_t readSignedVarint() {
+				const auto value = this->readVarint();
+				return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1U);
+			}
+			/// <returns>The next list of strings in the buffer.</returns>
+			std::vector<std::wstring> readStrings() {
+				const auto count = this->read<std::uint32_t>();
+				std::vector<std::wstring> strs {};
+				for (std::uint32_t i = 0; i < count; ++i) {
+					strs.emplace_back(this->readString());
+				}
+				return strs;
+			}
+			/// <returns>True if every byte of the buffer has been read.</returns>
+			bool isAtEnd() const noexcept {
+				return this->position == this->size;
+			}
+		protected:
+			/// <summary>Throws an exception if fewer than the given number of bytes remain.</summary>
+			/// <param name="count">The number of bytes about to be read.</param>
+			void checkAvailable(std::size_t count) const {
+				if (count > this->size - this->position) {
+					throw DataFileException {L"Unexpected end of binary data.", 0};
+				}
+			}
+		private:
+			/// <summary>The binary data being read.</summary>
+			const char* data;
+			/// <summary>The number of bytes of binary data.</summary>
+			std::size_t size;
+			/// <summary>The offset of the next byte to read.</summary>
+			std::size_t position {0};
+		};
+
+		/// <param name="file_name">The path of the file to read.</param>
+		/// <param name="contents">Receives the contents of the file.</param>
+		/// <returns>True if the file was read successfully.</returns>
+		bool readWholeFile(const std::wstring& file_name, std::vector<char>& contents);
+		/// <param name="bytes">The start of the bytes to hash.</param>
+		/// <param name="count">The number of bytes to hash.</param>
+		/// <returns>The 64-bit FNV-1a hash of the given bytes.</returns>
+		std::uint64_t hashBytes(const char* bytes, std::size_t count) noexcept;
+		/// <param name="text">The text to encode. (Surrogate pairs are combined.)</param>
+		/// <returns>The text encoded as UTF-8.</returns>
+		std::vector<char> encodeUtf8(std::wstring_view text);
+		/// <param name="bytes">The UTF-8 text to decode.</param>
+		/// <returns>The decoded text. (Invalid sequences become U+FFFD.)</returns>
+		std::wstring decodeUtf8(const std::vector<char>& bytes);
+
+		/// <summary>Combines separately written sections into a single binary file. The file begins
+		/// with a header (magic number, version, and section count) followed by a table containing
+		/// the identifier, offset, and size of each section, which lets readers skip to any section
+		/// and ignore sections that they do not recognize.</summary>
+		/// <param name="magic">The magic number that identifies the kind of file.</param>
+		/// <param name="version">The format version of the file.</param>
+		/// <param name="sections">The identifier and contents of each section.</param>
+		/// <returns>The contents of the file.</returns>
+		std::vector<char> buildSectionedFile(std::uint32_t magic, std::uint32_t version,
+			const std::vector<std::pair<std::uint32_t, BinaryWriter>>& sections);
+		/// <summary>Reads the section table of a file created by buildSectionedFile. The sections
+		/// are read in place, so the buffer must outlive the returned readers.</summary>
+		/// <param name="data">The start of the file's contents.</param>
+		/// <param name="size">The size of the file in bytes.</param>
+		/// <param name="magic">The magic number that the file must begin with.</param>
+		/// <param name="max_version">The newest format version that the caller understands.</param>
+		/// <returns>A reader for each section, keyed by section identifier.</returns>
+		std::map<std::uint32_t, BinaryReader> readSectionedFile(const char* data, std::size_t size,
+			std::uint32_t magic, std::uint32_t max_version);
 	}
 }
\ No newline at end of file
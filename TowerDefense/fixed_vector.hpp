@@ -0,0 +1,139 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace hoffman_isaiah {
+	namespace util {
+		/// <summary>A vector whose items are stored inside the object itself instead of on the heap.
+		/// It never allocates, so it can never hold more than its capacity.</summary>
+		/// <typeparam name="T">The type of item held by the vector.</typeparam>
+		/// <typeparam name="Capacity">The maximum number of items in the vector.</typeparam>
+		template <typename T, std::size_t Capacity>
+		class FixedVector {
+			static_assert(Capacity > 0, "The capacity must be positive.");
+		public:
+			FixedVector() noexcept = default;
+			~FixedVector() noexcept {
+				this->clear();
+			}
+			// Rule of 5:
+			FixedVector(const FixedVector& rhs) {
+				for (const auto& item : rhs) {
+					this->push_back(item);
+				}
+			}
+			FixedVector(FixedVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+				for (auto& item : rhs) {
+					this->push_back(std::move(item));
+				}
+				rhs.clear();
+			}
+			FixedVector& operator=(const FixedVector& rhs) {
+				if (this != &rhs) {
+					this->clear();
+					for (const auto& item : rhs) {
+						this->push_back(item);
+					}
+				}
+				return *this;
+			}
+			FixedVector& operator=(FixedVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+				if (this != &rhs) {
+					this->clear();
+					for (auto& item : rhs) {
+						this->push_back(std::move(item));
+					}
+					rhs.clear();
+				}
+				return *this;
+			}
+			/// <summary>Adds an item to the back of the vector. The vector must not be full.</summary>
+			/// <param name="item">The item to add.</param>
+			void push_back(const T& item) {
+				new (this->data() + this->item_count) T(item);
+				++this->item_count;
+			}
+			/// <summary>Adds an item to the back of the vector. The vector must not be full.</summary>
+			/// <param name="item">The item to add.</param>
+			void push_back(T&& item) {
+				new (this->data() + this->item_count) T(std::move(item));
+				++this->item_count;
+			}
+			/// <summary>Removes an item, moving later items forward to fill the gap.</summary>
+			/// <returns>The position after the removed item.</returns>
+			T* erase(T* pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+				return this->erase(pos, pos + 1);
+			}
+			/// <summary>Removes the items in the range [first, last), moving later items forward
+			/// to fill the gap.</summary>
+			/// <returns>The position after the removed items.</returns>
+			T* erase(T* first, T* last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+				if (first == last) {
+					return first;
+				}
+				T* my_output = first;
+				for (T* my_input = last; my_input != this->end(); ++my_input, ++my_output) {
+					*my_output = std::move(*my_input);
+				}
+				for (T* my_item = my_output; my_item != this->end(); ++my_item) {
+					my_item->~T();
+				}
+				this->item_count = static_cast<std::size_t>(my_output - this->data());
+				return first;
+			}
+			/// <summary>Removes every item.</summary>
+			void clear() noexcept {
+				for (auto& item : *this) {
+					item.~T();
+				}
+				this->item_count = 0;
+			}
+			// Getters
+			T* data() noexcept {
+				return std::launder(reinterpret_cast<T*>(this->storage));
+			}
+			const T* data() const noexcept {
+				return std::launder(reinterpret_cast<const T*>(this->storage));
+			}
+			T* begin() noexcept {
+				return this->data();
+			}
+			const T* begin() const noexcept {
+				return this->data();
+			}
+			T* end() noexcept {
+				return this->data() + this->item_count;
+			}
+			const T* end() const noexcept {
+				return this->data() + this->item_count;
+			}
+			T& operator[](std::size_t i) noexcept {
+				return this->data()[i];
+			}
+			const T& operator[](std::size_t i) const noexcept {
+				return this->data()[i];
+			}
+			std::size_t size() const noexcept {
+				return this->item_count;
+			}
+			bool empty() const noexcept {
+				return this->item_count == 0;
+			}
+			bool full() const noexcept {
+				return this->item_count == Capacity;
+			}
+			static constexpr std::size_t capacity() noexcept {
+				return Capacity;
+			}
+		private:
+			/// <summary>The raw storage of the items. (Only the first item_count are alive.)</summary>
+			alignas(T) unsigned char storage[sizeof(T) * Capacity];
+			/// <summary>The number of items in the vector.</summary>
+			std::size_t item_count {0};
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,467 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include "./../targetver.hpp"
+#include <Windows.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./../async_file_writer.hpp"
+#include "./../file_util.hpp"
+#include "./../globals.hpp"
+#include "./../resource_pack.hpp"
+#include "./../pathfinding/grid.hpp"
+#include "./balance_runner.hpp"
+#include "./game_util.hpp"
+#include "./my_game.hpp"
+#include "./tower.hpp"
+#include "./tower_types.hpp"
+#include "./simulation_host.hpp"
+using namespace std::literals::string_literals;
+
+namespace hoffman_isaiah {
+	namespace game {
+		namespace {
+			/// <summary>The data files (relative to the resources folder) that the results of a sweep depend on.
+			/// (The level files are added separately.)</summary>
+			constexpr const std::array<const wchar_t*, 5> balance_data_sources {
+				L"other.ini", L"enemies.ini", L"shots.ini", L"towers.ini", L"tower_upgrades.ini"
+			};
+			/// <summary>The column names of the rows in a chunk's results.</summary>
+			constexpr const wchar_t* chunk_columns
+				= L"game,map,seed,level,won,health_lost,money_before,money_after,score,ticks,steps_skipped,stalled";
+
+			/// <returns>A hash of the running executable. (The formulas that rate towers and
+			/// enemies are compiled into it, so rebuilding the game changes the hash.)</returns>
+			std::uint64_t hashExecutable() {
+				std::wstring exe_path(MAX_PATH, L'\0');
+				DWORD path_length = 0;
+				while ((path_length = GetModuleFileName(nullptr, exe_path.data(), static_cast<DWORD>(exe_path.size())))
+					== exe_path.size()) {
+					exe_path.resize(exe_path.size() * 2);
+				}
+				exe_path.resize(path_length);
+				std::vector<char> contents {};
+				if (path_length == 0 || !util::file::readWholeFile(exe_path, contents)) {
+					throw util::file::DataFileException {L"Could not read the game's executable to fingerprint the sweep."s, 0};
+				}
+				return util::file::hashBytes(contents.data(), contents.size());
+			}
+
+			/// <returns>The first line of a chunk's results, which identifies the sweep it belongs to.</returns>
+			std::wstring getChunkHeader(std::uint64_t fingerprint) {
+				std::wostringstream my_header {};
+				my_header << L"# " << std::hex << fingerprint << L"\n";
+				return my_header.str();
+			}
+
+			/// <param name="sorted_values">The values to look in, sorted from least to greatest.</param>
+			/// <param name="fraction">How far through the values to look (0 to 1).</param>
+			/// <returns>The value that the given fraction of the values are at or below.</returns>
+			double getPercentile(const std::vector<double>& sorted_values, double fraction) {
+				if (sorted_values.empty()) {
+					return 0.0;
+				}
+				const auto i = static_cast<std::size_t>(std::lround(fraction * (sorted_values.size() - 1)));
+				return sorted_values[i];
+			}
+
+			/// <summary>Collects the outcomes of a level of a map across every game.</summary>
+			struct LevelStatistics {
+				/// <summary>The number of games that played the level.</summary>
+				int games {0};
+				/// <summary>The number of games in which the player survived the level.</summary>
+				int wins {0};
+				/// <summary>The total amount of health lost during the level.</summary>
+				long long health_lost {0};
+				/// <summary>The player's money at the start of the level in each game.</summary>
+				std::vector<double> money {};
+				/// <summary>The player's score at the end of the level in each game.</summary>
+				std::vector<double> scores {};
+			};
+		}
+
+		BalanceSettings parseBalanceSettings(std::wstring file_contents) {
+			util::file::DataFileParser my_parser {std::move(file_contents)};
+			BalanceSettings my_settings {};
+			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
+#pragma warning(push)
+#pragma warning(disable: 26444) // ES84: Avoid unnamed objects with custom construction/destruction. (No Idea...)
+			my_parser.readKeyValue(L"version"s);
+			my_parser.expectToken(util::file::TokenTypes::Number, L"1"s);
+			my_parser.readKeyValue(L"maps"s);
+			my_settings.maps = my_parser.readList();
+			if (my_settings.maps.empty()) {
+				throw util::file::DataFileException {L"At least one map must be listed."s, my_parser.getLine()};
+			}
+			my_parser.readKeyValue(L"games_per_map"s);
+			my_settings.games_per_map = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.games_per_map, 1,
+				L"Games per map"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"games_per_chunk"s);
+			my_settings.games_per_chunk = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.games_per_chunk, 1,
+				L"Games per chunk"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"base_seed"s);
+			my_settings.base_seed = my_parser.parseNumber<int>();
+			my_parser.readKeyValue(L"max_level_ticks"s);
+			my_settings.max_level_ticks = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.max_level_ticks, 1,
+				L"Maximum level ticks"s, my_parser.getLine(), true);
+#pragma warning(pop)
+			return my_settings;
+		}
+
+		PlacementScript parsePlacementScript(std::wstring file_contents) {
+			util::file::DataFileParser my_parser {std::move(file_contents)};
+			PlacementScript my_script {};
+			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
+#pragma warning(push)
+#pragma warning(disable: 26444) // ES84: Avoid unnamed objects with custom construction/destruction. (No Idea...)
+			my_parser.readKeyValue(L"version"s);
+			my_parser.expectToken(util::file::TokenTypes::Number, L"1"s);
+			my_parser.readKeyValue(L"challenge_level"s);
+			my_script.challenge_level = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumber(my_script.challenge_level, 0, 3,
+				L"Challenge level"s, my_parser.getLine(), true, true);
+			my_parser.readKeyValue(L"last_level"s);
+			my_script.last_level = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_script.last_level, 1,
+				L"Last level"s, my_parser.getLine(), true);
+			while (my_parser.getNext()) {
+				// Tower and upgrade sections
+				PlacementStep my_step {};
+				const bool is_upgrade = my_parser.matchToken(util::file::TokenTypes::Section, L"upgrade"s);
+				if (!is_upgrade) {
+					my_parser.expectToken(util::file::TokenTypes::Section, L"tower"s);
+					my_parser.readKeyValue(L"name"s);
+					my_step.tower_name = my_parser.parseString();
+				}
+				my_parser.readKeyValue(L"level"s);
+				my_step.level = my_parser.parseNumber<int>();
+				util::file::DataFileParser::validateNumberMinBound(my_step.level, 1,
+					L"Level"s, my_parser.getLine(), true);
+				if (!my_script.steps.empty() && my_step.level < my_script.steps.back().level) {
+					throw util::file::DataFileException {L"Towers must be listed in the order that they are bought."s,
+						my_parser.getLine()};
+				}
+				my_parser.readKeyValue(L"x"s);
+				my_step.gx = my_parser.parseNumber<int>();
+				my_parser.readKeyValue(L"y"s);
+				my_step.gy = my_parser.parseNumber<int>();
+				if (is_upgrade) {
+					my_parser.readKeyValue(L"option"s);
+					my_step.upgrade_option = my_parser.parseNumber<int>();
+					util::file::DataFileParser::validateNumber(my_step.upgrade_option, 1, 2,
+						L"Upgrade option"s, my_parser.getLine(), true, true);
+				}
+				my_script.steps.emplace_back(std::move(my_step));
+			}
+#pragma warning(pop)
+			return my_script;
+		}
+
+		std::wstring writePlacementScript(const PlacementScript& script) {
+			std::wostringstream my_text {};
+			my_text << L"[global]\nversion = 1\nchallenge_level = " << script.challenge_level
+				<< L"\nlast_level = " << script.last_level << L"\n";
+			for (const auto& my_step : script.steps) {
+				if (my_step.upgrade_option == 0) {
+					my_text << L"\n[tower]\nname = \"" << my_step.tower_name << L"\"\n";
+				}
+				else {
+					my_text << L"\n[upgrade]\n";
+				}
+				my_text << L"level = " << my_step.level << L"\nx = " << my_step.gx << L"\ny = " << my_step.gy << L"\n";
+				if (my_step.upgrade_option != 0) {
+					my_text << L"option = " << my_step.upgrade_option << L"\n";
+				}
+			}
+			return my_text.str();
+		}
+
+		BalanceGameResult playPlacementScript(MyGame& game, const PlacementScript& script,
+			std::uint64_t seed, int max_level_ticks) {
+			BalanceGameResult my_result {};
+			my_result.map_name = script.map_name;
+			my_result.seed = seed;
+			rng::seed(seed);
+			game.resetState(script.challenge_level, script.map_name);
+			if (game.getMapBaseName() != script.map_name) {
+				throw util::file::DataFileException {L"Could not load the "s + script.map_name + L" map."s, 0};
+			}
+			my_result.starting_health = game.getPlayerHealth();
+			// Find the type of each tower that the script buys up front.
+			std::vector<int> step_types {};
+			for (const auto& my_step : script.steps) {
+				if (my_step.upgrade_option != 0) {
+					step_types.emplace_back(-1);
+					continue;
+				}
+				const auto& tower_types = game.getAllTowerTypes();
+				const auto my_type = std::find_if(tower_types.cbegin(), tower_types.cend(), [&my_step](const auto& t) {
+					return t->getName() == my_step.tower_name;
+				});
+				if (my_type == tower_types.cend()) {
+					throw util::file::DataFileException {L"The placement script for the "s + script.map_name
+						+ L" map buys a tower that does not exist: "s + my_step.tower_name + L"."s, 0};
+				}
+				step_types.emplace_back(static_cast<int>(my_type - tower_types.cbegin()));
+			}
+			std::size_t next_step = 0;
+			while (game.getLevelNumber() <= script.last_level) {
+				// Buy the towers and upgrades that are due in order. If the next one is too expensive,
+				// the rest wait until the player has saved up for it.
+				for (; next_step < script.steps.size() && script.steps[next_step].level <= game.getLevelNumber(); ++next_step) {
+					const auto& my_step = script.steps[next_step];
+					if (!game.getMap().getTerrainGraph(false).verifyCoordinates(my_step.gx, my_step.gy)) {
+						++my_result.steps_skipped;
+						continue;
+					}
+					if (my_step.upgrade_option == 0) {
+						if (game.getPlayerCash() < std::ceil(game.getTowerType(step_types[next_step])->getCost())) {
+							break;
+						}
+						const auto tower_count = game.getTowers().size();
+						game.selectTower(step_types[next_step]);
+						game.buyTower(my_step.gx, my_step.gy);
+						if (game.getTowers().size() == tower_count) {
+							++my_result.steps_skipped;
+						}
+						continue;
+					}
+					const auto upgrade_option = my_step.upgrade_option == 1 ? TowerUpgradeOption::One : TowerUpgradeOption::Two;
+					const Tower* my_tower = game.getTowerAt(my_step.gx, my_step.gy);
+					const TowerUpgradeInfo* my_upgrade = my_tower ? my_tower->getNextUpgrade(upgrade_option) : nullptr;
+					if (!my_upgrade) {
+						++my_result.steps_skipped;
+						continue;
+					}
+					if (game.getPlayerCash() < my_tower->getUpgradeCost(*my_upgrade)) {
+						break;
+					}
+					game.upgradeTower(my_step.gx, my_step.gy, upgrade_option);
+				}
+				LevelOutcome my_outcome {};
+				my_outcome.level = game.getLevelNumber();
+				my_outcome.money_before = game.getPlayerCash();
+				const int health_before = game.getPlayerHealth();
+				const long long start_tick = game.getTickCount();
+				game.startWave();
+				while (game.isInLevel()) {
+					if (game.getTickCount() - start_tick >= max_level_ticks) {
+						my_result.stalled = true;
+						break;
+					}
+					game.update();
+				}
+				my_outcome.ticks = game.getTickCount() - start_tick;
+				my_outcome.won = !my_result.stalled && game.getPlayerHealth() > 0;
+				my_outcome.health_lost = health_before - std::max(game.getPlayerHealth(), 0);
+				my_outcome.money_after = game.getPlayerCash();
+				my_outcome.score = game.calculateScore();
+				my_result.levels.emplace_back(my_outcome);
+				if (!my_outcome.won) {
+					break;
+				}
+			}
+			my_result.health_left = std::max(game.getPlayerHealth(), 0);
+			return my_result;
+		}
+
+		BalanceRunner::BalanceRunner(MyGame& game) :
+			my_game {game} {
+			const auto& my_resources = this->my_game.getResources();
+			std::vector<std::uint64_t> hashes {hashExecutable()};
+			const auto hash_resource = [&my_resources, &hashes](const std::wstring& path) {
+				util::file::ResourceView my_view {};
+				if (my_resources.getResource(path, my_view)) {
+					hashes.emplace_back(util::file::hashBytes(my_view.data(), my_view.size()));
+				}
+			};
+			util::file::ResourceView settings_file {};
+			if (!my_resources.getResource(balance_settings_file_name, settings_file)) {
+				throw util::file::DataFileException {L"Could not load the balance sweep's settings (resources/"s
+					+ balance_settings_file_name + L")."s, 0};
+			}
+			this->settings = parseBalanceSettings(settings_file.toWideString());
+			hash_resource(balance_settings_file_name);
+			for (const auto& map_name : this->settings.maps) {
+				const std::wstring script_name = L"balance/"s + map_name + L".ini"s;
+				util::file::ResourceView script_file {};
+				if (!my_resources.getResource(script_name, script_file)) {
+					throw util::file::DataFileException {L"Could not load the placement script for the "s
+						+ map_name + L" map (resources/"s + script_name + L")."s, 0};
+				}
+				this->scripts.emplace_back(parsePlacementScript(script_file.toWideString()));
+				this->scripts.back().map_name = map_name;
+				hash_resource(script_name);
+				hash_resource(getMapResourceName(map_name));
+				hash_resource(L"graphs/ground_graph_"s + map_name + L".txt"s);
+				hash_resource(L"graphs/air_graph_"s + map_name + L".txt"s);
+			}
+			for (const auto source : balance_data_sources) {
+				hash_resource(source);
+			}
+			for (const auto& level_file : my_resources.listResources(L"levels/"s)) {
+				hash_resource(L"levels/"s + level_file);
+			}
+			this->fingerprint = util::file::hashBytes(reinterpret_cast<const char*>(hashes.data()),
+				hashes.size() * sizeof(std::uint64_t));
+		}
+
+		bool BalanceRunner::runSweep() {
+			std::error_code ec {};
+			std::filesystem::create_directories(this->my_game.getUserDataPath() + balance_output_folder, ec);
+			std::vector<int> pending_chunks {};
+			for (int i = 0; i < this->getChunkCount(); ++i) {
+				if (!this->isChunkDone(i)) {
+					pending_chunks.emplace_back(i);
+				}
+			}
+			const int chunks_resumed = this->getChunkCount() - static_cast<int>(pending_chunks.size());
+			int chunks_done = chunks_resumed;
+			int chunks_failed = 0;
+			const auto start_time = std::chrono::steady_clock::now();
+			this->writeProgress(chunks_done, chunks_resumed, chunks_failed, 0.0);
+			SimulationHost my_host {this->my_game};
+			my_host.runJobs(static_cast<int>(pending_chunks.size()), [this, &pending_chunks](MyGame& game, int job) {
+				return this->runChunk(game, pending_chunks[job]);
+			}, [&](int job, bool succeeded) {
+				UNREFERENCED_PARAMETER(job);
+				++(succeeded ? chunks_done : chunks_failed);
+				this->writeProgress(chunks_done, chunks_resumed, chunks_failed, std::chrono::duration<double> {
+					std::chrono::steady_clock::now() - start_time}.count());
+			});
+			return this->writeReport() && chunks_failed == 0;
+		}
+
+		bool BalanceRunner::runChunk(MyGame& game, int chunk) const {
+			const int first_game = chunk * this->settings.games_per_chunk;
+			const int end_game = std::min(first_game + this->settings.games_per_chunk, this->getGameCount());
+			std::wostringstream my_results {};
+			my_results << getChunkHeader(this->getFingerprint()) << chunk_columns << L"\n";
+			for (int i = first_game; i < end_game; ++i) {
+				const auto my_result = this->runGame(game, i);
+				for (const auto& my_level : my_result.levels) {
+					my_results << my_result.game << L"," << my_result.map_name << L"," << my_result.seed << L","
+						<< my_level.level << L"," << my_level.won << L"," << my_level.health_lost << L","
+						<< std::fixed << std::setprecision(2) << my_level.money_before << L"," << my_level.money_after
+						<< L"," << my_level.score << L"," << my_level.ticks << L"," << my_result.steps_skipped << L","
+						<< my_result.stalled << L"\n";
+				}
+			}
+			const std::wstring my_text = my_results.str();
+			std::error_code ec {};
+			std::filesystem::create_directories(this->my_game.getUserDataPath() + balance_output_folder, ec);
+			return util::file::writeFileAtomically(this->getChunkFileName(chunk), util::file::encodeUtf8(my_text));
+		}
+
+		BalanceGameResult BalanceRunner::runGame(MyGame& game, int game_index) const {
+			auto my_result = playPlacementScript(game, this->scripts.at(game_index / this->settings.games_per_map),
+				this->getGameSeed(game_index), this->settings.max_level_ticks);
+			my_result.game = game_index;
+			return my_result;
+		}
+
+		bool BalanceRunner::writeReport() const {
+			// Key => (Map index, Level)
+			std::map<std::pair<int, int>, LevelStatistics> level_stats {};
+			for (int i = 0; i < this->getChunkCount(); ++i) {
+				std::vector<char> contents {};
+				if (!this->isChunkDone(i) || !util::file::readWholeFile(this->getChunkFileName(i), contents)) {
+					continue;
+				}
+				std::wistringstream my_rows {util::file::decodeUtf8(contents)};
+				std::wstring my_row {};
+				// (The first two lines are the header and the column names.)
+				std::getline(my_rows, my_row);
+				std::getline(my_rows, my_row);
+				while (std::getline(my_rows, my_row)) {
+					std::vector<std::wstring> my_fields {};
+					std::wistringstream my_row_stream {my_row};
+					std::wstring my_field {};
+					while (std::getline(my_row_stream, my_field, L',')) {
+						my_fields.emplace_back(my_field);
+					}
+					if (my_fields.size() < 9) {
+						continue;
+					}
+					const auto my_map = std::find(this->settings.maps.cbegin(), this->settings.maps.cend(), my_fields[1]);
+					if (my_map == this->settings.maps.cend()) {
+						continue;
+					}
+					auto& my_stats = level_stats[{static_cast<int>(my_map - this->settings.maps.cbegin()), std::stoi(my_fields[3])}];
+					++my_stats.games;
+					my_stats.wins += std::stoi(my_fields[4]);
+					my_stats.health_lost += std::stoi(my_fields[5]);
+					my_stats.money.emplace_back(std::stod(my_fields[6]));
+					my_stats.scores.emplace_back(std::stod(my_fields[8]));
+				}
+			}
+			std::wostringstream my_report {};
+			my_report << L"map,level,games,clear_rate,mean_health_lost,mean_money,money_p10,money_p50,money_p90,"
+				L"mean_score,score_p10,score_p50,score_p90\n" << std::fixed << std::setprecision(3);
+			for (auto& [my_key, my_stats] : level_stats) {
+				std::sort(my_stats.money.begin(), my_stats.money.end());
+				std::sort(my_stats.scores.begin(), my_stats.scores.end());
+				const double games = my_stats.games;
+				my_report << this->settings.maps[my_key.first] << L"," << my_key.second << L"," << my_stats.games << L","
+					<< my_stats.wins / games << L"," << my_stats.health_lost / games << L","
+					<< std::accumulate(my_stats.money.cbegin(), my_stats.money.cend(), 0.0) / games << L","
+					<< getPercentile(my_stats.money, 0.1) << L"," << getPercentile(my_stats.money, 0.5) << L","
+					<< getPercentile(my_stats.money, 0.9) << L","
+					<< std::accumulate(my_stats.scores.cbegin(), my_stats.scores.cend(), 0.0) / games << L","
+					<< getPercentile(my_stats.scores, 0.1) << L"," << getPercentile(my_stats.scores, 0.5) << L","
+					<< getPercentile(my_stats.scores, 0.9) << L"\n";
+			}
+			const std::wstring my_text = my_report.str();
+			return util::file::writeFileAtomically(this->my_game.getUserDataPath() + balance_output_folder
+				+ L"report.csv"s, util::file::encodeUtf8(my_text));
+		}
+
+		std::uint64_t BalanceRunner::getGameSeed(int game_index) const noexcept {
+			return rng::mixBits(static_cast<std::uint64_t>(static_cast<std::uint32_t>(this->settings.base_seed)) << 32
+				| static_cast<std::uint32_t>(game_index));
+		}
+
+		std::wstring BalanceRunner::getChunkFileName(int chunk) const {
+			return this->my_game.getUserDataPath() + balance_output_folder + L"chunk_"s + std::to_wstring(chunk) + L".csv"s;
+		}
+
+		bool BalanceRunner::isChunkDone(int chunk) const {
+			std::vector<char> contents {};
+			if (!util::file::readWholeFile(this->getChunkFileName(chunk), contents)) {
+				return false;
+			}
+			const auto expected_header = util::file::encodeUtf8(getChunkHeader(this->getFingerprint()));
+			return contents.size() >= expected_header.size()
+				&& std::equal(expected_header.cbegin(), expected_header.cend(), contents.cbegin());
+		}
+
+		void BalanceRunner::writeProgress(int chunks_done, int chunks_resumed, int chunks_failed,
+			double elapsed_seconds) const {
+			std::wostringstream my_progress {};
+			my_progress << L"Chunks finished: " << chunks_done << L" of " << this->getChunkCount() << L"\n"
+				<< L"Chunks failed: " << chunks_failed << L"\n"
+				<< std::fixed << std::setprecision(0) << L"Elapsed seconds: " << elapsed_seconds << L"\n";
+			const int chunks_done_now = chunks_done - chunks_resumed;
+			if (chunks_done_now > 0) {
+				const int chunks_left = this->getChunkCount() - chunks_done - chunks_failed;
+				my_progress << L"Estimated seconds left: " << elapsed_seconds / chunks_done_now * chunks_left << L"\n";
+			}
+			const std::wstring my_text = my_progress.str();
+			util::file::writeFileAtomically(this->my_game.getUserDataPath() + balance_output_folder + L"progress.txt"s,
+				util::file::encodeUtf8(my_text));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hoffman_isaiah {
+	namespace game {
+		// Forward declaration
+		class MyGame;
+
+		/// <summary>The name of the balance sweep's settings file (relative to the resources folder).</summary>
+		constexpr const wchar_t* balance_settings_file_name = L"balance/sweep.ini";
+		/// <summary>The folder (relative to the user data folder) that a balance sweep's checkpoints
+		/// and reports are written to.</summary>
+		constexpr const wchar_t* balance_output_folder = L"balance/";
+
+		/// <summary>Controls how many games a balance sweep plays and how they are split up.</summary>
+		struct BalanceSettings {
+			/// <summary>The base names of the maps to play. (Each map needs a placement script.)</summary>
+			std::vector<std::wstring> maps {};
+			/// <summary>The number of games to play on each map.</summary>
+			int games_per_map {1000};
+			/// <summary>The number of games in each chunk. (A chunk's games are played one after
+			/// another by a single session, and its results are saved once it finishes.)</summary>
+			int games_per_chunk {25};
+			/// <summary>The seed that every game's seed is derived from.</summary>
+			int base_seed {0};
+			/// <summary>The number of logic ticks after which a level is given up on.</summary>
+			int max_level_ticks {216000};
+		};
+
+		/// <summary>A tower that a placement script buys (or upgrades).</summary>
+		struct PlacementStep {
+			/// <summary>The first level that the tower is bought before. (If the player cannot
+			/// afford it yet, it is bought before the first level that they can.)</summary>
+			int level {1};
+			/// <summary>The name of the tower's type. (Unused by upgrades.)</summary>
+			std::wstring tower_name {};
+			/// <summary>The x-coordinate of the square to build on.</summary>
+			int gx {0};
+			/// <summary>The y-coordinate of the square to build on.</summary>
+			int gy {0};
+			/// <summary>0 to buy a tower; otherwise, the upgrade option (1 or 2) to upgrade the
+			/// tower that is already on the square with.</summary>
+			int upgrade_option {0};
+		};
+
+		/// <summary>A fixed way of playing a map, which stands in for the player during a balance sweep.</summary>
+		struct PlacementScript {
+			/// <summary>The base name of the map that the script is for.</summary>
+			std::wstring map_name {};
+			/// <summary>The challenge level to play on (0 is the easiest).</summary>
+			int challenge_level {1};
+			/// <summary>The last level to play. (Games that get this far are stopped.)</summary>
+			int last_level {100};
+			/// <summary>The towers to buy in the order that they are bought.</summary>
+			std::vector<PlacementStep> steps {};
+		};
+
+		/// <summary>What happened during a single level of a balance game.</summary>
+		struct LevelOutcome {
+			/// <summary>The level's number.</summary>
+			int level {0};
+			/// <summary>True if the player survived the level.</summary>
+			bool won {false};
+			/// <summary>The amount of health that the player lost during the level.</summary>
+			int health_lost {0};
+			/// <summary>The player's money when the level started (after buying towers).</summary>
+			double money_before {0.0};
+			/// <summary>The player's money when the level ended.</summary>
+			double money_after {0.0};
+			/// <summary>The score that the player would get if the game ended after the level.</summary>
+			long long score {0};
+			/// <summary>The number of logic ticks that the level took.</summary>
+			long long ticks {0};
+		};
+
+		/// <summary>The results of a single balance game.</summary>
+		struct BalanceGameResult {
+			/// <summary>The game's number within the sweep.</summary>
+			int game {0};
+			/// <summary>The base name of the map that was played.</summary>
+			std::wstring map_name {};
+			/// <summary>The seed that the game's random numbers were generated from.</summary>
+			std::uint64_t seed {0};
+			/// <summary>The outcome of each level that was played in order.</summary>
+			std::vector<LevelOutcome> levels {};
+			/// <summary>The number of placement steps that could not be built (because the square
+			/// was taken or because building there would block the enemies' path).</summary>
+			int steps_skipped {0};
+			/// <summary>True if the game was stopped because a level took too long.</summary>
+			bool stalled {false};
+			/// <summary>The player's health when the game started.</summary>
+			int starting_health {0};
+			/// <summary>The player's health when the game ended.</summary>
+			int health_left {0};
+		};
+
+		/// <param name="file_contents">The contents of the settings file.</param>
+		/// <returns>The settings that were read.</returns>
+		BalanceSettings parseBalanceSettings(std::wstring file_contents);
+		/// <param name="file_contents">The contents of the placement script.</param>
+		/// <returns>The placement script that was read.</returns>
+		PlacementScript parsePlacementScript(std::wstring file_contents);
+		/// <param name="script">The placement script to write. (The map's name is not written.)</param>
+		/// <returns>The placement script in the format that parsePlacementScript() reads.</returns>
+		std::wstring writePlacementScript(const PlacementScript& script);
+		/// <summary>Plays a single game with a placement script standing in for the player.</summary>
+		/// <param name="game">The game to play with. Its type data and levels must have been loaded.</param>
+		/// <param name="script">The placement script to play with.</param>
+		/// <param name="seed">The seed of the game's random numbers.</param>
+		/// <param name="max_level_ticks">The number of logic ticks after which a level is given up on.</param>
+		/// <returns>The results of the game. (The game's number is left as 0.)</returns>
+		BalanceGameResult playPlacementScript(MyGame& game, const PlacementScript& script,
+			std::uint64_t seed, int max_level_ticks);
+
+		/// <summary>Plays thousands of seeded games without a window to measure how hard each
+		/// level is. Each map's games are played with a fixed placement script, and the games are
+		/// split into chunks that are played at the same time by the sessions of a simulation host.
+		/// A chunk's results are saved as soon as it finishes, so a sweep that is interrupted
+		/// picks up where it left off when it is run again.</summary>
+		class BalanceRunner {
+		public:
+			/// <summary>Loads the sweep's settings and placement scripts.</summary>
+			/// <param name="game">The game whose type data and levels are shared by the games that
+			/// are played. Its configuration must have been loaded; the type data and levels are
+			/// only needed to play games.</param>
+			BalanceRunner(MyGame& game);
+			/// <summary>Plays every chunk that has not been played yet with one session per core,
+			/// and then writes the report. Progress is written to the output folder whenever a
+			/// chunk finishes.</summary>
+			/// <returns>False if any chunk failed. (The report still covers the other chunks.)</returns>
+			bool runSweep();
+			/// <summary>Plays the games of a chunk and saves their results.</summary>
+			/// <param name="game">The game to play with.</param>
+			/// <param name="chunk">The number of the chunk to play.</param>
+			/// <returns>False if the results could not be saved.</returns>
+			bool runChunk(MyGame& game, int chunk) const;
+			/// <summary>Plays a single game.</summary>
+			/// <param name="game">The game to play with.</param>
+			/// <param name="game_index">The game's number within the sweep, which determines the
+			/// map and the seed.</param>
+			/// <returns>The results of the game.</returns>
+			BalanceGameResult runGame(MyGame& game, int game_index) const;
+			/// <summary>Combines the results of every finished chunk into a report that lists
+			/// the clear rate, health lost, money, and score of each level of each map.</summary>
+			/// <returns>False if the report could not be written.</returns>
+			bool writeReport() const;
+			// Getters
+			int getGameCount() const noexcept {
+				return static_cast<int>(this->settings.maps.size()) * this->settings.games_per_map;
+			}
+			int getChunkCount() const noexcept {
+				return (this->getGameCount() + this->settings.games_per_chunk - 1) / this->settings.games_per_chunk;
+			}
+			/// <returns>A hash of the game's executable, settings, placement scripts, and data files.
+			/// Checkpoints saved with a different fingerprint are played again.</returns>
+			std::uint64_t getFingerprint() const noexcept {
+				return this->fingerprint;
+			}
+		protected:
+			/// <param name="game_index">The game's number within the sweep.</param>
+			/// <returns>The seed of the game's random numbers.</returns>
+			std::uint64_t getGameSeed(int game_index) const noexcept;
+			/// <returns>The path of the file that a chunk's results are saved to.</returns>
+			std::wstring getChunkFileName(int chunk) const;
+			/// <returns>True if the chunk's results were saved by this version of the sweep.</returns>
+			bool isChunkDone(int chunk) const;
+			/// <summary>Writes how far along the sweep is.</summary>
+			/// <param name="chunks_done">The number of chunks that have finished.</param>
+			/// <param name="chunks_resumed">The number of chunks that had already finished when
+			/// the sweep started.</param>
+			/// <param name="chunks_failed">The number of chunks that failed.</param>
+			/// <param name="elapsed_seconds">The number of seconds since the sweep started.</param>
+			void writeProgress(int chunks_done, int chunks_resumed, int chunks_failed, double elapsed_seconds) const;
+		private:
+			/// <summary>The game whose type data and levels are shared by the games that are played.</summary>
+			MyGame& my_game;
+			/// <summary>The sweep's settings.</summary>
+			BalanceSettings settings {};
+			/// <summary>The placement script of each map. (Indices match those of settings.maps.)</summary>
+			std::vector<PlacementScript> scripts {};
+			/// <summary>A hash of everything that the results depend on.</summary>
+			std::uint64_t fingerprint {0};
+		};
+	}
+}
\ No newline at end of file
@@ -4,21 +4,28 @@
 #include <shlobj.h>
 #include "./../resource.h"
 #include <algorithm>
+#include <cerrno>
+#include <cwchar>
 #include <deque>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <queue>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
+#include "./../async_file_writer.hpp"
 #include "./../file_util.hpp"
 #include "./../globals.hpp"
+#include "./../profiler.hpp"
+#include "./../resource_pack.hpp"
 #include "./../audio/audio.hpp"
 #include "./../graphics/graphics.hpp"
 #include "./../graphics/shapes.hpp"
@@ -34,7 +41,14 @@ using namespace std::literals::string_literals;
 namespace hoffman_isaiah {
 	namespace game {
 
-		void MyGame::load_config_data(bool ran_once) {
+		void MyGame::load_config_data() {
+			IH_PROFILE_FUNCTION();
+			this->read_config_file(false);
+			this->resources->open(game::resource_pack_file_name, this->getResourceOverridesPath(),
+				this->resources_folder_path);
+		}
+
+		void MyGame::read_config_file(bool ran_once) {
 			constexpr const auto config_file_name = L"../config/config.ini";
 			[[maybe_unused]] std::wifstream config_file {this->userdata_folder_path + config_file_name};
 			if (config_file.fail() || config_file.bad()) {
@@ -66,60 +80,63 @@ namespace hoffman_isaiah {
 					// Reload the correct file.
 					if (!ran_once && std::filesystem::exists(this->userdata_folder_path + config_file_name)) {
 						config_file.close();
-						this->load_config_data(true);
+						this->read_config_file(true);
 						return;
 					}
 					my_parser.readKeyValue(L"do_copy");
 					if (my_parser.parseBoolean()) {
-						std::vector<std::thread> my_threads {};
-						my_threads.emplace_back([]() {
-							MessageBox(GetActiveWindow(), L"Copying files... Please be patient.",
-								L"First Time Startup Notice", MB_ICONINFORMATION | MB_OK);
-						});
-						// Copy needed files.
-						// This is really lazy code, but no real harm done.
-						for (int i = 1; i < 9999; ++i) {
-							my_threads.emplace_back([&, i]() {
-								const std::wstring level_str = L"levels/level"
-									+ std::to_wstring(i) + L".ini";
-								CopyFile((L"./resources/" + level_str).c_str(),
-									(this->resources_folder_path + level_str).c_str(), FALSE);
+						// The resource pack is read in place, so only loose resources need to be copied.
+						if (!std::filesystem::exists(game::resource_pack_file_name)) {
+							std::vector<std::thread> my_threads {};
+							my_threads.emplace_back([]() {
+								MessageBox(GetActiveWindow(), L"Copying files... Please be patient.",
+									L"First Time Startup Notice", MB_ICONINFORMATION | MB_OK);
 							});
-						}
-						for (int i = 100; i < 1000; ++i) {
-							my_threads.emplace_back([&, i]() {
-								const std::wstring music_str1 = L"music/Music_"
-									+ std::to_wstring(i) + L".wav";
-								CopyFile((L"./resources/" + music_str1).c_str(),
-									(this->resources_folder_path + music_str1).c_str(), FALSE);
-							});
-						}
-						for (int i = 1; i < 10; ++i) {
-							my_threads.emplace_back([&, i]() {
-								const std::wstring music_str2 = L"music/music0"
-									+ std::to_wstring(i) + L".wav";
-								CopyFile((L"./resources/" + music_str2).c_str(),
-									(this->resources_folder_path + music_str2).c_str(), FALSE);
-							});
-						}
-						const std::wstring my_resources[] = {
-							L"enemies.ini", L"enemies.ini.format", L"shots.ini", L"shots.ini.format",
-							L"towers.ini", L"towers.ini.format",
-							L"tower_upgrades.ini", L"tower_upgrades.ini.format", L"other.ini",
-							L"levels/global.ini", L"levels/global.ini.format",
-							L"levels/level0.ini.format",
-							// L"levels/levels.xlsx",
-							L"graphs/air_graph_beginner.txt", L"graphs/air_graph_intermediate.txt",
-							L"graphs/air_graph_experienced.txt", L"graphs/air_graph_expert.txt",
-							L"graphs/ground_graph_beginner.txt", L"graphs/ground_graph_intermediate.txt",
-							L"graphs/ground_graph_experienced.txt", L"graphs/ground_graph_expert.txt"
-						};
-						for (const auto& res_str : my_resources) {
-							CopyFile((L"./resources/" + res_str).c_str(), (this->resources_folder_path + res_str).c_str(), FALSE);
-						}
-						// Wait for everything to finish copying.
-						for (auto& t : my_threads) {
-							t.join();
+							// Copy needed files.
+							// This is really lazy code, but no real harm done.
+							for (int i = 1; i < 9999; ++i) {
+								my_threads.emplace_back([&, i]() {
+									const std::wstring level_str = L"levels/level"
+										+ std::to_wstring(i) + L".ini";
+									CopyFile((L"./resources/" + level_str).c_str(),
+										(this->resources_folder_path + level_str).c_str(), FALSE);
+								});
+							}
+							for (int i = 100; i < 1000; ++i) {
+								my_threads.emplace_back([&, i]() {
+									const std::wstring music_str1 = L"music/Music_"
+										+ std::to_wstring(i) + L".wav";
+									CopyFile((L"./resources/" + music_str1).c_str(),
+										(this->resources_folder_path + music_str1).c_str(), FALSE);
+								});
+							}
+							for (int i = 1; i < 10; ++i) {
+								my_threads.emplace_back([&, i]() {
+									const std::wstring music_str2 = L"music/music0"
+										+ std::to_wstring(i) + L".wav";
+									CopyFile((L"./resources/" + music_str2).c_str(),
+										(this->resources_folder_path + music_str2).c_str(), FALSE);
+								});
+							}
+							const std::wstring my_resources[] = {
+								L"enemies.ini", L"enemies.ini.format", L"shots.ini", L"shots.ini.format",
+								L"towers.ini", L"towers.ini.format",
+								L"tower_upgrades.ini", L"tower_upgrades.ini.format", L"other.ini",
+								L"levels/global.ini", L"levels/global.ini.format",
+								L"levels/level0.ini.format",
+								// L"levels/levels.xlsx",
+								L"graphs/air_graph_beginner.txt", L"graphs/air_graph_intermediate.txt",
+								L"graphs/air_graph_experienced.txt", L"graphs/air_graph_expert.txt",
+								L"graphs/ground_graph_beginner.txt", L"graphs/ground_graph_intermediate.txt",
+								L"graphs/ground_graph_experienced.txt", L"graphs/ground_graph_expert.txt"
+							};
+							for (const auto& res_str : my_resources) {
+								CopyFile((L"./resources/" + res_str).c_str(), (this->resources_folder_path + res_str).c_str(), FALSE);
+							}
+							// Wait for everything to finish copying.
+							for (auto& t : my_threads) {
+								t.join();
+							}
 						}
 						std::filesystem::create_directory(this->userdata_folder_path + L"../config/");
 						config_file.close();
@@ -142,11 +159,12 @@ namespace hoffman_isaiah {
 		}
 
 		void MyGame::load_global_misc_data() {
-			std::wifstream data_file {this->resources_folder_path + L"other.ini"s};
-			if (data_file.fail() || data_file.bad()) {
+			IH_PROFILE_FUNCTION();
+			util::file::ResourceView data_file {};
+			if (!this->getResources().getResource(L"other.ini"s, data_file)) {
 				throw util::file::DataFileException {L"Could not load global data (other.ini)."s, 0};
 			}
-			util::file::DataFileParser my_parser {data_file};
+			util::file::DataFileParser my_parser {data_file.toWideString()};
 			// Globals section
 			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
 			my_parser.getNext();
@@ -164,13 +182,14 @@ namespace hoffman_isaiah {
 		}
 
 		void MyGame::init_enemy_types() {
-			std::wifstream data_file {this->resources_folder_path + L"enemies.ini"s};
-			if (data_file.fail() || data_file.bad()) {
+			IH_PROFILE_FUNCTION();
+			util::file::ResourceView data_file {};
+			if (!this->getResources().getResource(L"enemies.ini"s, data_file)) {
 				throw util::file::DataFileException {L"Could not load the enemy data file (enemies.ini)."s, 0};
 			}
 			// (I might eventually rewrite this so that all the legacy code is gone...)
 			// (But this will do for the time being.)
-			util::file::DataFileParser my_parser {data_file};
+			util::file::DataFileParser my_parser {data_file.toWideString()};
 			// Globals section
 			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
 			auto my_token = my_parser.readKeyValue(L"version"s);
@@ -413,19 +432,16 @@ namespace hoffman_isaiah {
 					throw util::file::DataFileException {L"Duplicate enemy name: "s + n + L"."s, my_parser.getLine()};
 				}
 			} while (my_parser.getNext());
-			// Add listing for "seen before".
-			for (const auto& etype : this->enemy_types) {
-				this->enemies_seen.emplace(etype->getName(), false);
-				this->enemy_kill_count.emplace(etype->getName(), 0);
-			}
+			this->index_enemy_types();
 		}
 
 		void MyGame::init_shot_types() {
-			std::wifstream data_file {this->resources_folder_path + L"shots.ini"};
-			if (data_file.bad() || data_file.fail()) {
+			IH_PROFILE_FUNCTION();
+			util::file::ResourceView data_file {};
+			if (!this->getResources().getResource(L"shots.ini"s, data_file)) {
 				throw util::file::DataFileException {L"Could not open resources/shots.ini for reading."s, 0};
 			}
-			util::file::DataFileParser my_parser {data_file};
+			util::file::DataFileParser my_parser {data_file.toWideString()};
 			// Global section
 			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
 #pragma warning(push)
@@ -562,15 +578,17 @@ namespace hoffman_isaiah {
 				if (!insert_succeeded) {
 					throw util::file::DataFileException {L"Duplicate shot name found: "s + n + L"."s, my_parser.getLine()};
 				}
+				this->shot_types.at(n)->setTypeId(this->shot_type_ids.intern(n));
 			}
 		}
 
 		void MyGame::init_tower_types() {
-			std::wifstream data_file {this->resources_folder_path + L"towers.ini"};
-			if (data_file.bad() || data_file.fail()) {
+			IH_PROFILE_FUNCTION();
+			util::file::ResourceView data_file {};
+			if (!this->getResources().getResource(L"towers.ini"s, data_file)) {
 				throw util::file::DataFileException {L"Could not open resources/towers.ini for reading."s, 0};
 			}
-			util::file::DataFileParser my_parser {data_file};
+			util::file::DataFileParser my_parser {data_file.toWideString()};
 			// Global section
 			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
 			my_parser.readKeyValue(L"version"s);
@@ -679,6 +697,7 @@ namespace hoffman_isaiah {
 					my_parser.readKeyValue(L"target_names");
 					const auto ts_target_names = my_parser.readList();
 					auto my_ts_strategy = std::make_shared<TargetingStrategy>(ts_name, ts_strategy, ts_protocol, ts_target_names);
+					my_ts_strategy->resolveTargets(this->enemy_type_ids);
 					my_targeting_strategies.emplace(ts_name, std::move(my_ts_strategy));
 					break;
 				}
@@ -701,6 +720,7 @@ namespace hoffman_isaiah {
 			const int wall_cost = static_cast<int>(my_parser.parseNumber());
 			util::file::DataFileParser::validateNumberMinBound(wall_cost, 1, L"Cost (Wall)", my_parser.getLine(), true);
 			auto my_wall = std::make_unique<WallType>(wall_name, wall_desc, wall_color, wall_shape, wall_cost);
+			my_wall->setTypeId(this->tower_type_ids.intern(wall_name));
 			this->tower_types.emplace_back(std::move(my_wall));
 			// Trap section(s)
 			my_parser.getNext();
@@ -794,16 +814,18 @@ namespace hoffman_isaiah {
 				auto my_tower_type = std::make_unique<TowerType>(n, d, c, st, fmethod, tstrategy,
 					std::move(my_tower_shots), fs, fr, vs, rd, cost_adj, max_lv);
 				util::file::DataFileParser::validateNumberMinBound(my_tower_type->getCost(), 0.0, L"Tower Cost", my_parser.getLine(), false);
+				my_tower_type->setTypeId(this->tower_type_ids.intern(n));
 				this->tower_types.emplace_back(std::move(my_tower_type));
 			} while (my_parser.getNext());
 		}
 
 		void MyGame::load_tower_upgrades_data() {
-			std::wifstream data_file {this->resources_folder_path + L"tower_upgrades.ini"};
-			if (data_file.bad() || data_file.fail()) {
+			IH_PROFILE_FUNCTION();
+			util::file::ResourceView data_file {};
+			if (!this->getResources().getResource(L"tower_upgrades.ini"s, data_file)) {
 				throw util::file::DataFileException {L"Could not open resources/towers.ini for reading."s, 0};
 			}
-			util::file::DataFileParser my_parser {data_file};
+			util::file::DataFileParser my_parser {data_file.toWideString()};
 			// Global section
 			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
 			my_parser.readKeyValue(L"version"s);
@@ -886,11 +908,12 @@ namespace hoffman_isaiah {
 		}
 
 		void MyGame::load_global_level_data() {
-			std::wifstream data_file {this->resources_folder_path + L"levels/global.ini"};
-			if (data_file.bad() || data_file.fail()) {
+			IH_PROFILE_FUNCTION();
+			util::file::ResourceView data_file {};
+			if (!this->getResources().getResource(L"levels/global.ini"s, data_file)) {
 				throw util::file::DataFileException {L"Could not open resources/levels/global.ini for reading."s, 0};
 			}
-			util::file::DataFileParser my_parser {data_file};
+			util::file::DataFileParser my_parser {data_file.toWideString()};
 			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
 			int version = 1;
 			try {
@@ -1088,29 +1111,49 @@ namespace hoffman_isaiah {
 				const double nb_sigma = my_parser.parseNumber<double>();
 				util::file::DataFileParser::validateNumberMinBound(nb_sigma, 0.0, L"Number of bosses sigma", my_parser.getLine(), false);
 				const LevelNormalRandomVariable nb_var {NormalRandomVariable {nb_mu, nb_sigma}, nb_mod_increase};
-				this->my_level_generator = std::make_unique<LevelGenerator>(start_lv, my_cdata, my_edata, my_bdata,
+				this->my_level_generator = std::make_shared<LevelGenerator>(start_lv, my_cdata, my_edata, my_bdata,
 					wd_var, gd_var, bd_var, nw_var, ng_var, nb_var, wd, gd, bmod);
 			}
 		}
 
-		void MyGame::load_level_data() {
-			std::wifstream data_file {this->resources_folder_path + L"levels/level"s
-				+ std::to_wstring(this->level) + L".ini"s};
-			if (data_file.bad() || data_file.fail()) {
-				if (this->getLevelNumber() >= this->my_level_generator->getStartLevel()) {
-					this->my_level = this->my_level_generator->generateLevel(this->getLevelNumber(), *this);
-					return;
+		void MyGame::load_level_templates() {
+			IH_PROFILE_FUNCTION();
+			this->level_templates.clear();
+			this->level_template_errors.clear();
+			for (const auto& file_name : this->getResources().listResources(L"levels/"s)) {
+				// Only files named levelN.ini are hand-authored levels.
+				if (file_name.size() <= 9 || file_name.compare(0, 5, L"level"s) != 0
+					|| file_name.compare(file_name.size() - 4, 4, L".ini"s) != 0) {
+					continue;
 				}
-				else {
-					data_file.open(this->resources_folder_path + L"levels/level"s + std::to_wstring(this->my_level_backup_number) + L".ini"s);
-					if (data_file.bad() || data_file.fail()) {
-						throw util::file::DataFileException {L"Could not open resources/levels/level"s
-							+ std::to_wstring(this->level)
-							+ L".ini for reading. Automatically generating a level instead..."s, 0};
+				const std::wstring number_str = file_name.substr(5, file_name.size() - 9);
+				if (!std::all_of(number_str.begin(), number_str.end(), [](wchar_t c) { return c >= L'0' && c <= L'9'; })) {
+					continue;
+				}
+				errno = 0;
+				const long parsed_number = std::wcstol(number_str.c_str(), nullptr, 10);
+				if (errno == ERANGE || parsed_number < 1 || parsed_number > std::numeric_limits<int>::max()) {
+					// (No such level can be played, so the file is ignored.)
+					continue;
+				}
+				const int level_number = static_cast<int>(parsed_number);
+				util::file::ResourceView data_file {};
+				try {
+					if (!this->getResources().getResource(L"levels/"s + file_name, data_file)) {
+						throw util::file::DataFileException {L"Could not open resources/levels/"s + file_name
+							+ L" for reading."s, 0};
 					}
+					this->level_templates.emplace(level_number, this->parse_level_file(data_file.toWideString()));
+				}
+				catch (const util::file::DataFileException&) {
+					// Report the error when the level is actually played.
+					this->level_template_errors.emplace(level_number, std::current_exception());
 				}
 			}
-			util::file::DataFileParser my_parser {data_file};
+		}
+
+		std::shared_ptr<const LevelTemplate> MyGame::parse_level_file(std::wstring file_contents) const {
+			util::file::DataFileParser my_parser {std::move(file_contents)};
 			// Global section
 			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
 			my_parser.readKeyValue(L"version"s);
@@ -1129,7 +1172,7 @@ namespace hoffman_isaiah {
 			util::file::DataFileParser::validateNumber(wave_spawn_delay, 500, 60'000,
 				L"Wave spawn delay (ms)", my_parser.getLine(), true, true);
 			my_parser.getNext();
-			std::deque<std::unique_ptr<EnemyWave>> my_level_waves {};
+			std::vector<LevelTemplate::WaveTemplate> my_level_waves {};
 			do {
 				// [wave] sections
 				my_parser.expectToken(util::file::TokenTypes::Section, L"wave"s);
@@ -1137,19 +1180,16 @@ namespace hoffman_isaiah {
 				const int group_spawn_delay = static_cast<int>(my_parser.parseNumber());
 				util::file::DataFileParser::validateNumber(group_spawn_delay, 250, 20'000,
 					L"Group spawn delay (ms)", my_parser.getLine(), true, true);
-				std::deque<std::unique_ptr<EnemyGroup>> my_wave_groups {};
+				std::vector<LevelTemplate::GroupTemplate> my_wave_groups {};
 				my_parser.readKeyValue(L"groups"s);
 				my_parser.expectToken(util::file::TokenTypes::Object, L"{"s);
 				my_parser.getNext();
 				do {
 					my_parser.readKeyValue(L"enemy_name"s);
 					const std::wstring enemy_name = my_parser.parseString();
-					const EnemyType* etype = nullptr;
 					// Check the enemy exists.
-					try {
-						etype = this->getEnemyType(enemy_name);
-					}
-					catch (const std::out_of_range&) {
+					const int enemy_id = this->enemy_type_ids.find(enemy_name);
+					if (enemy_id < 0) {
 						throw util::file::DataFileException {L"Enemy type not found: "s + enemy_name + L"."s,
 							my_parser.getLine()};
 					}
@@ -1161,18 +1201,46 @@ namespace hoffman_isaiah {
 					const int enemy_spawn_delay = static_cast<int>(my_parser.parseNumber());
 					util::file::DataFileParser::validateNumber(enemy_spawn_delay, 20, 10'000,
 						L"Enemy spawn delay (ms)", my_parser.getLine(), true, true);
-					std::queue<std::unique_ptr<Enemy>> my_enemy_spawns {EnemyGroup::createEnemies(etype, extra_count, *this)};
-					auto my_group = std::make_unique<EnemyGroup>(std::move(my_enemy_spawns), enemy_spawn_delay);
-					my_wave_groups.emplace_front(std::move(my_group));
+					my_wave_groups.push_back(LevelTemplate::GroupTemplate {enemy_id, extra_count, enemy_spawn_delay});
 					my_parser.getNext();
 					my_parser.expectToken(util::file::TokenTypes::Object, L"}"s);
 					my_parser.getNext();
 				} while (my_parser.matchToken(util::file::TokenTypes::Object, L"{"s));
 				my_parser.expectToken(util::file::TokenTypes::Object, L"}"s);
-				auto my_wave = std::make_unique<EnemyWave>(std::move(my_wave_groups), group_spawn_delay);
-				my_level_waves.emplace_front(std::move(my_wave));
+				my_level_waves.push_back(LevelTemplate::WaveTemplate {group_spawn_delay, std::move(my_wave_groups)});
 			} while (my_parser.getNext());
-			this->my_level = std::make_unique<GameLevel>(this->level, desc, std::move(my_level_waves), wave_spawn_delay);
+			return std::make_shared<const LevelTemplate>(desc, std::move(my_level_waves), wave_spawn_delay);
+		}
+
+		void MyGame::load_level_data() {
+			IH_PROFILE_FUNCTION();
+			auto my_template = this->level_templates.find(this->level);
+			if (my_template == this->level_templates.end()) {
+				const auto my_error = this->level_template_errors.find(this->level);
+				if (my_error != this->level_template_errors.end()) {
+					std::rethrow_exception(my_error->second);
+				}
+				if (this->getLevelNumber() >= this->my_level_generator->getStartLevel()) {
+					this->my_level = this->my_level_generator->generateLevel(this->getLevelNumber(), *this);
+					this->my_level_source = L"generated"s;
+					return;
+				}
+				else {
+					my_template = this->level_templates.find(this->my_level_backup_number);
+					if (my_template == this->level_templates.end()) {
+						// Report why the backup level could not be read if it failed to parse.
+						const auto my_backup_error = this->level_template_errors.find(this->my_level_backup_number);
+						if (my_backup_error != this->level_template_errors.end()) {
+							std::rethrow_exception(my_backup_error->second);
+						}
+						throw util::file::DataFileException {L"Could not open resources/levels/level"s
+							+ std::to_wstring(this->level)
+							+ L".ini for reading. Automatically generating a level instead..."s, 0};
+					}
+				}
+			}
+			this->my_level = my_template->second->instantiate(this->level, *this);
+			this->my_level_source = L"level"s + std::to_wstring(my_template->first) + L".ini"s;
 		}
 
 		void MyGame::saveGame(std::wostream& save_file) const {
@@ -1238,10 +1306,10 @@ namespace hoffman_isaiah {
 					<< t->getGameY() << L" " << t->getLevel() << L" " << t->getUpgradePath() << L"\n";
 			}
 			// Output seen enemies.
-			for (const auto& seen_e : this->enemies_seen) {
-				if (seen_e.second) {
-					save_file << L"E: " << seen_e.first << L"\n\tK: "
-						<< std::hex << this->enemy_kill_count.at(seen_e.first) << std::dec << L"\n";
+			for (int i = 0; i < this->enemy_type_ids.size(); ++i) {
+				if (this->enemies_seen[i]) {
+					save_file << L"E: " << this->enemy_type_ids.getName(i) << L"\n\tK: "
+						<< std::hex << this->enemy_kill_count[i] << std::dec << L"\n";
 				}
 			}
 		}
@@ -1357,7 +1425,7 @@ namespace hoffman_isaiah {
 						// ith row, jth col corresponds to x = j, y = i
 						save_file >> buffer;
 						if (buffer == L"1") {
-							this->map->getHighlightGraph().getNode(j, i).setBlockage(true);
+							this->map->getHighlightGraph().setBlockage(j, i, true);
 						}
 					}
 				}
@@ -1375,31 +1443,13 @@ namespace hoffman_isaiah {
 					// Leading space is removed...
 					tower_name.erase(tower_name.begin());
 					save_file >> buffer >> tower_gx >> tower_gy;
-					const TowerType* my_type {nullptr};
-					for (const auto& tt : this->getAllTowerTypes()) {
-						if (tt->getName() == tower_name) {
-							my_type = tt.get();
-							break;
-						}
-					}
-					if (!my_type) {
-						throw std::runtime_error {"Error: Tower does not exist!"};
-					}
-					auto my_tower = std::make_unique<Tower>(this->getDeviceResources(),
-						this->getMap(), my_type, graphics::Color {0.f, 0.f, 0.f, 1.f},
-						tower_gx, tower_gy);
+					// Special code to handle upgrades (while not breaking old files.)
+					int tower_lv {1};
+					unsigned int tower_path {0};
 					if (version >= 2) {
-						// Special code to handle upgrades (while not breaking old files.)
-						int tower_lv;
-						int tower_path;
 						save_file >> tower_lv >> tower_path;
-						my_tower->setTowerUpgradeStatus(tower_lv, tower_path);
 					}
-					this->addTower(std::move(my_tower));
-					const auto my_floored_gx = static_cast<int>(std::floor(tower_gx));
-					const auto my_floored_gy = static_cast<int>(std::floor(tower_gy));
-					this->getMap().getFiterGraph(false).getNode(my_floored_gx, my_floored_gy).setBlockage(true);
-					this->getMap().getFiterGraph(true).getNode(my_floored_gx, my_floored_gy).setBlockage(true);
+					this->restoreTower(tower_name, tower_gx, tower_gy, tower_lv, tower_path);
 				}
 				else if (buffer == L"E:") {
 					// Load seen enemies.
@@ -1411,22 +1461,44 @@ namespace hoffman_isaiah {
 					if (version >= 3) {
 						save_file >> buffer >> std::hex >> kill_count >> std::dec;
 					}
-					try {
-						this->enemies_seen.at(enemy_name) = true;
-						this->enemy_kill_count.at(enemy_name) = kill_count;
-					}
-					catch (const std::out_of_range&) {
-						// Ignore.
+					// Enemy types that no longer exist are ignored.
+					const int enemy_id = this->enemy_type_ids.find(enemy_name);
+					if (enemy_id >= 0) {
+						this->enemies_seen[enemy_id] = true;
+						this->enemy_kill_count[enemy_id] = kill_count;
 					}
 				}
 			}
 		}
 
+		void MyGame::restoreTower(const std::wstring& tower_name, double tower_gx, double tower_gy,
+			int tower_level, unsigned int tower_path) {
+			const TowerType* my_type {nullptr};
+			for (const auto& tt : this->getAllTowerTypes()) {
+				if (tt->getName() == tower_name) {
+					my_type = tt.get();
+					break;
+				}
+			}
+			if (!my_type) {
+				throw std::runtime_error {"Error: Tower does not exist!"};
+			}
+			auto my_tower = std::make_unique<Tower>(this->getDeviceResources(),
+				this->getMap(), my_type, graphics::Color {0.f, 0.f, 0.f, 1.f},
+				tower_gx, tower_gy);
+			my_tower->setTowerUpgradeStatus(tower_level, tower_path);
+			this->addTower(std::move(my_tower));
+			const auto my_floored_gx = static_cast<int>(std::floor(tower_gx));
+			const auto my_floored_gy = static_cast<int>(std::floor(tower_gy));
+			this->getMap().getFiterGraph(false).getNode(my_floored_gx, my_floored_gy).setBlockage(true);
+			this->getMap().getFiterGraph(true).getNode(my_floored_gx, my_floored_gy).setBlockage(true);
+		}
+
 		void MyGame::saveGlobalData() const {
-			std::wofstream global_data_file {this->getUserDataPath() + game::global_save_file_name};
-			if (global_data_file.bad() || global_data_file.fail()) {
-				throw util::file::DataFileException {L"Could not open global save file for reading.", 0};
+			if (this->isHeadless()) {
+				return;
 			}
+			std::wostringstream global_data_file {};
 			global_data_file << L"V: " << 2 << L"\n";
 			global_data_file << L"CG: " << this->start_custom_games << L"\n";
 			global_data_file << L"HS: " << std::oct << this->highest_score
@@ -1436,11 +1508,19 @@ namespace hoffman_isaiah {
 				global_data_file << L"H: " << std::hex << high_level_pair.first << L" " << std::hex << high_level_pair.second << L"\n" << std::dec;
 			}
 			global_data_file << L"X: 1233\t85\t518\t112\nE: 421\nZYD: 2909\n";
-			global_data_file << L"AA: " << audio::g_my_audio->getMusicVolume()
-				<< L" " << (audio::g_my_audio->isMusicMuted() ? L"N" : L"Y");
+			if (audio::g_my_audio) {
+				global_data_file << L"AA: " << audio::g_my_audio->getMusicVolume()
+					<< L" " << (audio::g_my_audio->isMusicMuted() ? L"N" : L"Y");
+			}
+			else {
+				// Audio failed to load, so save the default settings.
+				global_data_file << L"AA: 6 Y";
+			}
+			this->save_writer->queueWrite(this->getUserDataPath() + game::global_save_file_name, global_data_file.str());
 		}
 
 		void MyGame::loadGlobalData() {
+			this->save_writer->waitForWrites();
 			if (!std::filesystem::exists(this->getUserDataPath() + game::global_save_file_name)) {
 				// Fail safely.
 				return;
@@ -1476,8 +1556,8 @@ namespace hoffman_isaiah {
 				// Read past junk.
 				global_data_file >> buffer >> buffer >> buffer >> buffer >> buffer
 					>> buffer >> buffer >> buffer;
-				if (version >= 2) {
-					// Read settings stuff.
+				if (version >= 2 && audio::g_my_audio) {
+					// Read settings stuff. (These are skipped if audio failed to load.)
 					global_data_file >> buffer >> buffer;
 					try {
 						audio::g_my_audio->setVolume(std::stoi(buffer));
@@ -8,12 +8,14 @@
 #include <cmath>
 #include "./../globals.hpp"
 #include "./../ih_math.hpp"
+#include "./../perf_counters.hpp"
 #include "./../graphics/graphics.hpp"
 #include "./../pathfinding/graph_node.hpp"
 #include "./../pathfinding/grid.hpp"
 #include "./../pathfinding/pathfinder.hpp"
 #include "./enemy_type.hpp"
 #include "./enemy.hpp"
+#include "./game_context.hpp"
 #include "./game_object.hpp"
 #include "./game_util.hpp"
 #include "./my_game.hpp"
@@ -35,32 +37,25 @@ namespace hoffman_isaiah {
 		}
 
 		bool BuffBase::isValidTarget(const Enemy& caller, const Enemy& target) const {
+			// Check type first since it is cheaper.
+			if (!this->buff_target_ids.contains(target.getBaseType().getTypeId())) {
+				return false;
+			}
 			const double dx = caller.getGameX() - target.getGameX();
 			const double dy = caller.getGameY() - target.getGameY();
-			if (std::sqrt(dx * dx + dy * dy) <= this->getRadius()) {
-				// Check name
-				auto valid_names = this->getTargetNames();
-				for (const auto& n : valid_names) {
-					if (target.getBaseType().getName() == n) {
-						return true;
-					}
-				}
-			}
-			return false;
+			return dx * dx + dy * dy <= this->getRadius() * this->getRadius();
 		}
 
 		void SmartBuff::apply(Enemy& target) {
 			// Apply buff by adding status effect
-			auto my_smart_effect = std::make_unique<SmartStrategyEffect>(this->getBuffDuration(),
-				pathfinding::HeuristicStrategies::Diagonal, true);
-			target.addStatus(std::move(my_smart_effect));
+			target.addStatus(SmartStrategyEffect {this->getBuffDuration(),
+				pathfinding::HeuristicStrategies::Diagonal, true});
 		}
 
 		void SpeedBuff::apply(Enemy& target) {
 			// Apply buff by adding status effect
-			auto my_speed_effect = std::make_unique<SpeedBoostEffect>(this->getBuffDuration(),
-				this->getWalkingBoost(), this->getRunningBoost(), this->getInjuredBoost());
-			target.addStatus(std::move(my_speed_effect));
+			target.addStatus(SpeedBoostEffect {this->getBuffDuration(),
+				this->getWalkingBoost(), this->getRunningBoost(), this->getInjuredBoost()});
 		}
 
 		void HealerBuff::apply(Enemy& target) {
@@ -68,22 +63,23 @@ namespace hoffman_isaiah {
 		}
 
 		void PurifyBuff::apply(Enemy& target) {
-			std::vector<int> statuses_to_remove {};
 			auto& active_statuses = target.getActiveStatuses();
-			// Determine which statuses to remove
-			for (unsigned int i = 0; i < active_statuses.size(); ++i) {
-				if (!active_statuses[i]->isPositiveEffect()) {
-					active_statuses[i]->clearEffects(target);
-					statuses_to_remove.emplace_back(i);
-					if (statuses_to_remove.size() >= static_cast<unsigned>(this->getMaxEffectsRemoved())) {
-						break;
+			// Clear the first few harmful statuses (and move the ones that are kept forward)
+			int statuses_removed = 0;
+			auto status_output = active_statuses.begin();
+			for (auto& my_status : active_statuses) {
+				if (statuses_removed < this->getMaxEffectsRemoved() && !isPositiveEffect(my_status)) {
+					clearStatusEffect(my_status, target);
+					++statuses_removed;
+				}
+				else {
+					if (&*status_output != &my_status) {
+						*status_output = std::move(my_status);
 					}
+					++status_output;
 				}
 			}
-			// Actually remove the statuses
-			for (unsigned int i = 0; i < statuses_to_remove.size(); ++i) {
-				active_statuses.erase(active_statuses.begin() + (statuses_to_remove[i] - i));
-			}
+			active_statuses.erase(status_output, active_statuses.end());
 		}
 
 		void RepairBuff::apply(Enemy& target) {
@@ -92,8 +88,7 @@ namespace hoffman_isaiah {
 
 		void ForcefieldBuff::apply(Enemy& target) {
 			target.addShield(this->getShieldHealth(), this->getShieldAbsorb());
-			auto my_shield_effect = std::make_unique<ShieldEffect>(this->getBuffDuration(), this->getShieldHealth());
-			target.addStatus(std::move(my_shield_effect));
+			target.addStatus(ShieldEffect {static_cast<double>(this->getBuffDuration()), this->getShieldHealth()});
 		}
 
 		// enemy.hpp
@@ -103,6 +98,13 @@ namespace hoffman_isaiah {
 			frames_until_expire {math::convertMillisecondsToFrames(ms_until_expire)} {
 		}
 
+		Enemy::StatusResistance::StatusResistance() noexcept :
+			status_effect {StatusEffects::Sentinel_DO_NOT_USE},
+			status_resist {0.0},
+			frames_until_expire {0.0},
+			num_times {0} {
+		}
+
 		void Enemy::StatusResistance::update() {
 			if (this->frames_until_expire > 0) {
 				--this->frames_until_expire;
@@ -128,16 +130,20 @@ namespace hoffman_isaiah {
 
 		Enemy::Enemy(graphics::DX::DeviceResources2D* dev_res, const GameMap& my_map,
 			const EnemyType* etype, graphics::Color o_color,
-			const GameMap& gmap, int level, double difficulty, int challenge_level) :
+			const GameMap& gmap, int level, double difficulty, int challenge_level,
+			util::PerfCounterRegistry& perf_counters) :
 			GameObject {dev_res, my_map, etype->getShape(), o_color, etype->getColor(),
 			gmap.getTerrainGraph(etype->isFlying()).getStartNode()->getGameX() + 0.5,
 			gmap.getTerrainGraph(etype->isFlying()).getStartNode()->getGameY() + 0.5,
 			Enemy::gwidth, Enemy::gheight},
 			base_type {etype},
+			perf_counters {&perf_counters},
 			my_pathfinder {gmap, etype->isFlying(), etype->canMoveDiagonally(), etype->getDefaultStrategy()},
 			my_path {},
 			current_node {nullptr},
-			current_direction {0.0},
+			direction_x {0.0},
+			direction_y {0.0},
+			distance_to_next_node {0.0},
 			current_health {Enemy::getAdjustedHealth(etype->getBaseHealth(), level, difficulty, challenge_level)},
 			maximum_health {Enemy::getAdjustedHealth(etype->getBaseHealth(), level, difficulty, challenge_level)},
 			current_armor_health {Enemy::getAdjustedArmorHealth(etype->getBaseArmorHP(), level, difficulty, challenge_level)},
@@ -153,6 +159,8 @@ namespace hoffman_isaiah {
 				this->scale(Enemy::unique_enemy_scale);
 			}
 			// Get path
+			this->my_pathfinder.setPerfCounters(this->perf_counters);
+			this->perf_counters->increment(util::PerfCounters::Repaths_Enemy_Spawn);
 			this->my_pathfinder.findPath(challenge_level / 10.0);
 			this->my_path = this->my_pathfinder.getPath();
 			this->current_node = &this->my_path.front();
@@ -164,14 +172,18 @@ namespace hoffman_isaiah {
 		Enemy::Enemy(graphics::DX::DeviceResources2D* dev_res, const GameMap& my_map,
 			const EnemyType* etype, graphics::Color o_color,
 			pathfinding::Pathfinder pf, double start_gx, double start_gy,
-			int level, double difficulty, int challenge_level) :
+			int level, double difficulty, int challenge_level,
+			util::PerfCounterRegistry& perf_counters) :
 			GameObject {dev_res, my_map, etype->getShape(), o_color, etype->getColor(),
 			start_gx, start_gy, Enemy::gwidth, Enemy::gheight},
 			base_type {etype},
+			perf_counters {&perf_counters},
 			my_pathfinder {pf},
 			my_path {pf.getPath()},
 			current_node {nullptr},
-			current_direction {0.0},
+			direction_x {0.0},
+			direction_y {0.0},
+			distance_to_next_node {0.0},
 			current_health {Enemy::getAdjustedHealth(etype->getBaseHealth(), level, difficulty, challenge_level)},
 			maximum_health {Enemy::getAdjustedHealth(etype->getBaseHealth(), level, difficulty, challenge_level)},
 			current_armor_health {Enemy::getAdjustedArmorHealth(etype->getBaseArmorHP(), level, difficulty, challenge_level)},
@@ -192,133 +204,105 @@ namespace hoffman_isaiah {
 			this->addEnemyBuffs();
 		}
 
-		bool Enemy::update() {
+		bool Enemy::update(const GameContext& context) {
 			// Check if we are still alive
 			if (!this->isAlive()) {
 				return true;
 			}
 			// Update status resistances.
 			for (auto& my_resist : this->status_resists) {
-				my_resist.second.update();
+				my_resist.update();
 			}
 			// Apply buffs
 			for (auto& b : this->buffs) {
-				b->update(*this, game::g_my_game->getEnemies());
+				b->update(*this, context.game.getEnemies());
 			}
-			// Apply status effects
-			std::vector<int> statuses_to_remove {};
-			for (unsigned int i = 0; i < this->status_effects.size(); ++i) {
-				if (this->status_effects[i]->update(*this)) {
-					const auto* my_status = this->status_effects[i].get();
-					const auto my_effect_type = my_status->getStatusEffectType();
-					if (!my_status->isPositiveEffect()) {
+			// Apply status effects (and remove the ones that have expired)
+			auto status_output = this->status_effects.begin();
+			for (auto& my_status : this->status_effects) {
+				if (updateStatusEffect(my_status, *this, context)) {
+					if (!isPositiveEffect(my_status)) {
 						// Check for status resistances.
-						auto my_iterator = this->status_resists.find(my_effect_type);
-						if (my_iterator == this->status_resists.end()) {
-							this->status_resists.emplace(my_effect_type, Enemy::StatusResistance {my_effect_type, 0.10, 1000});
+						const auto my_effect_type = getStatusEffectType(my_status);
+						auto& my_resist = this->status_resists[static_cast<int>(my_effect_type)];
+						if (!my_resist.hasBeenInflicted()) {
+							my_resist = Enemy::StatusResistance {my_effect_type, 0.10, 1000};
 						}
 						else {
-							my_iterator->second.increaseResist();
+							my_resist.increaseResist();
 						}
 					}
-					statuses_to_remove.emplace_back(i);
+				}
+				else {
+					if (&*status_output != &my_status) {
+						*status_output = std::move(my_status);
+					}
+					++status_output;
 				}
 			}
-			// Remove old status effects
-			for (unsigned int i = 0; i < statuses_to_remove.size(); ++i) {
-				this->status_effects.erase(this->status_effects.begin() + (statuses_to_remove[i] - i));
-			}
-			// Perform movement
+			this->status_effects.erase(status_output, this->status_effects.end());
+			return !this->isAlive();
+		}
+
+		void Enemy::storeMotion(EnemyMotionBuffer& motion, std::size_t i) noexcept {
 			const double my_speed = this->getCurrentSpeed() / game::logic_framerate /
 				this->current_node->getWeight();
-			const double rx = my_speed;
-			const double ry = my_speed;
-			if (!this->isStunned()) {
-				this->translate(rx * std::cos(this->current_direction), ry * std::sin(this->current_direction));
-			}
-			const double dx = (this->getNextNode().getGameX() + 0.5) - this->getGameX();
-			const double dy = (this->getNextNode().getGameY() + 0.5) - this->getGameY();
-			const bool update_next_node = std::sqrt(dx * dx + dy * dy) <= my_speed + 0.05 / game::logic_framerate;
-			if (update_next_node) {
-				// Change path
-				if (this->my_path.size() == 1) {
-					return true;
-				}
-				this->current_node = &this->getNextNode();
-				this->my_path.pop();
-				this->changeDirection();
-			}
+			motion.setEntry(i, this->getGameX(), this->getGameY(), this->direction_x, this->direction_y,
+				this->distance_to_next_node, my_speed, this->isStunned() || !this->isAlive() ? 0.0 : my_speed);
 			// Reset speed multipliers to normal
 			this->speed_multiplier = 1.0;
 			this->speed_boosts = {1.0, 1.0, 1.0};
-			return !this->isAlive();
 		}
 
-		void Enemy::draw(const graphics::Renderer2D& renderer) const noexcept {
-			// Call base class member first
-			GameObject::draw(renderer);
-			// Only draw bars if injured.
-			if (this->getHealthPercentage() >= 0.99 && (!this->hasArmor() || this->getArmorPercentage() >= 0.99)) {
-				return;
+		void Enemy::applyMotion(const EnemyMotionBuffer& motion, std::size_t i) {
+			const double dgx = motion.getGameX(i) - this->getGameX();
+			const double dgy = motion.getGameY(i) - this->getGameY();
+			if (dgx != 0.0 || dgy != 0.0) {
+				this->translate(dgx, dgy);
 			}
-			// Draw health bars
-			constexpr const graphics::Color bar_outline_color {0.2f, 0.2f, 0.2f, 1.0f};
-			constexpr const graphics::Color bar_empty_color {0.7f, 0.7f, 0.7f, 1.0f};
-			constexpr const graphics::Color health_fill_color {0.8f, 0.0f, 0.0f, 0.9f};
-			constexpr const graphics::Color armor_fill_color {0.0f, 0.0f, 0.8f, 0.9f};
-			constexpr const graphics::Color shield_fill_color {0.0, 0.8f, 0.8f, 0.9f};
-			const double hp_percent = this->getHealthPercentage();
-			const float bar_max_width = this->getBaseType().isUnique()
-				? 0.8f * this->getGameMap().getGameSquareWidth<float>()
-				: 0.4f * this->getGameMap().getGameSquareWidth<float>();
-			const float bar_height = 0.115f * this->getGameMap().getGameSquareHeight<float>();
-			const float hp_bar_offset = 3.23f * bar_height;
-			// Roughtly 3.23 * bar_height
-			// const float hp_bar_offset = 5.5f * graphics::screen_height / 645.f;
-			const float hp_bar_start_x = static_cast<float>(this->getScreenX()) - bar_max_width / 2.f;
-			const float hp_bar_end_x = static_cast<float>(hp_bar_start_x + hp_percent * bar_max_width);
-			const float hp_bar_start_y = static_cast<float>(this->getScreenY()) - bar_height / 2.f - hp_bar_offset;
-			const float hp_bar_end_y = hp_bar_start_y + bar_height;
-			const D2D1_RECT_F hp_bar_filled_rc {hp_bar_start_x, hp_bar_start_y, hp_bar_end_x, hp_bar_end_y};
-			const D2D1_RECT_F hp_bar_outline_rc {hp_bar_start_x, hp_bar_start_y, hp_bar_start_x + bar_max_width,
-				hp_bar_end_y};
-			renderer.setBrushColors(bar_outline_color, bar_empty_color);
-			renderer.outlineRectangle(hp_bar_outline_rc);
-			renderer.setFillColor(health_fill_color);
-			renderer.fillRectangle(hp_bar_filled_rc);
-			if (this->hasArmor() && this->getArmorPercentage() <= 0.99) {
-				const double ahp_percent = this->getArmorPercentage();
-				const float ahp_bar_offset = hp_bar_offset + bar_height + 0.5f * bar_height;
-				// Roughly hp_bar_offset + 0.5 * bar_height + bar_height
-				// const float ahp_bar_offset = hp_bar_offset + bar_height + 0.85f * graphics::screen_height / 645.f;
-				const float ahp_bar_start_x = hp_bar_start_x;
-				const float ahp_bar_end_x = static_cast<float>(ahp_bar_start_x + ahp_percent * bar_max_width);
-				const float ahp_bar_start_y = static_cast<float>(this->getScreenY()) - bar_height / 2.f - ahp_bar_offset;
-				const float ahp_bar_end_y = ahp_bar_start_y + bar_height;
-				const D2D1_RECT_F ahp_bar_filled_rc {ahp_bar_start_x, ahp_bar_start_y, ahp_bar_end_x, ahp_bar_end_y};
-				const D2D1_RECT_F ahp_bar_outline_rc {ahp_bar_start_x, ahp_bar_start_y, ahp_bar_start_x + bar_max_width,
-					ahp_bar_end_y};
-				renderer.setFillColor(bar_empty_color);
-				renderer.outlineRectangle(ahp_bar_outline_rc);
-				renderer.setFillColor(armor_fill_color);
-				renderer.fillRectangle(ahp_bar_filled_rc);
+			this->distance_to_next_node = motion.getDistanceLeft(i);
+		}
+
+		bool Enemy::advancePathNode() {
+			// Change path
+			if (this->my_path.size() == 1) {
+				return true;
+			}
+			this->current_node = &this->getNextNode();
+			this->my_path.pop();
+			this->changeDirection();
+			return false;
+		}
+
+		void EnemyMotionBuffer::advance() {
+			const auto count = this->gx.size();
+			// No branches or calls here so that the compiler is free to vectorize this loop.
+			for (std::size_t i = 0; i < count; ++i) {
+				this->gx[i] += this->dir_x[i] * this->distance_moved[i];
+				this->gy[i] += this->dir_y[i] * this->distance_moved[i];
+				this->distance_left[i] -= this->distance_moved[i];
 			}
-			if (this->getShieldHealth() > 0) {
-				const double shp_percent = this->getShieldHealth() / this->getMaxShieldHealth();
-				// const float shp_bar_offset = hp_bar_offset + bar_height + 0.85f * graphics::screen_height / 645.f;
-				const float shp_bar_offset = hp_bar_offset + bar_height + 0.5f * bar_height;
-				const float shp_bar_start_x = hp_bar_start_x;
-				const float shp_bar_end_x = static_cast<float>(shp_bar_start_x + shp_percent * bar_max_width);
-				const float shp_bar_start_y = static_cast<float>(this->getScreenY()) - bar_height / 2.f - shp_bar_offset;
-				const float shp_bar_end_y = shp_bar_start_y + bar_height;
-				const D2D1_RECT_F shp_bar_filled_rc {shp_bar_start_x, shp_bar_start_y, shp_bar_end_x, shp_bar_end_y};
-				const D2D1_RECT_F shp_bar_outline_rc {shp_bar_start_x, shp_bar_start_y, shp_bar_start_x + bar_max_width,
-					shp_bar_end_y};
-				renderer.setFillColor(shield_fill_color);
-				renderer.fillRectangle(shp_bar_filled_rc);
+			// Node transitions are rare, so they are handled separately.
+			this->arrivals.clear();
+			for (std::size_t i = 0; i < count; ++i) {
+				if (this->distance_left[i] <= this->speed[i] + 0.05 / game::logic_framerate) {
+					this->arrivals.emplace_back(static_cast<int>(i));
+				}
 			}
 		}
 
+		EnemySnapshot Enemy::getSnapshot() const noexcept {
+			EnemySnapshot my_snapshot {};
+			my_snapshot.sprite = this->getShapeInstance();
+			my_snapshot.health_fraction = static_cast<float>(this->getHealthPercentage());
+			my_snapshot.has_armor = this->hasArmor();
+			my_snapshot.armor_fraction = this->hasArmor() ? static_cast<float>(this->getArmorPercentage()) : 0.f;
+			my_snapshot.shield_fraction = this->getShieldHealth() > 0
+				? static_cast<float>(this->getShieldHealth() / this->getMaxShieldHealth()) : 0.f;
+			my_snapshot.is_unique = this->getBaseType().isUnique();
+			return my_snapshot;
+		}
+
 		void Enemy::takeDamage(double dmg, double wap, bool bypass_armor_completely) {
 			// Forcefield effect.
 			if (this->getShieldHealth() > 0 && !bypass_armor_completely) {
@@ -355,12 +339,12 @@ namespace hoffman_isaiah {
 			this->current_armor_health = math::get_min(this->getMaxArmorHealth(), this->getArmorHealth() + amt);
 		}
 
-		void Enemy::addStatus(std::unique_ptr<StatusEffectBase>&& effect) {
-			if (!effect->isPositiveEffect()) {
-				const auto my_iterator = this->status_resists.find(effect->getStatusEffectType());
-				if (my_iterator != this->status_resists.end()) {
-					const auto resist_chance = my_iterator->second.isActive()
-						? my_iterator->second.getResistance() : 0;
+		void Enemy::addStatus(StatusEffect effect) {
+			if (!isPositiveEffect(effect)) {
+				const auto& my_resist = this->status_resists[static_cast<int>(getStatusEffectType(effect))];
+				if (my_resist.hasBeenInflicted()) {
+					const auto resist_chance = my_resist.isActive()
+						? my_resist.getResistance() : 0;
 					const auto my_roll = rng::distro_uniform(rng::gen);
 					if (my_roll <= resist_chance) {
 						// Enemy resists the status affliction!
@@ -368,11 +352,15 @@ namespace hoffman_isaiah {
 					}
 				}
 			}
-			this->status_effects.emplace_back(std::move(effect));
+			if (this->status_effects.full()) {
+				// The enemy is already afflicted by as many effects as it can hold.
+				return;
+			}
+			this->status_effects.push_back(std::move(effect));
+			this->perf_counters->increment(util::PerfCounters::Status_Effects_Applied);
 		}
 
-		void Enemy::changeStrategy(const GameMap& gmap, pathfinding::HeuristicStrategies new_strat, bool diag_move) {
-			UNREFERENCED_PARAMETER(gmap);
+		void Enemy::changeStrategy(const GameContext& context, pathfinding::HeuristicStrategies new_strat, bool diag_move) {
 			if (this->my_path.size() == 1) {
 				// It kinda is pointless to do here...
 				// It also solves one bug where the enemy tries
@@ -385,7 +373,7 @@ namespace hoffman_isaiah {
 			// Obtain new path
 			this->my_pathfinder.setStrategy(new_strat, diag_move);
 			// How can I optimize this?
-			this->my_pathfinder.findPath(game::g_my_game->getChallengeLevel() / 10.0,
+			this->my_pathfinder.findPath(context.game.getChallengeLevel() / 10.0,
 				static_cast<int>(std::floor(this->getGameX())),
 				static_cast<int>(std::floor(this->getGameY())));
 			this->current_node = &this->my_path.front();
@@ -396,7 +384,9 @@ namespace hoffman_isaiah {
 		void Enemy::changeDirection() noexcept {
 			const double dx = (this->getNextNode().getGameX() + 0.5) - this->getGameX();
 			const double dy = (this->getNextNode().getGameY() + 0.5) - this->getGameY();
-			this->current_direction = std::atan2(dy, dx);
+			this->distance_to_next_node = std::sqrt(dx * dx + dy * dy);
+			this->direction_x = this->distance_to_next_node > 0.0 ? dx / this->distance_to_next_node : 0.0;
+			this->direction_y = this->distance_to_next_node > 0.0 ? dy / this->distance_to_next_node : 0.0;
 		}
 	}
 }
\ No newline at end of file
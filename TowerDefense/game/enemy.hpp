@@ -6,19 +6,92 @@
 #include <array>
 #include <vector>
 #include <memory>
+#include "./../fixed_vector.hpp"
 #include "./../globals.hpp"
 #include "./../graphics/graphics.hpp"
 #include "./../pathfinding/graph_node.hpp"
 #include "./../pathfinding/grid.hpp"
 #include "./../pathfinding/pathfinder.hpp"
 #include "./enemy_type.hpp"
+#include "./game_context.hpp"
 #include "./game_object.hpp"
+#include "./render_snapshot.hpp"
+#include "./status_effects.hpp"
 
 namespace hoffman_isaiah {
 	namespace game {
-		// Forward declaration
-		class StatusEffectBase;
-		enum class StatusEffects;
+		/// <summary>Stores the movement state of every enemy in the game as a structure of arrays
+		/// so that all of the enemies can be moved in a single tight loop.</summary>
+		class EnemyMotionBuffer {
+		public:
+			/// <summary>Resizes the buffer to hold the given number of enemies.</summary>
+			/// <param name="count">The number of enemies to store.</param>
+			void resize(std::size_t count) {
+				this->gx.resize(count);
+				this->gy.resize(count);
+				this->dir_x.resize(count);
+				this->dir_y.resize(count);
+				this->distance_left.resize(count);
+				this->speed.resize(count);
+				this->distance_moved.resize(count);
+				this->arrivals.clear();
+			}
+			/// <summary>Stores the movement state of a single enemy.</summary>
+			/// <param name="i">The index of the enemy.</param>
+			/// <param name="new_gx">The enemy's game x-coordinate.</param>
+			/// <param name="new_gy">The enemy's game y-coordinate.</param>
+			/// <param name="new_dir_x">The x-component of the unit vector pointing towards the enemy's next node.</param>
+			/// <param name="new_dir_y">The y-component of the unit vector pointing towards the enemy's next node.</param>
+			/// <param name="new_distance_left">The distance remaining before the enemy reaches its next node.</param>
+			/// <param name="new_speed">The distance the enemy can move this frame.</param>
+			/// <param name="new_distance_moved">The distance the enemy actually moves this frame
+			/// (which is 0 if the enemy is stunned).</param>
+			void setEntry(std::size_t i, double new_gx, double new_gy, double new_dir_x, double new_dir_y,
+				double new_distance_left, double new_speed, double new_distance_moved) noexcept {
+				this->gx[i] = new_gx;
+				this->gy[i] = new_gy;
+				this->dir_x[i] = new_dir_x;
+				this->dir_y[i] = new_dir_y;
+				this->distance_left[i] = new_distance_left;
+				this->speed[i] = new_speed;
+				this->distance_moved[i] = new_distance_moved;
+			}
+			/// <summary>Moves every enemy in the buffer by one logical frame and records which
+			/// enemies have arrived at their next node.</summary>
+			void advance();
+			// Getters
+			double getGameX(std::size_t i) const noexcept {
+				return this->gx[i];
+			}
+			double getGameY(std::size_t i) const noexcept {
+				return this->gy[i];
+			}
+			double getDistanceLeft(std::size_t i) const noexcept {
+				return this->distance_left[i];
+			}
+			/// <returns>The indices (in ascending order) of the enemies that arrived at their next
+			/// node during the last call to advance().</returns>
+			const std::vector<int>& getArrivals() const noexcept {
+				return this->arrivals;
+			}
+		private:
+			/// <summary>The game x-coordinates of the enemies.</summary>
+			std::vector<double> gx {};
+			/// <summary>The game y-coordinates of the enemies.</summary>
+			std::vector<double> gy {};
+			/// <summary>The x-components of the enemies' directions of movement.</summary>
+			std::vector<double> dir_x {};
+			/// <summary>The y-components of the enemies' directions of movement.</summary>
+			std::vector<double> dir_y {};
+			/// <summary>The distances remaining until the enemies reach their next nodes.</summary>
+			std::vector<double> distance_left {};
+			/// <summary>The distances the enemies can move this frame.</summary>
+			std::vector<double> speed {};
+			/// <summary>The distances the enemies actually move this frame.</summary>
+			std::vector<double> distance_moved {};
+			/// <summary>The enemies that have arrived at their next node.</summary>
+			std::vector<int> arrivals {};
+		};
 
 		/// <summary>Class that represents an actual enemy in the game.</summary>
 		class Enemy : public GameObject {
@@ -29,6 +102,8 @@ namespace hoffman_isaiah {
 			static constexpr const float gheight = 0.5f;
 			// The scale factor to apply to unique enemies.
 			static constexpr const float unique_enemy_scale = 1.33f;
+			// The maximum number of status effects that can affect an enemy at once.
+			static constexpr const int max_status_effects = 16;
 			/// <summary>Stores information about a enemy's resistance to a status affliction.</summary>
 			class StatusResistance {
 			public:
@@ -37,11 +112,18 @@ namespace hoffman_isaiah {
 				/// <param name="ms_until_expires">The number of milliseconds until
 				/// the resistance expires.</param>
 				StatusResistance(StatusEffects effect, double resist, int ms_until_expire) noexcept;
+				/// <summary>Creates an empty resistance for a status effect that has not
+				/// afflicted the enemy yet.</summary>
+				StatusResistance() noexcept;
 				/// <summary>Updates the status resistance.</summary>
 				void update();
 				/// <summary>Increase the value of the enemy's resistance.</summary>
 				void increaseResist();
 				// Getters
+				/// <returns>True if the enemy has been afflicted by the status effect before.</returns>
+				bool hasBeenInflicted() const noexcept {
+					return this->num_times > 0;
+				}
 				/// <returns>True if the status effect resistance is active.</returns>
 				bool isActive() const noexcept {
 					return this->frames_until_expire > 0;
@@ -64,18 +146,37 @@ namespace hoffman_isaiah {
 				int num_times {1};
 			};
 
+			/// <param name="perf_counters">The counters of the game that the enemy belongs to.</param>
 			Enemy(graphics::DX::DeviceResources2D* dev_res, const GameMap& my_map,
 				const EnemyType* etype, graphics::Color o_color,
-				const GameMap& gmap, int level, double difficulty, int challenge_level);
+				const GameMap& gmap, int level, double difficulty, int challenge_level,
+				util::PerfCounterRegistry& perf_counters);
+			/// <param name="perf_counters">The counters of the game that the enemy belongs to.</param>
 			Enemy(graphics::DX::DeviceResources2D* dev_res, const GameMap& my_map,
 				const EnemyType* etype, graphics::Color o_color,
 				pathfinding::Pathfinder pf, double start_gx, double start_gy,
-				int level, double difficulty, int challenge_level);
-			/// <summary>Advances the enemy's game state by one frame.</summary>
-			/// <returns>True if the enemy should be removed; otherwise, false.</returns>
-			bool update();
-			// Overrides GameObject::draw
-			void draw(const graphics::Renderer2D& renderer) const noexcept override;
+				int level, double difficulty, int challenge_level,
+				util::PerfCounterRegistry& perf_counters);
+			/// <summary>Advances the enemy's game state (other than its movement) by one frame.
+			/// (Movement is handled for all enemies at once by MyGame::advanceEnemies().)</summary>
+			/// <param name="context">The game that the enemy belongs to.</param>
+			/// <returns>True if the enemy has died and should be removed; otherwise, false.</returns>
+			bool update(const GameContext& context);
+			/// <summary>Stores the enemy's movement for this frame in the motion buffer and
+			/// then resets the enemy's speed multipliers.</summary>
+			/// <param name="motion">The buffer to store the enemy's movement state in.</param>
+			/// <param name="i">The enemy's index in the buffer.</param>
+			void storeMotion(EnemyMotionBuffer& motion, std::size_t i) noexcept;
+			/// <summary>Moves the enemy to the position computed in the motion buffer.</summary>
+			/// <param name="motion">The buffer containing the enemy's new movement state.</param>
+			/// <param name="i">The enemy's index in the buffer.</param>
+			void applyMotion(const EnemyMotionBuffer& motion, std::size_t i);
+			/// <summary>Moves the enemy onto the next segment of its path after it has arrived
+			/// at its next node.</summary>
+			/// <returns>True if the enemy has reached the goal; otherwise, false.</returns>
+			bool advancePathNode();
+			/// <returns>A copy of everything needed to draw the enemy.</returns>
+			EnemySnapshot getSnapshot() const noexcept;
 
 			/// <summary>Deals damage to the enemy.</summary>
 			/// <param name="dmg">The base amount of damage for the enemy to receive.</param>
@@ -90,8 +191,8 @@ namespace hoffman_isaiah {
 			/// <param name="amt">The amount of armor hitpoints to restore.</param>
 			void repair(double amt);
 			/// <summary>Adds a status to the enemy.</summary>
-			/// <param name="effect">The effect to add; uses move semantics.</param>
-			void addStatus(std::unique_ptr<StatusEffectBase>&& effect);
+			/// <param name="effect">The effect to add.</param>
+			void addStatus(StatusEffect effect);
 
 			// Setters/Changers
 			void multiplyWalkingBoost(double amt) noexcept {
@@ -121,10 +222,10 @@ namespace hoffman_isaiah {
 				this->dot_active = new_status;
 			}
 			/// <summary>Changes the enemy's pathfinding strategy.</summary>
-			/// <param name="gmap">Reference to the game's maps.</param>
+			/// <param name="context">The game that the enemy belongs to.</param>
 			/// <param name="new_strat">The new heuristic estimation strategy to use.</param>
 			/// <param name="diag_move">Whether the enemy is now allowed to move diagonally or not.</param>
-			void changeStrategy(const GameMap& gmap,
+			void changeStrategy(const GameContext& context,
 				pathfinding::HeuristicStrategies new_strat, bool diag_move);
 			/// <summary>Creates or extends a shield effect for the enemy.</summary>
 			/// <param name="shp">The starting health of the shield.</param>
@@ -249,10 +350,10 @@ namespace hoffman_isaiah {
 			bool canMoveDiagonally() const noexcept {
 				return this->move_diagonally;
 			}
-			std::vector<std::unique_ptr<StatusEffectBase>>& getActiveStatuses() noexcept {
+			util::FixedVector<StatusEffect, Enemy::max_status_effects>& getActiveStatuses() noexcept {
 				return this->status_effects;
 			}
-			const std::vector<std::unique_ptr<StatusEffectBase>>& getActiveStatuses() const noexcept {
+			const util::FixedVector<StatusEffect, Enemy::max_status_effects>& getActiveStatuses() const noexcept {
 				return this->status_effects;
 			}
 			// Calculated getters:
@@ -358,6 +459,8 @@ namespace hoffman_isaiah {
 		private:
 			/// <summary>The template type used to create the enemy.</summary>
 			const EnemyType* base_type;
+			/// <summary>The counters of the game that the enemy belongs to. (This is never nullptr.)</summary>
+			util::PerfCounterRegistry* perf_counters;
 			// Pathfinding stuff
 			/// <summary>The pathfinder used by the enemy.</summary>
 			pathfinding::Pathfinder my_pathfinder;
@@ -365,8 +468,13 @@ namespace hoffman_isaiah {
 			std::queue<pathfinding::GraphNode> my_path;
 			/// <summary>The last node in the path that the enemy travelled to.</summary>
 			const pathfinding::GraphNode* current_node;
-			/// <summary>The direction the enemy is currently moving in (in radians).</summary>
-			double current_direction;
+			/// <summary>The x-component of the unit vector in the direction the enemy is currently moving in.
+			/// (This only changes once per path segment.)</summary>
+			double direction_x;
+			/// <summary>The y-component of the unit vector in the direction the enemy is currently moving in.</summary>
+			double direction_y;
+			/// <summary>The distance remaining before the enemy reaches its next node.</summary>
+			double distance_to_next_node;
 			// Information and statistics
 			/// <summary>The amount of health that the enemy has remaining.</summary>
 			double current_health;
@@ -405,10 +513,12 @@ namespace hoffman_isaiah {
 			/// <summary>The list of passive buffs that this enemy possesses.</summary>
 			std::vector<std::unique_ptr<BuffBase>> buffs;
 			// Status ailments
-			/// <summary>The list of status effects that are currently affecting this enemy.</summary>
-			std::vector<std::unique_ptr<StatusEffectBase>> status_effects;
-			/// <summary>Keeps track of the enemy's resistance to status afflictions.</summary>
-			std::map<StatusEffects, Enemy::StatusResistance> status_resists;
+			/// <summary>The list of status effects that are currently affecting this enemy.
+			/// (These are stored inside the enemy, so spawning an enemy or afflicting it never allocates.)</summary>
+			util::FixedVector<StatusEffect, Enemy::max_status_effects> status_effects;
+			/// <summary>Keeps track of the enemy's resistance to status afflictions.
+			/// (Indexed by the StatusEffects enumeration.)</summary>
+			std::array<Enemy::StatusResistance, static_cast<int>(StatusEffects::Sentinel_DO_NOT_USE)> status_resists {};
 		};
 	}
 }
\ No newline at end of file
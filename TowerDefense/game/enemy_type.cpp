@@ -1,13 +1,20 @@
 // Author: Isaiah Hoffman
 // Created: March 8, 2019
+#include <memory>
 #include <vector>
 #include "./enemy_type.hpp"
 #include "./game_formulas.hpp"
-#include "./my_game.hpp"
+#include "./type_ids.hpp"
 namespace hoffman_isaiah::game {
 
-	double BuffBase::getAverageInfluenceRating() const noexcept {
-		// Maybe not the wisest use of global state but definitely convenient.
-		return enemy_buffs::buff_base::getAverageInfluenceRating(this->getTargetNames(), game::g_my_game->getAllEnemyTypes());
+	void BuffBase::resolveTargets(const NameTable& enemy_ids, const std::vector<std::shared_ptr<EnemyType>>& etypes) {
+		this->buff_target_ids.clear();
+		for (const auto& n : this->buff_names) {
+			const int id = enemy_ids.find(n);
+			if (id >= 0) {
+				this->buff_target_ids.insert(id);
+			}
+		}
+		this->average_influence_rating = enemy_buffs::buff_base::getAverageInfluenceRating(this->getTargetNames(), etypes);
 	}
 }
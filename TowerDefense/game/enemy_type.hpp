@@ -11,11 +11,13 @@
 #include "./../graphics/shapes.hpp"
 #include "./game_object_type.hpp"
 #include "./game_formulas.hpp"
+#include "./type_ids.hpp"
 
 namespace hoffman_isaiah {
 	namespace game {
 		// Forward declarations:
 		class Enemy;
+		class EnemyType;
 
 		/// <summary>Enumeration of valid types of buffs.</summary>
 		enum class BuffTypes {
@@ -56,9 +58,15 @@ namespace hoffman_isaiah {
 			void update(const Enemy& caller, std::vector<std::unique_ptr<Enemy>>& enemies);
 
 			// Getters
-			std::vector<std::wstring> getTargetNames() const noexcept {
+			const std::vector<std::wstring>& getTargetNames() const noexcept {
 				return this->buff_names;
 			}
+			/// <summary>Converts the buff's target names into enemy type identifiers and rates the
+			/// enemies that the buff affects. This must be called once all of the enemy types have
+			/// been loaded. (Names that do not refer to an enemy type are ignored.)</summary>
+			/// <param name="enemy_ids">The table of enemy type names.</param>
+			/// <param name="etypes">The list of enemy types.</param>
+			void resolveTargets(const NameTable& enemy_ids, const std::vector<std::shared_ptr<EnemyType>>& etypes);
 			double getRadius() const noexcept {
 				return this->buff_radius;
 			}
@@ -82,7 +90,9 @@ namespace hoffman_isaiah {
 				return false;
 			}
 			/// <returns>The average base rating of the enemies this buff affects.</returns>
-			double getAverageInfluenceRating() const noexcept;
+			double getAverageInfluenceRating() const noexcept {
+				return this->average_influence_rating;
+			}
 			/// <returns>The basic rating of the buff as determined by its
 			/// radius of influence, time between activations, and the number of enemies it affects.</returns>
 			virtual double getBaseRating() const noexcept {
@@ -96,6 +106,12 @@ namespace hoffman_isaiah {
 		private:
 			/// <summary>The names of enemies that are affected by the buff.</summary>
 			std::vector<std::wstring> buff_names;
+			/// <summary>The identifiers of the enemy types that are affected by the buff.</summary>
+			TypeIdSet buff_target_ids {};
+			/// <summary>The average base rating of the enemy types that are affected by the buff.
+			/// (This is found when the targets are resolved so that rating a buff does not need
+			/// the game's list of enemy types.)</summary>
+			double average_influence_rating {0.0};
 			/// <summary>The maximum distance (in game coordinate squares) that the buff covers.</summary>
 			double buff_radius;
 			/// <summary>The number of logical frames between each application of the buff.</summary>
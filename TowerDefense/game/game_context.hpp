@@ -0,0 +1,18 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+
+namespace hoffman_isaiah {
+	namespace game {
+		// Forward declaration
+		class MyGame;
+
+		/// <summary>The game session that an update belongs to. This is passed down to the objects
+		/// being updated (instead of them reaching for g_my_game) so that several games can be
+		/// updated at the same time, each on its own thread.</summary>
+		struct GameContext {
+			/// <summary>The game that is being updated.</summary>
+			MyGame& game;
+		};
+	}
+}
\ No newline at end of file
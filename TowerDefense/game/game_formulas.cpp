@@ -71,7 +71,7 @@ namespace hoffman_isaiah::game {
 	namespace enemy_buffs {
 		namespace buff_base {
 			double getAverageInfluenceRating(std::vector<std::wstring> target_names,
-				const std::vector<std::unique_ptr<EnemyType>>& etypes) {
+				const std::vector<std::shared_ptr<EnemyType>>& etypes) {
 				double total_rating = 0.0;
 				for (const auto& ename : target_names) {
 					for (const auto& my_type : etypes) {
@@ -1,45 +1,59 @@
 // File Author: Isaiah Hoffman
 // File Created: June 6, 2018
 #include <algorithm>
+#include <cmath>
 #include <deque>
 #include <future>
+#include <map>
 #include <memory>
 #include <queue>
 #include <random>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 #include "./../ih_math.hpp"
+#include "./../perf_counters.hpp"
+#include "./../profiler.hpp"
 #include "./../pathfinding/grid.hpp"
 #include "./../pathfinding/pathfinder.hpp"
 #include "./enemy.hpp"
+#include "./game_context.hpp"
 #include "./game_level.hpp"
 #include "./game_util.hpp"
 #include "./my_game.hpp"
 
 namespace hoffman_isaiah::game {
+	namespace {
+		/// <summary>The square root of two.</summary>
+		constexpr const double sqrt_two = 1.4142135623730950488;
+	}
+
 	EnemyGroup::EnemyGroup(std::queue<std::unique_ptr<Enemy>>&& group_enemies, int spawn_ms_delay) :
 		enemies {std::move(group_enemies)},
 		spawn_frame_delay {math::convertMillisecondsToFrames(spawn_ms_delay)},
 		frames_until_next_spawn {0} {
 	}
 
-	void EnemyGroup::update() noexcept {
+	void EnemyGroup::update(const GameContext& context) noexcept {
 		--this->frames_until_next_spawn;
 		if (!this->hasEnemiesLeft() || this->frames_until_next_spawn > 0) {
 			return;
 		}
 		this->frames_until_next_spawn += this->spawn_frame_delay;
-		game::g_my_game->addEnemy(std::move(this->enemies.front()));
+		context.game.addEnemy(std::move(this->enemies.front()));
 		this->enemies.pop();
 	}
 
 	std::queue<std::unique_ptr<Enemy>> EnemyGroup::createEnemies(const EnemyType* etype,
 		int extra_count, const MyGame& my_game) {
+		IH_PROFILE_FUNCTION();
 		const int enemy_count = etype->isUnique()
 			? 1 + extra_count : my_game.getChallengeLevel() + extra_count + 2;
 		pathfinding::Pathfinder my_pathfinder {my_game.getMap(), etype->isFlying(),
 			etype->canMoveDiagonally(), etype->getDefaultStrategy()};
+		my_pathfinder.setPerfCounters(&my_game.getPerfCounters());
+		my_game.getPerfCounters().increment(util::PerfCounters::Repaths_Group_Spawn);
 		my_pathfinder.findPath(my_game.getChallengeLevel() / 10.0);
 		std::queue<std::unique_ptr<Enemy>> my_enemy_spawns {};
 		std::vector<std::future<std::unique_ptr<Enemy>>> enemy_asyncs {};
@@ -50,7 +64,8 @@ namespace hoffman_isaiah::game {
 					graphics::Color {0.f, 0.f, 0.f, 1.f}, my_pathfinder,
 					my_game.getMap().getTerrainGraph(etype->isFlying()).getStartNode()->getGameX() + 0.5,
 					my_game.getMap().getTerrainGraph(etype->isFlying()).getStartNode()->getGameY() + 0.5,
-					my_game.getLevelNumber(), my_game.getDifficulty(), my_game.getChallengeLevel());
+					my_game.getLevelNumber(), my_game.getDifficulty(), my_game.getChallengeLevel(),
+					my_game.getPerfCounters());
 				}));
 		}
 		for (int i = 0; i < enemy_count; ++i) {
@@ -67,9 +82,9 @@ namespace hoffman_isaiah::game {
 		frames_until_next_spawn {0} {
 	}
 
-	void EnemyWave::update() noexcept {
+	void EnemyWave::update(const GameContext& context) noexcept {
 		for (auto& g : this->active_groups) {
-			g->update();
+			g->update(context);
 		}
 		if (this->groups.empty()) {
 			return;
@@ -83,6 +98,24 @@ namespace hoffman_isaiah::game {
 		this->groups.pop_back();
 	}
 
+	std::unique_ptr<GameLevel> LevelTemplate::instantiate(int level_number, const MyGame& my_game) const {
+		std::deque<std::unique_ptr<EnemyWave>> my_level_waves {};
+		for (const auto& wave_template : this->waves) {
+			std::deque<std::unique_ptr<EnemyGroup>> my_wave_groups {};
+			for (const auto& group_template : wave_template.groups) {
+				const EnemyType* etype = my_game.getEnemyType(group_template.enemy_type_id);
+				std::queue<std::unique_ptr<Enemy>> my_enemy_spawns {EnemyGroup::createEnemies(etype,
+					group_template.extra_count, my_game)};
+				// (Groups and waves are spawned from the back of their queues.)
+				my_wave_groups.emplace_front(std::make_unique<EnemyGroup>(std::move(my_enemy_spawns),
+					group_template.enemy_spawn_delay));
+			}
+			my_level_waves.emplace_front(std::make_unique<EnemyWave>(std::move(my_wave_groups),
+				wave_template.group_spawn_delay));
+		}
+		return std::make_unique<GameLevel>(level_number, this->desc, std::move(my_level_waves), this->wave_spawn_delay);
+	}
+
 	GameLevel::GameLevel(int level_no, std::wstring level_desc,
 		std::deque<std::unique_ptr<EnemyWave>>&& level_waves, int spawn_ms_delay) :
 		level {level_no},
@@ -93,9 +126,9 @@ namespace hoffman_isaiah::game {
 		frames_until_next_spawn {0} {
 	}
 
-	void GameLevel::update() noexcept {
+	void GameLevel::update(const GameContext& context) noexcept {
 		for (auto& w : this->active_waves) {
-			w->update();
+			w->update(context);
 		}
 		if (this->waves.empty()) {
 			return;
@@ -112,6 +145,7 @@ namespace hoffman_isaiah::game {
 	GlobalLevelEnemyData::GlobalLevelEnemyData(const MyGame& my_game, std::wstring ename,
 		std::wstring cname, double z, LevelNormalRandomVariable ec_var, std::array<int, 3> stimes) :
 		enemy_type {my_game.getEnemyType(ename)},
+		enemy_type_id {my_game.getEnemyTypeId(ename)},
 		color_name {cname},
 		z_difficulty {z},
 		extra_count_var {ec_var},
@@ -120,9 +154,44 @@ namespace hoffman_isaiah::game {
 
 	GlobalLevelBossData::GlobalLevelBossData(const MyGame& my_game, std::wstring ename, double z) :
 		enemy_type {my_game.getEnemyType(ename)},
+		enemy_type_id {my_game.getEnemyTypeId(ename)},
 		z_difficulty {z} {
 	}
 
+	void ZScoreTable::add(double z, int item) {
+		// (Items with equal z-scores stay in the order that they were added.)
+		const auto it = std::upper_bound(this->z_scores.begin(), this->z_scores.end(), z);
+		const auto pos = it - this->z_scores.begin();
+		this->z_scores.insert(it, z);
+		this->items.insert(this->items.begin() + pos, item);
+	}
+
+	int ZScoreTable::draw(double mu, double sigma, double u) const noexcept {
+		if (sigma <= 0.0) {
+			const auto it = std::lower_bound(this->z_scores.begin(), this->z_scores.end(), mu);
+			return it == this->z_scores.end() ? this->items.back() : this->items[it - this->z_scores.begin()];
+		}
+		// The probability that a roll is at most z.
+		const auto cdf = [mu, sigma](double z) noexcept {
+			return 0.5 * std::erfc((mu - z) / (sigma * sqrt_two));
+		};
+		const double valid_probability = cdf(this->z_scores.back());
+		if (!(valid_probability > 0.0)) {
+			// Practically every roll would be rerolled, and whatever probability is left lies
+			// just below the largest z-score.
+			return this->items.back();
+		}
+		// Rolling u * valid_probability is the same as rerolling until the roll is at most the
+		// largest z-score. Since the CDF is increasing, the first item whose CDF reaches the
+		// roll is the first item whose z-score reaches the roll.
+		const double my_roll = u * valid_probability;
+		const auto it = std::lower_bound(this->z_scores.begin(), this->z_scores.end(), my_roll,
+			[&cdf](double z, double roll) noexcept {
+			return cdf(z) < roll;
+		});
+		return it == this->z_scores.end() ? this->items.back() : this->items[it - this->z_scores.begin()];
+	}
+
 	LevelGenerator::LevelGenerator(int start_lv, std::vector<GlobalLevelColorData> cdata,
 		std::vector<GlobalLevelEnemyData> edata, std::vector<GlobalLevelBossData> bdata,
 		LevelNormalRandomVariable wd_var, LevelNormalRandomVariable gd_var,
@@ -144,93 +213,95 @@ namespace hoffman_isaiah::game {
 		std::sort(this->color_data.begin(), this->color_data.end(), [](const auto& a, const auto& b) {
 			return a.getZScore() < b.getZScore();
 		});
-		std::sort(this->enemy_data.begin(), this->enemy_data.end(), [](const auto& a, const auto& b) {
-			return a.getColorName() == b.getColorName() && a.getZScore() < b.getZScore();
-		});
 		std::sort(this->boss_data.begin(), this->boss_data.end(), [](const auto& a, const auto& b) {
 			return a.getZScore() < b.getZScore();
 		});
+		// Colors are interned so that generating a level never compares color names.
+		std::map<std::wstring, int> color_ids {};
+		for (int i = 0; i < static_cast<int>(this->color_data.size()); ++i) {
+			color_ids.emplace(this->color_data[i].getName(), i);
+		}
+		this->enemy_tables.resize(this->color_data.size());
+		for (int i = 0; i < static_cast<int>(this->enemy_data.size()); ++i) {
+			const auto it = color_ids.find(this->enemy_data[i].getColorName());
+			if (it != color_ids.end()) {
+				this->enemy_tables[it->second].add(this->enemy_data[i].getZScore(), i);
+			}
+		}
+		for (int i = 0; i < static_cast<int>(this->color_data.size()); ++i) {
+			// (A wave of a color without any enemies could never be filled.)
+			if (!this->enemy_tables[i].isEmpty()) {
+				this->color_table.add(this->color_data[i].getZScore(), i);
+			}
+		}
+		for (int i = 0; i < static_cast<int>(this->boss_data.size()); ++i) {
+			this->boss_table.add(this->boss_data[i].getZScore(), i);
+		}
 	}
 
 	std::unique_ptr<GameLevel> LevelGenerator::generateLevel(int level_number, const MyGame& my_game) {
+		return this->generateTemplate(level_number).instantiate(level_number, my_game);
+	}
+
+	LevelTemplate LevelGenerator::generateTemplate(int level_number) const {
 		const int levels_above_start = level_number - this->getStartLevel();
 		const int num_waves = this->rollNumWaves(levels_above_start);
 		const int num_groups = this->rollNumGroups(levels_above_start);
 		const int min_wave_groups = num_groups / num_waves;
 		const int wave_groups_overflow = num_groups % num_waves;
-		std::deque<std::unique_ptr<EnemyWave>> my_level_waves {};
+		const bool is_boss_level = levels_above_start % this->boss_level_mod == 0
+			&& level_number > this->getStartLevel() && !this->boss_table.isEmpty();
+		std::vector<LevelTemplate::WaveTemplate> my_level_waves {};
 		for (int w = 0; w < num_waves; ++w) {
-			if ((level_number - this->getStartLevel()) % this->boss_level_mod == 0
-				&& level_number > start_level
-				&& w == num_waves / 2) {
+			if (is_boss_level && w == num_waves / 2) {
 				// Boss level; add boss enemies.
+				static constexpr const int extra_count = 0;
+				static constexpr const int enemy_delay = 1500;
 				const int groups_in_this_wave = this->rollNumBosses(levels_above_start);
-				std::deque<std::unique_ptr<EnemyGroup>> my_wave_groups {};
+				LevelTemplate::WaveTemplate my_boss_wave {this->getGroupDelay(), {}};
 				for (int g = 0; g < groups_in_this_wave; ++g) {
-					// Determine boss type.
-					const EnemyType* my_etype {nullptr};
-					static constexpr const int extra_count = 0;
-					static constexpr const int enemy_delay = 1500;
-					while (!my_etype) {
-						const double my_boss_difficulty = this->rollBossDifficulty(levels_above_start);
-						for (const auto& bdata : this->getBossData()) {
-							my_etype = bdata.getType();
-						}
-					}
-					std::queue<std::unique_ptr<Enemy>> group_enemies {
-						EnemyGroup::createEnemies(my_etype, extra_count, my_game)};
-					auto my_enemy_group = std::make_unique<EnemyGroup>(
-						std::move(group_enemies), enemy_delay);
-					my_wave_groups.emplace_back(std::move(my_enemy_group));
+					my_boss_wave.groups.push_back(LevelTemplate::GroupTemplate {
+						this->rollBoss(levels_above_start).getTypeId(), extra_count, enemy_delay});
 				}
-				auto my_enemy_wave = std::make_unique<EnemyWave>(std::move(my_wave_groups),
-					this->getGroupDelay());
-				my_level_waves.emplace_back(std::move(my_enemy_wave));
+				my_level_waves.emplace_back(std::move(my_boss_wave));
+			}
+			if (this->color_table.isEmpty()) {
+				continue;
 			}
 			const int groups_in_this_wave = w - wave_groups_overflow < 0
 				? min_wave_groups + 1 : min_wave_groups;
-			// Determine wave color.
-			std::wstring cname = L"";
-			while (cname == L"") {
-				const double my_wave_difficulty = this->rollWaveDifficulty(levels_above_start);
-				for (const auto& cdata : this->getColorData()) {
-					if (my_wave_difficulty <= cdata.getZScore()) {
-						cname = cdata.getName();
-						break;
-					}
-				}
-			}
-			std::deque<std::unique_ptr<EnemyGroup>> my_wave_groups {};
+			const int color_id = this->rollWaveColor(levels_above_start);
+			LevelTemplate::WaveTemplate my_wave {this->getGroupDelay(), {}};
 			for (int g = 0; g < groups_in_this_wave; ++g) {
 				// Determine group type and associated count.
-				const EnemyType* my_etype {nullptr};
-				int extra_count = 0;
-				int enemy_delay = 0;
-				while (!my_etype) {
-					const double my_group_difficulty = this->rollGroupDifficulty(levels_above_start);
-					for (const auto& edata : this->getEnemyData()) {
-						if (edata.getColorName() == cname && my_group_difficulty <= edata.getZScore()) {
-							my_etype = edata.getType();
-							extra_count = edata.rollExtraCount(levels_above_start);
-							const double my_roll = rng::distro_uniform(rng::gen);
-							enemy_delay = my_roll <= 0.33 ? edata.getSpawnTime(EnemySpawnDensities::Dense)
-								: my_roll <= 0.67 ? edata.getSpawnTime(EnemySpawnDensities::Normal)
-								: edata.getSpawnTime(EnemySpawnDensities::Sparse);
-							break;
-						}
-					}
-				}
-				std::queue<std::unique_ptr<Enemy>> group_enemies {
-					EnemyGroup::createEnemies(my_etype, extra_count, my_game)};
-				auto my_enemy_group = std::make_unique<EnemyGroup>(std::move(group_enemies), enemy_delay);
-				my_wave_groups.emplace_back(std::move(my_enemy_group));
+				const GlobalLevelEnemyData& edata = this->rollGroupEnemy(color_id, levels_above_start);
+				const int extra_count = edata.rollExtraCount(levels_above_start);
+				const double my_roll = rng::distro_uniform(rng::gen);
+				const int enemy_delay = my_roll <= 0.33 ? edata.getSpawnTime(EnemySpawnDensities::Dense)
+					: my_roll <= 0.67 ? edata.getSpawnTime(EnemySpawnDensities::Normal)
+					: edata.getSpawnTime(EnemySpawnDensities::Sparse);
+				my_wave.groups.push_back(LevelTemplate::GroupTemplate {edata.getTypeId(), extra_count, enemy_delay});
 			}
-			auto my_enemy_wave = std::make_unique<EnemyWave>(
-				std::move(my_wave_groups), this->getGroupDelay());
-			my_level_waves.emplace_back(std::move(my_enemy_wave));
+			my_level_waves.emplace_back(std::move(my_wave));
 		}
-		auto my_level = std::make_unique<GameLevel>(level_number, L"",
-			std::move(my_level_waves), this->getWaveDelay());
-		return my_level;
+		return LevelTemplate {L"", std::move(my_level_waves), this->getWaveDelay()};
+	}
+
+	int LevelGenerator::rollWaveColor(int levels_above_start) const noexcept {
+		return this->color_table.draw(this->wave_difficulty_var.getMean(levels_above_start),
+			this->wave_difficulty_var.getBaseVariable().getStandardDeviation(), rng::distro_uniform(rng::gen));
+	}
+
+	const GlobalLevelEnemyData& LevelGenerator::rollGroupEnemy(int color_id, int levels_above_start) const noexcept {
+		const int enemy_index = this->enemy_tables[color_id].draw(this->group_difficulty_var.getMean(levels_above_start),
+			this->group_difficulty_var.getBaseVariable().getStandardDeviation(), rng::distro_uniform(rng::gen));
+		return this->enemy_data[enemy_index];
+	}
+
+	const GlobalLevelBossData& LevelGenerator::rollBoss(int levels_above_start) const noexcept {
+		const int boss_index = this->boss_table.draw(
+			this->boss_difficulty_var.getMean(levels_above_start / this->boss_level_mod),
+			this->boss_difficulty_var.getBaseVariable().getStandardDeviation(), rng::distro_uniform(rng::gen));
+		return this->boss_data[boss_index];
 	}
 }
\ No newline at end of file
@@ -4,9 +4,12 @@
 #include <deque>
 #include <memory>
 #include <queue>
+#include <string>
+#include <utility>
 #include <vector>
 #include "./../ih_math.hpp"
 #include "./enemy.hpp"
+#include "./game_context.hpp"
 #include "./game_util.hpp"
 
 namespace hoffman_isaiah::winapi {
@@ -27,7 +30,8 @@ namespace hoffman_isaiah::game {
 		/// <param name="spawn_ms_delay">The delay in milliseconds between enemies.</param>
 		EnemyGroup(std::queue<std::unique_ptr<Enemy>>&& group_enemies, int spawn_ms_delay);
 		/// <summary>Updates the state of the enemy group by one logical frame.</summary>
-		void update() noexcept;
+		/// <param name="context">The game that spawned enemies are added to.</param>
+		void update(const GameContext& context) noexcept;
 		/// <returns>The total number of enemies currently in the group.</returns>
 		int getEnemyCount() const noexcept {
 			return static_cast<int>(this->enemies.size());
@@ -59,7 +63,8 @@ namespace hoffman_isaiah::game {
 		/// <param name="spawn_ms_delay">The delay in milliseconds between groups.</param>
 		EnemyWave(std::deque<std::unique_ptr<EnemyGroup>>&& wave_groups, int spawn_ms_delay);
 		/// <summary>Updates the state of the enemy wave by one logical frame.</summary>
-		void update() noexcept;
+		/// <param name="context">The game that spawned enemies are added to.</param>
+		void update(const GameContext& context) noexcept;
 		/// <returns>The number of enemies still left to spawn in the wave.</returns>
 		int getEnemyCount() const noexcept {
 			int subtotal = 0;
@@ -105,7 +110,8 @@ namespace hoffman_isaiah::game {
 		GameLevel(int level_no, std::wstring level_desc,
 			std::deque<std::unique_ptr<EnemyWave>>&& level_waves, int spawn_ms_delay);
 		/// <summary>Updates the state of the game level by one logical frame.</summary>
-		void update() noexcept;
+		/// <param name="context">The game that spawned enemies are added to.</param>
+		void update(const GameContext& context) noexcept;
 		/// <returns>The number of enemies left to spawn in the level.</returns>
 		int getEnemyCount() const noexcept {
 			int subtotal = 0;
@@ -150,6 +156,60 @@ namespace hoffman_isaiah::game {
 		double frames_until_next_spawn;
 	};
 
+	/// <summary>Stores the parsed contents of a hand-authored level file. Templates never change
+	/// once they are loaded; each time the level is started or previewed, a new GameLevel is
+	/// created from the template.</summary>
+	class LevelTemplate {
+	public:
+		/// <summary>Describes a group of enemies of the same type.</summary>
+		struct GroupTemplate {
+			/// <summary>The identifier of the type of enemy in the group.</summary>
+			int enemy_type_id;
+			/// <summary>The number of extra enemies in the group.</summary>
+			int extra_count;
+			/// <summary>The delay in milliseconds between enemies.</summary>
+			int enemy_spawn_delay;
+		};
+		/// <summary>Describes a wave of enemy groups.</summary>
+		struct WaveTemplate {
+			/// <summary>The delay in milliseconds between groups.</summary>
+			int group_spawn_delay;
+			/// <summary>The groups in the wave in the order that they spawn.</summary>
+			std::vector<GroupTemplate> groups;
+		};
+
+		/// <param name="level_desc">The description for the level.</param>
+		/// <param name="level_waves">The waves in the level in the order that they spawn.</param>
+		/// <param name="spawn_ms_delay">The delay in milliseconds between waves.</param>
+		LevelTemplate(std::wstring level_desc, std::vector<WaveTemplate> level_waves, int spawn_ms_delay) :
+			desc {std::move(level_desc)},
+			waves {std::move(level_waves)},
+			wave_spawn_delay {spawn_ms_delay} {
+		}
+		/// <summary>Creates a playable level from the template.</summary>
+		/// <param name="level_number">The number of the level being created.</param>
+		/// <param name="my_game">Reference to the game state.</param>
+		/// <returns>The newly created level.</returns>
+		std::unique_ptr<GameLevel> instantiate(int level_number, const MyGame& my_game) const;
+		// Getters
+		std::wstring getDesc() const noexcept {
+			return this->desc;
+		}
+		const std::vector<WaveTemplate>& getWaves() const noexcept {
+			return this->waves;
+		}
+		int getWaveSpawnDelay() const noexcept {
+			return this->wave_spawn_delay;
+		}
+	private:
+		/// <summary>A description for the level.</summary>
+		std::wstring desc;
+		/// <summary>The waves in the level in the order that they spawn.</summary>
+		std::vector<WaveTemplate> waves;
+		/// <summary>The delay in milliseconds between waves.</summary>
+		int wave_spawn_delay;
+	};
+
 	/// <summary>Stores a normally distributed random variable whose mean changes each level.</summary>
 	class LevelNormalRandomVariable {
 	public:
@@ -165,6 +225,18 @@ namespace hoffman_isaiah::game {
 		double operator()(int levels_above_start) const noexcept {
 			return this->normal_params() + this->level_change * levels_above_start;
 		}
+		/// <param name="levels_above_start">The number of levels since the first generated level.</param>
+		/// <returns>The center of the distribution for the given level.</returns>
+		double getMean(int levels_above_start) const noexcept {
+			return this->normal_params.getMean() + this->level_change * levels_above_start;
+		}
+		// Getters
+		const NormalRandomVariable& getBaseVariable() const noexcept {
+			return this->normal_params;
+		}
+		double getLevelChange() const noexcept {
+			return this->level_change;
+		}
 	private:
 		/// <summary>The parameters to the normal distribution.</summary>
 		NormalRandomVariable normal_params;
@@ -223,6 +295,9 @@ namespace hoffman_isaiah::game {
 		const EnemyType* getType() const noexcept {
 			return this->enemy_type;
 		}
+		int getTypeId() const noexcept {
+			return this->enemy_type_id;
+		}
 		std::wstring getColorName() const noexcept {
 			return this->color_name;
 		}
@@ -235,9 +310,14 @@ namespace hoffman_isaiah::game {
 				: spawn_density == EnemySpawnDensities::Normal ? this->spawn_times.at(1)
 				: this->spawn_times.at(2);
 		}
+		const LevelNormalRandomVariable& getExtraCountVariable() const noexcept {
+			return this->extra_count_var;
+		}
 	private:
 		/// <summary>The enemy type associated with this data.</summary>
 		const EnemyType* enemy_type;
+		/// <summary>The identifier of the enemy type.</summary>
+		int enemy_type_id;
 		/// <summary>The color group the enemy belongs to.</summary>
 		std::wstring color_name;
 		/// <summary>The z-score associated with this enemy which is used to determine
@@ -261,19 +341,55 @@ namespace hoffman_isaiah::game {
 		const EnemyType* getType() const noexcept {
 			return this->enemy_type;
 		}
+		int getTypeId() const noexcept {
+			return this->enemy_type_id;
+		}
 		double getZScore() const noexcept {
 			return this->z_difficulty;
 		}
 	private:
 		/// <summary>The enemy type associated with this data.</summary>
 		const EnemyType* enemy_type;
+		/// <summary>The identifier of the enemy type.</summary>
+		int enemy_type_id;
 		/// <summary>The z-score associated with this enemy which is used to determine
 		/// the frequency this enemy is spawned.</summary>
 		double z_difficulty;
 	};
 
+	/// <summary>A list of items sorted by z-score that is used to pick an item with a single
+	/// roll of a normal random variable. An item is picked when the roll is at most its z-score
+	/// and no easier item's z-score, and rolls above the largest z-score are rerolled. Instead of
+	/// actually rerolling, the roll is made as a probability restricted to the valid range, which
+	/// is then located with a binary search, so every draw takes O(log n) time.</summary>
+	class ZScoreTable {
+	public:
+		/// <param name="z">The z-score of the item.</param>
+		/// <param name="item">The item, which is usually an index into another list.</param>
+		void add(double z, int item);
+		/// <param name="mu">The center of the normal distribution.</param>
+		/// <param name="sigma">The standard deviation of the normal distribution.</param>
+		/// <param name="u">A uniformly distributed value in [0, 1).</param>
+		/// <returns>The item that the roll selects. (The table must not be empty.)</returns>
+		int draw(double mu, double sigma, double u) const noexcept;
+		// Getters
+		bool isEmpty() const noexcept {
+			return this->items.empty();
+		}
+		int size() const noexcept {
+			return static_cast<int>(this->items.size());
+		}
+	private:
+		/// <summary>The z-score of each item in increasing order.</summary>
+		std::vector<double> z_scores {};
+		/// <summary>The items in the same order as their z-scores.</summary>
+		std::vector<int> items {};
+	};
+
 	/// <summary>Used to generate new levels randomly.</summary>
 	class LevelGenerator {
+		// (MyGame writes the generator's settings to the type database.)
+		friend class MyGame;
 	public:
 		/// <param name="start_lv">The number of the first level to automatically generate.</param>
 		/// <param name="cdata">The color metadata for the level generator.</param>
@@ -298,26 +414,26 @@ namespace hoffman_isaiah::game {
 		/// <param name="my_game">Reference to the game state.</param>
 		/// <returns>A pointer to the generated level. The caller is responsible for taking ownership.</returns>
 		std::unique_ptr<GameLevel> generateLevel(int level_number, const MyGame& my_game);
+		/// <summary>Randomly chooses the waves and groups of a level without creating any enemies.</summary>
+		/// <param name="level_number">The level number of the level to generate.</param>
+		/// <returns>The template of the generated level.</returns>
+		LevelTemplate generateTemplate(int level_number) const;
 		// Getters
 		int getStartLevel() const noexcept {
 			return this->start_level;
 		}
 	protected:
 		/// <param name="levels_above_start">The number of levels since the first generated level.</param>
-		/// <returns>The wave difficulty value for this particular call.</returns>
-		double rollWaveDifficulty(int levels_above_start) const noexcept {
-			return this->wave_difficulty_var(levels_above_start);
-		}
+		/// <returns>The identifier of a randomly chosen wave color (which is also its index
+		/// in the color data).</returns>
+		int rollWaveColor(int levels_above_start) const noexcept;
+		/// <param name="color_id">The identifier of the wave's color.</param>
 		/// <param name="levels_above_start">The number of levels since the first generated level.</param>
-		/// <returns>The group difficulty value for this particular call.</returns>
-		double rollGroupDifficulty(int levels_above_start) const noexcept {
-			return this->group_difficulty_var(levels_above_start);
-		}
+		/// <returns>The metadata of a randomly chosen enemy of the given color.</returns>
+		const GlobalLevelEnemyData& rollGroupEnemy(int color_id, int levels_above_start) const noexcept;
 		/// <param name="levels_above_start">The number of levels since the first generated level.</param>
-		/// <returns>The boss difficulty value for this particular call.</returns>
-		double rollBossDifficulty(int levels_above_start) const noexcept {
-			return this->boss_difficulty_var(levels_above_start / this->boss_level_mod);
-		}
+		/// <returns>The metadata of a randomly chosen boss.</returns>
+		const GlobalLevelBossData& rollBoss(int levels_above_start) const noexcept;
 		/// <param name="levels_above_start">The number of levels since the first generated level.</param>
 		/// <returns>The number of waves to generate for this particular call.</returns>
 		int rollNumWaves(int levels_above_start) const noexcept {
@@ -359,6 +475,13 @@ namespace hoffman_isaiah::game {
 		std::vector<GlobalLevelEnemyData> enemy_data;
 		/// <summary>The global boss metadata.</summary>
 		std::vector<GlobalLevelBossData> boss_data;
+		/// <summary>The colors that have at least one enemy, keyed by their z-scores.</summary>
+		ZScoreTable color_table {};
+		/// <summary>The indices of the enemies of each color keyed by their z-scores.
+		/// (This is indexed by color identifier.)</summary>
+		std::vector<ZScoreTable> enemy_tables {};
+		/// <summary>The indices of the bosses keyed by their z-scores.</summary>
+		ZScoreTable boss_table {};
 		/// <summary>The normally distributed random variable associated with
 		/// the difficulty of generated waves each level.</summary>
 		LevelNormalRandomVariable wave_difficulty_var;
@@ -17,60 +17,17 @@ namespace hoffman_isaiah {
 			sprite {nullptr},
 			my_map {game_map},
 			gx {cgx},
-			gy {cgy} {
+			gy {cgy},
+			shape {st},
+			outline_color {o_color},
+			fill_color {f_color},
+			gwidth {gw},
+			gheight {gh} {
 			const float csx = static_cast<float>(this->getGameMap().convertToScreenX(cgx));
 			const float csy = static_cast<float>(this->getGameMap().convertToScreenY(cgy));
-			float sw = static_cast<float>(gw) * this->getGameMap().getGameSquareWidth<float>();
-			float sh = static_cast<float>(gh) * this->getGameMap().getGameSquareHeight<float>();
-
-			switch (st) {
-			case graphics::shapes::ShapeTypes::Star:
-			{
-				const std::array<std::array<float, 2>, 10> points {{
-					{csx, csy + sh / 2.f},
-					{csx + sw / 4.f * std::cos(0.7f * math::calculate_pi<float>()),
-					csy + sh / 4.f * std::sin(0.7f * math::calculate_pi<float>())},
-					{csx + sw / 2.f * std::cos(0.9f * math::calculate_pi<float>()),
-					csy + sh / 2.f * std::sin(0.9f * math::calculate_pi<float>())},
-					{csx + sw / 4.f * std::cos(1.1f * math::calculate_pi<float>()),
-					csy + sh / 4.f * std::sin(1.1f * math::calculate_pi<float>())},
-					{csx + sw / 2.f * std::cos(1.3f * math::calculate_pi<float>()),
-					csy + sh / 2.f * std::sin(1.3f * math::calculate_pi<float>())},
-					{csx + sw / 4.f * std::cos(1.5f * math::calculate_pi<float>()),
-					csy + sh / 4.f * std::sin(1.5f * math::calculate_pi<float>())},
-					{csx + sw / 2.f * std::cos(1.7f * math::calculate_pi<float>()),
-					csy + sh / 2.f * std::sin(1.7f * math::calculate_pi<float>())},
-					{csx + sw / 4.f * std::cos(1.9f * math::calculate_pi<float>()),
-					csy + sh / 4.f * std::sin(1.9f * math::calculate_pi<float>())},
-					{csx + sw / 2.f * std::cos(2.1f * math::calculate_pi<float>()),
-					csy + sh / 2.f * std::sin(2.1f * math::calculate_pi<float>())},
-					{csx + sw / 4.f * std::cos(2.3f * math::calculate_pi<float>()),
-					csy + sh / 4.f * std::sin(2.3f * math::calculate_pi<float>())}
-				}};
-				this->sprite = std::make_unique<graphics::shapes::Shape2DPolygon<10>>(
-					dev_res, o_color, f_color, points, csx, csy);
-				break;
-			}
-			case graphics::shapes::ShapeTypes::Diamond:
-				this->sprite = std::make_unique<graphics::shapes::Shape2DDiamond>(dev_res, o_color, f_color,
-					csx, csy, sw, sh);
-				break;
-			case graphics::shapes::ShapeTypes::Rectangle:
-				this->sprite = std::make_unique<graphics::shapes::Shape2DRectangle>(dev_res, o_color, f_color,
-					csx - sw / 2.f, csy - sh / 2.f, csx + sw / 2.f, csy + sh / 2.f);
-				break;
-			case graphics::shapes::ShapeTypes::Triangle:
-			{
-				this->sprite = std::make_unique<graphics::shapes::Shape2DTriangle>(dev_res, o_color, f_color,
-					csx - sw / 2.f, csy - sh / 2.f, csx, csy + sh / 2.f, csx + sw / 2.f, csy - sh / 2.f);
-				break;
-			}
-			case graphics::shapes::ShapeTypes::Ellipse:
-			default:
-				this->sprite = std::make_unique<graphics::shapes::Shape2DEllipse>(dev_res, o_color, f_color,
-					csx, csy, sw, sh);
-				break;
-			}
+			const float sw = static_cast<float>(gw) * this->getGameMap().getGameSquareWidth<float>();
+			const float sh = static_cast<float>(gh) * this->getGameMap().getGameSquareHeight<float>();
+			this->sprite = graphics::shapes::createShape(dev_res, st, o_color, f_color, csx, csy, sw, sh);
 		}
 	}
 }
\ No newline at end of file
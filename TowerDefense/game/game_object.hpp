@@ -40,6 +40,7 @@ namespace hoffman_isaiah {
 			}
 			void scale(float new_size_percent) {
 				this->sprite->change_scale(new_size_percent, new_size_percent);
+				this->scale_factor = new_size_percent;
 			}
 
 			// Getters
@@ -63,6 +64,21 @@ namespace hoffman_isaiah {
 			const GameMap& getGameMap() const noexcept {
 				return this->my_map;
 			}
+			/// <returns>A description of how the object currently looks, which can be drawn
+			/// without touching the object itself.</returns>
+			graphics::shapes::ShapeInstance getShapeInstance() const noexcept {
+				graphics::shapes::ShapeInstance my_instance {};
+				my_instance.shape = this->shape;
+				my_instance.outline_color = graphics::toDrawColor(this->outline_color);
+				my_instance.fill_color = graphics::toDrawColor(this->fill_color);
+				my_instance.center_sx = static_cast<float>(this->getScreenX());
+				my_instance.center_sy = static_cast<float>(this->getScreenY());
+				my_instance.width_sw = static_cast<float>(this->gwidth) * this->scale_factor
+					* this->getGameMap().getGameSquareWidth<float>();
+				my_instance.height_sh = static_cast<float>(this->gheight) * this->scale_factor
+					* this->getGameMap().getGameSquareHeight<float>();
+				return my_instance;
+			}
 		protected:
 			// Setters and Changers
 			// Note that these don't perform actual changes to the graphical representation.
@@ -81,6 +97,18 @@ namespace hoffman_isaiah {
 			double gx;
 			/// <summary>The object's game y-coordinate.</summary>
 			double gy;
+			/// <summary>The kind of shape that the object is drawn as.</summary>
+			graphics::shapes::ShapeTypes shape;
+			/// <summary>The color that the object is outlined with.</summary>
+			graphics::Color outline_color;
+			/// <summary>The color that the object is filled with.</summary>
+			graphics::Color fill_color;
+			/// <summary>The object's unscaled width in game coordinates.</summary>
+			double gwidth;
+			/// <summary>The object's unscaled height in game coordinates.</summary>
+			double gheight;
+			/// <summary>The amount by which the object's sprite has been scaled.</summary>
+			float scale_factor {1.f};
 		};
 	}
 }
\ No newline at end of file
@@ -30,6 +30,18 @@ namespace hoffman_isaiah {
 			graphics::shapes::ShapeTypes getShape() const noexcept {
 				return this->shape;
 			}
+			/// <returns>The dense identifier assigned to the type when it was loaded or -1
+			/// if no identifier has been assigned.</returns>
+			int getTypeId() const noexcept {
+				return this->type_id;
+			}
+			// Setters
+			/// <summary>Assigns the type's identifier. (This should only be called while loading
+			/// the type from its data file.)</summary>
+			/// <param name="id">The identifier obtained from interning the type's name.</param>
+			void setTypeId(int id) noexcept {
+				this->type_id = id;
+			}
 		protected:
 			GameObjectType(std::wstring n, std::wstring d, graphics::Color c, graphics::shapes::ShapeTypes st) :
 				name {n},
@@ -46,6 +58,8 @@ namespace hoffman_isaiah {
 			graphics::Color color;
 			/// <summary>The default shape to use for the object.</summary>
 			graphics::shapes::ShapeTypes shape;
+			/// <summary>The identifier of the type. (Types of the same kind have distinct identifiers.)</summary>
+			int type_id {-1};
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,291 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./../async_file_writer.hpp"
+#include "./../file_util.hpp"
+#include "./../globals.hpp"
+#include "./../resource.h"
+#include "./../graphics/graphics.hpp"
+#include "./../pathfinding/grid.hpp"
+#include "./../pathfinding/pathfinder.hpp"
+#include "./my_game.hpp"
+#include "./tower.hpp"
+#include "./tower_types.hpp"
+
+namespace hoffman_isaiah {
+	namespace game {
+		namespace {
+			/// <summary>The magic number that begins every binary save file ("TDSV").</summary>
+			constexpr const std::uint32_t save_file_magic = 0x56534454U;
+			/// <summary>The current format version of binary save files. Sections may be added
+			/// without changing this, but the layout of existing sections may not.</summary>
+			constexpr const std::uint32_t save_file_version = 1U;
+
+			/// <summary>Identifies each section of a binary save file. Sections that the loader
+			/// does not recognize are skipped.</summary>
+			enum class SaveSections : std::uint32_t {
+				State = 1, Map_Name = 2, Terrain = 3, Influence = 4, Highlights = 5, Towers = 6, Enemies_Seen = 7
+			};
+
+			/// <param name="sections">The sections that were found in the save file.</param>
+			/// <param name="id">The section to find.</param>
+			/// <returns>A reader positioned at the start of the requested section.</returns>
+			util::file::BinaryReader& getSection(std::map<std::uint32_t, util::file::BinaryReader>& sections, SaveSections id) {
+				const auto my_section = sections.find(static_cast<std::uint32_t>(id));
+				if (my_section == sections.end()) {
+					throw util::file::DataFileException {L"The save file is missing a required section.", 0};
+				}
+				return my_section->second;
+			}
+
+			/// <param name="sections">The sections that were found in the save file.</param>
+			/// <param name="id">The section to look for.</param>
+			/// <returns>True if the save file contains the given section.</returns>
+			bool hasSection(const std::map<std::uint32_t, util::file::BinaryReader>& sections, SaveSections id) {
+				return sections.count(static_cast<std::uint32_t>(id)) > 0;
+			}
+		}
+
+		bool MyGame::saveGameFile(const std::wstring& file_name) const {
+			if (this->isInLevel()) {
+				// Cannot save during levels.
+				return false;
+			}
+			// (This goes through the background writer so that it cannot race with an
+			// autosave to the same file.)
+			this->save_writer->queueWrite(file_name, this->writeBinarySave());
+			return this->flushSaves();
+		}
+
+		bool MyGame::autosaveGame() const {
+			if (this->isInLevel() || this->isHeadless()) {
+				return false;
+			}
+			this->save_writer->queueWrite(this->getUserDataPath() + game::default_save_file_name,
+				this->writeBinarySave());
+			return true;
+		}
+
+		bool MyGame::flushSaves() const {
+			return this->save_writer->flush();
+		}
+
+		std::vector<std::wstring> MyGame::takeFailedSaves() const {
+			return this->save_writer->takeFailedWrites();
+		}
+
+		bool MyGame::loadGameFile(const std::wstring& file_name) {
+			// Make sure that the newest save is read rather than one that is partly written.
+			// (Any failed saves are left for the user interface to report.)
+			this->save_writer->waitForWrites();
+			std::vector<char> contents {};
+			if (!util::file::readWholeFile(file_name, contents)) {
+				return false;
+			}
+			std::uint32_t magic {0};
+			if (contents.size() >= sizeof(magic)) {
+				std::memcpy(&magic, contents.data(), sizeof(magic));
+			}
+			if (magic == save_file_magic) {
+				this->readBinarySave(contents.data(), contents.size());
+			}
+			else {
+				// Saves made before the binary format existed are text, which can still be
+				// imported. (They are converted the next time the game is saved.)
+				std::wistringstream save_file {std::wstring {contents.begin(), contents.end()}};
+				this->loadGame(save_file);
+			}
+			return true;
+		}
+
+		std::vector<char> MyGame::writeBinarySave() const {
+			// Each section is built separately so that its size is known before the
+			// section table is written.
+			std::vector<std::pair<std::uint32_t, util::file::BinaryWriter>> sections {};
+			const auto add_section = [&sections](SaveSections id, util::file::BinaryWriter&& section) {
+				sections.emplace_back(static_cast<std::uint32_t>(id), std::move(section));
+			};
+			// Player state
+			util::file::BinaryWriter state {};
+			state.writeSignedVarint(this->challenge_level);
+			state.writeSignedVarint(this->level);
+			state.writeSignedVarint(this->lose_streak);
+			state.writeSignedVarint(this->win_streak);
+			state.writeSignedVarint(this->player.getHealth());
+			state.write(this->difficulty);
+			state.write(this->hp_buy_cost);
+			state.write(this->player.getMoney());
+			add_section(SaveSections::State, std::move(state));
+			// Map name (mainly for the terrain editor rather than the game itself.)
+			util::file::BinaryWriter map_name {};
+			map_name.writeString(this->map_base_name);
+			add_section(SaveSections::Map_Name, std::move(map_name));
+			// Terrain and influence maps
+			util::file::BinaryWriter terrain {};
+			pathfinding::writeGrid(terrain, this->getMap().getTerrainGraph(false));
+			pathfinding::writeGrid(terrain, this->getMap().getTerrainGraph(true));
+			add_section(SaveSections::Terrain, std::move(terrain));
+			util::file::BinaryWriter influence {};
+			pathfinding::writeGrid(influence, this->getMap().getInfluenceGraph(false));
+			pathfinding::writeGrid(influence, this->getMap().getInfluenceGraph(true));
+			add_section(SaveSections::Influence, std::move(influence));
+			// Marked tiles are stored as the lengths of alternating runs of unmarked
+			// and marked tiles (in row-major order), starting with unmarked tiles.
+			const auto& highlight_graph = this->getMap().getHighlightGraph();
+			util::file::BinaryWriter highlights {};
+			highlights.writeVarint(static_cast<std::uint64_t>(highlight_graph.getRows()));
+			highlights.writeVarint(static_cast<std::uint64_t>(highlight_graph.getColumns()));
+			bool run_marked {false};
+			std::uint64_t run_length {0};
+			for (int i = 0; i < highlight_graph.getRows(); ++i) {
+				for (int j = 0; j < highlight_graph.getColumns(); ++j) {
+					if (highlight_graph.getNode(j, i).isBlocked() != run_marked) {
+						highlights.writeVarint(run_length);
+						run_marked = !run_marked;
+						run_length = 0;
+					}
+					++run_length;
+				}
+			}
+			highlights.writeVarint(run_length);
+			add_section(SaveSections::Highlights, std::move(highlights));
+			// Towers
+			util::file::BinaryWriter my_towers {};
+			my_towers.writeVarint(this->towers.size());
+			for (const auto& t : this->towers) {
+				my_towers.writeString(t->getBaseType()->getName());
+				my_towers.write(t->getGameX());
+				my_towers.write(t->getGameY());
+				my_towers.writeSignedVarint(t->getLevel());
+				my_towers.writeVarint(t->getUpgradePath());
+			}
+			add_section(SaveSections::Towers, std::move(my_towers));
+			// Seen enemies
+			util::file::BinaryWriter seen_enemies {};
+			std::uint64_t seen_count {0};
+			for (int i = 0; i < this->enemy_type_ids.size(); ++i) {
+				if (this->enemies_seen[i]) {
+					++seen_count;
+				}
+			}
+			seen_enemies.writeVarint(seen_count);
+			for (int i = 0; i < this->enemy_type_ids.size(); ++i) {
+				if (this->enemies_seen[i]) {
+					seen_enemies.writeString(this->enemy_type_ids.getName(i));
+					seen_enemies.writeSignedVarint(this->enemy_kill_count[i]);
+				}
+			}
+			add_section(SaveSections::Enemies_Seen, std::move(seen_enemies));
+			return util::file::buildSectionedFile(save_file_magic, save_file_version, sections);
+		}
+
+		void MyGame::readBinarySave(const char* data, std::size_t size) {
+			// Each section is read in place from the file's buffer.
+			auto sections = util::file::readSectionedFile(data, size, save_file_magic, save_file_version);
+			// Player state
+			auto& state = getSection(sections, SaveSections::State);
+			this->challenge_level = static_cast<int>(state.readSignedVarint());
+			this->level = static_cast<int>(state.readSignedVarint());
+			this->lose_streak = static_cast<int>(state.readSignedVarint());
+			this->win_streak = static_cast<int>(state.readSignedVarint());
+			const auto player_health = static_cast<int>(state.readSignedVarint());
+			this->difficulty = state.read<double>();
+			this->hp_buy_cost = state.read<double>();
+			this->player = Player {state.read<double>(), player_health};
+			// Map name
+			this->map_base_name = getSection(sections, SaveSections::Map_Name).readString();
+			if (MyGame::getDefaultMapName(this->getChallengeLevel() + ID_CHALLENGE_LEVEL_EASY) != this->getMapBaseName()) {
+				this->setGameType(true);
+			}
+			// Terrain map
+			auto& terrain = getSection(sections, SaveSections::Terrain);
+			auto my_gterrain = std::make_unique<pathfinding::Grid>();
+			auto my_aterrain = std::make_unique<pathfinding::Grid>();
+			pathfinding::readGrid(terrain, *my_gterrain);
+			pathfinding::readGrid(terrain, *my_aterrain);
+			if (my_gterrain->getRows() != my_aterrain->getRows() || my_gterrain->getColumns() != my_aterrain->getColumns()) {
+				throw util::file::DataFileException {L"The ground and air terrain maps in the save file differ in size.", 0};
+			}
+			this->map = std::make_shared<game::GameMap>(std::move(my_gterrain), std::move(my_aterrain));
+			// Note that above move invalidates the test paths.
+			this->ground_test_pf = std::make_shared<pathfinding::Pathfinder>(this->getMap(), false,
+				false, pathfinding::HeuristicStrategies::Manhattan);
+			this->air_test_pf = std::make_shared<pathfinding::Pathfinder>(this->getMap(), true,
+				false, pathfinding::HeuristicStrategies::Manhattan);
+			// Influence map
+			if (hasSection(sections, SaveSections::Influence)) {
+				auto& influence = getSection(sections, SaveSections::Influence);
+				pathfinding::Grid ground_influence_map {};
+				pathfinding::Grid air_influence_map {};
+				pathfinding::readGrid(influence, ground_influence_map);
+				pathfinding::readGrid(influence, air_influence_map);
+				this->map->setInfluenceGraphs(ground_influence_map, air_influence_map);
+			}
+			// Marked tiles
+			if (hasSection(sections, SaveSections::Highlights)) {
+				auto& highlights = getSection(sections, SaveSections::Highlights);
+				const auto highlight_rows = highlights.readVarint();
+				const auto highlight_cols = highlights.readVarint();
+				if (highlight_rows != static_cast<std::uint64_t>(this->map->getRows())
+					|| highlight_cols != static_cast<std::uint64_t>(this->map->getColumns())) {
+					throw util::file::DataFileException {L"The marked tiles in the save file do not match the map.", 0};
+				}
+				const auto tile_count = highlight_rows * highlight_cols;
+				std::uint64_t tile {0};
+				bool run_marked {false};
+				while (tile < tile_count) {
+					const auto run_length = highlights.readVarint();
+					if (run_length > tile_count - tile) {
+						throw util::file::DataFileException {L"Invalid run length in the marked tiles of the save file.", 0};
+					}
+					if (run_marked) {
+						for (auto i = tile; i < tile + run_length; ++i) {
+							this->map->getHighlightGraph().setBlockage(static_cast<int>(i % highlight_cols),
+								static_cast<int>(i / highlight_cols), true);
+						}
+					}
+					tile += run_length;
+					run_marked = !run_marked;
+				}
+			}
+			// Towers
+			if (hasSection(sections, SaveSections::Towers)) {
+				auto& my_towers = getSection(sections, SaveSections::Towers);
+				const auto tower_count = my_towers.readVarint();
+				for (std::uint64_t i = 0; i < tower_count; ++i) {
+					const auto tower_name = my_towers.readString();
+					const auto tower_gx = my_towers.read<double>();
+					const auto tower_gy = my_towers.read<double>();
+					const auto tower_lv = static_cast<int>(my_towers.readSignedVarint());
+					const auto tower_path = static_cast<unsigned int>(my_towers.readVarint());
+					if (!this->getMap().getTerrainGraph(false).verifyCoordinates(tower_gx, tower_gy)) {
+						throw util::file::DataFileException {L"A tower in the save file is outside of the map.", 0};
+					}
+					this->restoreTower(tower_name, tower_gx, tower_gy, tower_lv, tower_path);
+				}
+			}
+			// Seen enemies
+			if (hasSection(sections, SaveSections::Enemies_Seen)) {
+				auto& seen_enemies = getSection(sections, SaveSections::Enemies_Seen);
+				const auto seen_count = seen_enemies.readVarint();
+				for (std::uint64_t i = 0; i < seen_count; ++i) {
+					const auto enemy_name = seen_enemies.readString();
+					const auto kill_count = static_cast<long long>(seen_enemies.readSignedVarint());
+					// Enemy types that no longer exist are ignored.
+					const int enemy_id = this->enemy_type_ids.find(enemy_name);
+					if (enemy_id >= 0) {
+						this->enemies_seen[enemy_id] = true;
+						this->enemy_kill_count[enemy_id] = kill_count;
+					}
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 // File Author: Isaiah Hoffman
 // File Created: April 14, 2018
+#include <cstdint>
 #include <random>
 #include "./game_util.hpp"
 namespace hoffman_isaiah {
@@ -12,6 +13,11 @@ namespace hoffman_isaiah {
 			thread_local std::mt19937 gen {rd()};
 #endif
 			thread_local std::uniform_real_distribution<double> distro_uniform {};
+
+			void seed(std::uint64_t new_seed) {
+				gen.seed(static_cast<decltype(gen)::result_type>(new_seed));
+				distro_uniform.reset();
+			}
 		}
 	}
 }
\ No newline at end of file
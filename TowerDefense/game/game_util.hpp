@@ -1,6 +1,7 @@
 #pragma once
 // File Author: Isaiah Hoffman
 // File Created: April 14, 2018
+#include <cstdint>
 #include <random>
 
 namespace hoffman_isaiah {
@@ -16,6 +17,18 @@ namespace hoffman_isaiah {
 #endif
 			/// <summary>An integer distribution that gives values from 1 to 100 uniformly.</summary>
 			extern thread_local std::uniform_real_distribution<double> distro_uniform;
+			/// <summary>Restarts the random numbers of the calling thread from a seed, so that the
+			/// same sequence of calls gives the same numbers again.</summary>
+			/// <param name="new_seed">The seed to restart from.</param>
+			void seed(std::uint64_t new_seed);
+			/// <summary>Spreads out the bits of a number so that nearby inputs give unrelated outputs.
+			/// (This is SplitMix64, which is useful for deriving many seeds from one.)</summary>
+			constexpr std::uint64_t mixBits(std::uint64_t x) noexcept {
+				x += 0x9E3779B97F4A7C15ULL;
+				x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+				x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+				return x ^ (x >> 31);
+			}
 		}
 
 		/// <summary>Represents a normally distributed random variable.</summary>
@@ -25,21 +38,28 @@ namespace hoffman_isaiah {
 			/// <param name="sigma">The standard deviation of the random variable.</param>
 			NormalRandomVariable(double mu, double sigma) :
 				mean {mu},
-				standard_deviation {sigma},
-				distro_normal {mu, sigma} {
+				standard_deviation {sigma} {
 			}
 
 			/// <returns>A random normally distributed value as specified by this class's data.</returns>
 			double operator()() const noexcept {
-				return this->distro_normal(rng::gen);
+				// (A new distribution is used each time since distributions carry state between
+				// calls, and the level generator may be shared by games running on other threads.)
+				std::normal_distribution<double> distro_normal {this->mean, this->standard_deviation};
+				return distro_normal(rng::gen);
+			}
+			// Getters
+			double getMean() const noexcept {
+				return this->mean;
+			}
+			double getStandardDeviation() const noexcept {
+				return this->standard_deviation;
 			}
 		private:
 			/// <summary>The mean of the random variable.</summary>
 			double mean;
 			/// <summary>The standard deviation of the random variable.</summary>
 			double standard_deviation;
-			/// <summary>The normal distribution associated with the random variable.</summary>
-			mutable std::normal_distribution<double> distro_normal;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,383 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "./../async_file_writer.hpp"
+#include "./../file_util.hpp"
+#include "./../globals.hpp"
+#include "./../resource_pack.hpp"
+#include "./../pathfinding/grid.hpp"
+#include "./../pathfinding/pathfinder.hpp"
+#include "./balance_runner.hpp"
+#include "./game_util.hpp"
+#include "./layout_optimizer.hpp"
+#include "./my_game.hpp"
+#include "./simulation_host.hpp"
+#include "./tower_types.hpp"
+using namespace std::literals::string_literals;
+
+namespace hoffman_isaiah {
+	namespace game {
+		namespace {
+			/// <returns>A hash of a layout that identifies it among the layouts of a map.</returns>
+			std::uint64_t hashLayout(const PlacementScript& layout) {
+				const std::wstring my_text = writePlacementScript(layout);
+				return util::file::hashBytes(reinterpret_cast<const char*>(my_text.data()),
+					my_text.size() * sizeof(wchar_t));
+			}
+
+			/// <summary>Writes text to a file (as UTF-8) in one go.</summary>
+			/// <returns>False if the file could not be written.</returns>
+			bool writeTextFile(const std::wstring& file_name, const std::wstring& text) {
+				return util::file::writeFileAtomically(file_name, util::file::encodeUtf8(text));
+			}
+		}
+
+		OptimizerSettings parseOptimizerSettings(std::wstring file_contents) {
+			util::file::DataFileParser my_parser {std::move(file_contents)};
+			OptimizerSettings my_settings {};
+			my_parser.expectToken(util::file::TokenTypes::Section, L"global"s);
+#pragma warning(push)
+#pragma warning(disable: 26444) // ES84: Avoid unnamed objects with custom construction/destruction. (No Idea...)
+			my_parser.readKeyValue(L"version"s);
+			my_parser.expectToken(util::file::TokenTypes::Number, L"1"s);
+			my_parser.readKeyValue(L"maps"s);
+			my_settings.maps = my_parser.readList();
+			if (my_settings.maps.empty()) {
+				throw util::file::DataFileException {L"At least one map must be listed."s, my_parser.getLine()};
+			}
+			my_parser.readKeyValue(L"towers"s);
+			my_settings.towers = my_parser.readList();
+			if (my_settings.towers.empty()) {
+				throw util::file::DataFileException {L"At least one tower must be listed."s, my_parser.getLine()};
+			}
+			my_parser.readKeyValue(L"beam_width"s);
+			my_settings.beam_width = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.beam_width, 1,
+				L"Beam width"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"children_per_layout"s);
+			my_settings.children_per_layout = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.children_per_layout, 1,
+				L"Children per layout"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"rounds"s);
+			my_settings.rounds = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.rounds, 1,
+				L"Rounds"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"games_per_layout"s);
+			my_settings.games_per_layout = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.games_per_layout, 1,
+				L"Games per layout"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"target_level"s);
+			my_settings.target_level = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.target_level, 1,
+				L"Target level"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"spot_radius"s);
+			my_settings.spot_radius = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.spot_radius, 0,
+				L"Spot radius"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"early_stop_margin"s);
+			my_settings.early_stop_margin = my_parser.parseNumber<double>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.early_stop_margin, 0.0,
+				L"Early stop margin"s, my_parser.getLine(), true);
+			my_parser.readKeyValue(L"base_seed"s);
+			my_settings.base_seed = my_parser.parseNumber<int>();
+			my_parser.readKeyValue(L"max_level_ticks"s);
+			my_settings.max_level_ticks = my_parser.parseNumber<int>();
+			util::file::DataFileParser::validateNumberMinBound(my_settings.max_level_ticks, 1,
+				L"Maximum level ticks"s, my_parser.getLine(), true);
+#pragma warning(pop)
+			return my_settings;
+		}
+
+		double getLayoutGameScore(const BalanceGameResult& my_result) noexcept {
+			const auto levels_won = std::count_if(my_result.levels.cbegin(), my_result.levels.cend(),
+				[](const LevelOutcome& my_level) {
+				return my_level.won;
+			});
+			const double health_fraction = my_result.starting_health > 0
+				? static_cast<double>(my_result.health_left) / my_result.starting_health : 0.0;
+			return static_cast<double>(levels_won) + std::clamp(health_fraction, 0.0, 1.0);
+		}
+
+		LayoutOptimizer::LayoutOptimizer(MyGame& game) :
+			my_game {game},
+			my_host {game} {
+			const auto& my_resources = this->my_game.getResources();
+			util::file::ResourceView settings_file {};
+			if (!my_resources.getResource(optimizer_settings_file_name, settings_file)) {
+				throw util::file::DataFileException {L"Could not load the layout optimizer's settings (resources/"s
+					+ optimizer_settings_file_name + L")."s, 0};
+			}
+			this->settings = parseOptimizerSettings(settings_file.toWideString());
+			// Each map is played on the same challenge level as in balance sweeps.
+			for (const auto& map_name : this->settings.maps) {
+				const std::wstring script_name = L"balance/"s + map_name + L".ini"s;
+				util::file::ResourceView script_file {};
+				if (!my_resources.getResource(script_name, script_file)) {
+					throw util::file::DataFileException {L"Could not load the placement script for the "s
+						+ map_name + L" map (resources/"s + script_name + L")."s, 0};
+				}
+				this->challenge_levels.emplace_back(parsePlacementScript(script_file.toWideString()).challenge_level);
+			}
+			const auto& tower_types = this->my_game.getAllTowerTypes();
+			for (const auto& tower_name : this->settings.towers) {
+				const auto my_type = std::find_if(tower_types.cbegin(), tower_types.cend(), [&tower_name](const auto& t) {
+					return t->getName() == tower_name;
+				});
+				if (my_type == tower_types.cend()) {
+					throw util::file::DataFileException {L"The layout optimizer lists a tower that does not exist: "s
+						+ tower_name + L"."s, 0};
+				}
+				this->tower_type_ids.emplace_back(static_cast<int>(my_type - tower_types.cbegin()));
+			}
+			this->search_gen.seed(rng::mixBits(static_cast<std::uint32_t>(this->settings.base_seed)));
+		}
+
+		bool LayoutOptimizer::optimize() {
+			std::error_code ec {};
+			std::filesystem::create_directories(this->my_game.getUserDataPath() + optimizer_output_folder, ec);
+			std::wstring my_report = L"map,round,candidates,played,stopped_early,failed,best_score,"
+				L"weakest_kept_score,best_steps\n"s;
+			bool succeeded = true;
+			for (int i = 0; i < static_cast<int>(this->settings.maps.size()); ++i) {
+				succeeded = this->optimizeMap(i, my_report) && succeeded;
+			}
+			return succeeded;
+		}
+
+		bool LayoutOptimizer::optimizeMap(int map_index, std::wstring& report) {
+			const auto& map_name = this->settings.maps[map_index];
+			this->my_game.resetState(this->challenge_levels[map_index], map_name);
+			if (this->my_game.getMapBaseName() != map_name) {
+				throw util::file::DataFileException {L"Could not load the "s + map_name + L" map."s, 0};
+			}
+			// Better layouts come first. (Ties go to the layout with fewer steps.)
+			const auto is_better = [](const ScoredLayout& a, const ScoredLayout& b) {
+				return a.getScore() > b.getScore()
+					|| (a.getScore() == b.getScore() && a.layout.steps.size() < b.layout.steps.size());
+			};
+			PlacementScript empty_layout {};
+			empty_layout.map_name = map_name;
+			empty_layout.challenge_level = this->challenge_levels[map_index];
+			empty_layout.last_level = this->settings.target_level;
+			std::unordered_set<std::uint64_t> seen_layouts {hashLayout(empty_layout)};
+			int failed_count = 0;
+			auto beam = this->playCandidates(map_name, {empty_layout}, {}, failed_count);
+			if (beam.empty()) {
+				return false;
+			}
+			bool succeeded = true;
+			for (int round = 1; round <= this->settings.rounds; ++round) {
+				std::vector<PlacementScript> candidates {};
+				for (const auto& parent : beam) {
+					auto children = this->expandLayout(parent, seen_layouts);
+					std::move(children.begin(), children.end(), std::back_inserter(candidates));
+				}
+				if (candidates.empty()) {
+					break;
+				}
+				// Only layouts that could displace the weakest kept layout are worth playing fully.
+				const auto cutoff_scores = static_cast<int>(beam.size()) >= this->settings.beam_width
+					? beam.back().game_scores : std::vector<double> {};
+				auto scored_candidates = this->playCandidates(map_name, candidates, cutoff_scores, failed_count);
+				const int played_count = static_cast<int>(scored_candidates.size());
+				succeeded = succeeded && failed_count == 0;
+				std::move(scored_candidates.begin(), scored_candidates.end(), std::back_inserter(beam));
+				std::stable_sort(beam.begin(), beam.end(), is_better);
+				if (static_cast<int>(beam.size()) > this->settings.beam_width) {
+					beam.resize(this->settings.beam_width);
+				}
+				std::wostringstream my_row {};
+				my_row << map_name << L"," << round << L"," << candidates.size() << L"," << played_count << L","
+					<< candidates.size() - played_count - failed_count << L"," << failed_count << L","
+					<< std::fixed << std::setprecision(3) << beam.front().getScore() << L"," << beam.back().getScore()
+					<< L"," << beam.front().layout.steps.size() << L"\n";
+				report += my_row.str();
+				// (Both files are rewritten every round so that long searches can be checked on.)
+				writeTextFile(this->getOutputFileName(L"report.csv"s), report);
+				writeTextFile(this->getOutputFileName(map_name + L".ini"s), writePlacementScript(beam.front().layout));
+			}
+			return succeeded;
+		}
+
+		std::vector<PlacementScript> LayoutOptimizer::expandLayout(const ScoredLayout& parent,
+			std::unordered_set<std::uint64_t>& seen_layouts) {
+			// New steps are bought between the parent's last step and the level that it tends to lose on.
+			const int first_level = parent.layout.steps.empty() ? 1 : parent.layout.steps.back().level;
+			const int losing_level = std::clamp(static_cast<int>(parent.getScore()) + 1, first_level,
+				std::max(this->settings.target_level, first_level));
+			std::uniform_int_distribution<int> level_distro {first_level, losing_level};
+			// Find the upgrades that the parent's towers could take next.
+			std::map<std::pair<int, int>, std::pair<const TowerType*, int>> tower_levels {};
+			for (const auto& my_step : parent.layout.steps) {
+				if (my_step.upgrade_option == 0) {
+					const auto& tower_types = this->my_game.getAllTowerTypes();
+					const auto my_type = std::find_if(tower_types.cbegin(), tower_types.cend(), [&my_step](const auto& t) {
+						return t->getName() == my_step.tower_name;
+					});
+					if (my_type != tower_types.cend()) {
+						tower_levels[{my_step.gx, my_step.gy}] = {my_type->get(), 1};
+					}
+				}
+				else {
+					const auto my_tower = tower_levels.find({my_step.gx, my_step.gy});
+					if (my_tower != tower_levels.end()) {
+						++my_tower->second.second;
+					}
+				}
+			}
+			std::vector<std::tuple<int, int, int>> upgrade_choices {};
+			for (const auto& [my_square, my_tower] : tower_levels) {
+				for (const auto& upgrade : my_tower.first->getUpgrades()) {
+					if (upgrade.getLevel() == my_tower.second + 1) {
+						upgrade_choices.emplace_back(my_square.first, my_square.second,
+							upgrade.getOption() == TowerUpgradeOption::One ? 1 : 2);
+					}
+				}
+			}
+			// Squares are tried in a random order, and squares where a tower cannot be built
+			// are thrown out before anything is played.
+			this->setLayoutBlockage(parent.layout, true);
+			auto my_spots = this->getSpotsNearPaths();
+			std::shuffle(my_spots.begin(), my_spots.end(), this->search_gen);
+			std::size_t next_spot = 0;
+			std::vector<PlacementScript> children {};
+			std::uniform_int_distribution<std::size_t> tower_distro {0, this->tower_type_ids.size() - 1};
+			std::bernoulli_distribution upgrade_distro {1.0 / 3.0};
+			// (A few extra attempts make up for children that turn out to have been seen before.)
+			for (int attempt = 0; attempt < this->settings.children_per_layout * 2
+				&& static_cast<int>(children.size()) < this->settings.children_per_layout; ++attempt) {
+				PlacementStep my_step {};
+				my_step.level = level_distro(this->search_gen);
+				if (!upgrade_choices.empty() && upgrade_distro(this->search_gen)) {
+					std::uniform_int_distribution<std::size_t> choice_distro {0, upgrade_choices.size() - 1};
+					std::tie(my_step.gx, my_step.gy, my_step.upgrade_option) = upgrade_choices[choice_distro(this->search_gen)];
+				}
+				else {
+					while (next_spot < my_spots.size()
+						&& !this->my_game.canBuildTower(my_spots[next_spot].first, my_spots[next_spot].second)) {
+						++next_spot;
+					}
+					if (next_spot >= my_spots.size()) {
+						continue;
+					}
+					my_step.tower_name = this->my_game.getTowerType(this->tower_type_ids[tower_distro(this->search_gen)])->getName();
+					std::tie(my_step.gx, my_step.gy) = my_spots[next_spot++];
+				}
+				PlacementScript my_child = parent.layout;
+				my_child.steps.emplace_back(std::move(my_step));
+				if (seen_layouts.insert(hashLayout(my_child)).second) {
+					children.emplace_back(std::move(my_child));
+				}
+			}
+			this->setLayoutBlockage(parent.layout, false);
+			return children;
+		}
+
+		std::vector<ScoredLayout> LayoutOptimizer::playCandidates(const std::wstring& map_name,
+			const std::vector<PlacementScript>& candidates, const std::vector<double>& cutoff_scores,
+			int& failed_count) {
+			std::vector<std::vector<double>> candidate_scores(candidates.size());
+			failed_count = this->my_host.runJobs(static_cast<int>(candidates.size()),
+				[this, &candidates, &cutoff_scores, &candidate_scores](MyGame& game, int job) {
+				candidate_scores[job] = this->playLayout(game, candidates[job], cutoff_scores);
+				return true;
+			});
+			// (The results are gathered in the order of the candidates so that the search does not
+			// depend on which session finished first.)
+			std::vector<ScoredLayout> scored_layouts {};
+			for (std::size_t i = 0; i < candidates.size(); ++i) {
+				if (static_cast<int>(candidate_scores[i].size()) == this->settings.games_per_layout) {
+					scored_layouts.emplace_back(ScoredLayout {candidates[i], std::move(candidate_scores[i])});
+					scored_layouts.back().layout.map_name = map_name;
+				}
+			}
+			return scored_layouts;
+		}
+
+		std::vector<double> LayoutOptimizer::playLayout(MyGame& game, const PlacementScript& layout,
+			const std::vector<double>& cutoff_scores) const {
+			std::vector<double> game_scores {};
+			double total_score = 0.0;
+			double cutoff_total = 0.0;
+			for (int i = 0; i < this->settings.games_per_layout; ++i) {
+				const auto my_result = playPlacementScript(game, layout, this->getGameSeed(i),
+					this->settings.max_level_ticks);
+				game_scores.emplace_back(getLayoutGameScore(my_result));
+				if (i >= static_cast<int>(cutoff_scores.size())) {
+					continue;
+				}
+				// Every layout plays the same seeds, so each game can be compared with the same game
+				// of the weakest kept layout. A layout that has fallen far enough behind is clearly losing.
+				total_score += game_scores.back();
+				cutoff_total += cutoff_scores[i];
+				if (total_score + this->settings.early_stop_margin < cutoff_total) {
+					break;
+				}
+			}
+			return game_scores;
+		}
+
+		void LayoutOptimizer::setLayoutBlockage(const PlacementScript& layout, bool blocked) {
+			for (const auto& my_step : layout.steps) {
+				if (my_step.upgrade_option == 0
+					&& this->my_game.getMap().getTerrainGraph(false).verifyCoordinates(my_step.gx, my_step.gy)) {
+					this->my_game.getMap().getFiterGraph(false).getNode(my_step.gx, my_step.gy).setBlockage(blocked);
+					this->my_game.getMap().getFiterGraph(true).getNode(my_step.gx, my_step.gy).setBlockage(blocked);
+				}
+			}
+		}
+
+		std::vector<std::pair<int, int>> LayoutOptimizer::getSpotsNearPaths() const {
+			const auto& my_map = this->my_game.getMap();
+			const int columns = my_map.getTerrainGraph(false).getColumns();
+			const int rows = my_map.getTerrainGraph(false).getRows();
+			std::vector<bool> is_near_path(static_cast<std::size_t>(columns) * rows, false);
+			for (const bool find_air : {false, true}) {
+				pathfinding::Pathfinder my_pathfinder {my_map, find_air, false, pathfinding::HeuristicStrategies::Manhattan};
+				auto my_path = my_pathfinder.findPath(0.0);
+				for (; !my_path.empty(); my_path.pop()) {
+					const auto& my_node = my_path.front();
+					for (int gy = std::max(my_node.getGameY() - this->settings.spot_radius, 0);
+						gy <= std::min(my_node.getGameY() + this->settings.spot_radius, rows - 1); ++gy) {
+						for (int gx = std::max(my_node.getGameX() - this->settings.spot_radius, 0);
+							gx <= std::min(my_node.getGameX() + this->settings.spot_radius, columns - 1); ++gx) {
+							is_near_path[static_cast<std::size_t>(gy) * columns + gx] = true;
+						}
+					}
+				}
+			}
+			std::vector<std::pair<int, int>> my_spots {};
+			for (int gy = 0; gy < rows; ++gy) {
+				for (int gx = 0; gx < columns; ++gx) {
+					if (is_near_path[static_cast<std::size_t>(gy) * columns + gx]
+						&& !my_map.getFiterGraph(false).getNode(gx, gy).isBlocked()
+						&& !my_map.getTerrainGraph(false).getNode(gx, gy).isBlocked()) {
+						my_spots.emplace_back(gx, gy);
+					}
+				}
+			}
+			return my_spots;
+		}
+
+		std::uint64_t LayoutOptimizer::getGameSeed(int game_index) const noexcept {
+			return rng::mixBits(static_cast<std::uint64_t>(static_cast<std::uint32_t>(this->settings.base_seed)) << 32
+				| static_cast<std::uint32_t>(game_index));
+		}
+
+		std::wstring LayoutOptimizer::getOutputFileName(const std::wstring& file_name) const {
+			return this->my_game.getUserDataPath() + optimizer_output_folder + file_name;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "./balance_runner.hpp"
+#include "./simulation_host.hpp"
+
+namespace hoffman_isaiah {
+	namespace game {
+		// Forward declaration
+		class MyGame;
+
+		/// <summary>The name of the layout optimizer's settings file (relative to the resources folder).</summary>
+		constexpr const wchar_t* optimizer_settings_file_name = L"balance/optimizer.ini";
+		/// <summary>The folder (relative to the user data folder) that the layout optimizer's
+		/// report and best layouts are written to.</summary>
+		constexpr const wchar_t* optimizer_output_folder = L"optimizer/";
+
+		/// <summary>Controls how widely and how deeply the layout optimizer searches.</summary>
+		struct OptimizerSettings {
+			/// <summary>The base names of the maps to find layouts for. (Each map needs a placement
+			/// script, which provides the challenge level to play on.)</summary>
+			std::vector<std::wstring> maps {};
+			/// <summary>The names of the tower types that layouts may buy.</summary>
+			std::vector<std::wstring> towers {};
+			/// <summary>The number of layouts kept after each round.</summary>
+			int beam_width {8};
+			/// <summary>The number of new layouts tried for each kept layout in each round.</summary>
+			int children_per_layout {12};
+			/// <summary>The number of rounds to search for. (Each round adds a tower or an upgrade.)</summary>
+			int rounds {40};
+			/// <summary>The number of games (with different seeds) that each layout is played for.</summary>
+			int games_per_layout {4};
+			/// <summary>The level that layouts try to survive until. (Games that get this far are stopped.)</summary>
+			int target_level {120};
+			/// <summary>How far (in squares) from the enemies' paths new towers are placed.</summary>
+			int spot_radius {2};
+			/// <summary>How many levels a layout may trail the weakest kept layout by (in total over
+			/// the games played so far) before it stops being played.</summary>
+			double early_stop_margin {2.0};
+			/// <summary>The seed that the search and every game's seed are derived from.</summary>
+			int base_seed {0};
+			/// <summary>The number of logic ticks after which a level is given up on.</summary>
+			int max_level_ticks {216000};
+		};
+
+		/// <summary>A layout along with how well it did.</summary>
+		struct ScoredLayout {
+			/// <summary>The layout's towers and upgrades.</summary>
+			PlacementScript layout {};
+			/// <summary>The score of each game that was played in the order of their seeds. A game's
+			/// score is the number of levels survived plus the fraction of the player's health left.</summary>
+			std::vector<double> game_scores {};
+			/// <returns>The layout's average score.</returns>
+			double getScore() const noexcept {
+				double total = 0.0;
+				for (const auto score : this->game_scores) {
+					total += score;
+				}
+				return this->game_scores.empty() ? 0.0 : total / this->game_scores.size();
+			}
+		};
+
+		/// <param name="file_contents">The contents of the settings file.</param>
+		/// <returns>The settings that were read.</returns>
+		OptimizerSettings parseOptimizerSettings(std::wstring file_contents);
+		/// <param name="my_result">The results of a game.</param>
+		/// <returns>The game's score: the number of levels survived plus the fraction of the
+		/// player's health left.</returns>
+		double getLayoutGameScore(const BalanceGameResult& my_result) noexcept;
+
+		/// <summary>Searches for strong tower layouts for each map with a beam search. Each round,
+		/// every kept layout is extended with a random tower (placed near the enemies' paths) or
+		/// a random upgrade of one of its towers, and the best layouts are kept for the next round.
+		/// Placements that would block the enemies' paths are ruled out up front using the same
+		/// rule as buying a tower, so only legal layouts are ever played. Layouts are played at the
+		/// same time by the sessions of a simulation host with the same seeds, and a layout stops
+		/// being played once it falls clearly behind the weakest kept layout.</summary>
+		class LayoutOptimizer {
+		public:
+			/// <summary>Loads the optimizer's settings and each map's challenge level, and creates the
+			/// sessions that layouts are played with.</summary>
+			/// <param name="game">The game that candidates are checked against, whose type data and
+			/// levels are shared by the sessions. Its type data and levels must have been loaded.</param>
+			LayoutOptimizer(MyGame& game);
+			/// <summary>Searches for layouts for every map. The best layout found for each map is
+			/// written to the output folder as a placement script, along with a report of how each
+			/// round went.</summary>
+			/// <returns>False if any candidate failed to be played.</returns>
+			bool optimize();
+			/// <summary>Plays a layout for up to the configured number of games.</summary>
+			/// <param name="game">The game to play with.</param>
+			/// <param name="layout">The layout to play.</param>
+			/// <param name="cutoff_scores">The game scores of the weakest kept layout. (The layout
+			/// stops being played once it trails these by more than the early stop margin.) This may
+			/// be empty to play every game.</param>
+			/// <returns>The score of each game that was played.</returns>
+			std::vector<double> playLayout(MyGame& game, const PlacementScript& layout,
+				const std::vector<double>& cutoff_scores) const;
+			// Getters
+			const OptimizerSettings& getSettings() const noexcept {
+				return this->settings;
+			}
+		protected:
+			/// <summary>Searches for a layout for a single map.</summary>
+			/// <param name="map_index">The index of the map in the settings.</param>
+			/// <param name="report">The report that each round's results are added to.</param>
+			/// <returns>False if any candidate failed to be played.</returns>
+			bool optimizeMap(int map_index, std::wstring& report);
+			/// <summary>Creates new layouts by adding a tower or an upgrade to a kept layout.
+			/// Placements that would block the enemies' paths are never created.</summary>
+			/// <param name="parent">The layout to extend.</param>
+			/// <param name="seen_layouts">The hashes of every layout created so far. (New layouts
+			/// are added, and layouts that were created before are not created again.)</param>
+			/// <returns>The new layouts.</returns>
+			std::vector<PlacementScript> expandLayout(const ScoredLayout& parent,
+				std::unordered_set<std::uint64_t>& seen_layouts);
+			/// <summary>Plays layouts in parallel on the simulation host's sessions.</summary>
+			/// <param name="map_name">The name of the map that the layouts are for.</param>
+			/// <param name="candidates">The layouts to play.</param>
+			/// <param name="cutoff_scores">The game scores of the weakest kept layout.</param>
+			/// <param name="failed_count">Set to the number of candidates that failed to be played.</param>
+			/// <returns>The layouts that were played for every game. (Layouts that stopped early are left out.)</returns>
+			std::vector<ScoredLayout> playCandidates(const std::wstring& map_name,
+				const std::vector<PlacementScript>& candidates, const std::vector<double>& cutoff_scores,
+				int& failed_count);
+			/// <summary>Blocks or unblocks the squares of every tower that a layout buys.</summary>
+			void setLayoutBlockage(const PlacementScript& layout, bool blocked);
+			/// <returns>The squares that are near the paths that enemies currently take.</returns>
+			std::vector<std::pair<int, int>> getSpotsNearPaths() const;
+			/// <param name="game_index">The game's number.</param>
+			/// <returns>The seed of the game's random numbers. (Every layout uses the same seeds.)</returns>
+			std::uint64_t getGameSeed(int game_index) const noexcept;
+			/// <returns>The path of a file in the output folder.</returns>
+			std::wstring getOutputFileName(const std::wstring& file_name) const;
+		private:
+			/// <summary>The game that candidates are checked against.</summary>
+			MyGame& my_game;
+			/// <summary>Plays the layouts. (Its sessions share the type data of my_game.)</summary>
+			SimulationHost my_host;
+			/// <summary>The optimizer's settings.</summary>
+			OptimizerSettings settings {};
+			/// <summary>The challenge level to play each map on. (Indices match those of settings.maps.)</summary>
+			std::vector<int> challenge_levels {};
+			/// <summary>The indices of the tower types that layouts may buy.</summary>
+			std::vector<int> tower_type_ids {};
+			/// <summary>Makes the random choices of the search. (This is separate from the game's random
+			/// numbers so that the games do not affect the search and vice versa.)</summary>
+			std::mt19937_64 search_gen {};
+		};
+	}
+}
\ No newline at end of file
@@ -2,19 +2,28 @@
 // File Created: March 26, 2018
 #include "./../targetver.hpp"
 #include <Windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <future>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <iostream>
-#include <fstream>
 #include <thread>
 #include <utility>
 #include <vector>
 #include "./../resource.h"
+#include "./../async_file_writer.hpp"
 #include "./../file_util.hpp"
 #include "./../globals.hpp"
 #include "./../ih_math.hpp"
 #include "./../main.hpp"
+#include "./../perf_counters.hpp"
+#include "./../profiler.hpp"
+#include "./../resource_pack.hpp"
 #include "./../audio/audio.hpp"
 #include "./../graphics/graphics.hpp"
 #include "./../graphics/graphics_DX.hpp"
@@ -23,9 +32,11 @@
 #include "./../pathfinding/pathfinder.hpp"
 #include "./enemy_type.hpp"
 #include "./enemy.hpp"
+#include "./game_context.hpp"
 #include "./game_level.hpp"
 #include "./game_util.hpp"
 #include "./my_game.hpp"
+#include "./render_snapshot.hpp"
 #include "./shot_types.hpp"
 #include "./shot.hpp"
 #include "./status_effects.hpp"
@@ -40,7 +51,12 @@ namespace hoffman_isaiah {
 		MyGame::MyGame(graphics::DX::DeviceResources2D* dev_res) :
 			device_resources {dev_res},
 			highest_levels {{ID_CHALLENGE_LEVEL_EASY, 0}, {ID_CHALLENGE_LEVEL_NORMAL, 0},
-				{ID_CHALLENGE_LEVEL_HARD, 0}, {ID_CHALLENGE_LEVEL_EXPERT, 0}} {
+				{ID_CHALLENGE_LEVEL_HARD, 0}, {ID_CHALLENGE_LEVEL_EXPERT, 0}},
+			save_writer {std::make_unique<util::file::AsyncFileWriter>()},
+			perf_counters {std::make_unique<util::PerfCounterRegistry>()},
+			resources {std::make_unique<util::file::ResourcePack>(this->getResourceOverridesPath(),
+				this->resources_folder_path)} {
+			this->enemy_motion = std::make_unique<EnemyMotionBuffer>();
 		}
 
 		MyGame::~MyGame() noexcept = default;
@@ -78,33 +94,32 @@ namespace hoffman_isaiah {
 			this->enemies.clear();
 			this->towers.clear();
 			this->shots.clear();
-			for (auto& e_seen : this->enemies_seen) {
-				e_seen.second = false;
-			}
+			this->tower_coverage.clear();
+			this->enemies_by_tile.clear();
+			this->occupied_tiles.clear();
+			std::fill(this->enemies_seen.begin(), this->enemies_seen.end(), false);
 			this->is_paused = false;
 			this->in_level = false;
-			const auto air_terrain_filename_base = this->resources_folder_path + L"graphs/air_graph_";
-			const auto ground_terrain_filename_base = this->resources_folder_path + L"graphs/ground_graph_";
-			std::wifstream ground_terrain_file {ground_terrain_filename_base + map_name + L".txt"};
-			std::wifstream air_terrain_file {air_terrain_filename_base + map_name + L".txt"};
-			if (ground_terrain_file.good() && air_terrain_file.good()) {
-				this->map = std::make_shared<GameMap>(ground_terrain_file, air_terrain_file);
+			auto my_map = game::loadMapFile(this->getResources(), map_name);
+			if (my_map) {
+				this->map = std::move(my_map);
 				this->debugUpdate(DebugUpdateStates::Terrain_Changed);
 				this->setGameType(is_custom);
 				this->map_base_name = map_name;
 			}
 			else {
 				this->map_base_name = MyGame::getDefaultMapName(new_clevel + ID_CHALLENGE_LEVEL_EASY);
-				ground_terrain_file.open(ground_terrain_filename_base + this->getMapBaseName() + L".txt");
-				air_terrain_file.open(air_terrain_filename_base + this->getMapBaseName() + L".txt");
-				if (ground_terrain_file.good() && air_terrain_file.good()) {
-					MessageBox(nullptr, L"Warning: Specified map could not be found. Falling back to a default map.", L"Map Load Failed",
-						MB_OK | MB_ICONWARNING);
-					this->map = std::make_shared<GameMap>(ground_terrain_file, air_terrain_file);
+				my_map = game::loadMapFile(this->getResources(), this->getMapBaseName());
+				if (my_map) {
+					if (!this->headless) {
+						MessageBox(nullptr, L"Warning: Specified map could not be found. Falling back to a default map.", L"Map Load Failed",
+							MB_OK | MB_ICONWARNING);
+					}
+					this->map = std::move(my_map);
 					this->debugUpdate(DebugUpdateStates::Terrain_Changed);
 					this->setGameType(false);
 				}
-				else {
+				else if (!this->headless) {
 					MessageBox(nullptr, L"Map loading failed.", L"Map Load Failed", MB_OK | MB_ICONERROR);
 				}
 			}
@@ -119,21 +134,23 @@ namespace hoffman_isaiah {
 			if (this->is_paused || !this->in_level) {
 				return;
 			}
+			IH_PROFILE_FUNCTION();
 			if (!this->player.isAlive()) {
+				this->recordLevelPerformance(L"lost"s);
 				this->is_paused = true;
 				this->in_level = false;
 				// To prevent players from closing out and thus being able to replay the level.
-				const std::wstring save_name {this->getUserDataPath() + game::default_save_file_name};
-				std::wofstream my_save {save_name};
-				this->saveGame(my_save);
-				my_save.close();
-				std::wofstream my_game_stats {save_name + L".stats"};
-				for (const auto& estats : this->enemy_kill_count) {
-					if (this->enemies_seen.at(estats.first)) {
-						my_game_stats << estats.first << L": " << estats.second << L"\n";
+				this->autosaveGame();
+				std::wostringstream my_game_stats {};
+				for (int i = 0; i < this->enemy_type_ids.size(); ++i) {
+					if (this->enemies_seen[i]) {
+						my_game_stats << this->enemy_type_ids.getName(i) << L": " << this->enemy_kill_count[i] << L"\n";
 					}
 				}
-				my_game_stats.close();
+				if (!this->headless) {
+					this->save_writer->queueWrite(this->getUserDataPath() + game::default_save_file_name + L".stats"s,
+						my_game_stats.str());
+				}
 				// For integrity reasons, the stats of custom games are not tracked.
 				if (!this->in_custom_game) {
 					if (this->getLevelNumber() > 99) {
@@ -145,32 +162,37 @@ namespace hoffman_isaiah {
 					}
 				}
 				this->saveGlobalData();
-				audio::g_my_audio->playSong(audio::gameover_index);
+				this->playSong(audio::gameover_index);
 			}
 			// Do processing...
-			for (int k = 0; k < this->update_speed && this->in_level; ++k) {
+			const GameContext my_context {*this};
+			const int tick_count_this_update = this->max_speed ? 1 : this->update_speed;
+			for (int k = 0; k < tick_count_this_update && this->in_level; ++k) {
+				const auto tick_start = std::chrono::steady_clock::now();
+				++this->tick_count;
 				// Update level
 				if (this->my_level) {
-					this->my_level->update();
+					IH_PROFILE_SCOPE("Level update");
+					this->my_level->update(my_context);
 				}
 				// Update enemies
-				std::vector<std::future<bool>> ret_values {};
-				std::vector<int> enemies_to_remove {};
-				for (unsigned int i = 0; i < this->enemies.size(); ++i) {
-					// Here, we want a pointer to a member since the function we want to invoke
-					// is a class method.
-					//ret_values.push_back(std::async(&Enemy::update, this->enemies[i].get()));
-				}
-				for (unsigned int i = 0; i < this->enemies.size(); ++i) {
-					if (this->enemies[i]->update()) {
-					//if (ret_values.at(i).get()) {
-						if (this->enemies[i]->isAlive()) {
-							this->did_lose_life = true;
-							this->player.changeHealth(-this->enemies[i]->getBaseType().getDamage());
+				{
+					IH_PROFILE_SCOPE("Enemy update");
+					std::vector<int> enemies_to_remove {};
+					for (auto& e : this->enemies) {
+						e->update(my_context);
+					}
+					const auto& enemies_at_goal = this->advanceEnemies();
+					auto goal_iterator = enemies_at_goal.cbegin();
+					for (unsigned int i = 0; i < this->enemies.size(); ++i) {
+						const bool is_at_goal = goal_iterator != enemies_at_goal.cend()
+							&& *goal_iterator == static_cast<int>(i);
+						if (is_at_goal) {
+							++goal_iterator;
 						}
-						else {
+						if (!this->enemies[i]->isAlive()) {
 							++this->my_level_enemy_killed;
-							this->enemy_kill_count.at(this->enemies[i]->getBaseType().getName()) += 1;
+							++this->enemy_kill_count[this->enemies[i]->getBaseType().getTypeId()];
 							// Alter influence score on Experienced challenge level and higher
 							if (this->getChallengeLevel() >= ID_CHALLENGE_LEVEL_HARD - ID_CHALLENGE_LEVEL_EASY) {
 								auto& my_node = this->getMap().getInfluenceGraph(
@@ -179,35 +201,63 @@ namespace hoffman_isaiah {
 										static_cast<int>(std::floor(this->enemies[i]->getGameY())));
 								my_node.setWeight(my_node.getWeight() + 1);
 							}
+							enemies_to_remove.emplace_back(i);
+						}
+						else if (is_at_goal) {
+							this->did_lose_life = true;
+							this->player.changeHealth(-this->enemies[i]->getBaseType().getDamage());
+							enemies_to_remove.emplace_back(i);
 						}
-						enemies_to_remove.emplace_back(i);
 					}
-				}
-				for (unsigned int i = 0; i < enemies_to_remove.size(); ++i) {
-					// Remove dead/goal enemies (yes, the parenthesis are required...)
-					this->enemies.erase(this->enemies.begin() + (enemies_to_remove[i] - i));
+					for (unsigned int i = 0; i < enemies_to_remove.size(); ++i) {
+						// Remove dead/goal enemies (yes, the parenthesis are required...)
+						this->enemies.erase(this->enemies.begin() + (enemies_to_remove[i] - i));
+					}
 				}
 				// Update shots
-				std::vector<int> shots_to_remove {};
-				for (unsigned int i = 0; i < this->shots.size(); ++i) {
-					if (this->shots[i]->update(this->enemies)) {
-						shots_to_remove.emplace_back(i);
+				{
+					IH_PROFILE_SCOPE("Shot update");
+					std::vector<int> shots_to_remove {};
+					for (unsigned int i = 0; i < this->shots.size(); ++i) {
+						if (this->shots[i]->update(my_context, this->enemies)) {
+							shots_to_remove.emplace_back(i);
+						}
 					}
-				}
-				for (unsigned int i = 0; i < shots_to_remove.size(); ++i) {
-					// Remove shots that collided or that should otherwise be erased
-					this->shots.erase(this->shots.begin() + (shots_to_remove[i] - i));
+					for (unsigned int i = 0; i < shots_to_remove.size(); ++i) {
+						// Remove shots that collided or that should otherwise be erased
+						this->shots.erase(this->shots.begin() + (shots_to_remove[i] - i));
+					}
+					this->perf_counters->increment(util::PerfCounters::Shots_Destroyed,
+						static_cast<std::int64_t>(shots_to_remove.size()));
 				}
 				// Update towers
-				for (auto& t : this->towers) {
-					auto ret_value = t->update(this->enemies);
-					for (auto& s : ret_value) {
-						this->shots.emplace_back(std::move(s));
+				{
+					IH_PROFILE_SCOPE("Tower update");
+					this->updateEnemyTiles();
+					for (auto& t : this->towers) {
+						auto ret_value = t->update(my_context, this->enemies_by_tile);
+						this->perf_counters->increment(util::PerfCounters::Shots_Spawned,
+							static_cast<std::int64_t>(ret_value.size()));
+						for (auto& s : ret_value) {
+							this->shots.emplace_back(std::move(s));
+						}
 					}
 				}
+				this->perf_counters->recordValue(util::PerfHighWaterMarks::Live_Enemies,
+					static_cast<std::int64_t>(this->enemies.size()));
+				this->perf_counters->recordValue(util::PerfHighWaterMarks::Live_Shots,
+					static_cast<std::int64_t>(this->shots.size()));
+				this->perf_counters->recordValue(util::PerfHighWaterMarks::Live_Towers,
+					static_cast<std::int64_t>(this->towers.size()));
+				// (Headless games never write performance reports, so they do not time their ticks.)
+				if (!this->headless) {
+					this->perf_counters->recordTickTime(std::chrono::duration<double, std::milli>(
+						std::chrono::steady_clock::now() - tick_start).count());
+				}
 				// Determine if the level is finished
 				if (this->my_level && !this->my_level->hasEnemiesLeft() && this->enemies.empty()
 					&& this->player.isAlive()) {
+					this->recordLevelPerformance(L"won"s);
 					// Award reward money
 					const double kill_percent = static_cast<double>(this->my_level_enemy_killed)
 						/ this->my_level_enemy_count;
@@ -270,20 +320,125 @@ namespace hoffman_isaiah {
 					this->did_lose_life = false;
 					this->in_level = false;
 					if (level < 100) {
-						audio::g_my_audio->playSong(audio::town_index);
+						this->playSong(audio::town_index);
 					}
 					else {
-						audio::g_my_audio->playSong(audio::victory_index);
+						this->playSong(audio::victory_index);
 					}
 				}
 			}
 		}
 
-		void MyGame::addEnemy(std::unique_ptr<Enemy>&& e) {
-			const std::wstring ename = e->getBaseType().getName();
-			if (!this->enemies_seen.at(ename)) {
-				this->enemies_seen.at(ename) = true;
+		void MyGame::fillRenderSnapshot(RenderSnapshot& my_snapshot) const {
+			IH_PROFILE_FUNCTION();
+			// (Clearing keeps the vectors' capacity, so a steady state makes no allocations.)
+			my_snapshot.shots.clear();
+			for (const auto& s : this->shots) {
+				my_snapshot.shots.emplace_back(s->getShapeInstance());
+			}
+			my_snapshot.towers.clear();
+			for (const auto& t : this->towers) {
+				my_snapshot.towers.emplace_back(t->getSnapshot());
+			}
+			my_snapshot.enemies.clear();
+			for (const auto& e : this->enemies) {
+				my_snapshot.enemies.emplace_back(e->getSnapshot());
+			}
+			my_snapshot.square_sw = this->getMap().getGameSquareWidth<float>();
+			my_snapshot.square_sh = this->getMap().getGameSquareHeight<float>();
+			my_snapshot.use_small_text = this->getMap().getColumns() > 40 || this->getMap().getRows() > 40;
+			my_snapshot.buildIndexes(graphics::DrawRect {static_cast<float>(this->getMap().convertToScreenX(0)),
+				static_cast<float>(this->getMap().convertToScreenY(0)),
+				static_cast<float>(this->getMap().convertToScreenX(this->getMap().getColumns())),
+				static_cast<float>(this->getMap().convertToScreenY(this->getMap().getRows()))});
+			my_snapshot.level = this->level;
+			my_snapshot.difficulty = this->difficulty;
+			my_snapshot.health = this->player.getHealth();
+			my_snapshot.money = this->player.getMoney();
+			my_snapshot.is_alive = this->player.isAlive();
+			my_snapshot.score = my_snapshot.is_alive ? 0 : this->calculateScore();
+			my_snapshot.is_hiscore = this->is_hiscore;
+			my_snapshot.in_level = this->isInLevel();
+			my_snapshot.is_paused = this->isPaused();
+			my_snapshot.is_max_speed = this->isMaxSpeed();
+			my_snapshot.ticks_per_second = this->ticks_per_second;
+			my_snapshot.ground_test_path.clear();
+			my_snapshot.air_test_path.clear();
+#if defined(DEBUG) || defined(_DEBUG)
+			// (The paths are found here because buying and selling towers changes the
+			// pathfinders, which only happens while the game is locked.)
+			if (this->show_test_paths && this->ground_test_pf->checkPathExists()) {
+				auto ground_path = this->ground_test_pf->findPath(0);
+				while (!ground_path.empty()) {
+					my_snapshot.ground_test_path.emplace_back(ground_path.front().getGameX(),
+						ground_path.front().getGameY());
+					ground_path.pop();
+				}
+				auto air_path = this->air_test_pf->findPath(0);
+				while (!air_path.empty()) {
+					my_snapshot.air_test_path.emplace_back(air_path.front().getGameX(),
+						air_path.front().getGameY());
+					air_path.pop();
+				}
+			}
+#endif // DEBUG | _DEBUG -> Path Debugging
+		}
+
+		const std::vector<int>& MyGame::advanceEnemies() {
+			this->enemy_motion->resize(this->enemies.size());
+			for (std::size_t i = 0; i < this->enemies.size(); ++i) {
+				this->enemies[i]->storeMotion(*this->enemy_motion, i);
 			}
+			this->enemy_motion->advance();
+			for (std::size_t i = 0; i < this->enemies.size(); ++i) {
+				this->enemies[i]->applyMotion(*this->enemy_motion, i);
+			}
+			// Fix-up pass for the (few) enemies that reached the end of their current path segment.
+			this->enemies_at_goal.clear();
+			for (const auto i : this->enemy_motion->getArrivals()) {
+				if (this->enemies[i]->isAlive() && this->enemies[i]->advancePathNode()) {
+					this->enemies_at_goal.emplace_back(i);
+				}
+			}
+			return this->enemies_at_goal;
+		}
+
+		void MyGame::updateTowerCoverage() {
+			const auto tile_count = static_cast<std::size_t>(this->getMap().getTileCount());
+			this->tower_coverage.assign(tile_count, {});
+			this->enemies_by_tile.assign(tile_count, {});
+			this->occupied_tiles.clear();
+			for (auto& t : this->towers) {
+				t->setEnemiesInCoverage(false);
+				for (const auto tile : t->getCoveredTiles()) {
+					this->tower_coverage[tile].emplace_back(t.get());
+				}
+			}
+		}
+
+		void MyGame::updateEnemyTiles() {
+			// Only the tiles that were occupied last time need to be cleared.
+			for (const auto tile : this->occupied_tiles) {
+				this->enemies_by_tile[tile].clear();
+				for (auto t : this->tower_coverage[tile]) {
+					t->setEnemiesInCoverage(false);
+				}
+			}
+			this->occupied_tiles.clear();
+			for (const auto& e : this->enemies) {
+				const int tile = this->getMap().getTileIndex(e->getGameX(), e->getGameY());
+				if (this->enemies_by_tile[tile].empty()) {
+					this->occupied_tiles.emplace_back(tile);
+					for (auto t : this->tower_coverage[tile]) {
+						t->setEnemiesInCoverage(true);
+					}
+				}
+				this->enemies_by_tile[tile].emplace_back(e.get());
+			}
+		}
+
+		void MyGame::addEnemy(std::unique_ptr<Enemy>&& e) {
+			this->enemies_seen[e->getBaseType().getTypeId()] = true;
 			this->enemies.emplace_back(std::move(e));
 		}
 
@@ -295,9 +450,7 @@ namespace hoffman_isaiah {
 			this->is_paused = false;
 			if (!this->isInLevel() && this->player.isAlive()) {
 				// Automatically save the player's progress...
-				std::wofstream save_file {this->getUserDataPath() + game::default_save_file_name};
-				if (!save_file.fail() && !save_file.bad()) {
-					this->saveGame(save_file);
+				if (this->autosaveGame()) {
 					if (!this->in_custom_game) {
 						if (this->getLevelNumber() > this->highest_levels.at(challenge_level + ID_CHALLENGE_LEVEL_EASY)) {
 							this->highest_levels.at(challenge_level + ID_CHALLENGE_LEVEL_EASY) = this->getLevelNumber();
@@ -307,21 +460,28 @@ namespace hoffman_isaiah {
 				}
 				// Load the level...
 				this->in_level = true;
+				this->updateTowerCoverage();
+				// Anything counted between levels (such as previews) is discarded so that the
+				// level's report starts with its own enemies.
+				this->perf_counters->takeSample();
 				try {
 					this->load_level_data();
 				}
-				catch ([[maybe_unused]] const util::file::DataFileException& e) {
-					MessageBox(nullptr, e.what(), L"Level Loading Error", MB_OK);
+				catch (const util::file::DataFileException& e) {
+					if (!this->headless) {
+						this->level_load_error = e.what();
+					}
 					// Though it is not really meant to be used for levels under the threshold,
 					// it should still work despite such.
 					this->my_level = this->my_level_generator->generateLevel(this->getLevelNumber(), *this);
+					this->my_level_source = L"generated"s;
 				}
 				this->my_level_enemy_count = this->my_level->getEnemyCount();
 				if (level != 99 && level % 5 != 0 || level == 100) {
-					audio::g_my_audio->playSong(audio::level_index);
+					this->playSong(audio::level_index);
 				}
 				else {
-					audio::g_my_audio->playSong(audio::boss_index);
+					this->playSong(audio::boss_index);
 				}
 			}
 		}
@@ -375,36 +535,17 @@ namespace hoffman_isaiah {
 				// Invalid tower selected
 				return;
 			}
-			if (this->getMap().getFiterGraph(false).getNode(gx, gy).isBlocked()
-				|| this->getMap().getTerrainGraph(false).getNode(gx, gy).isBlocked()
-				|| (this->getMap().getTerrainGraph(false).getStartNode()->getGameX() == gx
-				&& this->getMap().getTerrainGraph(false).getStartNode()->getGameY() == gy)
-				|| (this->getMap().getTerrainGraph(true).getStartNode()->getGameX() == gx
-				&& this->getMap().getTerrainGraph(true).getStartNode()->getGameY() == gy)
-				|| (this->getMap().getTerrainGraph(false).getGoalNode()->getGameX() == gx
-				&& this->getMap().getTerrainGraph(false).getGoalNode()->getGameY() == gy)
-				|| (this->getMap().getTerrainGraph(true).getGoalNode()->getGameX() == gx
-				&& this->getMap().getTerrainGraph(true).getGoalNode()->getGameY() == gy)) {
-				// Cannot build on this space...
-				return;
-			}
 			// (We round for simplicity sake and also consistency.)
 			if (this->player.getMoney() < std::ceil(this->getTowerType(this->getSelectedTower())->getCost())) {
 				// Insufficient funds...
 				return;
 			}
-			this->getMap().getFiterGraph(false).getNode(gx, gy).setBlockage(true);
-			this->getMap().getFiterGraph(true).getNode(gx, gy).setBlockage(true);
-			const auto my_pathfinder_ground = std::make_unique<pathfinding::Pathfinder>(this->getMap(), false,
-				false, pathfinding::HeuristicStrategies::Manhattan);
-			const auto my_pathfinder_air = std::make_unique<pathfinding::Pathfinder>(this->getMap(), true,
-				false, pathfinding::HeuristicStrategies::Manhattan);
-			if (!my_pathfinder_ground->checkPathExists() || !my_pathfinder_air->checkPathExists()) {
-				// No path for enemies...
-				this->getMap().getFiterGraph(false).getNode(gx, gy).setBlockage(false);
-				this->getMap().getFiterGraph(true).getNode(gx, gy).setBlockage(false);
+			if (!this->canBuildTower(gx, gy)) {
+				// Cannot build on this space or no path for enemies...
 				return;
 			}
+			this->getMap().getFiterGraph(false).getNode(gx, gy).setBlockage(true);
+			this->getMap().getFiterGraph(true).getNode(gx, gy).setBlockage(true);
 			this->player.changeMoney(-this->getTowerType(this->getSelectedTower())->getCost());
 			auto my_tower = std::make_unique<Tower>(this->device_resources, this->getMap(),
 				this->getTowerType(this->getSelectedTower()),
@@ -413,6 +554,21 @@ namespace hoffman_isaiah {
 			this->debugUpdate(DebugUpdateStates::Terrain_Changed);
 		}
 
+		bool MyGame::upgradeTower(int gx, int gy, TowerUpgradeOption upgrade_option) {
+			if (this->isInLevel() || !this->player.isAlive()) {
+				// Can't upgrade while enemies are present or if dead
+				return false;
+			}
+			Tower* my_tower = this->getTowerAt(gx, gy);
+			const TowerUpgradeInfo* my_upgrade = my_tower ? my_tower->getNextUpgrade(upgrade_option) : nullptr;
+			if (!my_upgrade || this->player.getMoney() < my_tower->getUpgradeCost(*my_upgrade)) {
+				return false;
+			}
+			this->player.changeMoney(-my_tower->getUpgradeCost(*my_upgrade));
+			my_tower->upgradeTower(my_upgrade->getLevel(), upgrade_option);
+			return true;
+		}
+
 		void MyGame::sellTower(int gx, int gy) {
 			if (this->isInLevel() || !this->player.isAlive()) {
 				// Can't sell while enemies are present or if dead
@@ -433,6 +589,44 @@ namespace hoffman_isaiah {
 			}
 		}
 
+		bool MyGame::canBuildTower(int gx, int gy) {
+			if (!this->getMap().getTerrainGraph(false).verifyCoordinates(gx, gy)
+				|| this->getMap().getFiterGraph(false).getNode(gx, gy).isBlocked()
+				|| this->getMap().getTerrainGraph(false).getNode(gx, gy).isBlocked()
+				|| (this->getMap().getTerrainGraph(false).getStartNode()->getGameX() == gx
+				&& this->getMap().getTerrainGraph(false).getStartNode()->getGameY() == gy)
+				|| (this->getMap().getTerrainGraph(true).getStartNode()->getGameX() == gx
+				&& this->getMap().getTerrainGraph(true).getStartNode()->getGameY() == gy)
+				|| (this->getMap().getTerrainGraph(false).getGoalNode()->getGameX() == gx
+				&& this->getMap().getTerrainGraph(false).getGoalNode()->getGameY() == gy)
+				|| (this->getMap().getTerrainGraph(true).getGoalNode()->getGameX() == gx
+				&& this->getMap().getTerrainGraph(true).getGoalNode()->getGameY() == gy)) {
+				// Cannot build on this space...
+				return false;
+			}
+			// Enemies must still be able to reach the goal with the square blocked.
+			this->getMap().getFiterGraph(false).getNode(gx, gy).setBlockage(true);
+			this->getMap().getFiterGraph(true).getNode(gx, gy).setBlockage(true);
+			const auto my_pathfinder_ground = std::make_unique<pathfinding::Pathfinder>(this->getMap(), false,
+				false, pathfinding::HeuristicStrategies::Manhattan);
+			const auto my_pathfinder_air = std::make_unique<pathfinding::Pathfinder>(this->getMap(), true,
+				false, pathfinding::HeuristicStrategies::Manhattan);
+			const bool path_exists = my_pathfinder_ground->checkPathExists() && my_pathfinder_air->checkPathExists();
+			this->getMap().getFiterGraph(false).getNode(gx, gy).setBlockage(false);
+			this->getMap().getFiterGraph(true).getNode(gx, gy).setBlockage(false);
+			return path_exists;
+		}
+
+		Tower* MyGame::getTowerAt(int gx, int gy) const noexcept {
+			for (const auto& t : this->towers) {
+				if (static_cast<int>(std::floor(t->getGameX())) == gx
+					&& static_cast<int>(std::floor(t->getGameY())) == gy) {
+					return t.get();
+				}
+			}
+			return nullptr;
+		}
+
 		void MyGame::toggleAllRadii() noexcept {
 			for (auto& t : this->towers) {
 				t->toggleShowCoverage();
@@ -455,10 +649,73 @@ namespace hoffman_isaiah {
 		}
 
 		const EnemyType* MyGame::getEnemyType(std::wstring name) const {
-			for (auto& etype : this->enemy_types) {
-				if (etype->getName() == name) return etype.get();
+			return this->enemy_types[this->getEnemyTypeId(name)].get();
+		}
+
+		void MyGame::saveProfileTrace(const std::wstring& file_name) const {
+			const std::string trace = util::Profiler::getChromeTrace();
+			this->save_writer->queueWrite(this->getUserDataPath() + file_name, std::vector<char>(trace.begin(), trace.end()));
+		}
+
+		void MyGame::recordLevelPerformance(const std::wstring& outcome) {
+			const auto my_sample = this->perf_counters->takeSample();
+			if (this->headless) {
+				return;
+			}
+			if (this->perf_report.empty()) {
+				// One report is written per session.
+				const std::time_t now = std::time(nullptr);
+				std::tm local_now {};
+				localtime_s(&local_now, &now);
+				std::wostringstream file_name {};
+				file_name << L"perf_report_" << std::put_time(&local_now, L"%Y%m%d_%H%M%S") << L".csv";
+				this->perf_report_file_name = file_name.str();
+				this->perf_report = L"level,source,outcome,challenge_level,difficulty,enemies,"s
+					+ util::PerfCounterRegistry::getCsvHeader() + L"\n"s;
+			}
+			std::wostringstream my_row {};
+			my_row << this->getLevelNumber() << L"," << this->my_level_source << L"," << outcome
+				<< L"," << this->getChallengeLevel() << L"," << std::fixed << std::setprecision(3) << this->difficulty
+				<< L"," << this->my_level_enemy_count << L"," << util::PerfCounterRegistry::getCsvColumns(my_sample) << L"\n";
+			this->perf_report += my_row.str();
+			// (The whole report is rewritten each time, so it is complete even if the game crashes later.)
+			this->save_writer->queueWrite(this->getUserDataPath() + this->perf_report_file_name, this->perf_report);
+		}
+
+		void MyGame::playSong(int index) const {
+			if (!this->headless && audio::g_my_audio) {
+				audio::g_my_audio->playSong(index);
+			}
+		}
+
+		void MyGame::benchmarkLevelGenerator(std::wostream& report, int first_level, int last_level, int trials) const {
+			if (!this->my_level_generator) {
+				report << L"There is no level generator to benchmark.\n";
+				return;
+			}
+			static constexpr const int levels_per_line = 100;
+			report << L"Levels\tMicroseconds per level\tGroups per level\n";
+			std::chrono::steady_clock::duration total_time {0};
+			for (int block_start = first_level; block_start <= last_level; block_start += levels_per_line) {
+				const int block_end = math::get_min(block_start + levels_per_line - 1, last_level);
+				long long group_count = 0;
+				const auto start_time = std::chrono::steady_clock::now();
+				for (int level = block_start; level <= block_end; ++level) {
+					for (int t = 0; t < trials; ++t) {
+						const LevelTemplate my_template = this->my_level_generator->generateTemplate(level);
+						for (const auto& wave : my_template.getWaves()) {
+							group_count += static_cast<long long>(wave.groups.size());
+						}
+					}
+				}
+				const auto block_time = std::chrono::steady_clock::now() - start_time;
+				total_time += block_time;
+				const double levels_generated = static_cast<double>(block_end - block_start + 1) * trials;
+				report << block_start << L"-" << block_end << L"\t" << std::fixed << std::setprecision(2)
+					<< std::chrono::duration<double, std::micro> {block_time}.count() / levels_generated << L"\t"
+					<< group_count / levels_generated << L"\n";
 			}
-			throw std::out_of_range {"Enemy does not exist."};
+			report << L"Total\t" << std::chrono::duration<double, std::milli> {total_time}.count() << L" ms\n";
 		}
 	}
 }
\ No newline at end of file
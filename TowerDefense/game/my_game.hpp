@@ -2,14 +2,17 @@
 // File Author: Isaiah Hoffman
 // File Created: March 20, 2018
 #include <cmath>
+#include <exception>
 #include <iosfwd>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "./../globals.hpp"
 #include "./../ih_math.hpp"
+#include "./type_ids.hpp"
 
 namespace hoffman_isaiah {
 	namespace pathfinding {
@@ -17,6 +20,17 @@ namespace hoffman_isaiah {
 		class Pathfinder;
 	}
 
+	namespace util {
+		// Forward declaration
+		class PerfCounterRegistry;
+	}
+
+	namespace util::file {
+		// Forward declarations
+		class AsyncFileWriter;
+		class ResourcePack;
+	}
+
 	namespace graphics {
 		// Forward declarations
 		class Renderer2D;
@@ -30,12 +44,17 @@ namespace hoffman_isaiah {
 		class GameMap;
 		class EnemyType;
 		class Enemy;
+		class EnemyMotionBuffer;
 		class ShotBaseType;
 		class Shot;
 		class TowerType;
 		class Tower;
+		enum class TowerUpgradeOption;
+		class BalanceRunner;
 		class GameLevel;
 		class LevelGenerator;
+		class LevelTemplate;
+		struct RenderSnapshot;
 
 		// Debug-related update states
 		enum class DebugUpdateStates {
@@ -81,6 +100,7 @@ namespace hoffman_isaiah {
 		/// <summary>Class that represents an instance of the game itself.</summary>
 		class MyGame {
 			friend class graphics::Renderer2D;
+			friend class BalanceRunner;
 		public:
 			// Other stuff
 			MyGame(graphics::DX::DeviceResources2D* dev_res);
@@ -97,13 +117,15 @@ namespace hoffman_isaiah {
 			void resetState(int new_clevel, std::wstring map_name, bool is_custom = false);
 			/// <summary>Updates the state of the game by one tick.</summary>
 			void update();
+			/// <summary>Copies everything needed to draw the game into a render snapshot.</summary>
+			/// <param name="my_snapshot">The snapshot to fill. (Anything it held before is replaced.)</param>
+			void fillRenderSnapshot(RenderSnapshot& my_snapshot) const;
 			/// <summary>Updates the state of the game in some way for debugging reasons.</summary>
 			/// <param name="cause">The reason to update the game state.</param>
 			void debugUpdate(DebugUpdateStates cause);
 			// Note: Defined in data_loading.cpp
-			/// <summary>Loads application data.</summary>
-			/// <param name="ran_once">Has this method been called before?</param>
-			void load_config_data(bool ran_once = false);
+			/// <summary>Loads application data and opens the resource pack.</summary>
+			void load_config_data();
 			/// <summary>Initializes the list of enemy types in this game.</summary>
 			void init_enemy_types();
 			/// <summary>Initializes the list of shot types in this game.</summary>
@@ -116,16 +138,70 @@ namespace hoffman_isaiah {
 			void load_global_misc_data();
 			/// <summary>Loads data that applies to all levels.</summary>
 			void load_global_level_data();
-			/// <summary>Loads the level data for the current level.</summary>
+			/// <summary>Parses all of the hand-authored level files into level templates. (This
+			/// must be called after the enemy types are loaded.)</summary>
+			void load_level_templates();
+			/// <summary>Creates the current level from its level template.</summary>
 			void load_level_data();
+			// Note: Defined in type_database.cpp
+			/// <summary>Loads the enemy, shot, tower, upgrade, global level, and miscellaneous data.
+			/// The compiled type database is used if it is up to date with the data files; otherwise,
+			/// the data files are parsed and the database is rebuilt.</summary>
+			void load_type_data();
+			/// <summary>Parses the data files and writes the results to the compiled type database.</summary>
+			void compile_type_database();
+			/// <summary>Uses the type data and level templates of another game instead of loading them.
+			/// The types are shared rather than copied, so neither game may change them afterwards.
+			/// (This lets many headless games run side by side with one copy of the type data.)</summary>
+			/// <param name="source">The game to share the type data of. It must be fully loaded.</param>
+			void shareTypeData(const MyGame& source);
 			// Other stuff:
-			/// <summary>Saves the game state.</summary>
+			/// <summary>Saves the game state in the older text format.</summary>
 			/// <param name="save_file">The file to save the game's state to.</param>
 			void saveGame(std::wostream& save_file) const;
-			/// <summary>Loads a previously saved game state.</summary>
+			/// <summary>Loads a game state that was saved in the older text format.</summary>
 			/// <param name="save_file">The file to load the game's state from.</param>
 			void loadGame(std::wistream& save_file);
-			/// <summary>Saves global user data.</summary>
+			/// <summary>Times how long the level generator takes to choose the waves and groups
+			/// of each level in a range. (Enemies are not created, so no map is needed.)</summary>
+			/// <param name="report">The stream to write the timings to.</param>
+			/// <param name="first_level">The first level to generate.</param>
+			/// <param name="last_level">The last level to generate.</param>
+			/// <param name="trials">The number of times to generate each level.</param>
+			void benchmarkLevelGenerator(std::wostream& report, int first_level, int last_level, int trials) const;
+			/// <summary>Saves every event recorded by the profiler as a Chrome trace. (The file is
+			/// written in the background.)</summary>
+			/// <param name="file_name">The name of the trace file within the user data folder.</param>
+			void saveProfileTrace(const std::wstring& file_name) const;
+			// Note: Defined in game_save.cpp
+			/// <summary>Saves the game state to a binary save file and waits for the write to finish.</summary>
+			/// <param name="file_name">The path of the file to save the game's state to.</param>
+			/// <returns>False if the game could not be saved (including because a level is in progress).</returns>
+			bool saveGameFile(const std::wstring& file_name) const;
+			/// <summary>Saves the game state to the default save file. Only the snapshot of the
+			/// state is taken on the calling thread; the file is written in the background.</summary>
+			/// <returns>False if a level is in progress or if the game is headless, in which case
+			/// nothing is saved.</returns>
+			bool autosaveGame() const;
+			/// <summary>Waits for any saves that are being written in the background to finish.</summary>
+			/// <returns>False if any save failed since failed saves were last reported.</returns>
+			bool flushSaves() const;
+			/// <summary>Gets the saves that failed to be written in the background since failed
+			/// saves were last reported. (This does not wait for saves that are still being written.)</summary>
+			/// <returns>The paths of the files that could not be saved.</returns>
+			std::vector<std::wstring> takeFailedSaves() const;
+			/// <summary>Gets the error from the last level file that could not be loaded (in which
+			/// case the level was generated instead) if it has not been reported yet.</summary>
+			/// <returns>The error message or an empty string if there is nothing to report.</returns>
+			std::wstring takeLevelLoadError() {
+				return std::exchange(this->level_load_error, std::wstring {});
+			}
+			/// <summary>Loads a previously saved game state. Both binary and text save files are accepted.</summary>
+			/// <param name="file_name">The path of the file to load the game's state from.</param>
+			/// <returns>False if the file does not exist.</returns>
+			bool loadGameFile(const std::wstring& file_name);
+			/// <summary>Saves global user data. (The file is written in the background. Headless
+			/// games do not save anything.)</summary>
 			void saveGlobalData() const;
 			/// <summary>Loads global user data.</summary>
 			void loadGlobalData();
@@ -154,15 +230,37 @@ namespace hoffman_isaiah {
 			void buyHealth();
 			/// <summary>Changes the speed at which the game is updated.</summary>
 			void changeUpdateSpeed();
+			/// <summary>Toggles maximum speed mode, in which the game is updated as often as
+			/// possible instead of at a fixed rate.</summary>
+			void toggleMaxSpeed() noexcept {
+				this->max_speed = !this->max_speed;
+			}
+			/// <param name="new_ticks_per_second">The measured number of logic ticks run per second.</param>
+			void setTicksPerSecond(double new_ticks_per_second) noexcept {
+				this->ticks_per_second = new_ticks_per_second;
+			}
 			/// <summary>Attempts to buy and place a tower at the given game coordinates.</summary>
 			/// <param name="gx">The x-location of the place to build (in game coordinate squares).</param>
 			/// <param name="gy">The y-location of the place to build (in game coordinate squares).</param>
 			void buyTower(int gx, int gy);
+			/// <summary>Attempts to upgrade the tower at the given game coordinates to its next level.</summary>
+			/// <param name="gx">The x-location of the tower to upgrade (in game coordinate squares).</param>
+			/// <param name="gy">The y-location of the tower to upgrade (in game coordinate squares).</param>
+			/// <param name="upgrade_option">The upgrade option to choose.</param>
+			/// <returns>True if the tower was upgraded.</returns>
+			bool upgradeTower(int gx, int gy, TowerUpgradeOption upgrade_option);
 			/// <summary>Attempts to sell and remove a tower at the given game coordinates.</summary>
 			/// <param name="gx">The x-location of the tower to destroy (in game coordinate squares).</param>
 			/// <param name="gy">The y-location of the tower to destroy (in game coordinate squares).</param>
 			void sellTower(int gx, int gy);
 			// Misc:
+			/// <summary>Checks if a tower could be built on a square without blocking every path
+			/// that enemies could take. (This is the rule that buyTower() uses; the player's money
+			/// is not checked.)</summary>
+			/// <param name="gx">The x-location of the square (in game coordinate squares).</param>
+			/// <param name="gy">The y-location of the square (in game coordinate squares).</param>
+			/// <returns>True if a tower could be built on the square.</returns>
+			bool canBuildTower(int gx, int gy);
 			/// <summary>Toggles the showing of paths (as an aid for debugging pathfinding).</summary>
 			void toggleShowPaths() noexcept {
 				this->show_test_paths = !this->show_test_paths;
@@ -171,8 +269,8 @@ namespace hoffman_isaiah {
 			void toggleAllRadii() noexcept;
 			/// <summary>Sets an enemy type as "seen" before.</summary>
 			/// <param name="name">The name of the type seen.</param>
-			void setEnemyTypeAsSeen(std::wstring name) noexcept {
-				this->enemies_seen.at(name) = true;
+			void setEnemyTypeAsSeen(std::wstring name) {
+				this->enemies_seen.at(this->getEnemyTypeId(name)) = true;
 			}
 			/// <param name="amt">The amount of money to add (or remove) from the player.</param>
 			void changePlayerCash(double amt) noexcept {
@@ -182,6 +280,12 @@ namespace hoffman_isaiah {
 			void setGameType(bool is_custom) noexcept {
 				this->in_custom_game = is_custom;
 			}
+			/// <param name="is_headless">Is the game being played without a window (such as by
+			/// the balance runner)? Headless games never save anything, play music, or show
+			/// message boxes.</param>
+			void setHeadless(bool is_headless) noexcept {
+				this->headless = is_headless;
+			}
 			// Getters
 			graphics::DX::DeviceResources2D* getDeviceResources() const noexcept {
 				return this->device_resources;
@@ -200,26 +304,44 @@ namespace hoffman_isaiah {
 			std::wstring getDefaultMapName(int new_challenge) const;
 			/// <param name="name">The name of the enemy type to obtain.</param>
 			const EnemyType* getEnemyType(std::wstring name) const;
+			/// <param name="name">The name of the enemy type to look up.</param>
+			/// <returns>The identifier of the enemy type (which is also its index in the list).</returns>
+			int getEnemyTypeId(const std::wstring& name) const {
+				const int id = this->enemy_type_ids.find(name);
+				if (id < 0) {
+					throw std::out_of_range {"Enemy does not exist."};
+				}
+				return id;
+			}
 			/// <param name="index">The zero-based index of the enemy to retrieve (relative to the beginning of the file).</param>
 			const EnemyType* getEnemyType(int index) const {
 				return this->enemy_types.at(index).get();
 			}
-			const std::vector<std::unique_ptr<EnemyType>>& getAllEnemyTypes() const noexcept {
+			const std::vector<std::shared_ptr<EnemyType>>& getAllEnemyTypes() const noexcept {
 				return this->enemy_types;
 			}
-			std::map<std::wstring, bool> getSeenEnemies() const noexcept {
-				return this->enemies_seen;
+			std::map<std::wstring, bool> getSeenEnemies() const {
+				std::map<std::wstring, bool> ret {};
+				for (int i = 0; i < static_cast<int>(this->enemies_seen.size()); ++i) {
+					ret.emplace(this->enemy_type_ids.getName(i), this->enemies_seen[i]);
+				}
+				return ret;
+			}
+			/// <param name="id">The identifier of the enemy type.</param>
+			/// <returns>True if an enemy of the given type has been seen before.</returns>
+			bool isEnemyTypeSeen(int id) const {
+				return this->enemies_seen.at(id);
 			}
 			const ShotBaseType* getShotType(std::wstring name) const {
 				return this->shot_types.at(name).get();
 			}
-			const std::map<std::wstring, std::unique_ptr<ShotBaseType>>& getAllShotTypes() const noexcept {
+			const std::map<std::wstring, std::shared_ptr<ShotBaseType>>& getAllShotTypes() const noexcept {
 				return this->shot_types;
 			}
 			const TowerType* getTowerType(int i) const {
 				return this->tower_types.at(i).get();
 			}
-			const std::vector<std::unique_ptr<TowerType>>& getAllTowerTypes() const noexcept {
+			const std::vector<std::shared_ptr<TowerType>>& getAllTowerTypes() const noexcept {
 				return this->tower_types;
 			}
 			std::vector<std::unique_ptr<Enemy>>& getEnemies() noexcept {
@@ -228,12 +350,21 @@ namespace hoffman_isaiah {
 			std::vector<std::unique_ptr<Tower>>& getTowers() noexcept {
 				return this->towers;
 			}
+			/// <returns>The tower on the given square or nullptr if there is no tower there.</returns>
+			Tower* getTowerAt(int gx, int gy) const noexcept;
 			bool isPaused() const noexcept {
 				return this->is_paused;
 			}
 			bool isInLevel() const noexcept {
 				return this->in_level;
 			}
+			bool isMaxSpeed() const noexcept {
+				return this->max_speed;
+			}
+			/// <returns>The total number of logic ticks that have been run.</returns>
+			long long getTickCount() const noexcept {
+				return this->tick_count;
+			}
 			/// <returns>-1 indicates that "None" is selected. Otherwise, the number
 			/// corresponds with the tower type's index in the list.</returns>
 			int getSelectedTower() const noexcept {
@@ -257,10 +388,30 @@ namespace hoffman_isaiah {
 			std::wstring getUserDataPath() const noexcept {
 				return this->userdata_folder_path;
 			}
+			/// <returns>The path of the folder whose files override the game's resources.</returns>
+			std::wstring getResourceOverridesPath() const {
+				return this->userdata_folder_path + game::resource_overrides_folder_name;
+			}
+			/// <returns>The game's resources. (Files in the overrides folder take precedence over
+			/// the resource pack, and the resources folder is only used if there is no pack.)</returns>
+			const util::file::ResourcePack& getResources() const noexcept {
+				return *this->resources;
+			}
+			/// <returns>The performance counters of this game.</returns>
+			util::PerfCounterRegistry& getPerfCounters() const noexcept {
+				return *this->perf_counters;
+			}
 			/// <returns>The amount of money the player possesses.</returns>
 			double getPlayerCash() const noexcept {
 				return this->player.getMoney();
 			}
+			/// <returns>The amount of health the player possesses.</returns>
+			int getPlayerHealth() const noexcept {
+				return this->player.getHealth();
+			}
+			bool isHeadless() const noexcept {
+				return this->headless;
+			}
 			/// <returns>The new speed that the game will update at based on the current update speed.</returns>
 			int getNextUpdateSpeed() const noexcept {
 				switch (this->update_speed) {
@@ -290,6 +441,43 @@ namespace hoffman_isaiah {
 				return this->highest_levels;
 			}
 		protected:
+			// Note: Defined in data_loading.cpp
+			/// <summary>Reads the configuration file, which determines where resources and user data are stored.</summary>
+			/// <param name="ran_once">Has this method been called before?</param>
+			void read_config_file(bool ran_once);
+			// Note: Defined in type_database.cpp
+			/// <summary>Loads the type data from the compiled type database.</summary>
+			/// <returns>False if the database is missing or out of date with the data files.</returns>
+			bool load_type_database();
+			/// <summary>Writes the currently loaded type data to the compiled type database.</summary>
+			void save_type_database() const;
+			/// <summary>Parses the data files that the type database is compiled from.</summary>
+			void load_data_files();
+			/// <summary>Removes all of the loaded type data.</summary>
+			void clear_type_data() noexcept;
+			/// <summary>Assigns identifiers to the loaded enemy types and resolves the targets
+			/// of their buffs.</summary>
+			void index_enemy_types();
+			/// <summary>Parses a single level file.</summary>
+			/// <param name="file_contents">The contents of the level file to parse.</param>
+			/// <returns>The template containing the level's data.</returns>
+			std::shared_ptr<const LevelTemplate> parse_level_file(std::wstring file_contents) const;
+			/// <summary>Recreates a tower from a save file and blocks the tile it occupies.</summary>
+			/// <param name="tower_name">The name of the tower's type.</param>
+			/// <param name="tower_gx">The tower's game x-coordinate.</param>
+			/// <param name="tower_gy">The tower's game y-coordinate.</param>
+			/// <param name="tower_level">The tower's upgrade level.</param>
+			/// <param name="tower_path">The upgrade options that were chosen for the tower.</param>
+			void restoreTower(const std::wstring& tower_name, double tower_gx, double tower_gy,
+				int tower_level, unsigned int tower_path);
+			// Note: Defined in game_save.cpp
+			/// <returns>The game state encoded in the binary save format.</returns>
+			std::vector<char> writeBinarySave() const;
+			/// <summary>Loads the game state from a buffer in the binary save format. The
+			/// sections are read directly from the buffer without copying.</summary>
+			/// <param name="data">The start of the buffer.</param>
+			/// <param name="size">The size of the buffer in bytes.</param>
+			void readBinarySave(const char* data, std::size_t size);
 			/// <summary>Calculates the player's final score.</summary>
 			/// <returns>The calculated final score.</returns>
 			long long calculateScore() const noexcept {
@@ -324,6 +512,23 @@ namespace hoffman_isaiah {
 					: this->getLevelNumber() > 10 ? 2500ll : 0ll;
 				return score_bonus + clevel_mod_numerator * (level_score_component + difficulty_score_component) / clevel_mod_denominator;
 			}
+			/// <summary>Moves all of the living enemies by one logical frame.</summary>
+			/// <returns>The indices (in ascending order) of the enemies that reached the goal.</returns>
+			const std::vector<int>& advanceEnemies();
+			/// <summary>Rebuilds the index that maps each tile to the towers covering it.
+			/// (Towers cannot be bought, sold, or upgraded during a level, so this only needs
+			/// to be done when a level starts.)</summary>
+			void updateTowerCoverage();
+			/// <summary>Groups the living enemies by the tile they are on and lets each tower
+			/// know whether any enemy is within its coverage.</summary>
+			void updateEnemyTiles();
+			/// <summary>Adds the performance counters of the level that just ended to this session's
+			/// performance report and writes the report to the user data folder.</summary>
+			/// <param name="outcome">How the level ended ("won" or "lost").</param>
+			void recordLevelPerformance(const std::wstring& outcome);
+			/// <summary>Plays a song unless the game is headless.</summary>
+			/// <param name="index">The index of the song to play.</param>
+			void playSong(int index) const;
 			/// <summary>Updates the value of the dynamic difficulty variable.</summary>
 			void updateDifficulty() noexcept {
 				if (!this->did_lose_life) {
@@ -356,22 +561,38 @@ namespace hoffman_isaiah {
 			std::wstring map_base_name {L"intermediate"};
 			/// <summary>The game map being used by the program.</summary>
 			std::shared_ptr<GameMap> map {nullptr};
-			/// <summary>The list of enemy template types.</summary>
-			std::vector<std::unique_ptr<game::EnemyType>> enemy_types {};
-			/// <summary>Stores which enemy types have been seen before.</summary>
-			std::map<std::wstring, bool> enemies_seen {};
-			/// <summary>Stores how many times each enemy type has been killed.</summary>
-			std::map<std::wstring, long long> enemy_kill_count {};
+			/// <summary>The list of enemy template types. (These may be shared with other games.)</summary>
+			std::vector<std::shared_ptr<game::EnemyType>> enemy_types {};
+			/// <summary>Assigns identifiers to the names of the enemy types.</summary>
+			NameTable enemy_type_ids {};
+			/// <summary>Stores which enemy types have been seen before. (Indexed by type identifier.)</summary>
+			std::vector<bool> enemies_seen {};
+			/// <summary>Stores how many times each enemy type has been killed. (Indexed by type identifier.)</summary>
+			std::vector<long long> enemy_kill_count {};
 			/// <summary>The list of enemies that are currently alive.</summary>
 			std::vector<std::unique_ptr<game::Enemy>> enemies {};
-			/// <summary>The list of shot template types.</summary>
-			std::map<std::wstring, std::unique_ptr<game::ShotBaseType>> shot_types {};
+			/// <summary>The list of shot template types. (These may be shared with other games.)</summary>
+			std::map<std::wstring, std::shared_ptr<game::ShotBaseType>> shot_types {};
+			/// <summary>Assigns identifiers to the names of the shot types.</summary>
+			NameTable shot_type_ids {};
 			/// <summary>The list of projectiles that are currently active.</summary>
 			std::vector<std::unique_ptr<game::Shot>> shots {};
-			/// <summary>The list of tower template types.</summary>
-			std::vector<std::unique_ptr<game::TowerType>> tower_types {};
+			/// <summary>The list of tower template types. (These may be shared with other games.)</summary>
+			std::vector<std::shared_ptr<game::TowerType>> tower_types {};
+			/// <summary>Assigns identifiers to the names of the tower types.</summary>
+			NameTable tower_type_ids {};
 			/// <summary>The list of towers currently in the game.</summary>
 			std::vector<std::unique_ptr<game::Tower>> towers {};
+			/// <summary>The movement state of the living enemies. (Indices match those of enemies.)</summary>
+			std::unique_ptr<EnemyMotionBuffer> enemy_motion {nullptr};
+			/// <summary>The enemies that reached the goal during the last call to advanceEnemies().</summary>
+			std::vector<int> enemies_at_goal {};
+			/// <summary>For each tile of the map, the towers whose coverage includes that tile.</summary>
+			std::vector<std::vector<game::Tower*>> tower_coverage {};
+			/// <summary>For each tile of the map, the living enemies currently on that tile.</summary>
+			std::vector<std::vector<const game::Enemy*>> enemies_by_tile {};
+			/// <summary>The tiles that had at least one enemy on them as of the last update.</summary>
+			std::vector<int> occupied_tiles {};
 			/// <summary>The player's health and cash.</summary>
 			Player player {};
 			/// <summary>The current level number the player is on.</summary>
@@ -384,6 +605,15 @@ namespace hoffman_isaiah {
 			int my_level_enemy_killed {0};
 			/// <summary>The game level to use if the loading of a level file fails.</summary>
 			int my_level_backup_number {-1};
+			/// <summary>Where the current level came from (its level file or "generated").</summary>
+			std::wstring my_level_source {};
+			/// <summary>The error from the last level file that could not be loaded. (Levels are
+			/// started on the simulation thread, so the user interface reports it later.)</summary>
+			std::wstring level_load_error {};
+			/// <summary>The contents of this session's performance report (a CSV file).</summary>
+			std::wstring perf_report {};
+			/// <summary>The name of this session's performance report within the user data folder.</summary>
+			std::wstring perf_report_file_name {};
 			/// <summary>The current dynamic difficulty level the player is at.</summary>
 			double difficulty {1.00};
 			/// <summary>The current game difficulty level the player is at.</summary>
@@ -408,22 +638,43 @@ namespace hoffman_isaiah {
 			double hp_buy_multiplier {1.00};
 			/// <summary>The number of times to update the game per logical frame.</summary>
 			int update_speed {1};
+			/// <summary>Is the game running as fast as possible? (Each call to update then runs
+			/// a single logic tick, and the caller decides how many to run.)</summary>
+			bool max_speed {false};
+			/// <summary>The total number of logic ticks that have been run.</summary>
+			long long tick_count {0};
+			/// <summary>The most recently measured number of logic ticks run per second.</summary>
+			double ticks_per_second {0.0};
 			/// <summary>Stores the path to the resources folder.</summary>
 			std::wstring resources_folder_path {L"./resources/"};
 			/// <summary>Stores the path to the userdata folder.</summary>
 			std::wstring userdata_folder_path {L"./userdata/"};
-			/// <summary>Stores the automatic level generator.</summary>
-			std::unique_ptr<LevelGenerator> my_level_generator {nullptr};
+			/// <summary>Stores the automatic level generator. (This may be shared with other games.)</summary>
+			std::shared_ptr<LevelGenerator> my_level_generator {nullptr};
+			/// <summary>The parsed hand-authored levels. Key => Level number.</summary>
+			std::map<int, std::shared_ptr<const LevelTemplate>> level_templates {};
+			/// <summary>The errors that occurred while parsing hand-authored levels. (These are
+			/// reported when the level is played.) Key => Level number.</summary>
+			std::map<int, std::exception_ptr> level_template_errors {};
 			/// <summary>Is the player allowed to load and play custom games and maps?</summary>
 			bool start_custom_games {false};
 			/// <summary>Is the player in a custom game?</summary>
 			bool in_custom_game {false};
+			/// <summary>Is the game being played without a window?</summary>
+			bool headless {false};
 			/// <summary>Stores the highest score obtained by the player.</summary>
 			long long highest_score {0};
 			/// <summary>Is the current score a high score?</summary>
 			bool is_hiscore {false};
 			/// <summary>Maps the highest levels reached on each difficulty.</summary>
 			std::map<int, int> highest_levels;
+			/// <summary>Writes save files in the background.</summary>
+			std::unique_ptr<util::file::AsyncFileWriter> save_writer;
+			/// <summary>Counts the work done by this game. (Each game has its own counters so that
+			/// games played at the same time do not disturb each other's counts.)</summary>
+			std::unique_ptr<util::PerfCounterRegistry> perf_counters;
+			/// <summary>Provides the game's resources.</summary>
+			std::unique_ptr<util::file::ResourcePack> resources;
 			// Testing things
 			std::shared_ptr<pathfinding::Pathfinder> ground_test_pf {nullptr};
 			std::shared_ptr<pathfinding::Pathfinder> air_test_pf {nullptr};
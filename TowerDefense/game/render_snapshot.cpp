@@ -0,0 +1,185 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include "./../graphics/draw_list.hpp"
+#include "./../graphics/spatial_index.hpp"
+#include "./render_snapshot.hpp"
+
+namespace hoffman_isaiah {
+	namespace game {
+		namespace {
+			/// <returns>The area covered by a shape.</returns>
+			graphics::DrawRect getShapeBounds(const graphics::shapes::ShapeInstance& my_shape) noexcept {
+				return graphics::DrawRect {my_shape.center_sx - my_shape.width_sw / 2.f,
+					my_shape.center_sy - my_shape.height_sh / 2.f, my_shape.center_sx + my_shape.width_sw / 2.f,
+					my_shape.center_sy + my_shape.height_sh / 2.f};
+			}
+		}
+
+		void EnemySnapshot::record(graphics::DrawList& my_list, float square_sw, float square_sh,
+			bool show_details) const {
+			my_list.addShape(graphics::DrawLayers::Enemies, this->sprite);
+			// Only draw bars if injured.
+			if (!show_details || (this->health_fraction >= 0.99f && (!this->has_armor || this->armor_fraction >= 0.99f))) {
+				return;
+			}
+			// Draw health bars
+			constexpr const graphics::DrawColor bar_outline_color {0.2f, 0.2f, 0.2f, 1.0f};
+			constexpr const graphics::DrawColor health_fill_color {0.8f, 0.0f, 0.0f, 0.9f};
+			constexpr const graphics::DrawColor armor_fill_color {0.0f, 0.0f, 0.8f, 0.9f};
+			constexpr const graphics::DrawColor shield_fill_color {0.0, 0.8f, 0.8f, 0.9f};
+			const float bar_max_width = this->is_unique ? 0.8f * square_sw : 0.4f * square_sw;
+			const float bar_height = 0.115f * square_sh;
+			// Roughly 3.23 * bar_height
+			const float hp_bar_offset = 3.23f * bar_height;
+			const float hp_bar_start_x = this->sprite.center_sx - bar_max_width / 2.f;
+			const float hp_bar_end_x = hp_bar_start_x + this->health_fraction * bar_max_width;
+			const float hp_bar_start_y = this->sprite.center_sy - bar_height / 2.f - hp_bar_offset;
+			const float hp_bar_end_y = hp_bar_start_y + bar_height;
+			my_list.outlineRectangle(graphics::DrawLayers::Bar_Backgrounds, graphics::DrawRect {hp_bar_start_x,
+				hp_bar_start_y, hp_bar_start_x + bar_max_width, hp_bar_end_y}, bar_outline_color);
+			my_list.fillRectangle(graphics::DrawLayers::Bar_Fills, graphics::DrawRect {hp_bar_start_x,
+				hp_bar_start_y, hp_bar_end_x, hp_bar_end_y}, health_fill_color);
+			if (this->has_armor && this->armor_fraction <= 0.99f) {
+				// Roughly hp_bar_offset + 0.5 * bar_height + bar_height
+				const float ahp_bar_offset = hp_bar_offset + bar_height + 0.5f * bar_height;
+				const float ahp_bar_start_x = hp_bar_start_x;
+				const float ahp_bar_end_x = ahp_bar_start_x + this->armor_fraction * bar_max_width;
+				const float ahp_bar_start_y = this->sprite.center_sy - bar_height / 2.f - ahp_bar_offset;
+				const float ahp_bar_end_y = ahp_bar_start_y + bar_height;
+				my_list.outlineRectangle(graphics::DrawLayers::Bar_Backgrounds, graphics::DrawRect {ahp_bar_start_x,
+					ahp_bar_start_y, ahp_bar_start_x + bar_max_width, ahp_bar_end_y}, bar_outline_color);
+				my_list.fillRectangle(graphics::DrawLayers::Bar_Fills, graphics::DrawRect {ahp_bar_start_x,
+					ahp_bar_start_y, ahp_bar_end_x, ahp_bar_end_y}, armor_fill_color);
+			}
+			if (this->shield_fraction > 0.f) {
+				const float shp_bar_offset = hp_bar_offset + bar_height + 0.5f * bar_height;
+				const float shp_bar_start_x = hp_bar_start_x;
+				const float shp_bar_end_x = shp_bar_start_x + this->shield_fraction * bar_max_width;
+				const float shp_bar_start_y = this->sprite.center_sy - bar_height / 2.f - shp_bar_offset;
+				const float shp_bar_end_y = shp_bar_start_y + bar_height;
+				my_list.fillRectangle(graphics::DrawLayers::Bar_Overlays, graphics::DrawRect {shp_bar_start_x,
+					shp_bar_start_y, shp_bar_end_x, shp_bar_end_y}, shield_fill_color);
+			}
+		}
+
+		graphics::DrawRect EnemySnapshot::getBounds() const noexcept {
+			return getShapeBounds(this->sprite);
+		}
+
+		void TowerSnapshot::record(graphics::DrawList& my_list, float square_sw, float square_sh,
+			bool use_small_text, bool show_details) const {
+			my_list.addShape(graphics::DrawLayers::Towers, this->sprite);
+			// Draw radius if appropriate
+			if (this->show_coverage) {
+				constexpr const graphics::DrawColor range_color {0.7f, 0.f, 0.f, 0.8f};
+				my_list.outlineEllipse(graphics::DrawLayers::Tower_Ranges, this->sprite.center_sx, this->sprite.center_sy,
+					this->firing_range * square_sw, this->firing_range * square_sh, range_color);
+				// Also paint upgrade level.
+				constexpr const graphics::DrawColor text_color {1.f, 0.2f, 1.f, 1.f};
+				if (show_details && this->level > 1) {
+					const graphics::DrawRect level_rect {this->sprite.center_sx - 0.5f * square_sw,
+						this->sprite.center_sy - 0.5f * square_sh, this->sprite.center_sx + 0.5f * square_sw,
+						this->sprite.center_sy + 0.5f * square_sh};
+					my_list.outlineRectangle(graphics::DrawLayers::Labels, level_rect, range_color);
+					my_list.addText(graphics::DrawLayers::Labels, std::to_wstring(this->level), level_rect,
+						text_color, use_small_text);
+				}
+			}
+			if (!show_details || !this->has_ammo_bar) {
+				return;
+			}
+			// Draw ammunition bar
+			constexpr const graphics::DrawColor bar_outline_color {0.2f, 0.2f, 0.2f, 1.0f};
+			constexpr const graphics::DrawColor bar_empty_color {0.8f, 0.8f, 0.8f, 0.6f};
+			constexpr const graphics::DrawColor bar_filling_color {1.f, 0.f, 1.f, 0.9f};
+			constexpr const graphics::DrawColor bar_reloading_color {0.3f, 0.6f, 0.6f, 0.7f};
+			const float bar_max_width = 0.7f * square_sw;
+			const float bar_height = 0.15f * square_sh;
+			// Roughly 3.6x the bar's height.
+			const float ammo_bar_offset = 3.6f * bar_height;
+			const float ammo_bar_start_x = this->sprite.center_sx - bar_max_width / 2.f;
+			const float ammo_bar_start_y = this->sprite.center_sy - bar_height / 2.f - ammo_bar_offset;
+			const float ammo_bar_end_x = ammo_bar_start_x + bar_max_width * this->shots_fired_fraction;
+			const float ammo_bar_end_y = ammo_bar_start_y + bar_height;
+			const graphics::DrawRect ammo_bar_outline_rc {ammo_bar_start_x, ammo_bar_start_y,
+				ammo_bar_start_x + bar_max_width, ammo_bar_end_y};
+			my_list.outlineRectangle(graphics::DrawLayers::Bar_Backgrounds, ammo_bar_outline_rc, bar_outline_color);
+			my_list.fillRectangle(graphics::DrawLayers::Bar_Backgrounds, ammo_bar_outline_rc, bar_empty_color);
+			my_list.fillRectangle(graphics::DrawLayers::Bar_Fills, graphics::DrawRect {ammo_bar_start_x,
+				ammo_bar_start_y, ammo_bar_end_x, ammo_bar_end_y}, bar_filling_color);
+			if (this->reload_fraction > 0) {
+				const float reload_bar_start_x = this->sprite.center_sx + bar_max_width / 2.f
+					- (bar_max_width * (1.f - this->reload_fraction));
+				const float reload_bar_end_x = this->sprite.center_sx + bar_max_width / 2.f;
+				my_list.fillRectangle(graphics::DrawLayers::Bar_Overlays, graphics::DrawRect {reload_bar_start_x,
+					ammo_bar_start_y, reload_bar_end_x, ammo_bar_end_y}, bar_reloading_color);
+			}
+		}
+
+		graphics::DrawRect TowerSnapshot::getBounds(float square_sw, float square_sh) const noexcept {
+			auto my_bounds = getShapeBounds(this->sprite);
+			if (this->show_coverage) {
+				const float range_sw = this->firing_range * square_sw;
+				const float range_sh = this->firing_range * square_sh;
+				my_bounds.left = std::min(my_bounds.left, this->sprite.center_sx - range_sw);
+				my_bounds.top = std::min(my_bounds.top, this->sprite.center_sy - range_sh);
+				my_bounds.right = std::max(my_bounds.right, this->sprite.center_sx + range_sw);
+				my_bounds.bottom = std::max(my_bounds.bottom, this->sprite.center_sy + range_sh);
+			}
+			return my_bounds;
+		}
+
+		void RenderSnapshot::record(graphics::DrawList& my_list) const {
+			for (const auto& s : this->shots) {
+				my_list.addShape(graphics::DrawLayers::Shots, s);
+			}
+			for (const auto& t : this->towers) {
+				t.record(my_list, this->square_sw, this->square_sh, this->use_small_text);
+			}
+			for (const auto& e : this->enemies) {
+				e.record(my_list, this->square_sw, this->square_sh);
+			}
+		}
+
+		void RenderSnapshot::record(graphics::DrawList& my_list, graphics::DrawRect visible_rect,
+			bool show_details) const {
+			// Bars and labels stick out of the sprites by up to a square.
+			visible_rect.left -= this->square_sw;
+			visible_rect.top -= this->square_sh;
+			visible_rect.right += this->square_sw;
+			visible_rect.bottom += this->square_sh;
+			this->shot_index.query(visible_rect, [this, &my_list](std::uint32_t i) {
+				my_list.addShape(graphics::DrawLayers::Shots, this->shots[i]);
+			});
+			this->tower_index.query(visible_rect, [this, &my_list, show_details](std::uint32_t i) {
+				this->towers[i].record(my_list, this->square_sw, this->square_sh, this->use_small_text, show_details);
+			});
+			this->enemy_index.query(visible_rect, [this, &my_list, show_details](std::uint32_t i) {
+				this->enemies[i].record(my_list, this->square_sw, this->square_sh, show_details);
+			});
+		}
+
+		void RenderSnapshot::buildIndexes(graphics::DrawRect map_rect) {
+			const float cell_sw = snapshot_index_cell_squares * this->square_sw;
+			const float cell_sh = snapshot_index_cell_squares * this->square_sh;
+			this->shot_index.reset(map_rect, cell_sw, cell_sh);
+			for (const auto& s : this->shots) {
+				this->shot_index.add(getShapeBounds(s));
+			}
+			this->shot_index.build();
+			this->tower_index.reset(map_rect, cell_sw, cell_sh);
+			for (const auto& t : this->towers) {
+				this->tower_index.add(t.getBounds(this->square_sw, this->square_sh));
+			}
+			this->tower_index.build();
+			this->enemy_index.reset(map_rect, cell_sw, cell_sh);
+			for (const auto& e : this->enemies) {
+				this->enemy_index.add(e.getBounds());
+			}
+			this->enemy_index.build();
+		}
+	}
+}
\ No newline at end of file
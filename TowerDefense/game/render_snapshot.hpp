@@ -0,0 +1,124 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <utility>
+#include <vector>
+#include "./../graphics/draw_list.hpp"
+#include "./../graphics/spatial_index.hpp"
+
+namespace hoffman_isaiah {
+	namespace game {
+		// The width and height (in game squares) of the cells that render snapshots sort
+		// their objects into.
+		constexpr const float snapshot_index_cell_squares = 4.f;
+
+		/// <summary>How an enemy looked when its snapshot was taken.</summary>
+		struct EnemySnapshot {
+			/// <summary>Records the enemy along with its health bars.</summary>
+			/// <param name="square_sw">The width of a game square in screen coordinates.</param>
+			/// <param name="square_sh">The height of a game square in screen coordinates.</param>
+			/// <param name="show_details">Should the health bars be drawn? (They are left out
+			/// when the squares are too small to see them.)</param>
+			void record(graphics::DrawList& my_list, float square_sw, float square_sh,
+				bool show_details = true) const;
+			/// <returns>The area covered by the enemy's sprite.</returns>
+			graphics::DrawRect getBounds() const noexcept;
+
+			/// <summary>The enemy's shape and position.</summary>
+			graphics::shapes::ShapeInstance sprite {};
+			/// <summary>The fraction of the enemy's health that remains.</summary>
+			float health_fraction {1.f};
+			/// <summary>The fraction of the enemy's armor that remains.</summary>
+			float armor_fraction {1.f};
+			/// <summary>The fraction of the enemy's shield that remains (0 if it has none).</summary>
+			float shield_fraction {0.f};
+			/// <summary>Does the enemy still have armor?</summary>
+			bool has_armor {false};
+			/// <summary>Is the enemy a unique (boss) enemy?</summary>
+			bool is_unique {false};
+		};
+
+		/// <summary>How a tower looked when its snapshot was taken.</summary>
+		struct TowerSnapshot {
+			/// <summary>Records the tower along with its coverage and ammunition bar.</summary>
+			/// <param name="square_sw">The width of a game square in screen coordinates.</param>
+			/// <param name="square_sh">The height of a game square in screen coordinates.</param>
+			/// <param name="use_small_text">Should the tower's level be drawn with small text?</param>
+			/// <param name="show_details">Should the tower's level and ammunition bar be drawn?
+			/// (They are left out when the squares are too small to see them.)</param>
+			void record(graphics::DrawList& my_list, float square_sw, float square_sh,
+				bool use_small_text, bool show_details = true) const;
+			/// <param name="square_sw">The width of a game square in screen coordinates.</param>
+			/// <param name="square_sh">The height of a game square in screen coordinates.</param>
+			/// <returns>The area covered by the tower's sprite and (if shown) its coverage.</returns>
+			graphics::DrawRect getBounds(float square_sw, float square_sh) const noexcept;
+
+			/// <summary>The tower's shape and position.</summary>
+			graphics::shapes::ShapeInstance sprite {};
+			/// <summary>Should the tower's coverage be drawn?</summary>
+			bool show_coverage {false};
+			/// <summary>The tower's firing range in game squares.</summary>
+			float firing_range {0.f};
+			/// <summary>The tower's upgrade level.</summary>
+			int level {1};
+			/// <summary>Does the tower fire volleys (and thus have an ammunition bar)?</summary>
+			bool has_ammo_bar {false};
+			/// <summary>The fraction of the current volley that has been fired.</summary>
+			float shots_fired_fraction {0.f};
+			/// <summary>The fraction of the reload time that remains.</summary>
+			float reload_fraction {0.f};
+		};
+
+		/// <summary>A compact copy of everything needed to draw the game, taken after a logic
+		/// tick. The simulation thread fills snapshots and the rendering thread draws them, so
+		/// drawing never touches the live game objects.</summary>
+		struct RenderSnapshot {
+			/// <summary>Records every shot, tower, and enemy into a draw list.</summary>
+			/// <param name="my_list">The draw list to add the commands to.</param>
+			void record(graphics::DrawList& my_list) const;
+			/// <summary>Records the shots, towers, and enemies that might be visible into a draw
+			/// list. (The indexes must have been built.)</summary>
+			/// <param name="my_list">The draw list to add the commands to.</param>
+			/// <param name="visible_rect">The visible part of the map in map coordinates.</param>
+			/// <param name="show_details">Should bars and labels be drawn?</param>
+			void record(graphics::DrawList& my_list, graphics::DrawRect visible_rect, bool show_details) const;
+			/// <summary>Builds the spatial indexes of the shots, towers, and enemies. (This is
+			/// done on the simulation thread, so the rendering thread only has to visit the
+			/// objects that are near the visible part of the map.)</summary>
+			/// <param name="map_rect">The area covered by the map.</param>
+			void buildIndexes(graphics::DrawRect map_rect);
+
+			/// <summary>The shape and position of each shot.</summary>
+			std::vector<graphics::shapes::ShapeInstance> shots {};
+			std::vector<TowerSnapshot> towers {};
+			std::vector<EnemySnapshot> enemies {};
+			/// <summary>Finds the shots near a part of the map. (Items are numbered by their
+			/// positions in the list of shots; the same goes for the other two indexes.)</summary>
+			graphics::SpatialIndex shot_index {};
+			graphics::SpatialIndex tower_index {};
+			graphics::SpatialIndex enemy_index {};
+			/// <summary>The width of a game square in screen coordinates.</summary>
+			float square_sw {0.f};
+			/// <summary>The height of a game square in screen coordinates.</summary>
+			float square_sh {0.f};
+			/// <summary>Should tower levels be drawn with small text? (Large maps have small squares.)</summary>
+			bool use_small_text {false};
+			// Status shown on the screen.
+			int level {1};
+			double difficulty {1.0};
+			int health {0};
+			double money {0.0};
+			bool is_alive {true};
+			long long score {0};
+			bool is_hiscore {false};
+			bool in_level {false};
+			bool is_paused {false};
+			bool is_max_speed {false};
+			double ticks_per_second {0.0};
+			/// <summary>The (x, y) game coordinates of the squares on the paths found by the
+			/// debugging pathfinders. (These are empty unless the paths are being shown.)</summary>
+			std::vector<std::pair<int, int>> ground_test_path {};
+			std::vector<std::pair<int, int>> air_test_path {};
+		};
+	}
+}
\ No newline at end of file
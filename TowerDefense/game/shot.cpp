@@ -1,15 +1,19 @@
 // File Author: Isaiah Hoffman
 // File Created: June 4, 2018
 #include <cmath>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 #include "./../globals.hpp"
 #include "./../ih_math.hpp"
+#include "./../perf_counters.hpp"
 #include "./../graphics/graphics.hpp"
 #include "./../pathfinding/grid.hpp"
 #include "./enemy.hpp"
+#include "./game_context.hpp"
 #include "./game_object.hpp"
+#include "./my_game.hpp"
 #include "./shot.hpp"
 #include "./shot_types.hpp"
 #include "./tower.hpp"
@@ -22,13 +26,65 @@ namespace hoffman_isaiah {
 			ot.getGameX(), ot.getGameY(), 0.3f, 0.3f},
 			base_type {stype},
 			origin_tower {ot},
-			theta {angle} {
+			theta {angle},
+			frame_dgx {std::cos(angle) * stype->getSpeed() / game::logic_framerate},
+			frame_dgy {std::sin(angle) * stype->getSpeed() / game::logic_framerate} {
+			this->frames_to_live = this->computeFramesToLive();
 		}
 
-		bool Shot::update(std::vector<std::unique_ptr<Enemy>>& enemies) {
-			// Update location
+		int Shot::computeFramesToLive() const {
 			const double r = this->base_type->getSpeed() / game::logic_framerate;
-			this->translate(std::cos(this->theta) * r, std::sin(this->theta) * r);
+			// The old per-frame check removed the shot once its distance from the tower exceeded the range.
+			const int range_frames = static_cast<int>(std::floor(this->origin_tower.getFiringRange() / r)) + 1;
+			const double max_dist = range_frames * r;
+			const auto& ground_graph = this->getGameMap().getTerrainGraph(false);
+			const auto& air_graph = this->getGameMap().getTerrainGraph(true);
+			// Amanatides-Woo traversal of the tiles along the shot's path.
+			// (Distances are measured along the path in game coordinate squares.)
+			const double dir_x = std::cos(this->theta);
+			const double dir_y = std::sin(this->theta);
+			constexpr const double no_crossing = 1e20;
+			int tile_x = static_cast<int>(std::floor(this->getGameX()));
+			int tile_y = static_cast<int>(std::floor(this->getGameY()));
+			const int step_x = dir_x > 0 ? 1 : -1;
+			const int step_y = dir_y > 0 ? 1 : -1;
+			const double delta_x = dir_x != 0.0 ? 1.0 / std::abs(dir_x) : no_crossing;
+			const double delta_y = dir_y != 0.0 ? 1.0 / std::abs(dir_y) : no_crossing;
+			double next_x = dir_x > 0 ? (tile_x + 1 - this->getGameX()) * delta_x
+				: dir_x < 0 ? (this->getGameX() - tile_x) * delta_x : no_crossing;
+			double next_y = dir_y > 0 ? (tile_y + 1 - this->getGameY()) * delta_y
+				: dir_y < 0 ? (this->getGameY() - tile_y) * delta_y : no_crossing;
+			double tile_enter_dist = 0.0;
+			while (tile_enter_dist <= max_dist) {
+				// The first frame on which the shot is positioned within the current tile.
+				const int enter_frame = math::get_max(1, static_cast<int>(std::ceil(tile_enter_dist / r)));
+				if (tile_x < 0 || tile_y < 0 || tile_x >= ground_graph.getWidth() || tile_y >= ground_graph.getHeight()) {
+					// Off the map (which the shot can never come back from.)
+					return math::get_min(range_frames, enter_frame);
+				}
+				const double tile_exit_dist = math::get_min(next_x, next_y);
+				if (ground_graph.getNode(tile_x, tile_y).isBlocked() && air_graph.getNode(tile_x, tile_y).isBlocked()
+					&& enter_frame * r < tile_exit_dist) {
+					// (Shots fast enough to skip over a tile entirely between frames are not stopped by it.)
+					return math::get_min(range_frames, enter_frame);
+				}
+				tile_enter_dist = tile_exit_dist;
+				if (next_x < next_y) {
+					tile_x += step_x;
+					next_x += delta_x;
+				}
+				else {
+					tile_y += step_y;
+					next_y += delta_y;
+				}
+			}
+			return range_frames;
+		}
+
+		bool Shot::update(const GameContext& context, std::vector<std::unique_ptr<Enemy>>& enemies) {
+			// Update location
+			this->translate(this->frame_dgx, this->frame_dgy);
+			--this->frames_to_live;
 			// Check for hits
 			unsigned int i = 0;
 			for (; i < enemies.size(); ++i) {
@@ -38,7 +94,11 @@ namespace hoffman_isaiah {
 					break;
 				}
 			}
+			context.game.getPerfCounters().increment(util::PerfCounters::Collision_Tests,
+				i < enemies.size() ? i + 1 : i);
 			if (i < enemies.size() && this->base_type->getImpactRadius() > 0.0) {
+				context.game.getPerfCounters().increment(util::PerfCounters::Collision_Tests,
+					static_cast<std::int64_t>(enemies.size()) - 1);
 				// Check for splash effects as well
 				for (unsigned int j = 0; j < enemies.size(); ++j) {
 					auto& e = enemies[j];
@@ -52,21 +112,7 @@ namespace hoffman_isaiah {
 					}
 				}
 			}
-			const double tdx = std::abs(this->getGameX() - this->origin_tower.getGameX());
-			const double tdy = std::abs(this->getGameY() - this->origin_tower.getGameY());
-			const int igx = static_cast<int>(std::floor(this->getGameX()));
-			const int igy = static_cast<int>(std::floor(this->getGameY()));
-			const bool is_on_blocked_space = (igx >= 0 && igy >= 0
-				&& igx < this->getGameMap().getTerrainGraph(false).getWidth()
-				&& igy < this->getGameMap().getTerrainGraph(false).getHeight())
-				? this->getGameMap().getTerrainGraph(true).getNode(igx, igy).isBlocked()
-					&& this->getGameMap().getTerrainGraph(false).getNode(igx, igy).isBlocked()
-				: true;
-			return i < enemies.size() || is_on_blocked_space
-				|| std::sqrt(tdx * tdx + tdy * tdy) > this->origin_tower.getFiringRange()
-				|| this->getGameX() < 0 || this->getGameY() < 0
-				|| this->getGameX() >= this->getGameMap().getTerrainGraph(false).getWidth()
-				|| this->getGameY() >= this->getGameMap().getTerrainGraph(false).getHeight();
+			return i < enemies.size() || this->frames_to_live <= 0;
 		}
 	}
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "./../globals.hpp"
 #include "./../graphics/graphics.hpp"
 #include "./../pathfinding/grid.hpp"
+#include "./game_context.hpp"
 #include "./game_object.hpp"
 #include "./shot_types.hpp"
 
@@ -23,9 +24,22 @@ namespace hoffman_isaiah {
 				const ShotBaseType* stype, graphics::Color o_color, const Tower& ot, double angle);
 
 			/// <summary>Advances the projectile's state by one logical frame.</summary>
+			/// <param name="context">The game that the projectile belongs to.</param>
 			/// <param name"enemies">The list of enemies currently present in the game.</param>
 			/// <returns>True if this shot should be deleted; otherwise, false.</returns>
-			bool update(std::vector<std::unique_ptr<Enemy>>& enemies);
+			bool update(const GameContext& context, std::vector<std::unique_ptr<Enemy>>& enemies);
+			/// <returns>The number of logical frames remaining before the projectile expires
+			/// (assuming that it does not hit anything first).</returns>
+			int getFramesToLive() const noexcept {
+				return this->frames_to_live;
+			}
+		protected:
+			/// <summary>Determines the logical frame on which the projectile will leave its tower's
+			/// range, leave the map, or land on a space that is blocked for both ground and air units.
+			/// (Shots travel in a straight line at a constant speed, so this is done once by walking
+			/// the tiles along the projectile's path.)</summary>
+			/// <returns>The number of frames that the projectile lives for (ignoring collisions).</returns>
+			int computeFramesToLive() const;
 		private:
 			/// <summary>The template type of this projectile.</summary>
 			const ShotBaseType* base_type;
@@ -33,6 +47,12 @@ namespace hoffman_isaiah {
 			const Tower& origin_tower;
 			/// <summary>The angle (in radians) that the projectile moves in each turn.</summary>
 			double theta;
+			/// <summary>The change in the projectile's game x-coordinate each logical frame.</summary>
+			double frame_dgx;
+			/// <summary>The change in the projectile's game y-coordinate each logical frame.</summary>
+			double frame_dgy;
+			/// <summary>The number of logical frames remaining before the projectile expires.</summary>
+			int frames_to_live {0};
 		};
 	}
 }
\ No newline at end of file
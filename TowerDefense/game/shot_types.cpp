@@ -35,9 +35,8 @@ namespace hoffman_isaiah {
 				// Don't apply another (because otherwise, DoT gets overpowered)
 				return;
 			}
-			auto my_status = std::make_unique<DoTEffect>(this->getDamageType(),
-				this->getDamagePerTick(), this->getMillisecondsBetweenTicks(), this->getTotalTicks());
-			e.addStatus(std::move(my_status));
+			e.addStatus(DoTEffect {this->getDamageType(), this->getDamagePerTick(),
+				this->getMillisecondsBetweenTicks(), this->getTotalTicks()});
 		}
 
 		void SlowShotType::apply(Enemy& e) const {
@@ -47,8 +46,7 @@ namespace hoffman_isaiah {
 					return;
 				}
 			}
-			auto my_status = std::make_unique<SlowEffect>(this->getSlowDuration(), this->getSlowFactor());
-			e.addStatus(std::move(my_status));
+			e.addStatus(SlowEffect {static_cast<double>(this->getSlowDuration()), this->getSlowFactor()});
 		}
 
 		void StunShotType::apply(Enemy& e) const {
@@ -64,8 +62,7 @@ namespace hoffman_isaiah {
 					return;
 				}
 			}
-			auto my_status = std::make_unique<StunEffect>(this->getStunDuration());
-			e.addStatus(std::move(my_status));
+			e.addStatus(StunEffect {this->getStunDuration()});
 		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include "./../targetver.hpp"
+#include <Windows.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "./../task_graph.hpp"
+#include "./my_game.hpp"
+#include "./simulation_host.hpp"
+using namespace std::literals::string_literals;
+
+namespace hoffman_isaiah {
+	namespace game {
+		SimulationHost::SimulationHost(const MyGame& source, unsigned int session_count) {
+			if (session_count == 0) {
+				session_count = std::max(std::thread::hardware_concurrency(), 1U);
+			}
+			for (unsigned int i = 0; i < session_count; ++i) {
+				// (The Direct2D factory is multithreaded, so every session can create its geometry with it.)
+				auto my_session = std::make_unique<MyGame>(source.getDeviceResources());
+				my_session->setHeadless(true);
+				my_session->load_config_data();
+				my_session->shareTypeData(source);
+				this->sessions.emplace_back(std::move(my_session));
+			}
+		}
+
+		SimulationHost::~SimulationHost() noexcept = default;
+
+		int SimulationHost::runJobs(int job_count, const std::function<bool(MyGame& game, int job)>& run_job,
+			const std::function<void(int job, bool succeeded)>& on_finished) {
+			// Guards the idle sessions, the failure count, and calls to on_finished.
+			std::mutex my_mutex {};
+			std::vector<MyGame*> idle_sessions {};
+			for (const auto& my_session : this->sessions) {
+				idle_sessions.emplace_back(my_session.get());
+			}
+			int jobs_failed = 0;
+			util::TaskGraph my_jobs {};
+			for (int i = 0; i < job_count; ++i) {
+				my_jobs.addTask(L"Job "s + std::to_wstring(i), [&, i]() {
+					// There is one thread per session, so a session is always free when a job starts.
+					MyGame* my_session = nullptr;
+					{
+						std::lock_guard<std::mutex> lock {my_mutex};
+						my_session = idle_sessions.back();
+						idle_sessions.pop_back();
+					}
+					// Keep the computer usable during long runs.
+					SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+					bool succeeded = false;
+					try {
+						succeeded = run_job(*my_session, i);
+					}
+					catch (...) {
+						succeeded = false;
+					}
+					std::lock_guard<std::mutex> lock {my_mutex};
+					idle_sessions.emplace_back(my_session);
+					if (!succeeded) {
+						++jobs_failed;
+					}
+					if (on_finished) {
+						on_finished(i, succeeded);
+					}
+				});
+			}
+			my_jobs.run(static_cast<unsigned int>(this->sessions.size()));
+			return jobs_failed;
+		}
+	}
+}
\ No newline at end of file
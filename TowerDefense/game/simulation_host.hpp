@@ -0,0 +1,51 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace hoffman_isaiah {
+	namespace game {
+		// Forward declaration
+		class MyGame;
+
+		/// <summary>Plays many headless games at the same time in this process. Each session is a
+		/// game of its own (with its own map, enemies, towers, and shots, whose storage is reused
+		/// from one job to the next), while the type data and level templates are loaded once and
+		/// shared by every session. Jobs are run on a pool of threads with one thread per session,
+		/// and a session is only ever used by one job at a time.</summary>
+		class SimulationHost {
+		public:
+			/// <summary>Creates the sessions.</summary>
+			/// <param name="source">The game whose type data and level templates are shared. It must
+			/// be fully loaded and must outlive this object.</param>
+			/// <param name="session_count">The number of games to play at once or 0 to play one game
+			/// per core.</param>
+			SimulationHost(const MyGame& source, unsigned int session_count = 0);
+			~SimulationHost() noexcept;
+			// Rule of 5:
+			SimulationHost(const SimulationHost&) = delete;
+			SimulationHost(SimulationHost&&) = delete;
+			SimulationHost& operator=(const SimulationHost&) = delete;
+			SimulationHost& operator=(SimulationHost&&) = delete;
+			/// <summary>Runs jobs on the sessions and waits for every job to finish.</summary>
+			/// <param name="job_count">The number of jobs to run.</param>
+			/// <param name="run_job">Runs a job with the game of the session that it was given. Returns
+			/// false if the job failed. (A job that throws an exception also fails.) This is called
+			/// from the pool's threads.</param>
+			/// <param name="on_finished">Called with the index of each job once it finishes along with
+			/// whether it succeeded (if not empty). Calls are never made at the same time as each other.</param>
+			/// <returns>The number of jobs that failed.</returns>
+			int runJobs(int job_count, const std::function<bool(MyGame& game, int job)>& run_job,
+				const std::function<void(int job, bool succeeded)>& on_finished = nullptr);
+			// Getters
+			int getSessionCount() const noexcept {
+				return static_cast<int>(this->sessions.size());
+			}
+		private:
+			/// <summary>The game of each session.</summary>
+			std::vector<std::unique_ptr<MyGame>> sessions {};
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include "./../targetver.hpp"
+#include <Windows.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "./../globals.hpp"
+#include "./../ih_math.hpp"
+#include "./../profiler.hpp"
+#include "./my_game.hpp"
+#include "./render_snapshot.hpp"
+#include "./simulation_thread.hpp"
+
+namespace hoffman_isaiah {
+	namespace game {
+		SimulationThread::~SimulationThread() noexcept {
+			this->stop();
+		}
+
+		void SimulationThread::start() {
+			this->my_game.fillRenderSnapshot(this->snapshots.getWriteBuffer());
+			this->snapshots.publish();
+			this->keep_running.store(true, std::memory_order_release);
+			this->worker = std::thread {[this]() {
+				this->run();
+			}};
+		}
+
+		void SimulationThread::stop() noexcept {
+			this->keep_running.store(false, std::memory_order_release);
+			if (this->worker.joinable()) {
+				this->worker.join();
+			}
+		}
+
+		void SimulationThread::postCommand(const GameCommand& my_command) {
+			if (!this->commands.tryPush(my_command)) {
+				this->executeCommand(my_command);
+			}
+		}
+
+		std::unique_lock<std::mutex> SimulationThread::lockGame() {
+			this->waiting_threads.fetch_add(1, std::memory_order_relaxed);
+			std::unique_lock<std::mutex> my_lock {this->game_mutex};
+			this->waiting_threads.fetch_sub(1, std::memory_order_relaxed);
+			return my_lock;
+		}
+
+		void SimulationThread::executeCommand(const GameCommand& my_command) {
+			switch (my_command.type) {
+			case GameCommandTypes::Buy_Tower:
+				this->my_game.buyTower(my_command.gx, my_command.gy);
+				break;
+			case GameCommandTypes::Sell_Tower:
+				this->my_game.sellTower(my_command.gx, my_command.gy);
+				break;
+			case GameCommandTypes::Start_Wave:
+				this->my_game.startWave();
+				break;
+			default:
+				break;
+			}
+		}
+
+		void SimulationThread::run() {
+			IH_PROFILE_THREAD_NAME("Simulation");
+			using clock = std::chrono::steady_clock;
+			const auto tick_length = std::chrono::microseconds {math::getMicrosecondsInSecond() / logic_framerate};
+			const auto max_speed_budget = std::chrono::duration<double, std::milli> {max_speed_tick_budget_ms};
+			const auto tick_rate_interval = std::chrono::duration<double, std::milli> {tick_rate_sample_interval_ms};
+			auto next_tick_time = clock::now();
+			auto last_tick_rate_time = next_tick_time;
+			long long last_tick_count = -1;
+			while (this->keep_running.load(std::memory_order_acquire)) {
+				bool is_max_speed = false;
+				{
+					std::unique_lock<std::mutex> my_lock {this->game_mutex};
+					// Player actions are run between ticks so that a tick never sees half of one.
+					GameCommand my_command {};
+					while (this->commands.tryPop(my_command)) {
+						this->executeCommand(my_command);
+					}
+					is_max_speed = this->my_game.isMaxSpeed() && this->my_game.isInLevel() && !this->my_game.isPaused();
+					if (is_max_speed) {
+						// Run as many ticks as fit in the budget unless the UI needs the game.
+						const auto budget_end_time = clock::now() + max_speed_budget;
+						do {
+							this->my_game.update();
+						} while (this->my_game.isInLevel() && !this->my_game.isPaused()
+							&& this->waiting_threads.load(std::memory_order_relaxed) == 0
+							&& clock::now() < budget_end_time);
+						next_tick_time = clock::now();
+					}
+					else {
+						const auto now = clock::now();
+						int ticks_run = 0;
+						while (next_tick_time <= now && ticks_run < max_catch_up_ticks) {
+							this->my_game.update();
+							next_tick_time += tick_length;
+							++ticks_run;
+						}
+						if (next_tick_time <= now) {
+							// Too far behind (such as after a dialog held the lock); drop the missed ticks.
+							next_tick_time = now + tick_length;
+						}
+					}
+					// Measure the number of ticks run per second.
+					const auto tick_rate_time = clock::now();
+					if (last_tick_count < 0) {
+						last_tick_count = this->my_game.getTickCount();
+					}
+					else if (tick_rate_time - last_tick_rate_time >= tick_rate_interval) {
+						const std::chrono::duration<double> elapsed_seconds = tick_rate_time - last_tick_rate_time;
+						this->my_game.setTicksPerSecond((this->my_game.getTickCount() - last_tick_count)
+							/ elapsed_seconds.count());
+						last_tick_rate_time = tick_rate_time;
+						last_tick_count = this->my_game.getTickCount();
+					}
+					this->my_game.fillRenderSnapshot(this->snapshots.getWriteBuffer());
+				}
+				this->snapshots.publish();
+				if (is_max_speed) {
+					std::this_thread::yield();
+				}
+				else {
+					std::this_thread::sleep_until(next_tick_time);
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
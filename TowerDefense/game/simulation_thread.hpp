@@ -0,0 +1,86 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "./../spsc_queue.hpp"
+#include "./../triple_buffer.hpp"
+#include "./render_snapshot.hpp"
+
+namespace hoffman_isaiah {
+	namespace game {
+		// Forward declaration
+		class MyGame;
+
+		/// <summary>The player actions that are run by the simulation thread between ticks.</summary>
+		enum class GameCommandTypes {
+			Buy_Tower, Sell_Tower, Start_Wave, Sentinel_DO_NOT_USE
+		};
+
+		/// <summary>A player action waiting to be run by the simulation thread.</summary>
+		struct GameCommand {
+			/// <summary>The action to take.</summary>
+			GameCommandTypes type {GameCommandTypes::Sentinel_DO_NOT_USE};
+			/// <summary>The x-coordinate of the square to act on (if any).</summary>
+			int gx {-1};
+			/// <summary>The y-coordinate of the square to act on (if any).</summary>
+			int gy {-1};
+		};
+
+		/// <summary>Runs the game's logic ticks at a fixed rate on a thread of its own. After
+		/// each tick, a render snapshot is published for the UI thread to draw, so drawing never
+		/// waits on the simulation and the simulation never waits on drawing.</summary>
+		class SimulationThread {
+		public:
+			/// <param name="game">The game to simulate. (It must outlive this object.)</param>
+			SimulationThread(MyGame& game) :
+				my_game {game} {
+			}
+			/// <summary>Stops the thread if it is still running.</summary>
+			~SimulationThread() noexcept;
+			SimulationThread(const SimulationThread&) = delete;
+			SimulationThread& operator=(const SimulationThread&) = delete;
+			/// <summary>Publishes a snapshot of the game's current state and then starts the thread.</summary>
+			void start();
+			/// <summary>Stops the thread after its current tick and waits for it to exit. (This
+			/// must not be called while holding the game's lock.)</summary>
+			void stop() noexcept;
+			/// <summary>Queues a player action to be run before the next tick. (This should only
+			/// be called by the UI thread while it holds the game's lock; the action is run right
+			/// away if the queue happens to be full.)</summary>
+			/// <param name="my_command">The action to run.</param>
+			void postCommand(const GameCommand& my_command);
+			/// <summary>Locks the game so that it can be read or changed outside of the simulation
+			/// thread. (The simulation thread gives up the lock as soon as it can.)</summary>
+			/// <returns>The lock, which is held until it is destroyed.</returns>
+			std::unique_lock<std::mutex> lockGame();
+			/// <returns>The newest render snapshot. (This should only be called by the UI thread,
+			/// and the result may only be used until the next call.)</returns>
+			const RenderSnapshot& getLatestSnapshot() noexcept {
+				return this->snapshots.getReadBuffer();
+			}
+		protected:
+			/// <summary>The simulation thread's main loop.</summary>
+			void run();
+			/// <summary>Runs a player action. (The game's lock must be held.)</summary>
+			/// <param name="my_command">The action to run.</param>
+			void executeCommand(const GameCommand& my_command);
+		private:
+			/// <summary>The game being simulated.</summary>
+			MyGame& my_game;
+			/// <summary>Guards the game state.</summary>
+			std::mutex game_mutex {};
+			/// <summary>The number of threads (other than the simulation thread) waiting for the game's lock.</summary>
+			std::atomic<int> waiting_threads {0};
+			/// <summary>Cleared to ask the thread to exit.</summary>
+			std::atomic<bool> keep_running {false};
+			/// <summary>The simulation thread itself.</summary>
+			std::thread worker {};
+			/// <summary>Player actions waiting to be run.</summary>
+			util::SpscQueue<GameCommand, 256> commands {};
+			/// <summary>Passes render snapshots from the simulation thread to the UI thread.</summary>
+			util::TripleBuffer<RenderSnapshot> snapshots {};
+		};
+	}
+}
\ No newline at end of file
@@ -1,14 +1,29 @@
 // File Author: Isaiah Hoffman
 // File Created: May 21, 2018
+#include <variant>
+#include "./../perf_counters.hpp"
 #include "./enemy.hpp"
+#include "./game_context.hpp"
 #include "./my_game.hpp"
 #include "./status_effects.hpp"
 #include "./game_util.hpp"
 
 namespace hoffman_isaiah {
 	namespace game {
+		bool updateStatusEffect(StatusEffect& effect, Enemy& e, const GameContext& context) {
+			return std::visit([&e, &context](auto& my_effect) {
+				return my_effect.update(e, context);
+			}, effect);
+		}
+
+		void clearStatusEffect(StatusEffect& effect, Enemy& e) {
+			std::visit([&e](auto& my_effect) {
+				my_effect.clearEffects(e);
+			}, effect);
+		}
 
-		bool DoTEffect::update(Enemy& e) {
+		bool DoTEffect::update(Enemy& e, const GameContext& context) {
+			UNREFERENCED_PARAMETER(context);
 			++this->frames_since_last_tick;
 			e.setDoTActive(true);
 			if (this->frames_since_last_tick >= this->frames_between_ticks) {
@@ -33,14 +48,15 @@ namespace hoffman_isaiah {
 			return this->total_ticks <= 0;
 		}
 
-		bool SmartStrategyEffect::update(Enemy& e) {
+		bool SmartStrategyEffect::update(Enemy& e, const GameContext& context) {
 			// (Weird ordering, but I don't want the case
 			// where a programming/design bug causes
 			// the enemy's strategy to be permanently
 			// replaced.)
 			if (this->frames_until_expire <= 0) {
 				// Revert to default
-				e.changeStrategy(game::g_my_game->getMap(), e.getBaseType().getDefaultStrategy(),
+				context.game.getPerfCounters().increment(util::PerfCounters::Repaths_Strategy_Restore);
+				e.changeStrategy(context, e.getBaseType().getDefaultStrategy(),
 					e.getBaseType().canMoveDiagonally());
 				return true;
 			}
@@ -67,7 +83,8 @@ namespace hoffman_isaiah {
 					// on enemy by eliminating unnecessary ones
 					return true;
 				}
-				e.changeStrategy(game::g_my_game->getMap(), this->strat, this->diag_change);
+				context.game.getPerfCounters().increment(util::PerfCounters::Repaths_Strategy_Change);
+				e.changeStrategy(context, this->strat, this->diag_change);
 				this->done_payload = true;
 			}
 			if (this->done_payload) {
@@ -79,7 +96,8 @@ namespace hoffman_isaiah {
 			return false;
 		}
 
-		bool SlowEffect::update(Enemy& e) {
+		bool SlowEffect::update(Enemy& e, const GameContext& context) {
+			UNREFERENCED_PARAMETER(context);
 			// It is worth noting that slow effects are multiplicative.
 			// For instance, if an enemy receives both a 10% slow effect
 			// and a 25% slow effect, the total slowdown for the enemy
@@ -95,7 +113,8 @@ namespace hoffman_isaiah {
 			e.setStun(false);
 		}
 
-		bool StunEffect::update(Enemy& e) {
+		bool StunEffect::update(Enemy& e, const GameContext& context) {
+			UNREFERENCED_PARAMETER(context);
 			e.setStun(true);
 			--this->frames_until_expire;
 			if (this->frames_until_expire < 0) {
@@ -104,7 +123,8 @@ namespace hoffman_isaiah {
 			return this->frames_until_expire < 0;
 		}
 
-		bool SpeedBoostEffect::update(Enemy& e) {
+		bool SpeedBoostEffect::update(Enemy& e, const GameContext& context) {
+			UNREFERENCED_PARAMETER(context);
 			// Like with the SlowEffect, these values are multiplicative,
 			// not additive.
 			// One has to be careful here as there is no upper cap, so
@@ -117,7 +137,8 @@ namespace hoffman_isaiah {
 			return this->frames_until_expire <= 0;
 		}
 
-		bool ShieldEffect::update(Enemy& e) {
+		bool ShieldEffect::update(Enemy& e, const GameContext& context) {
+			UNREFERENCED_PARAMETER(context);
 			e.degradeShield(this->shield_dmg_per_tick);
 			--this->frames_until_expire;
 			return this->frames_until_expire <= 0 || e.getShieldHealth() <= 0.0;
@@ -1,9 +1,12 @@
 #pragma once
 // File Author: Isaiah Hoffman
 // File Created: May 21, 2018
+#include "./../globals.hpp"
 #include "./../ih_math.hpp"
+#include "./game_context.hpp"
 #include <array>
 #include <string>
+#include <variant>
 
 namespace hoffman_isaiah {
 	namespace game {
@@ -12,36 +15,27 @@ namespace hoffman_isaiah {
 
 		/// <summary>Enumeration of possible status effects.</summary>
 		enum class StatusEffects {
-			DoT, Smart, Slow, Stun, Speed_Boost, Forcefield
+			DoT, Smart, Slow, Stun, Speed_Boost, Forcefield, Sentinel_DO_NOT_USE
 		};
 
+		// Status effects are applied very frequently (think of a fast-firing slow tower),
+		// so they are stored by value in a std::variant (see StatusEffect below) rather
+		// than allocated one at a time and called through virtual functions.
+		// Every effect class must provide update(), clearEffects(), and isPositiveEffect().
 		/// <summary>Base class for all status effects.</summary>
 		class StatusEffectBase {
 		public:
 			StatusEffectBase(StatusEffects my_effect_type) noexcept :
 				effect_type {my_effect_type} {
 			}
-			virtual ~StatusEffectBase() noexcept = default;
-			// Rule of 5:
-			StatusEffectBase(const StatusEffectBase&) noexcept = default;
-			StatusEffectBase(StatusEffectBase&&) noexcept = default;
-			StatusEffectBase& operator=(const StatusEffectBase&) noexcept = default;
-			StatusEffectBase& operator=(StatusEffectBase&&) noexcept = default;
 			/// <summary>This function clears harmful effects when the status effect finishes.</summary>
-			virtual void clearEffects(Enemy& e) {
+			void clearEffects(Enemy& e) {
 				UNREFERENCED_PARAMETER(e);
 			}
-			/// <summary>This function is called once every frame on each
-			/// enemy afflicted by this status effect.</summary>
-			/// <param name="e">The enemy that this is being called for.</param>
-			/// <returns>True if the status effect should be removed from the enemy.</returns>
-			virtual bool update(Enemy& e) = 0;
 			// Getters
 			StatusEffects getStatusEffectType() const noexcept {
 				return this->effect_type;
 			}
-			/// <returns>True if the status effect is considered beneficial to the enemy; otherwise, false.</returns>
-			virtual bool isPositiveEffect() const noexcept = 0;
 		private:
 			/// <summary>The status effect type.</summary>
 			StatusEffects effect_type;
@@ -78,10 +72,10 @@ namespace hoffman_isaiah {
 				frames_between_ticks {math::convertMillisecondsToFrames(ms_tick)},
 				total_ticks {t_ticks} {
 			}
-			// Implements StatusEffectBase::update()
-			bool update(Enemy& e) override;
-			// Implements StatusEffectBase::isPositiveEffect()
-			bool isPositiveEffect() const noexcept override {
+			// Used by updateStatusEffect()
+			bool update(Enemy& e, const GameContext& context);
+			// Used by isPositiveEffect()
+			bool isPositiveEffect() const noexcept {
 				return this->type == DoTDamageTypes::Heal;
 			}
 		private:
@@ -110,10 +104,10 @@ namespace hoffman_isaiah {
 				strat {new_strat},
 				diag_change {diag_move_change} {
 			}
-			// Implements StatusEffectBase::update()
-			bool update(Enemy& e) override;
-			// Implements StatusEffectBase::isPositiveEffect()
-			bool isPositiveEffect() const noexcept override {
+			// Used by updateStatusEffect()
+			bool update(Enemy& e, const GameContext& context);
+			// Used by isPositiveEffect()
+			bool isPositiveEffect() const noexcept {
 				return true;
 			}
 		private:
@@ -150,10 +144,10 @@ namespace hoffman_isaiah {
 				frames_until_expire {math::convertMillisecondsToFrames(ms_til_expires)},
 				speed_multiplier {1.0 - sf} {
 			}
-			// Implements StatusEffectBase::update()
-			bool update(Enemy& e) override;
-			// Implements StatusEffectBase::isPositiveEffect()
-			bool isPositiveEffect() const noexcept override {
+			// Used by updateStatusEffect()
+			bool update(Enemy& e, const GameContext& context);
+			// Used by isPositiveEffect()
+			bool isPositiveEffect() const noexcept {
 				return this->speed_multiplier > 1.0;
 			}
 		private:
@@ -173,12 +167,12 @@ namespace hoffman_isaiah {
 				StatusEffectBase {StatusEffects::Stun},
 				frames_until_expire {math::convertMillisecondsToFrames(ms_until_expires)} {
 			}
-			// Implements StatusEffectBase::onClear()
-			void clearEffects(Enemy& e) override;
-			// Implements StatusEffectBase::update()
-			bool update(Enemy& e) override;
-			// Implements StatusEffectBase::isPositiveEffect()
-			bool isPositiveEffect() const noexcept override {
+			// Used by clearStatusEffect() (hides StatusEffectBase::clearEffects())
+			void clearEffects(Enemy& e);
+			// Used by updateStatusEffect()
+			bool update(Enemy& e, const GameContext& context);
+			// Used by isPositiveEffect()
+			bool isPositiveEffect() const noexcept {
 				return false;
 			}
 		private:
@@ -210,10 +204,10 @@ namespace hoffman_isaiah {
 				// Don't try to use this as a knockback effect; this game is not
 				// designed for such an effect!
 			}
-			// Implements StatusEffectBase::update()
-			bool update(Enemy& e) override;
-			// Implements StatusEffectBase::isPositiveEffect()
-			bool isPositiveEffect() const noexcept override {
+			// Used by updateStatusEffect()
+			bool update(Enemy& e, const GameContext& context);
+			// Used by isPositiveEffect()
+			bool isPositiveEffect() const noexcept {
 				return math::get_avg(this->walking_boost, this->running_boost, this->injured_boost) > 1.0;
 			}
 		private:
@@ -240,11 +234,10 @@ namespace hoffman_isaiah {
 				shield_dmg_per_tick {0} {
 				this->shield_dmg_per_tick = sh / this->frames_until_expire;
 			}
-		protected:
-			// Implements StatusEffectBase::update()
-			bool update(Enemy& e) override;
-			// Implements StatusEffectBase::isPositiveEffect()
-			bool isPositiveEffect() const noexcept override {
+			// Used by updateStatusEffect()
+			bool update(Enemy& e, const GameContext& context);
+			// Used by isPositiveEffect()
+			bool isPositiveEffect() const noexcept {
 				return true;
 			}
 		private:
@@ -253,5 +246,32 @@ namespace hoffman_isaiah {
 			/// <summary>The amount by which the enemy's shield degrades each frame.</summary>
 			double shield_dmg_per_tick;
 		};
+
+		/// <summary>Holds any one of the status effects by value.</summary>
+		using StatusEffect = std::variant<DoTEffect, SmartStrategyEffect, SlowEffect,
+			StunEffect, SpeedBoostEffect, ShieldEffect>;
+
+		/// <summary>Advances a status effect by one logical frame.</summary>
+		/// <param name="effect">The status effect to update.</param>
+		/// <param name="e">The enemy afflicted by the status effect.</param>
+		/// <param name="context">The game that the enemy belongs to.</param>
+		/// <returns>True if the status effect should be removed from the enemy.</returns>
+		bool updateStatusEffect(StatusEffect& effect, Enemy& e, const GameContext& context);
+		/// <summary>Clears any harmful effects left on the enemy by the status effect.</summary>
+		/// <param name="effect">The status effect being removed.</param>
+		/// <param name="e">The enemy afflicted by the status effect.</param>
+		void clearStatusEffect(StatusEffect& effect, Enemy& e);
+		/// <returns>True if the status effect is considered beneficial to the enemy; otherwise, false.</returns>
+		inline bool isPositiveEffect(const StatusEffect& effect) {
+			return std::visit([](const auto& my_effect) noexcept {
+				return my_effect.isPositiveEffect();
+			}, effect);
+		}
+		/// <returns>The type of the given status effect.</returns>
+		inline StatusEffects getStatusEffectType(const StatusEffect& effect) {
+			return std::visit([](const auto& my_effect) noexcept {
+				return my_effect.getStatusEffectType();
+			}, effect);
+		}
 	}
 }
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include "./../graphics/graphics_DX.hpp"
 #include "./../pathfinding/grid.hpp"
 #include "./enemy.hpp"
+#include "./game_context.hpp"
 #include "./game_object.hpp"
 #include "./game_util.hpp"
 #include "./shot.hpp"
@@ -21,73 +22,24 @@
 
 namespace hoffman_isaiah {
 	namespace game {
-		void Tower::draw(const graphics::Renderer2D& renderer) const noexcept {
-			GameObject::draw(renderer);
-			// Draw radius if appropriate
-			if (!this->getBaseType()->isWall() && this->show_coverage) {
-				renderer.setOutlineColor(graphics::Color {0.7f, 0.f, 0.f, 0.8f});
-				renderer.outlineEllipse(renderer.createEllipse(static_cast<float>(this->getScreenX()),
-					static_cast<float>(this->getScreenY()),
-					static_cast<float>(this->getFiringRange() * this->getGameMap().getGameSquareWidth<double>()),
-					static_cast<float>(this->getFiringRange() * this->getGameMap().getGameSquareHeight<double>())));
-				// Also paint upgrade level.
-				constexpr const graphics::Color text_color {1.f, 0.2f, 1.f, 1.f};
-				if (this->getLevel() > 1) {
-					if (this->getGameMap().getColumns() <= 40 && this->getGameMap().getRows() <= 40) {
-						renderer.drawText(std::to_wstring(this->getLevel()), text_color,
-							renderer.createRectangle(static_cast<float>(this->getGameMap().convertToScreenX(this->getGameX() - 0.5)),
-								static_cast<float>(this->getGameMap().convertToScreenY(this->getGameY() - 0.5)),
-								this->getGameMap().getGameSquareWidth<float>(), this->getGameMap().getGameSquareHeight<float>()));
-					}
-					else {
-						renderer.drawSmallText(std::to_wstring(this->getLevel()), text_color,
-							renderer.createRectangle(static_cast<float>(this->getGameMap().convertToScreenX(this->getGameX() - 0.5)),
-								static_cast<float>(this->getGameMap().convertToScreenY(this->getGameY() - 0.5)),
-								this->getGameMap().getGameSquareWidth<float>(), this->getGameMap().getGameSquareHeight<float>()));
-					}
-				}
-			}
-			if (this->getVolleyShots() == 0) {
-				return;
-			}
-			// Draw ammunition bar
-			constexpr const graphics::Color bar_outline_color {0.2f, 0.2f, 0.2f, 1.0f};
-			constexpr const graphics::Color bar_empty_color {0.8f, 0.8f, 0.8f, 0.6f};
-			constexpr const graphics::Color bar_filling_color {1.f, 0.f, 1.f, 0.9f};
-			constexpr const graphics::Color bar_reloading_color {0.3f, 0.6f, 0.6f, 0.7f};
-			const float shots_fired_percent = static_cast<float>(this->shots_fired_since_reload)
-				/ static_cast<float>(this->getVolleyShots());
-			const float reload_time_percent = static_cast<float>(this->frames_to_reload)
-				/ static_cast<float>(math::convertMillisecondsToFrames(this->getReloadDelay()));
-			const float bar_max_width = 0.7f * this->getGameMap().getGameSquareWidth<float>();
-			const float bar_height = 0.15f * this->getGameMap().getGameSquareHeight<float>();
-			const float ammo_bar_offset = 3.6f * bar_height;
-			// Roughly 3.6x the bar's height.
-//			const float ammo_bar_offset = 8.f * graphics::screen_height / 645.f;
-			const float ammo_bar_start_x = static_cast<float>(this->getScreenX()) - bar_max_width / 2.f;
-			const float ammo_bar_start_y = static_cast<float>(this->getScreenY()) - bar_height / 2.f - ammo_bar_offset;
-			const float ammo_bar_end_x = ammo_bar_start_x + bar_max_width * shots_fired_percent;
-			const float ammo_bar_end_y = ammo_bar_start_y + bar_height;
-			const D2D_RECT_F ammo_bar_filled_rc {ammo_bar_start_x, ammo_bar_start_y, ammo_bar_end_x, ammo_bar_end_y};
-			const D2D_RECT_F ammo_bar_outline_rc {ammo_bar_start_x, ammo_bar_start_y,
-				ammo_bar_start_x + bar_max_width, ammo_bar_end_y};
-			renderer.setBrushColors(bar_outline_color, bar_empty_color);
-			renderer.outlineRectangle(ammo_bar_outline_rc);
-			renderer.fillRectangle(ammo_bar_outline_rc);
-			renderer.setFillColor(bar_filling_color);
-			renderer.fillRectangle(ammo_bar_filled_rc);
-			if (reload_time_percent > 0) {
-				const float reload_bar_start_x = static_cast<float>(this->getScreenX()) + bar_max_width / 2.f
-					- (bar_max_width * (1.f - reload_time_percent));
-				const float reload_bar_end_x = static_cast<float>(this->getScreenX()) + bar_max_width / 2.f;
-				const D2D_RECT_F reload_bar_filled_rc {reload_bar_start_x, ammo_bar_start_y,
-					reload_bar_end_x, ammo_bar_end_y};
-				renderer.setFillColor(bar_reloading_color);
-				renderer.fillRectangle(reload_bar_filled_rc);
+		TowerSnapshot Tower::getSnapshot() const noexcept {
+			TowerSnapshot my_snapshot {};
+			my_snapshot.sprite = this->getShapeInstance();
+			my_snapshot.show_coverage = !this->getBaseType()->isWall() && this->show_coverage;
+			my_snapshot.firing_range = static_cast<float>(this->getFiringRange());
+			my_snapshot.level = this->getLevel();
+			my_snapshot.has_ammo_bar = this->getVolleyShots() != 0;
+			if (my_snapshot.has_ammo_bar) {
+				my_snapshot.shots_fired_fraction = static_cast<float>(this->shots_fired_since_reload)
+					/ static_cast<float>(this->getVolleyShots());
+				my_snapshot.reload_fraction = static_cast<float>(this->frames_to_reload)
+					/ static_cast<float>(math::convertMillisecondsToFrames(this->getReloadDelay()));
 			}
+			return my_snapshot;
 		}
 
-		std::vector<std::unique_ptr<Shot>> Tower::update(const std::vector<std::unique_ptr<Enemy>>& enemies) {
+		std::vector<std::unique_ptr<Shot>> Tower::update(const GameContext& context,
+			const std::vector<std::vector<const Enemy*>>& enemies_by_tile) {
 			std::vector<std::unique_ptr<Shot>> my_shots {};
 			if (this->getBaseType()->isWall()) {
 				return my_shots;
@@ -104,7 +56,8 @@ namespace hoffman_isaiah {
 			if (this->frames_til_next_shot <= 0.0) {
 				this->frames_til_next_shot += math::convertMillisecondsToFrames(1000.0
 					/ this->getFiringSpeed());
-				auto target = this->findTarget(enemies);
+				// No enemy is anywhere near the tower, so don't bother scanning for one.
+				const auto target = this->enemies_in_coverage ? this->findTarget(enemies_by_tile) : nullptr;
 				if (!target) {
 					// Take the time to reload a single shot instead of firing
 					if (this->shots_fired_since_reload > 0) {
@@ -132,18 +85,18 @@ namespace hoffman_isaiah {
 						const auto my_roll = rng::distro_uniform(rng::gen);
 						if (my_roll <= my_multishot_ability->second.first) {
 							for (int i = 0; i < static_cast<int>(my_multishot_ability->second.second); ++i) {
-								my_shots.emplace_back(this->createShot(target));
+								my_shots.emplace_back(this->createShot(context, target));
 							}
 						}
 					}
-					my_shots.emplace_back(this->createShot(target));
+					my_shots.emplace_back(this->createShot(context, target));
 					return my_shots;
 				}
 			}
 			return my_shots;
 		}
 
-		const Enemy* Tower::findTarget(const std::vector<std::unique_ptr<Enemy>>& enemies) const {
+		const Enemy* Tower::findTarget(const std::vector<std::vector<const Enemy*>>& enemies_by_tile) const {
 			const auto& my_method = this->getBaseType()->getFiringMethod();
 			const bool use_highest = this->getBaseType()->getTargetingStrategy().getProtocol()
 				== TargetingStrategyProtocols::Highest;
@@ -156,77 +109,153 @@ namespace hoffman_isaiah {
 			[[maybe_unused]] const Enemy* target_winner {nullptr};
 			const auto my_strat = this->getBaseType()->getTargetingStrategy().getStrategy();
 			bool use_fallback = true;
-			for (const auto& e : enemies) {
-				const double signed_gdx = e->getGameX() - this->getGameX();
-				const double signed_gdy = e->getGameY() - this->getGameY();
-				const double e_angle_from_tower = std::atan2(-signed_gdy, signed_gdx);
-				const double adjusted_angle = e_angle_from_tower;
-				if (my_method.getMethod() != FiringMethodTypes::Default) {
-					if (adjusted_angle < my_method.getMinimumAngle()
-						|| adjusted_angle > my_method.getMaximumAngle()) {
-						// Not within firing angle of the tower
-						continue;
-					}
-				}
-				const double gdx = math::get_abs(signed_gdx);
-				const double gdy = std::abs(signed_gdy);
-				const double gdist = std::sqrt(gdx * gdx + gdy * gdy);
-				if (gdist <= this->getFiringRange()) {
-					// Valid target
-					if (my_strat == TargetingStrategyTypes::Distances || !target_winner) {
-						if ((use_highest && gdist > fallback_winning_value)
-							|| (!use_highest && gdist < fallback_winning_value)) {
-							fallback_winning_value = gdist;
-							fallback_winner = e.get();
+			for (const auto tile : this->covered_tiles) {
+				for (const auto e : enemies_by_tile[tile]) {
+					const double signed_gdx = e->getGameX() - this->getGameX();
+					const double signed_gdy = e->getGameY() - this->getGameY();
+					const double e_angle_from_tower = std::atan2(-signed_gdy, signed_gdx);
+					const double adjusted_angle = e_angle_from_tower;
+					if (my_method.getMethod() != FiringMethodTypes::Default) {
+						if (adjusted_angle < my_method.getMinimumAngle()
+							|| adjusted_angle > my_method.getMaximumAngle()) {
+							// Not within firing angle of the tower
+							continue;
 						}
 					}
-					if (my_strat == TargetingStrategyTypes::Names) {
-						for (auto& n : this->getBaseType()->getTargetingStrategy().getTargetNames()) {
-							if (e->getBaseType().getName() == n) {
+					const double gdx = math::get_abs(signed_gdx);
+					const double gdy = std::abs(signed_gdy);
+					const double gdist = std::sqrt(gdx * gdx + gdy * gdy);
+					if (gdist <= this->getFiringRange()) {
+						// Valid target
+						if (my_strat == TargetingStrategyTypes::Distances || !target_winner) {
+							if ((use_highest && gdist > fallback_winning_value)
+								|| (!use_highest && gdist < fallback_winning_value)) {
+								fallback_winning_value = gdist;
+								fallback_winner = e;
+							}
+						}
+						if (my_strat == TargetingStrategyTypes::Names) {
+							if (this->getBaseType()->getTargetingStrategy().isPreferredTarget(e->getBaseType().getTypeId())) {
 								if (!target_winner) {
-									target_winner = e.get();
+									target_winner = e;
 									target_winning_value = gdist;
 									use_fallback = false;
 								}
 								else if ((use_highest && gdist > target_winning_value)
 									|| (!use_highest && gdist < target_winning_value)) {
-									target_winner = e.get();
+									target_winner = e;
 									target_winning_value = gdist;
 								}
 							}
+						} // Names Targeting Strategy
+						else if (my_strat == TargetingStrategyTypes::Statistics) {
+							const auto test_stat = this->getBaseType()->getTargetingStrategy().getTestStatistic();
+							const double e_stat_value =
+								test_stat == TargetingStrategyStatistics::Damage ? e->getBaseType().getDamage() :
+								test_stat == TargetingStrategyStatistics::Health ? e->getHealth() :
+								test_stat == TargetingStrategyStatistics::Armor_Health ? e->getArmorHealth() :
+								test_stat == TargetingStrategyStatistics::Armor_Reduce ? e->getBaseType().getArmorReduce() :
+								test_stat == TargetingStrategyStatistics::Speed ? e->getCurrentSpeed() :
+								test_stat == TargetingStrategyStatistics::Buffs ? e->getBaseType().getBuffTypesCount() :
+								throw std::runtime_error {"Invalid targeting strategy encountered in Tower::findTarget!"};
+							if ((use_highest && e_stat_value > target_winning_value)
+								|| (!use_highest && e_stat_value < target_winning_value)) {
+								use_fallback = false;
+								target_winning_value = e_stat_value;
+								target_winner = e;
+								fallback_winning_value = gdist;
+							}
+							else if (e_stat_value == target_winning_value
+								&& ((use_highest && gdist > fallback_winning_value)
+									|| (!use_highest && gdist < fallback_winning_value))) {
+								use_fallback = true;
+								fallback_winning_value = gdist;
+								fallback_winner = e;
+							}
+						} // Statistics Targeting Strategy
+					}
+				}
+			}
+			return use_fallback ? fallback_winner : target_winner;
+		}
+
+		void Tower::updateCoverage() {
+			this->covered_tiles.clear();
+			if (this->getBaseType()->isWall()) {
+				return;
+			}
+			const auto& my_map = this->getGameMap();
+			const auto& ground_graph = my_map.getTerrainGraph(false);
+			const auto& air_graph = my_map.getTerrainGraph(true);
+			const auto& my_method = this->getBaseType()->getFiringMethod();
+			const double my_range = this->getFiringRange();
+			const int min_x = math::get_max(0, static_cast<int>(std::floor(this->getGameX() - my_range)));
+			const int max_x = math::get_min(my_map.getColumns() - 1, static_cast<int>(std::floor(this->getGameX() + my_range)));
+			const int min_y = math::get_max(0, static_cast<int>(std::floor(this->getGameY() - my_range)));
+			const int max_y = math::get_min(my_map.getRows() - 1, static_cast<int>(std::floor(this->getGameY() + my_range)));
+			// Determines whether any point of the tile lies within the tower's firing angles.
+			// (Same convention as findTarget: the y-axis is inverted and angles are in (-pi, pi].)
+			const auto is_within_angles = [this, &my_method](int gx, int gy) {
+				if (my_method.getMethod() == FiringMethodTypes::Default) {
+					return true;
+				}
+				if (this->getGameX() >= gx && this->getGameX() <= gx + 1
+					&& this->getGameY() >= gy && this->getGameY() <= gy + 1) {
+					// The tower itself is on this tile.
+					return true;
+				}
+				const double center_angle = std::atan2(-(gy + 0.5 - this->getGameY()), gx + 0.5 - this->getGameX());
+				double lowest_offset = 0.0;
+				double highest_offset = 0.0;
+				for (int dx = 0; dx <= 1; ++dx) {
+					for (int dy = 0; dy <= 1; ++dy) {
+						double offset = std::atan2(-(gy + dy - this->getGameY()), gx + dx - this->getGameX()) - center_angle;
+						if (offset > math::pi) {
+							offset -= 2 * math::pi;
 						}
-					} // Names Targeting Strategy
-					else if (my_strat == TargetingStrategyTypes::Statistics) {
-						const auto test_stat = this->getBaseType()->getTargetingStrategy().getTestStatistic();
-						const double e_stat_value =
-							test_stat == TargetingStrategyStatistics::Damage ? e->getBaseType().getDamage() :
-							test_stat == TargetingStrategyStatistics::Health ? e->getHealth() :
-							test_stat == TargetingStrategyStatistics::Armor_Health ? e->getArmorHealth() :
-							test_stat == TargetingStrategyStatistics::Armor_Reduce ? e->getBaseType().getArmorReduce() :
-							test_stat == TargetingStrategyStatistics::Speed ? e->getCurrentSpeed() :
-							test_stat == TargetingStrategyStatistics::Buffs ? e->getBaseType().getBuffTypesCount() :
-							throw std::runtime_error {"Invalid targeting strategy encountered in Tower::findTarget!"};
-						if ((use_highest && e_stat_value > target_winning_value)
-							|| (!use_highest && e_stat_value < target_winning_value)) {
-							use_fallback = false;
-							target_winning_value = e_stat_value;
-							target_winner = e.get();
-							fallback_winning_value = gdist;
-						}
-						else if (e_stat_value == target_winning_value
-							&& ((use_highest && gdist > fallback_winning_value)
-								|| (!use_highest && gdist < fallback_winning_value))) {
-							use_fallback = true;
-							fallback_winning_value = gdist;
-							fallback_winner = e.get();
+						else if (offset <= -math::pi) {
+							offset += 2 * math::pi;
 						}
-					} // Statistics Targeting Strategy
+						lowest_offset = math::get_min(lowest_offset, offset);
+						highest_offset = math::get_max(highest_offset, offset);
+					}
+				}
+				// The tile's arc may wrap around past +/- pi, so also check the shifted arcs.
+				for (int k = -1; k <= 1; ++k) {
+					const double arc_start = center_angle + lowest_offset + k * 2 * math::pi;
+					const double arc_end = center_angle + highest_offset + k * 2 * math::pi;
+					if (arc_end >= my_method.getMinimumAngle() && arc_start <= my_method.getMaximumAngle()) {
+						return true;
+					}
+				}
+				return false;
+			};
+			for (int gy = min_y; gy <= max_y; ++gy) {
+				for (int gx = min_x; gx <= max_x; ++gx) {
+					// Only consider tiles that enemies can actually travel over.
+					const auto& ground_node = ground_graph.getNode(gx, gy);
+					const auto& air_node = air_graph.getNode(gx, gy);
+					if (ground_node.isBlocked() && air_node.isBlocked()
+						&& &ground_node != ground_graph.getStartNode() && &ground_node != ground_graph.getGoalNode()
+						&& &air_node != air_graph.getStartNode() && &air_node != air_graph.getGoalNode()) {
+						continue;
+					}
+					// Use the point on the tile nearest to the tower for the range check.
+					const double nearest_gx = math::get_max(static_cast<double>(gx),
+						math::get_min(static_cast<double>(gx + 1), this->getGameX()));
+					const double nearest_gy = math::get_max(static_cast<double>(gy),
+						math::get_min(static_cast<double>(gy + 1), this->getGameY()));
+					const double gdx = nearest_gx - this->getGameX();
+					const double gdy = nearest_gy - this->getGameY();
+					if (gdx * gdx + gdy * gdy > my_range * my_range || !is_within_angles(gx, gy)) {
+						continue;
+					}
+					this->covered_tiles.emplace_back(my_map.getTileIndex(gx, gy));
 				}
 			}
-			return use_fallback ? fallback_winner : target_winner;
 		}
 
-		std::unique_ptr<Shot> Tower::createShot(const Enemy* target) const {
+		std::unique_ptr<Shot> Tower::createShot(const GameContext& context, const Enemy* target) const {
 			// Determine which shot to fire...
 			const auto roll = rng::distro_uniform(rng::gen);
 			double running_total = 0.0;
@@ -243,14 +272,13 @@ namespace hoffman_isaiah {
 			if (my_mega_missile_ability != this->upgrade_specials.cend()) {
 				const auto ability_roll = rng::distro_uniform(rng::gen);
 				if (ability_roll <= my_mega_missile_ability->second.first) {
-					// Probably should try to refactor this to not use global state in the future.
-					stype = game::g_my_game->getShotType(L"Mega Missile");
+					stype = context.game.getShotType(L"Mega Missile");
 				}
 			}
 			if (!stype) {
 				// Try recursion for now... If this doesn't work well, I'll think of
 				// something else...
-				return this->createShot(target);
+				return this->createShot(context, target);
 			}
 			// Consider firing method
 			// For now, I'm implementing pulse the same as static...
@@ -11,7 +11,9 @@
 #include "./../graphics/graphics.hpp"
 #include "./../graphics/graphics_DX.hpp"
 #include "./../pathfinding/grid.hpp"
+#include "./game_context.hpp"
 #include "./game_object.hpp"
+#include "./render_snapshot.hpp"
 #include "./tower_types.hpp"
 #include "./game_formulas.hpp"
 
@@ -37,9 +39,10 @@ namespace hoffman_isaiah {
 				base_type {ttype},
 				rating {ttype->getRating()},
 				value {ttype->getCost()} {
+				this->updateCoverage();
 			}
-			// Overrides GameObject::draw()
-			void draw(const graphics::Renderer2D& renderer) const noexcept override;
+			/// <returns>A copy of everything needed to draw the tower.</returns>
+			TowerSnapshot getSnapshot() const noexcept;
 			/// <summary>Toggles the showing of the area that the tower covers.</summary>
 			void toggleShowCoverage() noexcept {
 				this->show_coverage = !this->show_coverage;
@@ -51,12 +54,16 @@ namespace hoffman_isaiah {
 				this->shots_fired_since_reload = 0;
 				this->must_reload = false;
 				this->frames_to_reload = 0;
+				this->enemies_in_coverage = false;
 			}
 
 			/// <summary>Advances the tower's state by one logical frame.</summary>
-			/// <param name="enemies">The list of living enemies.</param>
+			/// <param name="context">The game that the tower belongs to.</param>
+			/// <param name="enemies_by_tile">The living enemies grouped by the index of the tile
+			/// that they are currently on.</param>
 			/// <returns>The shot created by the tower or nullptr if no shot was created.</returns>
-			std::vector<std::unique_ptr<Shot>> update(const std::vector<std::unique_ptr<Enemy>>& enemies);
+			std::vector<std::unique_ptr<Shot>> update(const GameContext& context,
+				const std::vector<std::vector<const Enemy*>>& enemies_by_tile);
 			
 			/// <summary>Upgrades a tower from its previous level to the new level. (Note: Do not use
 			///          to upgrade multiple times. Use setTowerUpgradeStatus instead.)</summary>
@@ -89,6 +96,7 @@ namespace hoffman_isaiah {
 						}
 						this->updateRating();
 						this->updateValue();
+						this->updateCoverage();
 						break;
 					}
 				}
@@ -101,10 +109,21 @@ namespace hoffman_isaiah {
 					this->upgradeTower(i, my_option);
 				}
 			}
+			/// <summary>Marks whether or not at least one enemy is currently on one of the
+			/// tiles covered by the tower.</summary>
+			/// <param name="has_enemies">True if an enemy is within the tower's coverage.</param>
+			void setEnemiesInCoverage(bool has_enemies) noexcept {
+				this->enemies_in_coverage = has_enemies;
+			}
 			// Getters
 			const TowerType* getBaseType() const noexcept {
 				return this->base_type;
 			}
+			/// <returns>The indices of the tiles that an enemy could occupy while within the tower's
+			/// firing range and firing angles.</returns>
+			const std::vector<int>& getCoveredTiles() const noexcept {
+				return this->covered_tiles;
+			}
 			// Upgrade getters:
 			int getLevel() const noexcept {
 				return this->level;
@@ -140,6 +159,21 @@ namespace hoffman_isaiah {
 			double getCost() const noexcept {
 				return this->value;
 			}
+			/// <param name="upgrade_option">The upgrade option to look for.</param>
+			/// <returns>The upgrade that would take the tower to its next level with the given
+			/// option or nullptr if the tower cannot be upgraded that way.</returns>
+			const TowerUpgradeInfo* getNextUpgrade(TowerUpgradeOption upgrade_option) const noexcept {
+				for (const auto& upgrade : this->getBaseType()->getUpgrades()) {
+					if (upgrade.getLevel() == this->getLevel() + 1 && upgrade.getOption() == upgrade_option) {
+						return &upgrade;
+					}
+				}
+				return nullptr;
+			}
+			/// <returns>The amount of money that an upgrade costs for this tower.</returns>
+			double getUpgradeCost(const TowerUpgradeInfo& upgrade) const noexcept {
+				return upgrade.getCostPercent() * this->getCost() + 1.0;
+			}
 			// Computations
 			// Note: For the most part, all of these should be very close to the same
 			//       as the versions in TowerType.
@@ -178,14 +212,19 @@ namespace hoffman_isaiah {
 					this->getBaseType()->isWall());
 			}
 		protected:
-			/// <summary>Finds a target enemy for the tower.</summary>
-			/// <param name="enemies">The list of enemies currently in the game.</param>
+			/// <summary>Finds a target enemy for the tower. Only enemies on the tiles covered
+			/// by the tower are considered.</summary>
+			/// <param name="enemies_by_tile">The enemies currently in the game grouped by tile.</param>
 			/// <returns>Nullptr if no valid target was found; otherwise, the selected target.</returns>
-			const Enemy* findTarget(const std::vector<std::unique_ptr<Enemy>>& enemies) const;
+			const Enemy* findTarget(const std::vector<std::vector<const Enemy*>>& enemies_by_tile) const;
+			/// <summary>Recomputes the list of tiles covered by the tower. This should be called
+			/// whenever the tower's firing range changes.</summary>
+			void updateCoverage();
 			/// <summary>Creates and returns a new shot.</summary>
+			/// <param name="context">The game that the tower belongs to.</param>
 			/// <param name="target">The target enemy found by findTarget().</param>
 			/// <returns>The newly created projectile.</returns>
-			std::unique_ptr<Shot> createShot(const Enemy* target) const;
+			std::unique_ptr<Shot> createShot(const GameContext& context, const Enemy* target) const;
 		private:
 			// Getters
 			graphics::DX::DeviceResources2D* getDeviceResources() const noexcept {
@@ -207,6 +246,13 @@ namespace hoffman_isaiah {
 			bool must_reload {false};
 			/// <summary>Shows the tower's coverage.</summary>
 			bool show_coverage {false};
+			/// <summary>The indices of the tiles that are (at least partially) within the tower's
+			/// firing range and firing angles and that an enemy could walk or fly over. Towers
+			/// do not move, so this only changes when the tower's firing range does.</summary>
+			std::vector<int> covered_tiles {};
+			/// <summary>Whether or not any enemy is currently on one of the covered tiles.
+			/// (If not, then there is no need to look for a target at all.)</summary>
+			bool enemies_in_coverage {false};
 			/// <summary>The index of the last angle that the tower fired its shot from.</summary>
 			mutable int angle_index {-1};
 			// Upgrade related stuff.
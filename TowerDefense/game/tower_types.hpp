@@ -12,6 +12,7 @@
 #include "./../graphics/graphics.hpp"
 #include "./game_object_type.hpp"
 #include "./game_formulas.hpp"
+#include "./type_ids.hpp"
 
 namespace hoffman_isaiah {
 	namespace winapi {
@@ -138,9 +139,27 @@ namespace hoffman_isaiah {
 			TargetingStrategyStatistics getTestStatistic() const noexcept {
 				return this->test_stat;
 			}
-			std::vector<std::wstring> getTargetNames() const noexcept {
+			const std::vector<std::wstring>& getTargetNames() const noexcept {
 				return this->target_names;
 			}
+			/// <param name="id">The identifier of an enemy type.</param>
+			/// <returns>True if the enemy type is one of the strategy's preferred targets.</returns>
+			bool isPreferredTarget(int id) const noexcept {
+				return this->target_ids.contains(id);
+			}
+			// Setters
+			/// <summary>Converts the preferred target names into enemy type identifiers. This must be
+			/// called after the enemy types have been loaded.</summary>
+			/// <param name="enemy_ids">The table of enemy type names.</param>
+			void resolveTargets(const NameTable& enemy_ids) {
+				this->target_ids.clear();
+				for (const auto& n : this->target_names) {
+					const int id = enemy_ids.find(n);
+					if (id >= 0) {
+						this->target_ids.insert(id);
+					}
+				}
+			}
 			std::wstring getReferenceName() const noexcept {
 				return this->reference_name;
 			}
@@ -156,6 +175,8 @@ namespace hoffman_isaiah {
 			TargetingStrategyStatistics test_stat;
 			/// <summary>The list of names of preferred targets.</summary>
 			std::vector<std::wstring> target_names;
+			/// <summary>The identifiers of the enemy types in target_names.</summary>
+			TypeIdSet target_ids {};
 		};
 
 		/// <summary>Enumeration of the options that a player can select for a tower.</summary>
@@ -0,0 +1,721 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./../async_file_writer.hpp"
+#include "./../file_util.hpp"
+#include "./../globals.hpp"
+#include "./../profiler.hpp"
+#include "./../resource_pack.hpp"
+#include "./../task_graph.hpp"
+#include "./../graphics/graphics.hpp"
+#include "./../graphics/shapes.hpp"
+#include "./enemy_type.hpp"
+#include "./game_level.hpp"
+#include "./game_util.hpp"
+#include "./my_game.hpp"
+#include "./shot_types.hpp"
+#include "./status_effects.hpp"
+#include "./tower_types.hpp"
+using namespace std::literals::string_literals;
+
+namespace hoffman_isaiah {
+	namespace game {
+		namespace {
+			/// <summary>The name of the compiled type database (relative to the resources folder).</summary>
+			constexpr const wchar_t* type_database_file_name = L"types.tddb";
+			/// <summary>The magic number that begins every type database ("TDDB").</summary>
+			constexpr const std::uint32_t type_database_magic = 0x42444454U;
+			/// <summary>The current format version of the type database. Increment this whenever
+			/// the layout changes so that older databases are rebuilt.</summary>
+			constexpr const std::uint32_t type_database_version = 1U;
+			/// <summary>The data files (relative to the resources folder) that the database is compiled from.</summary>
+			constexpr const std::array<const wchar_t*, 6> type_database_sources {
+				L"other.ini", L"enemies.ini", L"shots.ini", L"towers.ini", L"tower_upgrades.ini", L"levels/global.ini"
+			};
+
+			/// <summary>Identifies the version of a data file that the database was compiled from.</summary>
+			struct SourceStamp {
+				std::uint64_t size {0};
+				std::int64_t write_time {0};
+				std::uint64_t hash {0};
+			};
+
+			/// <param name="resources">The resources that the data file is loaded from.</param>
+			/// <param name="source">The path of the data file relative to the resources folder.</param>
+			/// <param name="compute_hash">Should the contents of the file be hashed too? (Packed files
+			/// are always hashed since the pack already stores their hashes.)</param>
+			/// <returns>The size, modification time, and (optionally) hash of the data file.</returns>
+			SourceStamp stampResource(const util::file::ResourcePack& resources, const std::wstring& source, bool compute_hash) {
+				SourceStamp stamp {};
+				const std::wstring file_name = resources.getLooseFilePath(source);
+				std::error_code ec {};
+				if (file_name.empty()) {
+					// (Packed files have no modification time; the pack's hash is used instead.)
+					util::file::ResourcePack::Entry my_entry {};
+					if (!resources.getPackedEntry(source, my_entry)) {
+						throw util::file::DataFileException {L"Could not open " + source + L" for reading.", 0};
+					}
+					stamp.size = my_entry.size;
+					stamp.hash = my_entry.hash;
+					return stamp;
+				}
+				stamp.size = static_cast<std::uint64_t>(std::filesystem::file_size(file_name, ec));
+				if (ec) {
+					throw util::file::DataFileException {L"Could not open " + file_name + L" for reading.", 0};
+				}
+				stamp.write_time = static_cast<std::int64_t>(std::filesystem::last_write_time(file_name, ec).time_since_epoch().count());
+				if (compute_hash) {
+					std::vector<char> contents {};
+					if (!util::file::readWholeFile(file_name, contents)) {
+						throw util::file::DataFileException {L"Could not open " + file_name + L" for reading.", 0};
+					}
+					stamp.hash = util::file::hashBytes(contents.data(), contents.size());
+				}
+				return stamp;
+			}
+
+			void writeColor(util::file::BinaryWriter& writer, graphics::Color c) {
+				writer.write(c.r);
+				writer.write(c.g);
+				writer.write(c.b);
+				writer.write(c.a);
+			}
+
+			graphics::Color readColor(util::file::BinaryReader& reader) {
+				graphics::Color c {};
+				c.r = reader.read<float>();
+				c.g = reader.read<float>();
+				c.b = reader.read<float>();
+				c.a = reader.read<float>();
+				return c;
+			}
+
+			void writeRandomVariable(util::file::BinaryWriter& writer, const LevelNormalRandomVariable& var) {
+				writer.write(var.getBaseVariable().getMean());
+				writer.write(var.getBaseVariable().getStandardDeviation());
+				writer.write(var.getLevelChange());
+			}
+
+			LevelNormalRandomVariable readRandomVariable(util::file::BinaryReader& reader) {
+				const double mu = reader.read<double>();
+				const double sigma = reader.read<double>();
+				const double change = reader.read<double>();
+				return LevelNormalRandomVariable {NormalRandomVariable {mu, sigma}, change};
+			}
+		}
+
+		void MyGame::load_type_data() {
+			IH_PROFILE_FUNCTION();
+			try {
+				if (this->load_type_database()) {
+					return;
+				}
+			}
+			catch (const util::file::DataFileException&) {
+				// Corrupted database; fall back to the text files.
+			}
+			catch (const std::out_of_range&) {
+				// The database refers to a type that it does not define.
+			}
+			this->load_data_files();
+			try {
+				this->save_type_database();
+			}
+			catch (...) {
+				// The database is only a cache, so failing to write it is not fatal.
+			}
+		}
+
+		void MyGame::compile_type_database() {
+			this->load_data_files();
+			this->save_type_database();
+		}
+
+		void MyGame::load_data_files() {
+			this->clear_type_data();
+			// Each loader writes to its own set of members, so loaders only have to wait
+			// for the loaders whose types they refer to.
+			util::TaskGraph loaders {};
+			const int enemies_task = loaders.addTask(L"Enemy types", [this]() { this->init_enemy_types(); });
+			const int shots_task = loaders.addTask(L"Shot types", [this]() { this->init_shot_types(); });
+			loaders.addTask(L"Miscellaneous data", [this]() { this->load_global_misc_data(); });
+			const int towers_task = loaders.addTask(L"Tower types", [this]() { this->init_tower_types(); },
+				{enemies_task, shots_task});
+			loaders.addTask(L"Tower upgrades", [this]() { this->load_tower_upgrades_data(); }, {towers_task});
+			loaders.addTask(L"Global level data", [this]() { this->load_global_level_data(); }, {enemies_task});
+			loaders.run();
+		}
+
+		void MyGame::clear_type_data() noexcept {
+			this->enemy_types.clear();
+			this->enemy_type_ids.clear();
+			this->enemies_seen.clear();
+			this->enemy_kill_count.clear();
+			this->shot_types.clear();
+			this->shot_type_ids.clear();
+			this->tower_types.clear();
+			this->tower_type_ids.clear();
+			this->my_level_generator = nullptr;
+		}
+
+		void MyGame::shareTypeData(const MyGame& source) {
+			this->enemy_types = source.enemy_types;
+			this->enemy_type_ids = source.enemy_type_ids;
+			this->shot_types = source.shot_types;
+			this->shot_type_ids = source.shot_type_ids;
+			this->tower_types = source.tower_types;
+			this->tower_type_ids = source.tower_type_ids;
+			this->my_level_generator = source.my_level_generator;
+			this->my_level_backup_number = source.my_level_backup_number;
+			this->level_templates = source.level_templates;
+			this->level_template_errors = source.level_template_errors;
+			this->hp_gained_per_buy = source.hp_gained_per_buy;
+			this->hp_buy_cost = source.hp_buy_cost;
+			this->hp_buy_multiplier = source.hp_buy_multiplier;
+			// (What the player has seen and killed belongs to each game.)
+			this->enemies_seen.assign(this->enemy_types.size(), false);
+			this->enemy_kill_count.assign(this->enemy_types.size(), 0);
+		}
+
+		void MyGame::index_enemy_types() {
+			// Assign identifiers (which match the types' indices in the list).
+			for (auto& etype : this->enemy_types) {
+				etype->setTypeId(this->enemy_type_ids.intern(etype->getName()));
+			}
+			// Buffs can target enemies defined later in the file, so they are resolved last.
+			for (const auto& etype : this->enemy_types) {
+				for (const auto& b : etype->getBuffTypes()) {
+					b->resolveTargets(this->enemy_type_ids, this->enemy_types);
+				}
+			}
+			// Add listing for "seen before".
+			this->enemies_seen.assign(this->enemy_types.size(), false);
+			this->enemy_kill_count.assign(this->enemy_types.size(), 0);
+		}
+
+		void MyGame::save_type_database() const {
+			IH_PROFILE_FUNCTION();
+			util::file::BinaryWriter writer {};
+			writer.write(type_database_magic);
+			writer.write(type_database_version);
+			// Sources
+			for (const auto source : type_database_sources) {
+				const SourceStamp stamp = stampResource(this->getResources(), source, true);
+				writer.writeString(source);
+				writer.write(stamp.size);
+				writer.write(stamp.write_time);
+				writer.write(stamp.hash);
+			}
+			// Miscellaneous data
+			writer.write(this->hp_gained_per_buy);
+			writer.write(this->hp_buy_cost);
+			writer.write(this->hp_buy_multiplier);
+			// Enemies
+			writer.write(static_cast<std::uint32_t>(this->enemy_types.size()));
+			for (const auto& etype : this->enemy_types) {
+				writer.writeString(etype->getName());
+				writer.writeString(etype->getDesc());
+				writeColor(writer, etype->getColor());
+				writer.write(etype->getShape());
+				writer.write(etype->getDamage());
+				writer.write(etype->getBaseHealth());
+				writer.write(etype->getBaseArmorHP());
+				writer.write(etype->getArmorReduce());
+				writer.write(etype->getPainTolerance());
+				writer.write(etype->getBaseWalkingSpeed());
+				writer.write(etype->getBaseRunningSpeed());
+				writer.write(etype->getBaseInjuredSpeed());
+				writer.write(etype->getDefaultStrategy());
+				writer.write(etype->canMoveDiagonally());
+				writer.write(etype->isFlying());
+				writer.write(etype->isUnique());
+				writer.write(static_cast<std::uint32_t>(etype->getBuffTypes().size()));
+				for (const auto& b : etype->getBuffTypes()) {
+					writer.write(b->getType());
+					writer.writeStrings(b->getTargetNames());
+					writer.write(b->getRadius());
+					writer.write(static_cast<std::int32_t>(std::lround(b->getTimeBetweenApplications())));
+					switch (b->getType()) {
+					case BuffTypes::Intelligence:
+						writer.write(static_cast<const SmartBuff&>(*b).getBuffDuration());
+						break;
+					case BuffTypes::Speed:
+					{
+						const auto& my_buff = static_cast<const SpeedBuff&>(*b);
+						writer.write(my_buff.getBuffDuration());
+						writer.write(my_buff.getWalkingBoost());
+						writer.write(my_buff.getRunningBoost());
+						writer.write(my_buff.getInjuredBoost());
+						break;
+					}
+					case BuffTypes::Healer:
+						writer.write(static_cast<const HealerBuff&>(*b).getHealAmount());
+						break;
+					case BuffTypes::Purify:
+						writer.write(static_cast<const PurifyBuff&>(*b).getMaxEffectsRemoved());
+						break;
+					case BuffTypes::Repair:
+						writer.write(static_cast<const RepairBuff&>(*b).getRepairAmount());
+						break;
+					case BuffTypes::Forcefield:
+					{
+						const auto& my_buff = static_cast<const ForcefieldBuff&>(*b);
+						writer.write(my_buff.getBuffDuration());
+						writer.write(my_buff.getShieldHealth());
+						writer.write(my_buff.getShieldAbsorb());
+						break;
+					}
+					} // End Switch
+				}
+			}
+			// Shots (in the order that their identifiers were assigned)
+			writer.write(static_cast<std::uint32_t>(this->shot_type_ids.size()));
+			for (int i = 0; i < this->shot_type_ids.size(); ++i) {
+				const ShotBaseType& stype = *this->shot_types.at(this->shot_type_ids.getName(i));
+				writer.write(stype.getType());
+				writer.writeString(stype.getName());
+				writer.writeString(stype.getDesc());
+				writeColor(writer, stype.getColor());
+				writer.write(stype.getShape());
+				writer.write(stype.getDamage());
+				writer.write(stype.getPiercing());
+				writer.write(stype.getSpeed());
+				writer.write(stype.getImpactRadius());
+				writer.write(stype.getSplashDamage());
+				writer.write(stype.getGroundMultiplier());
+				writer.write(stype.getAirMultiplier());
+				writer.write(stype.isSplashEffectType());
+				switch (stype.getType()) {
+				case ShotTypes::Standard:
+					break;
+				case ShotTypes::DoT:
+				{
+					const auto& my_shot = static_cast<const DoTShotType&>(stype);
+					writer.write(my_shot.getDamageType());
+					writer.write(my_shot.getDamagePerTick());
+					writer.write(my_shot.getMillisecondsBetweenTicks());
+					writer.write(my_shot.getTotalTicks());
+					break;
+				}
+				case ShotTypes::Slow:
+				{
+					const auto& my_shot = static_cast<const SlowShotType&>(stype);
+					writer.write(my_shot.getSlowFactor());
+					writer.write(my_shot.getSlowDuration());
+					writer.write(my_shot.getMultipleSlowChance());
+					break;
+				}
+				case ShotTypes::Stun:
+				{
+					const auto& my_shot = static_cast<const StunShotType&>(stype);
+					writer.write(my_shot.getStunChance());
+					writer.write(my_shot.getStunDuration());
+					writer.write(my_shot.getMultipleStunChance());
+					break;
+				}
+				default:
+					throw std::invalid_argument {"Unknown shot type."};
+				} // End Switch
+			}
+			// Towers (including walls and upgrades)
+			writer.write(static_cast<std::uint32_t>(this->tower_types.size()));
+			for (const auto& ttype : this->tower_types) {
+				writer.write(ttype->isWall());
+				writer.writeString(ttype->getName());
+				writer.writeString(ttype->getDesc());
+				writeColor(writer, ttype->getColor());
+				writer.write(ttype->getShape());
+				if (ttype->isWall()) {
+					writer.write(ttype->getCostAdjustment());
+					continue;
+				}
+				const FiringMethod& fmethod = ttype->getFiringMethod();
+				writer.writeString(fmethod.getReferenceName());
+				writer.write(fmethod.getMethod());
+				const auto angles = fmethod.getAngles();
+				writer.write(static_cast<std::uint32_t>(angles.size()));
+				for (const auto a : angles) {
+					writer.write(a);
+				}
+				writer.write(fmethod.getDuration());
+				const TargetingStrategy& tstrategy = ttype->getTargetingStrategy();
+				writer.writeString(tstrategy.getReferenceName());
+				writer.write(tstrategy.getStrategy());
+				writer.write(tstrategy.getProtocol());
+				writer.write(tstrategy.getTestStatistic());
+				writer.writeStrings(tstrategy.getTargetNames());
+				const auto tower_shots = ttype->getShotTypes();
+				writer.write(static_cast<std::uint32_t>(tower_shots.size()));
+				for (const auto& shot_info : tower_shots) {
+					writer.writeString(shot_info.first->getName());
+					writer.write(shot_info.second);
+				}
+				writer.write(ttype->getFiringSpeed());
+				writer.write(ttype->getFiringRange());
+				writer.write(ttype->getVolleyShots());
+				writer.write(ttype->getReloadDelay());
+				writer.write(ttype->getCostAdjustment());
+				writer.write(ttype->getMaxLevel());
+				writer.write(static_cast<std::uint32_t>(ttype->getUpgrades().size()));
+				for (const auto& upgrade : ttype->getUpgrades()) {
+					writer.write(upgrade.getLevel());
+					writer.write(upgrade.getOption());
+					writer.write(upgrade.getCostPercent());
+					writer.write(upgrade.getDamageMultiplier());
+					writer.write(upgrade.getSpeedMultiplier());
+					writer.write(upgrade.getRangeMultiplier());
+					writer.write(upgrade.getAmmoMultiplier());
+					writer.write(upgrade.getDelayMultiplier());
+					writer.write(upgrade.getSpecial());
+					writer.write(upgrade.getSpecialChance());
+					writer.write(upgrade.getSpecialPower());
+				}
+			}
+			// Global level data
+			writer.write(this->my_level_backup_number);
+			writer.write(this->my_level_generator != nullptr);
+			if (this->my_level_generator) {
+				const LevelGenerator& gen = *this->my_level_generator;
+				writer.write(gen.start_level);
+				writer.write(static_cast<std::uint32_t>(gen.color_data.size()));
+				for (const auto& cdata : gen.color_data) {
+					writer.writeString(cdata.getName());
+					writer.write(cdata.getZScore());
+				}
+				writer.write(static_cast<std::uint32_t>(gen.enemy_data.size()));
+				for (const auto& edata : gen.enemy_data) {
+					writer.writeString(edata.getType()->getName());
+					writer.writeString(edata.getColorName());
+					writer.write(edata.getZScore());
+					writeRandomVariable(writer, edata.getExtraCountVariable());
+					writer.write(edata.getSpawnTime(EnemySpawnDensities::Dense));
+					writer.write(edata.getSpawnTime(EnemySpawnDensities::Normal));
+					writer.write(edata.getSpawnTime(EnemySpawnDensities::Sparse));
+				}
+				writer.write(static_cast<std::uint32_t>(gen.boss_data.size()));
+				for (const auto& bdata : gen.boss_data) {
+					writer.writeString(bdata.getType()->getName());
+					writer.write(bdata.getZScore());
+				}
+				writeRandomVariable(writer, gen.wave_difficulty_var);
+				writeRandomVariable(writer, gen.group_difficulty_var);
+				writeRandomVariable(writer, gen.boss_difficulty_var);
+				writeRandomVariable(writer, gen.num_waves_var);
+				writeRandomVariable(writer, gen.num_groups_var);
+				writeRandomVariable(writer, gen.num_bosses_var);
+				writer.write(gen.wave_delay);
+				writer.write(gen.group_delay);
+				writer.write(gen.boss_level_mod);
+			}
+			// (A partial write never replaces a good database.)
+			if (!util::file::writeFileAtomically(this->resources_folder_path + type_database_file_name, writer.getData())) {
+				throw util::file::DataFileException {L"Could not write the type database."s, 0};
+			}
+		}
+
+		bool MyGame::load_type_database() {
+			IH_PROFILE_FUNCTION();
+			std::vector<char> contents {};
+			if (!util::file::readWholeFile(this->resources_folder_path + type_database_file_name, contents)) {
+				return false;
+			}
+			util::file::BinaryReader reader {contents.data(), contents.size()};
+			if (reader.read<std::uint32_t>() != type_database_magic
+				|| reader.read<std::uint32_t>() != type_database_version) {
+				return false;
+			}
+			// Sources
+			for (const auto source : type_database_sources) {
+				if (reader.readString() != source) {
+					return false;
+				}
+				SourceStamp old_stamp {};
+				old_stamp.size = reader.read<std::uint64_t>();
+				old_stamp.write_time = reader.read<std::int64_t>();
+				old_stamp.hash = reader.read<std::uint64_t>();
+				SourceStamp new_stamp = stampResource(this->getResources(), source, false);
+				if (new_stamp.size != old_stamp.size) {
+					return false;
+				}
+				if (new_stamp.write_time != old_stamp.write_time) {
+					// The file may have only been touched, so compare its contents.
+					new_stamp = stampResource(this->getResources(), source, true);
+					if (new_stamp.hash != old_stamp.hash) {
+						return false;
+					}
+				}
+			}
+			this->clear_type_data();
+			// Miscellaneous data
+			this->hp_gained_per_buy = reader.read<int>();
+			this->hp_buy_cost = reader.read<double>();
+			this->hp_buy_multiplier = reader.read<double>();
+			// Enemies
+			const auto enemy_count = reader.read<std::uint32_t>();
+			for (std::uint32_t i = 0; i < enemy_count; ++i) {
+				const std::wstring n = reader.readString();
+				const std::wstring d = reader.readString();
+				const graphics::Color c = readColor(reader);
+				const auto st = reader.read<graphics::shapes::ShapeTypes>();
+				const int dmg = reader.read<int>();
+				const double hp = reader.read<double>();
+				const double ahp = reader.read<double>();
+				const double ar = reader.read<double>();
+				const double pt = reader.read<double>();
+				const double wspd = reader.read<double>();
+				const double rspd = reader.read<double>();
+				const double ispd = reader.read<double>();
+				const auto strat = reader.read<pathfinding::HeuristicStrategies>();
+				const bool move_diag = reader.read<bool>();
+				const bool fly = reader.read<bool>();
+				const bool unique = reader.read<bool>();
+				std::vector<std::shared_ptr<BuffBase>> my_buffs {};
+				const auto buff_count = reader.read<std::uint32_t>();
+				for (std::uint32_t j = 0; j < buff_count; ++j) {
+					const auto buff_type = reader.read<BuffTypes>();
+					const auto target_names = reader.readStrings();
+					const double br = reader.read<double>();
+					const int ms_ticks = reader.read<std::int32_t>();
+					switch (buff_type) {
+					case BuffTypes::Intelligence:
+					{
+						const int bd = reader.read<int>();
+						my_buffs.emplace_back(std::make_shared<SmartBuff>(target_names, br, ms_ticks, bd));
+						break;
+					}
+					case BuffTypes::Speed:
+					{
+						const int bd = reader.read<int>();
+						const double wb = reader.read<double>();
+						const double rb = reader.read<double>();
+						const double ib = reader.read<double>();
+						my_buffs.emplace_back(std::make_shared<SpeedBuff>(target_names, br, ms_ticks, bd, wb, rb, ib));
+						break;
+					}
+					case BuffTypes::Healer:
+					{
+						const double heal_amt = reader.read<double>();
+						my_buffs.emplace_back(std::make_shared<HealerBuff>(target_names, br, ms_ticks, heal_amt));
+						break;
+					}
+					case BuffTypes::Purify:
+					{
+						const int cure_max = reader.read<int>();
+						my_buffs.emplace_back(std::make_shared<PurifyBuff>(target_names, br, ms_ticks, cure_max));
+						break;
+					}
+					case BuffTypes::Repair:
+					{
+						const double repair_amt = reader.read<double>();
+						my_buffs.emplace_back(std::make_shared<RepairBuff>(target_names, br, ms_ticks, repair_amt));
+						break;
+					}
+					case BuffTypes::Forcefield:
+					{
+						const int bd = reader.read<int>();
+						const double shp = reader.read<double>();
+						const double sa = reader.read<double>();
+						my_buffs.emplace_back(std::make_shared<ForcefieldBuff>(target_names, br, ms_ticks, bd, shp, sa));
+						break;
+					}
+					default:
+						throw util::file::DataFileException {L"Unknown buff type in the type database."s, 0};
+					} // End Switch
+				}
+				this->enemy_types.emplace_back(std::make_unique<EnemyType>(n, d, c, st, dmg, hp, ahp, ar, pt,
+					wspd, rspd, ispd, strat, move_diag, fly, unique, std::move(my_buffs)));
+			}
+			this->index_enemy_types();
+			// Shots
+			const auto shot_count = reader.read<std::uint32_t>();
+			for (std::uint32_t i = 0; i < shot_count; ++i) {
+				const auto shot_type = reader.read<ShotTypes>();
+				const std::wstring n = reader.readString();
+				const std::wstring d = reader.readString();
+				const graphics::Color c = readColor(reader);
+				const auto st = reader.read<graphics::shapes::ShapeTypes>();
+				const double dmg = reader.read<double>();
+				const double wap = reader.read<double>();
+				const double ms = reader.read<double>();
+				const double ir = reader.read<double>();
+				const double sdmg = reader.read<double>();
+				const double gm = reader.read<double>();
+				const double am = reader.read<double>();
+				const bool affect_splash = reader.read<bool>();
+				std::unique_ptr<ShotBaseType> my_shot {nullptr};
+				switch (shot_type) {
+				case ShotTypes::Standard:
+					my_shot = std::make_unique<NormalShotType>(n, d, c, st, dmg, wap, ms, ir, sdmg, gm, am);
+					break;
+				case ShotTypes::DoT:
+				{
+					const auto dot_type = reader.read<DoTDamageTypes>();
+					const double tick_dmg = reader.read<double>();
+					const int ms_ticks = reader.read<int>();
+					const int num_ticks = reader.read<int>();
+					my_shot = std::make_unique<DoTShotType>(n, d, c, st, dmg, wap, ms, ir, sdmg, gm, am,
+						affect_splash, dot_type, tick_dmg, ms_ticks, num_ticks);
+					break;
+				}
+				case ShotTypes::Slow:
+				{
+					const double sf = reader.read<double>();
+					const int sd = reader.read<int>();
+					const double schance = reader.read<double>();
+					my_shot = std::make_unique<SlowShotType>(n, d, c, st, dmg, wap, ms, ir, sdmg, gm, am,
+						affect_splash, sf, sd, schance);
+					break;
+				}
+				case ShotTypes::Stun:
+				{
+					const double schance = reader.read<double>();
+					const int sd = reader.read<int>();
+					const double mschance = reader.read<double>();
+					my_shot = std::make_unique<StunShotType>(n, d, c, st, dmg, wap, ms, ir, sdmg, gm, am,
+						affect_splash, schance, sd, mschance);
+					break;
+				}
+				default:
+					throw util::file::DataFileException {L"Unknown shot type in the type database."s, 0};
+				} // End Switch
+				my_shot->setTypeId(this->shot_type_ids.intern(n));
+				this->shot_types.emplace(n, std::move(my_shot));
+			}
+			// Towers
+			std::map<std::wstring, std::shared_ptr<FiringMethod>> my_firing_methods {};
+			std::map<std::wstring, std::shared_ptr<TargetingStrategy>> my_targeting_strategies {};
+			const auto tower_count = reader.read<std::uint32_t>();
+			for (std::uint32_t i = 0; i < tower_count; ++i) {
+				const bool is_wall = reader.read<bool>();
+				const std::wstring n = reader.readString();
+				const std::wstring d = reader.readString();
+				const graphics::Color c = readColor(reader);
+				const auto st = reader.read<graphics::shapes::ShapeTypes>();
+				if (is_wall) {
+					const int wall_cost = reader.read<int>();
+					auto my_wall = std::make_unique<WallType>(n, d, c, st, wall_cost);
+					my_wall->setTypeId(this->tower_type_ids.intern(n));
+					this->tower_types.emplace_back(std::move(my_wall));
+					continue;
+				}
+				// Towers share firing methods and targeting strategies by reference name.
+				const std::wstring fm_name = reader.readString();
+				const auto fm_method = reader.read<FiringMethodTypes>();
+				std::vector<double> fm_angles(reader.read<std::uint32_t>());
+				for (auto& a : fm_angles) {
+					a = reader.read<double>();
+				}
+				const int fm_duration = reader.read<int>();
+				auto& fmethod = my_firing_methods[fm_name];
+				if (!fmethod) {
+					fmethod = std::make_shared<FiringMethod>(fm_name, fm_method, std::move(fm_angles), fm_duration);
+				}
+				const std::wstring ts_name = reader.readString();
+				const auto ts_strategy = reader.read<TargetingStrategyTypes>();
+				const auto ts_protocol = reader.read<TargetingStrategyProtocols>();
+				const auto ts_stat = reader.read<TargetingStrategyStatistics>();
+				const auto ts_target_names = reader.readStrings();
+				auto& tstrategy = my_targeting_strategies[ts_name];
+				if (!tstrategy) {
+					if (ts_strategy == TargetingStrategyTypes::Names) {
+						tstrategy = std::make_shared<TargetingStrategy>(ts_name, ts_strategy, ts_protocol, ts_target_names);
+						tstrategy->resolveTargets(this->enemy_type_ids);
+					}
+					else {
+						tstrategy = std::make_shared<TargetingStrategy>(ts_name, ts_strategy, ts_protocol, ts_stat);
+					}
+				}
+				std::vector<std::pair<const ShotBaseType*, double>> my_tower_shots {};
+				const auto tower_shot_count = reader.read<std::uint32_t>();
+				for (std::uint32_t j = 0; j < tower_shot_count; ++j) {
+					const std::wstring shot_name = reader.readString();
+					const double freq = reader.read<double>();
+					my_tower_shots.emplace_back(this->getShotType(shot_name), freq);
+				}
+				const double fs = reader.read<double>();
+				const double fr = reader.read<double>();
+				const int vs = reader.read<int>();
+				const int rd = reader.read<int>();
+				const int cost_adj = reader.read<int>();
+				const int max_lv = reader.read<int>();
+				auto my_tower_type = std::make_unique<TowerType>(n, d, c, st, fmethod, tstrategy,
+					std::move(my_tower_shots), fs, fr, vs, rd, cost_adj, max_lv);
+				const auto upgrade_count = reader.read<std::uint32_t>();
+				for (std::uint32_t j = 0; j < upgrade_count; ++j) {
+					const int upgrade_level = reader.read<int>();
+					const auto upgrade_option = reader.read<TowerUpgradeOption>();
+					const double upgrade_cost_percent = reader.read<double>();
+					const double upgrade_damage_multi = reader.read<double>();
+					const double upgrade_speed_multi = reader.read<double>();
+					const double upgrade_range_multi = reader.read<double>();
+					const double upgrade_ammo_multi = reader.read<double>();
+					const double upgrade_delay_multi = reader.read<double>();
+					const auto upgrade_special = reader.read<TowerUpgradeSpecials>();
+					const double upgrade_special_chance = reader.read<double>();
+					const double upgrade_special_power = reader.read<double>();
+					my_tower_type->addUpgradeInfo(TowerUpgradeInfo {upgrade_level, upgrade_option, upgrade_cost_percent,
+						upgrade_damage_multi, upgrade_speed_multi, upgrade_range_multi, upgrade_ammo_multi,
+						upgrade_delay_multi, upgrade_special, upgrade_special_chance, upgrade_special_power});
+				}
+				my_tower_type->setTypeId(this->tower_type_ids.intern(n));
+				this->tower_types.emplace_back(std::move(my_tower_type));
+			}
+			// Global level data
+			this->my_level_backup_number = reader.read<int>();
+			if (reader.read<bool>()) {
+				const int start_lv = reader.read<int>();
+				std::vector<GlobalLevelColorData> my_cdata {};
+				const auto color_count = reader.read<std::uint32_t>();
+				for (std::uint32_t i = 0; i < color_count; ++i) {
+					const std::wstring cname = reader.readString();
+					const double z_score = reader.read<double>();
+					my_cdata.emplace_back(cname, z_score);
+				}
+				std::vector<GlobalLevelEnemyData> my_edata {};
+				const auto edata_count = reader.read<std::uint32_t>();
+				for (std::uint32_t i = 0; i < edata_count; ++i) {
+					const std::wstring ename = reader.readString();
+					const std::wstring cname = reader.readString();
+					const double z_score = reader.read<double>();
+					const LevelNormalRandomVariable ec_var = readRandomVariable(reader);
+					std::array<int, 3> spawn_times {};
+					for (auto& t : spawn_times) {
+						t = reader.read<int>();
+					}
+					my_edata.emplace_back(*this, ename, cname, z_score, ec_var, spawn_times);
+				}
+				std::vector<GlobalLevelBossData> my_bdata {};
+				const auto bdata_count = reader.read<std::uint32_t>();
+				for (std::uint32_t i = 0; i < bdata_count; ++i) {
+					const std::wstring ename = reader.readString();
+					const double z_score = reader.read<double>();
+					my_bdata.emplace_back(*this, ename, z_score);
+				}
+				const LevelNormalRandomVariable wd_var = readRandomVariable(reader);
+				const LevelNormalRandomVariable gd_var = readRandomVariable(reader);
+				const LevelNormalRandomVariable bd_var = readRandomVariable(reader);
+				const LevelNormalRandomVariable nw_var = readRandomVariable(reader);
+				const LevelNormalRandomVariable ng_var = readRandomVariable(reader);
+				const LevelNormalRandomVariable nb_var = readRandomVariable(reader);
+				const int wd = reader.read<int>();
+				const int gd = reader.read<int>();
+				const int bmod = reader.read<int>();
+				this->my_level_generator = std::make_shared<LevelGenerator>(start_lv, my_cdata, my_edata, my_bdata,
+					wd_var, gd_var, bd_var, nw_var, ng_var, nb_var, wd, gd, bmod);
+			}
+			if (!reader.isAtEnd()) {
+				throw util::file::DataFileException {L"Unexpected data at the end of the type database."s, 0};
+			}
+			return true;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <stdexcept>
+
+namespace hoffman_isaiah {
+	namespace game {
+		/// <summary>Maps the names of game object types to dense integer identifiers
+		/// (0, 1, 2, ...) in the order that the names were first added.</summary>
+		class NameTable {
+		public:
+			/// <summary>Adds a name to the table if it is not already present.</summary>
+			/// <param name="name">The name to add.</param>
+			/// <returns>The identifier associated with the name.</returns>
+			int intern(const std::wstring& name) {
+				const auto ret = this->ids.emplace(name, static_cast<int>(this->names.size()));
+				if (ret.second) {
+					this->names.emplace_back(name);
+				}
+				return ret.first->second;
+			}
+			/// <summary>Removes all of the names from the table.</summary>
+			void clear() noexcept {
+				this->ids.clear();
+				this->names.clear();
+			}
+			// Getters
+			/// <param name="name">The name to look up.</param>
+			/// <returns>The identifier associated with the name or -1 if the name is not in the table.</returns>
+			int find(const std::wstring& name) const {
+				const auto my_iterator = this->ids.find(name);
+				return my_iterator == this->ids.end() ? -1 : my_iterator->second;
+			}
+			/// <param name="id">The identifier to look up.</param>
+			/// <returns>The name associated with the given identifier.</returns>
+			const std::wstring& getName(int id) const {
+				return this->names.at(id);
+			}
+			/// <returns>The number of names in the table.</returns>
+			int size() const noexcept {
+				return static_cast<int>(this->names.size());
+			}
+		private:
+			/// <summary>Key => Name, Value => Identifier.</summary>
+			std::unordered_map<std::wstring, int> ids {};
+			/// <summary>The names in the table indexed by their identifiers.</summary>
+			std::vector<std::wstring> names {};
+		};
+
+		/// <summary>A set of type identifiers stored as a bitset. (The number of types is not
+		/// known until the data files are loaded, so the bitset grows as needed.)</summary>
+		class TypeIdSet {
+		public:
+			/// <summary>Adds an identifier to the set.</summary>
+			/// <param name="id">The identifier to add. (Must be non-negative.)</param>
+			void insert(int id) {
+				if (id < 0) {
+					throw std::out_of_range {"Type identifiers cannot be negative."};
+				}
+				const auto word = static_cast<std::size_t>(id) / bits_per_word;
+				if (word >= this->words.size()) {
+					this->words.resize(word + 1, 0);
+				}
+				this->words[word] |= std::uint64_t {1} << (static_cast<std::size_t>(id) % bits_per_word);
+			}
+			/// <summary>Removes all identifiers from the set.</summary>
+			void clear() noexcept {
+				this->words.clear();
+			}
+			/// <param name="id">The identifier to test.</param>
+			/// <returns>True if the identifier is in the set.</returns>
+			bool contains(int id) const noexcept {
+				const auto word = static_cast<std::size_t>(id) / bits_per_word;
+				// (Negative identifiers wrap around to a very large word index.)
+				return word < this->words.size()
+					&& ((this->words[word] >> (static_cast<std::size_t>(id) % bits_per_word)) & 1U) != 0;
+			}
+		private:
+			/// <summary>The number of identifiers stored in each word.</summary>
+			static constexpr const std::size_t bits_per_word = 64;
+			/// <summary>The bits of the set.</summary>
+			std::vector<std::uint64_t> words {};
+		};
+	}
+}
@@ -121,6 +121,31 @@ namespace hoffman_isaiah {
 		// This framerate controls how often the game state is updated
 		// per second.
 		constexpr const int logic_framerate = 120;
+		// In maximum speed mode, the game runs logic ticks for this many milliseconds at a
+		// time before checking for input again, and it only redraws the screen this many
+		// times a second so that most of the time goes to the simulation.
+		constexpr const double max_speed_tick_budget_ms = 12.0;
+		constexpr const int max_speed_graphics_framerate = 10;
+		// The number of milliseconds between updates of the displayed ticks per second.
+		constexpr const double tick_rate_sample_interval_ms = 500.0;
+		// When the simulation thread falls behind (such as when Windows sleeps for longer
+		// than asked), it runs at most this many ticks at once to catch up.
+		constexpr const int max_catch_up_ticks = 5;
+		// The path of the resource pack, which is read in place from the game's folder.
+		// (Without a pack, resources are read from the resources folder instead.)
+		constexpr const wchar_t* resource_pack_file_name = L"./resources.tdpk";
+		// The folder (relative to the user data folder) whose files take precedence over the
+		// game's resources, such as maps saved by the terrain editor.
+		constexpr const wchar_t* resource_overrides_folder_name = L"overrides/";
+		// The names of the profiler traces saved on request and after a slow frame. (Both
+		// are saved to the user data folder.)
+		constexpr const wchar_t* profile_trace_file_name = L"profile_trace.json";
+		constexpr const wchar_t* slow_frame_trace_file_name = L"slow_frame_trace.json";
+		// A frame that takes longer than this many milliseconds saves a profiler trace.
+		constexpr const double slow_frame_threshold_ms = 100.0;
+		// The minimum number of milliseconds between two slow frame traces, so that a
+		// stretch of slow frames is not made worse by saving a trace every frame.
+		constexpr const double slow_frame_trace_interval_ms = 10000.0;
 #if defined(DEBUG) || defined(_DEBUG)
 #ifdef _M_X64
 #define MY_PROJECT_FORMAT L"dx64aay"
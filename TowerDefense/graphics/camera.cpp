@@ -0,0 +1,96 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <cmath>
+#include "./camera.hpp"
+#include "./draw_list.hpp"
+
+namespace hoffman_isaiah {
+	namespace graphics {
+		int getDetailBlockSize(float square_sw, float square_sh) noexcept {
+			const float square_size = std::min(square_sw, square_sh);
+			if (square_size >= min_detailed_square_size || square_size <= 0.f) {
+				return 1;
+			}
+			return static_cast<int>(std::ceil(min_detailed_square_size / square_size));
+		}
+
+		void Camera::setMap(DrawRect new_field, int new_columns, int new_rows) noexcept {
+			const bool map_changed = new_columns != this->columns || new_rows != this->rows;
+			this->field = new_field;
+			this->columns = new_columns;
+			this->rows = new_rows;
+			if (map_changed) {
+				this->reset();
+			}
+			else {
+				this->clampView();
+			}
+		}
+
+		void Camera::reset() noexcept {
+			this->zoom = 1.f;
+			this->view_left = this->field.left;
+			this->view_top = this->field.top;
+		}
+
+		void Camera::zoomAt(float zoom_factor, float sx, float sy) noexcept {
+			const float map_sx = this->toMapX(sx);
+			const float map_sy = this->toMapY(sy);
+			this->zoom = std::clamp(this->zoom * zoom_factor, 1.f, max_camera_zoom);
+			this->view_left = map_sx - (sx - this->field.left) / this->zoom;
+			this->view_top = map_sy - (sy - this->field.top) / this->zoom;
+			this->clampView();
+		}
+
+		void Camera::pan(int x_steps, int y_steps) noexcept {
+			const auto visible_rect = this->getVisibleRect();
+			this->view_left += x_steps * camera_pan_step * (visible_rect.right - visible_rect.left);
+			this->view_top += y_steps * camera_pan_step * (visible_rect.bottom - visible_rect.top);
+			this->clampView();
+		}
+
+		DrawRect Camera::getVisibleRect() const noexcept {
+			return DrawRect {this->view_left, this->view_top,
+				this->view_left + (this->field.right - this->field.left) / this->zoom,
+				this->view_top + (this->field.bottom - this->field.top) / this->zoom};
+		}
+
+		TileRange Camera::getVisibleTiles() const noexcept {
+			const float field_width = this->field.right - this->field.left;
+			const float field_height = this->field.bottom - this->field.top;
+			if (this->columns <= 0 || this->rows <= 0 || field_width <= 0.f || field_height <= 0.f) {
+				return TileRange {};
+			}
+			const float square_sw = field_width / this->columns;
+			const float square_sh = field_height / this->rows;
+			const auto visible_rect = this->getVisibleRect();
+			TileRange visible_tiles {};
+			visible_tiles.min_gx = std::clamp(static_cast<int>(std::floor((visible_rect.left - this->field.left) / square_sw)),
+				0, this->columns);
+			visible_tiles.min_gy = std::clamp(static_cast<int>(std::floor((visible_rect.top - this->field.top) / square_sh)),
+				0, this->rows);
+			visible_tiles.end_gx = std::clamp(static_cast<int>(std::ceil((visible_rect.right - this->field.left) / square_sw)),
+				0, this->columns);
+			visible_tiles.end_gy = std::clamp(static_cast<int>(std::ceil((visible_rect.bottom - this->field.top) / square_sh)),
+				0, this->rows);
+			return visible_tiles;
+		}
+
+		int Camera::getDetailBlockSize() const noexcept {
+			if (this->columns <= 0 || this->rows <= 0) {
+				return 1;
+			}
+			return graphics::getDetailBlockSize((this->field.right - this->field.left) / this->columns * this->zoom,
+				(this->field.bottom - this->field.top) / this->rows * this->zoom);
+		}
+
+		void Camera::clampView() noexcept {
+			const auto visible_rect = this->getVisibleRect();
+			const float max_view_left = this->field.right - (visible_rect.right - visible_rect.left);
+			const float max_view_top = this->field.bottom - (visible_rect.bottom - visible_rect.top);
+			this->view_left = std::clamp(this->view_left, this->field.left, std::max(max_view_left, this->field.left));
+			this->view_top = std::clamp(this->view_top, this->field.top, std::max(max_view_top, this->field.top));
+		}
+	}
+}
\ No newline at end of file
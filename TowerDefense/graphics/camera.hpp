@@ -0,0 +1,113 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include "./draw_list.hpp"
+
+// Note: Like the draw list, the camera does not depend on Windows.
+namespace hoffman_isaiah {
+	namespace graphics {
+		// The farthest that the camera can zoom in. (A zoom of 1 shows the entire map.)
+		constexpr const float max_camera_zoom = 16.f;
+		// The amount that each notch of the mouse wheel zooms in or out by.
+		constexpr const float camera_zoom_step = 1.25f;
+		// The fraction of the visible area that each press of an arrow key moves the view by.
+		constexpr const float camera_pan_step = 0.1f;
+		// Squares that are smaller than this many pixels on the screen are drawn in blocks of
+		// several squares (without outlines) rather than one by one.
+		constexpr const float min_detailed_square_size = 6.f;
+
+		/// <param name="square_sw">The width of a game square on the screen.</param>
+		/// <param name="square_sh">The height of a game square on the screen.</param>
+		/// <returns>The number of squares along each side of the blocks that the map should be
+		/// drawn in. (1 means that every square is drawn in full.)</returns>
+		int getDetailBlockSize(float square_sw, float square_sh) noexcept;
+
+		/// <summary>A rectangle of game squares from (min_gx, min_gy) up to but not including
+		/// (end_gx, end_gy).</summary>
+		struct TileRange {
+			int min_gx {0};
+			int min_gy {0};
+			int end_gx {0};
+			int end_gy {0};
+		};
+
+		/// <summary>Pans and zooms the view of the map. Everything in the game is laid out in
+		/// map coordinates, which are the screen coordinates that the map would have if the
+		/// whole map were shown; the camera maps those onto the actual screen.</summary>
+		class Camera {
+		public:
+			/// <summary>Sets the area of the screen that the map is drawn in and the size of the
+			/// map. The view is reset if the size of the map changed.</summary>
+			/// <param name="new_field">The area that the entire map covers without any zoom.</param>
+			/// <param name="new_columns">The number of columns in the map.</param>
+			/// <param name="new_rows">The number of rows in the map.</param>
+			void setMap(DrawRect new_field, int new_columns, int new_rows) noexcept;
+			/// <summary>Zooms all the way out so that the entire map is shown.</summary>
+			void reset() noexcept;
+			/// <summary>Zooms in or out while keeping the point under the mouse in place.</summary>
+			/// <param name="zoom_factor">The amount to multiply the zoom by.</param>
+			/// <param name="sx">The screen x-coordinate to zoom around.</param>
+			/// <param name="sy">The screen y-coordinate to zoom around.</param>
+			void zoomAt(float zoom_factor, float sx, float sy) noexcept;
+			/// <summary>Moves the view by a number of steps in each direction.</summary>
+			/// <param name="x_steps">The number of steps to move right (or left if negative).</param>
+			/// <param name="y_steps">The number of steps to move down (or up if negative).</param>
+			void pan(int x_steps, int y_steps) noexcept;
+			// Conversions
+			float toScreenX(float map_sx) const noexcept {
+				return this->field.left + (map_sx - this->view_left) * this->zoom;
+			}
+			float toScreenY(float map_sy) const noexcept {
+				return this->field.top + (map_sy - this->view_top) * this->zoom;
+			}
+			float toMapX(float sx) const noexcept {
+				return this->view_left + (sx - this->field.left) / this->zoom;
+			}
+			float toMapY(float sy) const noexcept {
+				return this->view_top + (sy - this->field.top) / this->zoom;
+			}
+			// Getters
+			/// <returns>True if the camera shows less than the entire map.</returns>
+			bool isZoomed() const noexcept {
+				return this->zoom > 1.f;
+			}
+			float getZoom() const noexcept {
+				return this->zoom;
+			}
+			/// <returns>The amount to add to scaled map x-coordinates to get screen x-coordinates.</returns>
+			float getOffsetX() const noexcept {
+				return this->field.left - this->view_left * this->zoom;
+			}
+			/// <returns>The amount to add to scaled map y-coordinates to get screen y-coordinates.</returns>
+			float getOffsetY() const noexcept {
+				return this->field.top - this->view_top * this->zoom;
+			}
+			/// <returns>The area of the screen that the map is drawn in.</returns>
+			DrawRect getField() const noexcept {
+				return this->field;
+			}
+			/// <returns>The part of the map that is visible in map coordinates.</returns>
+			DrawRect getVisibleRect() const noexcept;
+			/// <returns>The squares that are at least partly visible.</returns>
+			TileRange getVisibleTiles() const noexcept;
+			/// <returns>The size of the blocks that the visible squares should be drawn in.</returns>
+			int getDetailBlockSize() const noexcept;
+		protected:
+			/// <summary>Keeps the view inside of the map.</summary>
+			void clampView() noexcept;
+		private:
+			/// <summary>The area of the screen that the map is drawn in.</summary>
+			DrawRect field {};
+			/// <summary>The number of columns in the map.</summary>
+			int columns {0};
+			/// <summary>The number of rows in the map.</summary>
+			int rows {0};
+			/// <summary>The amount that the map is magnified by.</summary>
+			float zoom {1.f};
+			/// <summary>The map x-coordinate shown at the left edge of the field.</summary>
+			float view_left {0.f};
+			/// <summary>The map y-coordinate shown at the top edge of the field.</summary>
+			float view_top {0.f};
+		};
+	}
+}
\ No newline at end of file
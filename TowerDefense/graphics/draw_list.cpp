@@ -0,0 +1,108 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "./draw_list.hpp"
+
+namespace hoffman_isaiah {
+	namespace graphics {
+		namespace {
+			/// <returns>Everything about a command that requires changing the brushes or the
+			/// geometry in order to draw it.</returns>
+			auto getState(const DrawCommand& my_command) noexcept {
+				// Only shapes need their size to match since their geometry is reused.
+				const bool is_shape = my_command.type == DrawCommandTypes::Shape;
+				return std::make_tuple(my_command.layer, my_command.type, my_command.shape,
+					std::array<float, 10> {
+						my_command.outline_color.r, my_command.outline_color.g,
+						my_command.outline_color.b, my_command.outline_color.a,
+						my_command.fill_color.r, my_command.fill_color.g,
+						my_command.fill_color.b, my_command.fill_color.a,
+						is_shape ? my_command.width_sw : 0.f, is_shape ? my_command.height_sh : 0.f
+					});
+			}
+
+			/// <returns>A command of the given kind that covers the given rectangle.</returns>
+			DrawCommand createRectCommand(DrawCommandTypes type, DrawLayers layer, DrawRect my_rect) noexcept {
+				DrawCommand my_command {};
+				my_command.type = type;
+				my_command.layer = layer;
+				my_command.center_sx = (my_rect.left + my_rect.right) / 2.f;
+				my_command.center_sy = (my_rect.top + my_rect.bottom) / 2.f;
+				my_command.width_sw = my_rect.right - my_rect.left;
+				my_command.height_sh = my_rect.bottom - my_rect.top;
+				return my_command;
+			}
+		}
+
+		void DrawList::addShape(DrawLayers layer, const shapes::ShapeInstance& my_shape) {
+			DrawCommand my_command {};
+			my_command.type = DrawCommandTypes::Shape;
+			my_command.layer = layer;
+			my_command.shape = my_shape.shape;
+			my_command.outline_color = my_shape.outline_color;
+			my_command.fill_color = my_shape.fill_color;
+			my_command.center_sx = my_shape.center_sx;
+			my_command.center_sy = my_shape.center_sy;
+			my_command.width_sw = my_shape.width_sw;
+			my_command.height_sh = my_shape.height_sh;
+			this->commands.emplace_back(my_command);
+		}
+
+		void DrawList::outlineEllipse(DrawLayers layer, float csx, float csy, float rx, float ry, DrawColor o_color) {
+			auto my_command = createRectCommand(DrawCommandTypes::Outline_Ellipse, layer,
+				DrawRect {csx - rx, csy - ry, csx + rx, csy + ry});
+			my_command.outline_color = o_color;
+			this->commands.emplace_back(my_command);
+		}
+
+		void DrawList::outlineRectangle(DrawLayers layer, DrawRect my_rect, DrawColor o_color) {
+			auto my_command = createRectCommand(DrawCommandTypes::Outline_Rectangle, layer, my_rect);
+			my_command.outline_color = o_color;
+			this->commands.emplace_back(my_command);
+		}
+
+		void DrawList::fillRectangle(DrawLayers layer, DrawRect my_rect, DrawColor f_color) {
+			auto my_command = createRectCommand(DrawCommandTypes::Fill_Rectangle, layer, my_rect);
+			my_command.fill_color = f_color;
+			this->commands.emplace_back(my_command);
+		}
+
+		void DrawList::addText(DrawLayers layer, std::wstring text, DrawRect my_rect, DrawColor t_color,
+			bool use_small_text) {
+			auto my_command = createRectCommand(use_small_text ? DrawCommandTypes::Small_Text : DrawCommandTypes::Text,
+				layer, my_rect);
+			my_command.fill_color = t_color;
+			my_command.text_index = static_cast<std::uint32_t>(this->texts.size());
+			this->texts.emplace_back(std::move(text));
+			this->commands.emplace_back(my_command);
+		}
+
+		void DrawList::sort() {
+			std::stable_sort(this->commands.begin(), this->commands.end(),
+				[](const DrawCommand& first, const DrawCommand& second) {
+				return getState(first) < getState(second);
+			});
+		}
+
+		bool DrawList::haveSameState(const DrawCommand& first, const DrawCommand& second) noexcept {
+			return getState(first) == getState(second);
+		}
+
+		std::size_t DrawList::countBatches() const noexcept {
+			std::size_t batch_count = this->commands.empty() ? 0 : 1;
+			for (std::size_t i = 1; i < this->commands.size(); ++i) {
+				if (!DrawList::haveSameState(this->commands[i - 1], this->commands[i])) {
+					++batch_count;
+				}
+			}
+			return batch_count;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Note: Nothing in this file depends on Windows, so scenes can be recorded (and tested)
+// without a window or a Direct2D device.
+namespace hoffman_isaiah {
+	namespace graphics {
+		/// <summary>A color with red, green, blue, and alpha channels from 0 to 1. (This has the
+		/// same layout as the colors used by Direct2D.)</summary>
+		struct DrawColor {
+			float r {0.f};
+			float g {0.f};
+			float b {0.f};
+			float a {0.f};
+		};
+
+		/// <summary>An axis-aligned rectangle in screen coordinates.</summary>
+		struct DrawRect {
+			float left {0.f};
+			float top {0.f};
+			float right {0.f};
+			float bottom {0.f};
+		};
+
+		namespace shapes {
+			enum class ShapeTypes {
+				Ellipse, Triangle, Rectangle, Diamond, Star
+			};
+
+			/// <summary>Describes a shape without creating its geometry, so that it can be copied
+			/// cheaply (such as between threads) and drawn later.</summary>
+			struct ShapeInstance {
+				/// <summary>The kind of shape.</summary>
+				ShapeTypes shape {ShapeTypes::Ellipse};
+				/// <summary>The color to outline the shape with.</summary>
+				DrawColor outline_color {};
+				/// <summary>The color to fill the shape with.</summary>
+				DrawColor fill_color {};
+				/// <summary>The screen x-coordinate of the center of the shape.</summary>
+				float center_sx {0.f};
+				/// <summary>The screen y-coordinate of the center of the shape.</summary>
+				float center_sy {0.f};
+				/// <summary>The width of the shape in screen coordinates.</summary>
+				float width_sw {0.f};
+				/// <summary>The height of the shape in screen coordinates.</summary>
+				float height_sh {0.f};
+			};
+		}
+
+		/// <summary>The layers of a scene, which are drawn from first to last. (Commands within
+		/// a layer may be drawn in any order.)</summary>
+		enum class DrawLayers {
+			Terrain, Terrain_Outlines, Marked_Tiles, Marked_Tile_Outlines,
+			Shots, Towers, Tower_Ranges, Enemies, Bar_Backgrounds, Bar_Fills, Bar_Overlays, Labels,
+			Sentinel_DO_NOT_USE
+		};
+
+		/// <summary>The kinds of draw commands. (Within a layer, outlines are drawn before fills
+		/// and fills before text.)</summary>
+		enum class DrawCommandTypes {
+			Shape, Outline_Ellipse, Outline_Rectangle, Fill_Rectangle, Text, Small_Text,
+			Sentinel_DO_NOT_USE
+		};
+
+		/// <summary>A single drawing operation. Every command covers a box given by its center
+		/// and size: the shape's bounds, the ellipse's bounds, the rectangle itself, or the
+		/// text's layout box.</summary>
+		struct DrawCommand {
+			/// <returns>The box covered by the command.</returns>
+			DrawRect getBounds() const noexcept {
+				return DrawRect {this->center_sx - this->width_sw / 2.f, this->center_sy - this->height_sh / 2.f,
+					this->center_sx + this->width_sw / 2.f, this->center_sy + this->height_sh / 2.f};
+			}
+
+			/// <summary>The kind of command.</summary>
+			DrawCommandTypes type {DrawCommandTypes::Sentinel_DO_NOT_USE};
+			/// <summary>The layer that the command is drawn in.</summary>
+			DrawLayers layer {DrawLayers::Sentinel_DO_NOT_USE};
+			/// <summary>The kind of shape to draw. (This is only used by shape commands.)</summary>
+			shapes::ShapeTypes shape {shapes::ShapeTypes::Ellipse};
+			/// <summary>The color used for outlines.</summary>
+			DrawColor outline_color {};
+			/// <summary>The color used for fills and text.</summary>
+			DrawColor fill_color {};
+			float center_sx {0.f};
+			float center_sy {0.f};
+			float width_sw {0.f};
+			float height_sh {0.f};
+			/// <summary>The index of the command's text in its draw list. (This is only used by
+			/// text commands.)</summary>
+			std::uint32_t text_index {0};
+		};
+
+		/// <summary>Records a scene as plain draw commands so that it can be sorted by brush
+		/// color and geometry and then drawn in batches that share the same state.</summary>
+		class DrawList {
+		public:
+			/// <summary>Removes every command. (The memory is kept for the next scene.)</summary>
+			void clear() noexcept {
+				this->commands.clear();
+				this->texts.clear();
+			}
+			/// <summary>Records a shape, which is outlined and then filled.</summary>
+			void addShape(DrawLayers layer, const shapes::ShapeInstance& my_shape);
+			/// <summary>Records an ellipse outline.</summary>
+			/// <param name="rx">The horizontal radius of the ellipse.</param>
+			/// <param name="ry">The vertical radius of the ellipse.</param>
+			void outlineEllipse(DrawLayers layer, float csx, float csy, float rx, float ry, DrawColor o_color);
+			/// <summary>Records a rectangle outline.</summary>
+			void outlineRectangle(DrawLayers layer, DrawRect my_rect, DrawColor o_color);
+			/// <summary>Records a filled rectangle.</summary>
+			void fillRectangle(DrawLayers layer, DrawRect my_rect, DrawColor f_color);
+			/// <summary>Records text.</summary>
+			/// <param name="use_small_text">Should the text be drawn with the small font?</param>
+			void addText(DrawLayers layer, std::wstring text, DrawRect my_rect, DrawColor t_color,
+				bool use_small_text);
+			/// <summary>Sorts the commands by layer and then by state, so that commands that can
+			/// be drawn together are next to each other. (Commands with the same state keep the
+			/// order in which they were recorded.)</summary>
+			void sort();
+			/// <returns>True if the two commands can be drawn without changing any brush colors
+			/// or geometry in between.</returns>
+			static bool haveSameState(const DrawCommand& first, const DrawCommand& second) noexcept;
+			/// <returns>The number of runs of commands that have the same state.</returns>
+			std::size_t countBatches() const noexcept;
+			// Getters
+			const std::vector<DrawCommand>& getCommands() const noexcept {
+				return this->commands;
+			}
+			/// <returns>The text of a text command.</returns>
+			const std::wstring& getText(const DrawCommand& my_command) const {
+				return this->texts.at(my_command.text_index);
+			}
+		private:
+			/// <summary>The recorded commands.</summary>
+			std::vector<DrawCommand> commands {};
+			/// <summary>The text of each text command.</summary>
+			std::vector<std::wstring> texts {};
+		};
+	}
+}
\ No newline at end of file
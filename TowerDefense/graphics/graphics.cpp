@@ -2,6 +2,7 @@
 // File Created: March 13, 2018
 #include "./../targetver.hpp"
 #include <Windows.h>
+#include <Windowsx.h>
 #include <d2d1.h>
 #include <dwrite.h>
 #include <algorithm>
@@ -17,11 +18,13 @@
 #include "./../globals.hpp"
 #include "./../ih_math.hpp"
 #include "./../main.hpp"
+#include "./../profiler.hpp"
 #include "./../resource.h"
 #include "./../game/enemy_type.hpp"
 #include "./../game/enemy.hpp"
 #include "./../game/game_object.hpp"
 #include "./../game/my_game.hpp"
+#include "./../game/render_snapshot.hpp"
 #include "./../game/shot_types.hpp"
 #include "./../game/shot.hpp"
 #include "./../game/tower_types.hpp"
@@ -30,12 +33,20 @@
 #include "./../pathfinding/grid.hpp"
 #include "./../pathfinding/pathfinder.hpp"
 #include "./../terrain/editor.hpp"
+#include "./camera.hpp"
 #include "./graphics_DX.hpp"
 #include "./graphics.hpp"
 #include "./shapes.hpp"
 using namespace std::literals::string_literals;
 namespace hoffman_isaiah {
 	namespace graphics {
+		Renderer2D::Renderer2D(DX::DeviceResources2D* dev_res) :
+			device_resources {dev_res} {
+		}
+
+		// Defined here because the shape cache needs the complete shape type.
+		Renderer2D::~Renderer2D() noexcept = default;
+
 		void Renderer2D::updateHealthOption(HWND hwnd, int new_price) const noexcept {
 			auto my_menu = GetSubMenu(GetMenu(hwnd), id_mm_actions_offset);
 			MENUITEMINFO my_info {};
@@ -66,8 +77,14 @@ namespace hoffman_isaiah {
 			DrawMenuBar(hwnd);
 		}
 
+		void Renderer2D::updateMaxSpeedOption(HWND hwnd, bool is_max_speed) const noexcept {
+			auto my_menu = GetSubMenu(GetMenu(hwnd), id_mm_actions_offset);
+			CheckMenuItem(my_menu, ID_MM_ACTIONS_MAX_SPEED, MF_BYCOMMAND | (is_max_speed ? MF_CHECKED : MF_UNCHECKED));
+			DrawMenuBar(hwnd);
+		}
+
 		void Renderer2D::createTowerMenu(HWND hwnd,
-			const std::vector<std::unique_ptr<game::TowerType>>& towers) const noexcept {
+			const std::vector<std::shared_ptr<game::TowerType>>& towers) const noexcept {
 			auto my_menu = GetSubMenu(GetMenu(hwnd), id_mm_towers_offset);
 			// Delete what may have previously been in the menu...
 			while (GetMenuItemCount(my_menu) > 4) {
@@ -83,7 +100,7 @@ namespace hoffman_isaiah {
 		}
 
 		void Renderer2D::createShotMenu(HWND hwnd,
-			const std::map<std::wstring, std::unique_ptr<game::ShotBaseType>>& shots) const noexcept {
+			const std::map<std::wstring, std::shared_ptr<game::ShotBaseType>>& shots) const noexcept {
 			auto my_menu = GetSubMenu(GetMenu(hwnd), id_mm_shots_offset);
 			// Delete what may have previously been in the menu...
 			while (GetMenuItemCount(my_menu) > 0) {
@@ -98,7 +115,7 @@ namespace hoffman_isaiah {
 		}
 
 		void Renderer2D::createEnemyMenu(HWND hwnd,
-			const std::vector<std::unique_ptr<game::EnemyType>>& enemies,
+			const std::vector<std::shared_ptr<game::EnemyType>>& enemies,
 			std::map<std::wstring, bool> seen_before) const noexcept {
 			auto my_menu = GetSubMenu(GetMenu(hwnd), id_mm_enemies_offset);
 			// Clear the menu.
@@ -147,6 +164,225 @@ namespace hoffman_isaiah {
 			this->device_resources->getRenderTarget()->FillGeometry(my_geom, this->device_resources->getFillBrush());
 		}
 
+		const shapes::Shape2DBase* Renderer2D::getCachedShape(const DrawCommand& my_command) const noexcept {
+			const ShapeKey my_key {static_cast<int>(my_command.shape), {
+				my_command.outline_color.r, my_command.outline_color.g, my_command.outline_color.b, my_command.outline_color.a,
+				my_command.fill_color.r, my_command.fill_color.g, my_command.fill_color.b, my_command.fill_color.a,
+				my_command.width_sw, my_command.height_sh
+			}};
+			auto shape_it = this->shape_cache.find(my_key);
+			if (shape_it == this->shape_cache.end()) {
+				try {
+					shape_it = this->shape_cache.emplace(my_key, shapes::createShape(this->device_resources,
+						my_command.shape, toColor(my_command.outline_color), toColor(my_command.fill_color), 0.f, 0.f,
+						my_command.width_sw, my_command.height_sh)).first;
+				}
+				catch (...) {
+					return nullptr;
+				}
+			}
+			return shape_it->second.get();
+		}
+
+		void Renderer2D::submit(const DrawList& my_list, ID2D1RenderTarget* render_target) const noexcept {
+			IH_PROFILE_FUNCTION();
+			// Shapes are moved into place on top of whatever transform (such as the camera's) is in use.
+			D2D1_MATRIX_3X2_F base_transform {};
+			render_target->GetTransform(&base_transform);
+			const auto& commands = my_list.getCommands();
+			std::size_t batch_start = 0;
+			while (batch_start < commands.size()) {
+				const auto& first_command = commands[batch_start];
+				std::size_t batch_end = batch_start + 1;
+				while (batch_end < commands.size() && DrawList::haveSameState(first_command, commands[batch_end])) {
+					++batch_end;
+				}
+				switch (first_command.type) {
+				case DrawCommandTypes::Shape:
+				{
+					const auto* my_shape = this->getCachedShape(first_command);
+					if (!my_shape) {
+						// Skip the shapes rather than failing the entire frame.
+						break;
+					}
+					this->setBrushColors(toColor(first_command.outline_color), toColor(first_command.fill_color));
+					for (auto i = batch_start; i < batch_end; ++i) {
+						render_target->SetTransform(D2D1::Matrix3x2F::Translation(commands[i].center_sx,
+							commands[i].center_sy) * base_transform);
+						render_target->DrawGeometry(my_shape->getGeometry(), this->device_resources->getOutlineBrush());
+						render_target->FillGeometry(my_shape->getGeometry(), this->device_resources->getFillBrush());
+					}
+					render_target->SetTransform(base_transform);
+					break;
+				}
+				case DrawCommandTypes::Outline_Ellipse:
+					this->setOutlineColor(toColor(first_command.outline_color));
+					for (auto i = batch_start; i < batch_end; ++i) {
+						render_target->DrawEllipse(Renderer2D::createEllipse(commands[i].center_sx, commands[i].center_sy,
+							commands[i].width_sw / 2.f, commands[i].height_sh / 2.f), this->device_resources->getOutlineBrush());
+					}
+					break;
+				case DrawCommandTypes::Outline_Rectangle:
+					this->setOutlineColor(toColor(first_command.outline_color));
+					for (auto i = batch_start; i < batch_end; ++i) {
+						const auto my_bounds = commands[i].getBounds();
+						render_target->DrawRectangle(D2D1_RECT_F {my_bounds.left, my_bounds.top, my_bounds.right,
+							my_bounds.bottom}, this->device_resources->getOutlineBrush());
+					}
+					break;
+				case DrawCommandTypes::Fill_Rectangle:
+					this->setFillColor(toColor(first_command.fill_color));
+					for (auto i = batch_start; i < batch_end; ++i) {
+						const auto my_bounds = commands[i].getBounds();
+						render_target->FillRectangle(D2D1_RECT_F {my_bounds.left, my_bounds.top, my_bounds.right,
+							my_bounds.bottom}, this->device_resources->getFillBrush());
+					}
+					break;
+				case DrawCommandTypes::Text:
+				case DrawCommandTypes::Small_Text:
+				{
+					this->setTextColor(toColor(first_command.fill_color));
+					auto* my_format = first_command.type == DrawCommandTypes::Text
+						? this->device_resources->getTextFormat() : this->device_resources->getSmallTextFormat();
+					for (auto i = batch_start; i < batch_end; ++i) {
+						const auto& my_text = my_list.getText(commands[i]);
+						const auto my_bounds = commands[i].getBounds();
+						render_target->DrawText(my_text.c_str(), static_cast<UINT32>(my_text.size()), my_format,
+							D2D1_RECT_F {my_bounds.left, my_bounds.top, my_bounds.right, my_bounds.bottom},
+							this->device_resources->getTextBrush());
+					}
+					break;
+				}
+				default:
+					break;
+				}
+				batch_start = batch_end;
+			}
+		}
+
+		void Renderer2D::drawMapLayer(const game::GameMap& my_map) const noexcept {
+			IH_PROFILE_FUNCTION();
+			if (this->device_resources->createMapLayerTarget()) {
+				// A new target starts out empty.
+				this->map_layer_source = nullptr;
+			}
+			auto* layer_target = this->device_resources->getMapLayerTarget();
+			if (layer_target) {
+				// The cache is kept up to date even while it is not shown so that it is ready
+				// as soon as the camera zooms back out.
+				const int cache_block_size = graphics::getDetailBlockSize(my_map.getGameSquareWidth<float>(),
+					my_map.getGameSquareHeight<float>());
+				layer_target->BeginDraw();
+				try {
+					this->redrawChangedTiles(my_map, layer_target, cache_block_size);
+					this->map_layer_source = &my_map;
+					this->map_layer_block_size = cache_block_size;
+				}
+				catch (...) {
+					// Redraw everything next frame instead.
+					this->map_layer_source = nullptr;
+				}
+				if (FAILED(layer_target->EndDraw())) {
+					this->map_layer_source = nullptr;
+				}
+			}
+			const int view_block_size = this->camera.getDetailBlockSize();
+			if (!layer_target || (this->camera.isZoomed() && view_block_size == 1)) {
+				// Record and draw the visible tiles. (When zoomed in, there are few enough of
+				// them that this is cheap, and they stay sharp.)
+				try {
+					const auto visible_tiles = this->camera.getVisibleTiles();
+					this->map_tiles.clear();
+					my_map.recordTiles(this->map_tiles, visible_tiles.min_gx - visible_tiles.min_gx % view_block_size,
+						visible_tiles.min_gy - visible_tiles.min_gy % view_block_size, visible_tiles.end_gx,
+						visible_tiles.end_gy, view_block_size);
+					this->map_tiles.sort();
+					this->submit(this->map_tiles);
+				}
+				catch (...) {
+					// Skip the map rather than failing the entire frame.
+				}
+				return;
+			}
+			// Otherwise, the tiles are small enough that the cached (and possibly blocky) map
+			// can be drawn through the camera as is.
+			ID2D1Bitmap* raw_bitmap {nullptr};
+			if (SUCCEEDED(layer_target->GetBitmap(&raw_bitmap))) {
+				std::unique_ptr<ID2D1Bitmap, winapi::ReleaseCOM<ID2D1Bitmap>> map_bitmap {raw_bitmap};
+				this->device_resources->getRenderTarget()->DrawBitmap(map_bitmap.get(), nullptr, 1.f,
+					this->camera.isZoomed() ? D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
+					: D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+			}
+		}
+
+		void Renderer2D::redrawChangedTiles(const game::GameMap& my_map, ID2D1RenderTarget* layer_target,
+			int block_size) const {
+			this->changed_map_tiles.clear();
+			// (The changes must be taken even when everything is redrawn so that they are forgotten.)
+			const bool all_tiles_changed = my_map.takeChangedTiles(this->changed_map_tiles);
+			if (all_tiles_changed || this->map_layer_source != &my_map || this->map_layer_block_size != block_size) {
+				layer_target->Clear(D2D1::ColorF {0.f, 0.f, 0.f, 0.f});
+				this->map_tiles.clear();
+				my_map.recordTiles(this->map_tiles, 0, 0, my_map.getWidth(), my_map.getHeight(), block_size);
+				this->map_tiles.sort();
+				this->submit(this->map_tiles, layer_target);
+				return;
+			}
+			// Redraw each block that contains a changed tile. (Unless the map is drawn in blocks,
+			// each block is a single tile.)
+			const int blocks_per_row = (my_map.getWidth() + block_size - 1) / block_size;
+			for (auto& tile : this->changed_map_tiles) {
+				tile = (tile / my_map.getWidth() / block_size) * blocks_per_row + (tile % my_map.getWidth()) / block_size;
+			}
+			std::sort(this->changed_map_tiles.begin(), this->changed_map_tiles.end());
+			this->changed_map_tiles.erase(std::unique(this->changed_map_tiles.begin(), this->changed_map_tiles.end()),
+				this->changed_map_tiles.end());
+			for (const int block : this->changed_map_tiles) {
+				const int block_gx = (block % blocks_per_row) * block_size;
+				const int block_gy = (block / blocks_per_row) * block_size;
+				const auto slx = static_cast<float>(my_map.convertToScreenX(block_gx));
+				const auto sty = static_cast<float>(my_map.convertToScreenY(block_gy));
+				const auto srx = static_cast<float>(my_map.convertToScreenX(std::min(block_gx + block_size, my_map.getWidth())));
+				const auto sby = static_cast<float>(my_map.convertToScreenY(std::min(block_gy + block_size, my_map.getHeight())));
+				// The outlines of a tile spill over into the neighboring tiles slightly, so the
+				// area cleared is a bit larger than the block, and the neighbors are redrawn into it.
+				layer_target->PushAxisAlignedClip(D2D1_RECT_F {slx - 1.f, sty - 1.f, srx + 1.f, sby + 1.f},
+					D2D1_ANTIALIAS_MODE_ALIASED);
+				layer_target->Clear(D2D1::ColorF {0.f, 0.f, 0.f, 0.f});
+				this->map_tiles.clear();
+				my_map.recordTiles(this->map_tiles, std::max(block_gx - block_size, 0), std::max(block_gy - block_size, 0),
+					std::min(block_gx + 2 * block_size, my_map.getWidth()),
+					std::min(block_gy + 2 * block_size, my_map.getHeight()), block_size);
+				this->map_tiles.sort();
+				this->submit(this->map_tiles, layer_target);
+				layer_target->PopAxisAlignedClip();
+			}
+		}
+
+		void Renderer2D::beginCameraView(const game::GameMap& my_map) const noexcept {
+			this->camera.setMap(DrawRect {static_cast<float>(my_map.convertToScreenX(0)),
+				static_cast<float>(my_map.convertToScreenY(0)),
+				static_cast<float>(my_map.convertToScreenX(my_map.getWidth())),
+				static_cast<float>(my_map.convertToScreenY(my_map.getHeight()))}, my_map.getWidth(), my_map.getHeight());
+			auto render_target = this->device_resources->getRenderTarget();
+			if (this->camera.isZoomed()) {
+				// Keep the magnified map out of the margins.
+				const auto my_field = this->camera.getField();
+				render_target->PushAxisAlignedClip(D2D1_RECT_F {my_field.left, my_field.top, my_field.right, my_field.bottom},
+					D2D1_ANTIALIAS_MODE_ALIASED);
+			}
+			render_target->SetTransform(D2D1::Matrix3x2F::Scale(this->camera.getZoom(), this->camera.getZoom())
+				* D2D1::Matrix3x2F::Translation(this->camera.getOffsetX(), this->camera.getOffsetY()));
+		}
+
+		void Renderer2D::endCameraView() const noexcept {
+			auto render_target = this->device_resources->getRenderTarget();
+			render_target->SetTransform(D2D1::Matrix3x2F::Identity());
+			if (this->camera.isZoomed()) {
+				render_target->PopAxisAlignedClip();
+			}
+		}
+
 		void Renderer2D::drawText(std::wstring text, Color t_color, D2D_RECT_F my_rect, bool draw_rect) const noexcept {
 			this->setTextColor(t_color);
 			this->device_resources->getRenderTarget()->DrawText(text.c_str(), static_cast<UINT32>(text.size()),
@@ -165,8 +401,8 @@ namespace hoffman_isaiah {
 			}
 		}
 
-		HRESULT Renderer2D::render(const game::MyGame* my_game, int mouse_gx, int mouse_gy,
-			int mouse_end_gx, int mouse_end_gy, bool in_editor) const {
+		HRESULT Renderer2D::render(const game::MyGame* my_game, const game::RenderSnapshot& my_snapshot,
+			int mouse_gx, int mouse_gy, int mouse_end_gx, int mouse_end_gy, bool in_editor) const {
 			// Check time before rendering
 			static LARGE_INTEGER last_update_time {0};
 			if (last_update_time.QuadPart == 0) {
@@ -178,24 +414,38 @@ namespace hoffman_isaiah {
 				return S_OK;
 			}
 			last_update_time = my_times.first;
+			IH_PROFILE_SCOPE("Renderer2D::render");
 			// Do drawing
 			auto render_target = this->device_resources->getRenderTarget();
 			render_target->BeginDraw();
 			render_target->Clear(Color {1.f, 1.f, 1.f, 1.f});
+			this->beginCameraView(my_game->getMap());
 			// Draw terrain
-			my_game->getMap().draw(*this, nullptr);
-			// Draw shots, towers, and enemies.
+			{
+				IH_PROFILE_SCOPE("Draw terrain");
+				my_game->getMap().draw(*this, nullptr);
+			}
+			// Draw the shots, towers, and enemies that might be visible.
 			if (!in_editor) {
-				for (const auto& s : my_game->shots) {
-					s->draw(*this);
-				}
-				for (const auto& t : my_game->towers) {
-					t->draw(*this);
-				}
-				for (const auto& e : my_game->enemies) {
-					e->draw(*this);
-				}
+				IH_PROFILE_SCOPE("Draw game objects");
+				this->draw_list.clear();
+				my_snapshot.record(this->draw_list, this->camera.getVisibleRect(), this->camera.getDetailBlockSize() == 1);
+				this->draw_list.sort();
+				this->submit(this->draw_list);
+			}
+#if (defined(DEBUG) || defined(_DEBUG))
+			// Paint pathfinder paths. (They were found by the simulation thread.)
+			for (const auto& my_square : my_snapshot.ground_test_path) {
+				this->paintSquare(my_game->getMap(), my_square.first, my_square.second, Color {0.f, 1.f, 0.f, 1.f},
+					Color {0.8f, 0.8f, 0.8f, 0.3f});
+			}
+			for (const auto& my_square : my_snapshot.air_test_path) {
+				this->paintSquare(my_game->getMap(), my_square.first, my_square.second, Color {1.f, 0.f, 0.f, 1.f},
+					Color {0.8f, 0.8f, 0.8f, 0.3f});
 			}
+#endif // DEBUG | _DEBUG -> Path Debugging
+			this->paintMouseSquares(my_game->getMap(), mouse_gx, mouse_gy, mouse_end_gx, mouse_end_gy);
+			this->endCameraView();
 #if 0
 			my_game->level = 999;
 			my_game->difficulty = 99.9922;
@@ -211,10 +461,10 @@ namespace hoffman_isaiah {
 			constexpr const float text_rect_height = 15.f;
 			constexpr const Color outline_color {0.5f, 0.5f, 0.5f, 1.f};
 			this->setOutlineColor(outline_color);
-			std::wstring level_text = L"Level: "s + std::to_wstring(my_game->level);
+			std::wstring level_text = L"Level: "s + std::to_wstring(my_snapshot.level);
 			const auto level_rect = Renderer2D::createRectangle(margin_left_sx,
 				text_rect_top_sy, 70.f, text_rect_height);
-			if (my_game->getLevelNumber() < 100) {
+			if (my_snapshot.level < 100) {
 				this->drawText(level_text, Color {0.f, 0.f, 0.f, 1.f}, level_rect);
 			}
 			else {
@@ -223,50 +473,37 @@ namespace hoffman_isaiah {
 				this->setOutlineColor(outline_color);
 			}
 			std::wostringstream difficulty_text {};
-			difficulty_text << L"Difficulty: " << std::setprecision(2) << std::fixed << my_game->difficulty;
+			difficulty_text << L"Difficulty: " << std::setprecision(2) << std::fixed << my_snapshot.difficulty;
 			const auto difficulty_rect = Renderer2D::createRectangle(margin_left_sx + 70.f + 25.f,
 				text_rect_top_sy, 120.f, text_rect_height);
 			this->drawText(difficulty_text.str(), Color {0.f, 0.f, 0.f, 1.f}, difficulty_rect);
-			std::wstring life_text = L"Life: "s + std::to_wstring(my_game->player.getHealth());
+			std::wstring life_text = L"Life: "s + std::to_wstring(my_snapshot.health);
 			const auto life_rect = Renderer2D::createRectangle(margin_left_sx + 95.f + 120.f + 25.f,
 				text_rect_top_sy, 75.f, text_rect_height);
 			this->drawText(life_text, Color {0.f, 0.f, 0.f, 1.f}, life_rect);
 			std::wostringstream cash_text {};
-			cash_text << L"Cash: $" << std::setprecision(0) << std::fixed << my_game->player.getMoney();
+			cash_text << L"Cash: $" << std::setprecision(0) << std::fixed << my_snapshot.money;
 			const auto cash_rect = Renderer2D::createRectangle(margin_left_sx + 240.f + 75.f + 25.f,
 				text_rect_top_sy, 100.f, text_rect_height);
 			this->drawText(cash_text.str(), Color {0.f, 0.f, 0.f, 1.f}, cash_rect);
-			if (!my_game->player.isAlive()) {
-				const long long score = my_game->calculateScore();
-				std::wstring score_text = L"Game over! Final Score: "s + std::to_wstring(score);
-				if (my_game->is_hiscore) {
+			if (!my_snapshot.is_alive) {
+				std::wstring score_text = L"Game over! Final Score: "s + std::to_wstring(my_snapshot.score);
+				if (my_snapshot.is_hiscore) {
 					score_text += L"\tHiscore!";
 				}
 				const auto score_rect = Renderer2D::createRectangle(margin_left_sx + 340.f + 100.f + 25.f,
 					text_rect_top_sy - text_rect_height / 4.f, 340.f, text_rect_height * 1.5f);
 				this->drawText(score_text, Color {0.f, 0.f, 0.f, 1.f}, score_rect);
 			}
-#if (defined(DEBUG) || defined(_DEBUG))
-			if (my_game->show_test_paths
-				&& my_game->ground_test_pf->checkPathExists()) {
-				// Paint pathfinder paths.
-				auto ground_path = my_game->ground_test_pf->findPath(0);
-				while (!ground_path.empty()) {
-					auto my_node = ground_path.front();
-					ground_path.pop();
-					this->paintSquare(my_game->getMap(), my_node.getGameX(), my_node.getGameY(), Color {0.f, 1.f, 0.f, 1.f},
-						Color {0.8f, 0.8f, 0.8f, 0.3f});
-				}
-				auto air_path = my_game->air_test_pf->findPath(0);
-				while (!air_path.empty()) {
-					auto my_node = air_path.front();
-					air_path.pop();
-					this->paintSquare(my_game->getMap(), my_node.getGameX(), my_node.getGameY(), Color {1.f, 0.f, 0.f, 1.f},
-						Color {0.8f, 0.8f, 0.8f, 0.3f});
-				}
+			else if (my_snapshot.is_max_speed && my_snapshot.in_level) {
+				std::wostringstream tick_rate_text {};
+				tick_rate_text << L"Max Speed: " << std::setprecision(0) << std::fixed
+					<< my_snapshot.ticks_per_second << L" ticks/s";
+				const auto tick_rate_rect = Renderer2D::createRectangle(margin_left_sx + 340.f + 100.f + 25.f,
+					text_rect_top_sy, 160.f, text_rect_height);
+				this->drawText(tick_rate_text.str(), Color {0.f, 0.f, 0.f, 1.f}, tick_rate_rect);
 			}
-#endif // DEBUG | _DEBUG -> Path Debugging
-			this->paintMouseSquares(my_game->getMap(), mouse_gx, mouse_gy, mouse_end_gx, mouse_end_gy);
+			IH_PROFILE_SCOPE("EndDraw");
 			return render_target->EndDraw();
 		}
 
@@ -287,20 +524,58 @@ namespace hoffman_isaiah {
 			auto render_target = this->device_resources->getRenderTarget();
 			render_target->BeginDraw();
 			render_target->Clear(Color {1.f, 1.f, 1.f, 1.f});
+			this->beginCameraView(my_editor.getMap());
 			// Draw terrain
 			my_editor.getMap().draw(*this, &my_editor);
 			this->paintMouseSquares(my_editor.getMap(), mouse_gx, mouse_gy, mouse_end_gx, mouse_end_gy);
+			this->endCameraView();
 			return render_target->EndDraw();
 		}
 
+		bool handleCameraInput(Camera& my_camera, HWND hwnd, const MSG& msg) noexcept {
+			if (msg.message == WM_MOUSEWHEEL) {
+				// Zoom around the mouse. (The wheel's position is in screen coordinates.)
+				POINT mouse_point {GET_X_LPARAM(msg.lParam), GET_Y_LPARAM(msg.lParam)};
+				ScreenToClient(hwnd, &mouse_point);
+				const float wheel_notches = static_cast<float>(GET_WHEEL_DELTA_WPARAM(msg.wParam)) / WHEEL_DELTA;
+				my_camera.zoomAt(std::pow(camera_zoom_step, wheel_notches), static_cast<float>(mouse_point.x),
+					static_cast<float>(mouse_point.y));
+				return true;
+			}
+			if (msg.message != WM_KEYDOWN) {
+				return false;
+			}
+			switch (msg.wParam) {
+			case VK_LEFT:
+				my_camera.pan(-1, 0);
+				return true;
+			case VK_RIGHT:
+				my_camera.pan(1, 0);
+				return true;
+			case VK_UP:
+				my_camera.pan(0, -1);
+				return true;
+			case VK_DOWN:
+				my_camera.pan(0, 1);
+				return true;
+			case VK_HOME:
+				my_camera.reset();
+				return true;
+			default:
+				return false;
+			}
+		}
+
 		void Renderer2D::paintMouseSquares(const game::GameMap& map, int mouse_gx, int mouse_gy, int mouse_end_gx, int mouse_end_gy) const noexcept {
 			// Highlight squares
 			if (map.getTerrainGraph(false).verifyCoordinates(mouse_gx, mouse_gy)
 				&& map.getTerrainGraph(false).verifyCoordinates(mouse_end_gx, mouse_end_gy)) {
-				const auto min_gx = math::get_min(mouse_gx, mouse_end_gx);
-				const auto min_gy = math::get_min(mouse_gy, mouse_end_gy);
-				const auto max_gx = math::get_max(mouse_gx, mouse_end_gx);
-				const auto max_gy = math::get_max(mouse_gy, mouse_end_gy);
+				// (Only the visible squares are painted.)
+				const auto visible_tiles = this->camera.getVisibleTiles();
+				const auto min_gx = math::get_max(math::get_min(mouse_gx, mouse_end_gx), visible_tiles.min_gx);
+				const auto min_gy = math::get_max(math::get_min(mouse_gy, mouse_end_gy), visible_tiles.min_gy);
+				const auto max_gx = math::get_min(math::get_max(mouse_gx, mouse_end_gx), visible_tiles.end_gx - 1);
+				const auto max_gy = math::get_min(math::get_max(mouse_gy, mouse_end_gy), visible_tiles.end_gy - 1);
 				constexpr const graphics::Color o_color {1.0f, 0.f, 0.f, 1.0f};
 				constexpr const graphics::Color f_color {0.8f, 0.8f, 0.8f, 0.2f};
 				for (int gx = min_gx; gx <= max_gx; ++gx) {
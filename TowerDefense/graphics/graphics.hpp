@@ -5,10 +5,13 @@
 #include <Windows.h>
 #include <d2d1.h>
 #include <dwrite.h>
+#include <array>
 #include <memory>
 #include <vector>
 #include <map>
 #include "./../globals.hpp"
+#include "./camera.hpp"
+#include "./draw_list.hpp"
 #include "./graphics_DX.hpp"
 
 namespace hoffman_isaiah {
@@ -19,6 +22,7 @@ namespace hoffman_isaiah {
 		class TowerType;
 		class ShotBaseType;
 		class GameMap;
+		struct RenderSnapshot;
 	}
 
 	namespace winapi {
@@ -57,12 +61,27 @@ namespace hoffman_isaiah {
 		// using a structure not directly included in a file.
 		using Color = D3DCOLORVALUE;
 
+		/// <returns>The Direct2D color that matches a draw list color.</returns>
+		constexpr Color toColor(DrawColor my_color) noexcept {
+			return Color {my_color.r, my_color.g, my_color.b, my_color.a};
+		}
+		/// <returns>The draw list color that matches a Direct2D color.</returns>
+		constexpr DrawColor toDrawColor(Color my_color) noexcept {
+			return DrawColor {my_color.r, my_color.g, my_color.b, my_color.a};
+		}
+
+		namespace shapes {
+			// Forward declaration
+			class Shape2DBase;
+		}
+
 		/// <summary>Class that handles rendering of 2D elements.</summary>
 		class Renderer2D {
 		public:
-			Renderer2D(DX::DeviceResources2D* dev_res) :
-				device_resources {dev_res} {
-			}
+			Renderer2D(DX::DeviceResources2D* dev_res);
+			~Renderer2D() noexcept;
+			Renderer2D(const Renderer2D&) = delete;
+			Renderer2D& operator=(const Renderer2D&) = delete;
 			/// <summary>Updates the text for the health option.</summary>
 			/// <param name="hwnd">Handle to the parent window.</param>
 			/// <param name="new_price">The new price to buy health.</param>
@@ -71,20 +90,24 @@ namespace hoffman_isaiah {
 			/// <param name="hwnd">Handle to the parent window.</param>
 			/// <param name="new_update_speed">The new speed to update the game at.</param>
 			void updateSpeedOption(HWND hwnd, int new_update_speed) const noexcept;
+			/// <summary>Updates the check mark of the maximum speed option.</summary>
+			/// <param name="hwnd">Handle to the parent window.</param>
+			/// <param name="is_max_speed">Is the game running at maximum speed?</param>
+			void updateMaxSpeedOption(HWND hwnd, bool is_max_speed) const noexcept;
 			/// <summary>Recreates the tower menu with the current list of towers.</summary>
 			/// <param name="hwnd">Handle to the parent window.</param>
 			/// <param name="towers">The list of tower types that the player can choose from.</param>
-			void createTowerMenu(HWND hwnd, const std::vector<std::unique_ptr<game::TowerType>>& towers) const noexcept;
+			void createTowerMenu(HWND hwnd, const std::vector<std::shared_ptr<game::TowerType>>& towers) const noexcept;
 			/// <summary>Recreates the shots menu with the current list of shots.</summary>
 			/// <param name="hwnd">Handle to the parent window.</param>
 			/// <param name="shots">The list of shot types.</param>
-			void createShotMenu(HWND hwnd, const std::map<std::wstring, std::unique_ptr<game::ShotBaseType>>& shots) const noexcept;
+			void createShotMenu(HWND hwnd, const std::map<std::wstring, std::shared_ptr<game::ShotBaseType>>& shots) const noexcept;
 			/// <summary>Recreates the enemies menu with the current list of enemies (that have been seen before).</summary>
 			/// <param name="hwnd">Handle to the parent window.</param>
 			/// <param name="enemies">The list of enemy types.</param>
 			/// <param name="seen_before">A list of boolean values that indicate whether a particular enemy
 			/// type has been seen before.</param>
-			void createEnemyMenu(HWND hwnd, const std::vector<std::unique_ptr<game::EnemyType>>& enemies,
+			void createEnemyMenu(HWND hwnd, const std::vector<std::shared_ptr<game::EnemyType>>& enemies,
 				std::map<std::wstring, bool> seen_before) const noexcept;
 			/// <summary>Updates the currently selected tower on the tower menu.</summary>
 			/// <param name="hwnd">Handle to the parent window.</param>
@@ -106,6 +129,18 @@ namespace hoffman_isaiah {
 			/// <param name="my_geom">The geometry to fill.</param>
 			/// <param name="f_color">The color to fill the geometry with.</param>
 			void fillGeometry(ID2D1Geometry* my_geom, Color f_color) const noexcept;
+			/// <summary>Draws a sorted draw list. Each run of commands with the same state is
+			/// drawn as one batch, so the brush colors and geometry change only between batches.</summary>
+			/// <param name="my_list">The commands to draw.</param>
+			void submit(const DrawList& my_list) const noexcept {
+				this->submit(my_list, this->device_resources->getRenderTarget());
+			}
+			/// <summary>Draws the map's terrain and marked tiles. These are cached in an off-screen
+			/// bitmap, and only the tiles that changed since the last frame are redrawn into it.
+			/// (When the camera is zoomed in far enough to see the tiles in full, the visible tiles
+			/// are drawn directly instead.)</summary>
+			/// <param name="my_map">Reference to the map being drawn.</param>
+			void drawMapLayer(const game::GameMap& my_map) const noexcept;
 
 			/// <summary>Renders some text on the screen.</summary>
 			/// <param name="text">The text to render on the screen.</param>
@@ -121,13 +156,15 @@ namespace hoffman_isaiah {
 			void drawSmallText(std::wstring text, Color t_color, D2D_RECT_F my_rect, bool draw_rect = true) const noexcept;
 			
 			/// <summary>Draws the current scene based on the game state.</summary>
-			/// <param name="my_game">Non-owning pointer to the current game state.</param>
+			/// <param name="my_game">Non-owning pointer to the current game state. (Only the map is
+			/// drawn from the game itself; the game's objects are drawn from the snapshot.)</param>
+			/// <param name="my_snapshot">The most recent snapshot of the game's objects.</param>
 			/// <param name="mouse_gx">The starting game x-coordinate of the mouse.</param>
 			/// <param name="mouse_gy">The starting game y-coordinate of the mouse.</param>
 			/// <param name="mouse_end_gx">The ending game x-coordinate of the mouse.</param>
 			/// <param name="mouse_end_gy">The ending game y-coordinate of the mouse.</param>
 			/// <param name="in_editor">Are we in the terrain editor?</param>
-			HRESULT render(const game::MyGame* my_game, int mouse_gx, int mouse_gy,
+			HRESULT render(const game::MyGame* my_game, const game::RenderSnapshot& my_snapshot, int mouse_gx, int mouse_gy,
 				int mouse_end_gx, int mouse_end_gy, bool in_editor = false) const;
 			/// <summary>Draws the current scene based on the editor's state.</summary>
 			/// <param name="my_editor">Reference to the editor being drawn.</param>
@@ -137,6 +174,15 @@ namespace hoffman_isaiah {
 			/// <param name="mouse_end_gy">The ending game y-coordinate of the mouse.</param>
 			HRESULT render(const terrain_editor::TerrainEditor& my_editor, int mouse_gx, int mouse_gy,
 				int mouse_end_gx, int mouse_end_gy) const;
+			// Getters
+			/// <returns>The camera used to view the map. (Mouse coordinates must be converted with
+			/// the camera before they are converted to game coordinates.)</returns>
+			const Camera& getCamera() const noexcept {
+				return this->camera;
+			}
+			Camera& getCamera() noexcept {
+				return this->camera;
+			}
 			// Setters
 			void setOutlineColor(Color o_color) const noexcept {
 				this->device_resources->getOutlineBrush()->SetColor(o_color);
@@ -187,9 +233,61 @@ namespace hoffman_isaiah {
 			/// <param name="mouse_end_gx">The ending game x-coordinate of the mouse.</param>
 			/// <param name="mouse_end_gy">The ending game y-coordinate of the mouse.</param>
 			void paintMouseSquares(const game::GameMap& map, int mouse_gx, int mouse_gy, int mouse_end_gx, int mouse_end_gy) const noexcept;
+			/// <summary>Starts drawing the map and the objects on it through the camera.</summary>
+			/// <param name="my_map">Reference to the map being drawn.</param>
+			void beginCameraView(const game::GameMap& my_map) const noexcept;
+			/// <summary>Goes back to drawing directly on the screen.</summary>
+			void endCameraView() const noexcept;
+		protected:
+			/// <returns>The geometry for a shape command, centered on the origin. (The geometry is
+			/// created the first time a shape of its kind, size, and colors is drawn and reused
+			/// afterwards.) Null is returned if the geometry could not be created.</returns>
+			const shapes::Shape2DBase* getCachedShape(const DrawCommand& my_command) const noexcept;
+			/// <summary>Draws a sorted draw list onto a render target that shares the renderer's brushes.</summary>
+			/// <param name="my_list">The commands to draw.</param>
+			/// <param name="render_target">The target to draw onto.</param>
+			void submit(const DrawList& my_list, ID2D1RenderTarget* render_target) const noexcept;
+			/// <summary>Redraws the tiles of the cached map layer that changed. (The layer's target
+			/// must be between BeginDraw and EndDraw.)</summary>
+			/// <param name="my_map">Reference to the map being drawn.</param>
+			/// <param name="layer_target">The target that holds the cached map layer.</param>
+			/// <param name="block_size">The size of the blocks that the tiles are drawn in.</param>
+			void redrawChangedTiles(const game::GameMap& my_map, ID2D1RenderTarget* layer_target, int block_size) const;
 		private:
+			/// <summary>Identifies a shape's geometry by everything but the shape's position.</summary>
+			struct ShapeKey {
+				int shape;
+				/// <summary>The outline color, the fill color, the width, and the height.</summary>
+				std::array<float, 10> values;
+				bool operator<(const ShapeKey& other) const noexcept {
+					return this->shape < other.shape || (this->shape == other.shape && this->values < other.values);
+				}
+			};
 			/// <summary>Shared pointer to the resources used by the renderer.</summary>
 			mutable graphics::DX::DeviceResources2D* device_resources;
+			/// <summary>The geometry of every shape drawn so far, centered on the origin.</summary>
+			mutable std::map<ShapeKey, std::unique_ptr<shapes::Shape2DBase>> shape_cache {};
+			/// <summary>The scene being drawn. (It is kept between frames to reuse its memory.)</summary>
+			mutable DrawList draw_list {};
+			/// <summary>The camera used to view the map. (It is updated to fit the map each frame.)</summary>
+			mutable Camera camera {};
+			/// <summary>The map whose layers are cached in the map layer target, or null if the
+			/// cache must be redrawn in full.</summary>
+			mutable const game::GameMap* map_layer_source {nullptr};
+			/// <summary>The size of the blocks that the cached map layer was drawn in.</summary>
+			mutable int map_layer_block_size {1};
+			/// <summary>The map tiles being redrawn. (It is kept between frames to reuse its memory.)</summary>
+			mutable DrawList map_tiles {};
+			/// <summary>The tiles that changed since the last frame.</summary>
+			mutable std::vector<int> changed_map_tiles {};
 		};
+
+		/// <summary>Zooms a camera in response to the mouse wheel, pans it in response to the
+		/// arrow keys, and resets it in response to the Home key.</summary>
+		/// <param name="my_camera">The camera to move.</param>
+		/// <param name="hwnd">Handle to the window that the camera draws in.</param>
+		/// <param name="msg">The message to handle.</param>
+		/// <returns>True if the message moved the camera.</returns>
+		bool handleCameraInput(Camera& my_camera, HWND hwnd, const MSG& msg) noexcept;
 	}
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ namespace hoffman_isaiah {
 		void DeviceResources2D::createDeviceIndependentResources() {
 			// Create Direct2D factory
 			ID2D1Factory* raw_factory {nullptr};
-			HRESULT hr = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &raw_factory);
+			HRESULT hr = D2D1CreateFactory(D2D1_FACTORY_TYPE_MULTI_THREADED, &raw_factory);
 			if (FAILED(hr)) {
 				winapi::handleWindowsError(L"Creation of Direct2D factory");
 			}
@@ -95,5 +95,18 @@ namespace hoffman_isaiah {
 			}
 			return hr;
 		}
+
+		bool DeviceResources2D::createMapLayerTarget() {
+			if (this->map_layer_target || !this->render_target) {
+				return false;
+			}
+			ID2D1BitmapRenderTarget* raw_layer_target {nullptr};
+			const HRESULT hr = this->render_target->CreateCompatibleRenderTarget(&raw_layer_target);
+			if (FAILED(hr)) {
+				return false;
+			}
+			this->map_layer_target.reset(raw_layer_target);
+			return true;
+		}
 	}
 }
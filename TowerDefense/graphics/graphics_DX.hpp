@@ -44,9 +44,14 @@ namespace hoffman_isaiah {
 			/// <param name="hwnd">Handle to the window that the resources are associated with.</param>
 			/// <returns>A value indicating whether or not the resources were successfully created.</returns>
 			HRESULT createDeviceResources(HWND hwnd);
+			/// <summary>Creates the off-screen target that the map's static layers are cached in
+			/// if it does not exist yet. (The device resources must already exist.)</summary>
+			/// <returns>True if the target was just created (so its contents must be redrawn).</returns>
+			bool createMapLayerTarget();
 			/// <summary>Releases the rendering target and associated brushes
 			/// that are device-dependent resources.</summary>
 			void discardDeviceResources() noexcept {
+				this->map_layer_target = nullptr;
 				this->text_brush = nullptr;
 				this->fill_brush = nullptr;
 				this->outline_brush = nullptr;
@@ -59,6 +64,11 @@ namespace hoffman_isaiah {
 			ID2D1HwndRenderTarget* getRenderTarget() noexcept {
 				return this->render_target.get();
 			}
+			/// <returns>The off-screen target that holds the map's static layers, or null if it
+			/// could not be created.</returns>
+			ID2D1BitmapRenderTarget* getMapLayerTarget() noexcept {
+				return this->map_layer_target.get();
+			}
 			ID2D1SolidColorBrush* getOutlineBrush() noexcept {
 				return this->outline_brush.get();
 			}
@@ -108,6 +118,10 @@ namespace hoffman_isaiah {
 			/// <summary>Pointer to the Direct2D brush used for text.</summary>
 			std::unique_ptr<ID2D1SolidColorBrush, winapi::ReleaseCOM<ID2D1SolidColorBrush>>
 				text_brush {nullptr};
+			/// <summary>Pointer to the off-screen target (the same size as the render target)
+			/// that holds the map's terrain and marked tiles between frames.</summary>
+			std::unique_ptr<ID2D1BitmapRenderTarget, winapi::ReleaseCOM<ID2D1BitmapRenderTarget>>
+				map_layer_target {nullptr};
 		};
 	}
 }
\ No newline at end of file
@@ -616,13 +616,9 @@ namespace hoffman_isaiah::winapi {
 	TowerUpgradeInfoDialog::TowerUpgradeInfoDialog(HWND owner, HINSTANCE h_inst, game::Tower& t, game::TowerUpgradeOption upgrade_opt) :
 		InfoDialogBase {h_inst, *t.getBaseType()},
 		my_tower {t} {
-		const auto upgrade_level = this->my_tower.getLevel() + 1;
-		for (const auto& upgrade : this->my_tower.getBaseType()->getUpgrades()) {
-			if (upgrade_level == upgrade.getLevel() && upgrade_opt == upgrade.getOption()) {
-				this->my_upgrade = &upgrade;
-				this->upgrade_cost = upgrade.getCostPercent() * this->my_tower.getCost() + 1.0;
-				break;
-			}
+		this->my_upgrade = this->my_tower.getNextUpgrade(upgrade_opt);
+		if (this->my_upgrade) {
+			this->upgrade_cost = this->my_tower.getUpgradeCost(*this->my_upgrade);
 		}
 		if (!this->my_upgrade) {
 			MessageBox(owner, L"Error: Could not find tower upgrade information.", L"Upgrade Dialog Creation Failed", MB_OK | MB_ICONWARNING);
@@ -3,6 +3,7 @@
 #include "./../targetver.hpp"
 #include <Windows.h>
 #include <d2d1.h>
+#include <cmath>
 #include <memory>
 #include <array>
 #include "./../globals.hpp"
@@ -135,5 +136,52 @@ namespace hoffman_isaiah {
 			}
 			this->recreateGeometry();
 		}
+
+		std::unique_ptr<Shape2DBase> createShape(graphics::DX::DeviceResources2D* dev_res, ShapeTypes st,
+			Color o_color, Color f_color, float csx, float csy, float sw, float sh) {
+			switch (st) {
+			case ShapeTypes::Star:
+			{
+				const std::array<std::array<float, 2>, 10> points {{
+					{csx, csy + sh / 2.f},
+					{csx + sw / 4.f * std::cos(0.7f * math::calculate_pi<float>()),
+					csy + sh / 4.f * std::sin(0.7f * math::calculate_pi<float>())},
+					{csx + sw / 2.f * std::cos(0.9f * math::calculate_pi<float>()),
+					csy + sh / 2.f * std::sin(0.9f * math::calculate_pi<float>())},
+					{csx + sw / 4.f * std::cos(1.1f * math::calculate_pi<float>()),
+					csy + sh / 4.f * std::sin(1.1f * math::calculate_pi<float>())},
+					{csx + sw / 2.f * std::cos(1.3f * math::calculate_pi<float>()),
+					csy + sh / 2.f * std::sin(1.3f * math::calculate_pi<float>())},
+					{csx + sw / 4.f * std::cos(1.5f * math::calculate_pi<float>()),
+					csy + sh / 4.f * std::sin(1.5f * math::calculate_pi<float>())},
+					{csx + sw / 2.f * std::cos(1.7f * math::calculate_pi<float>()),
+					csy + sh / 2.f * std::sin(1.7f * math::calculate_pi<float>())},
+					{csx + sw / 4.f * std::cos(1.9f * math::calculate_pi<float>()),
+					csy + sh / 4.f * std::sin(1.9f * math::calculate_pi<float>())},
+					{csx + sw / 2.f * std::cos(2.1f * math::calculate_pi<float>()),
+					csy + sh / 2.f * std::sin(2.1f * math::calculate_pi<float>())},
+					{csx + sw / 4.f * std::cos(2.3f * math::calculate_pi<float>()),
+					csy + sh / 4.f * std::sin(2.3f * math::calculate_pi<float>())}
+				}};
+				return std::make_unique<Shape2DPolygon<10>>(
+					dev_res, o_color, f_color, points, csx, csy);
+			}
+			case ShapeTypes::Diamond:
+				return std::make_unique<Shape2DDiamond>(dev_res, o_color, f_color,
+					csx, csy, sw, sh);
+			case ShapeTypes::Rectangle:
+				return std::make_unique<Shape2DRectangle>(dev_res, o_color, f_color,
+					csx - sw / 2.f, csy - sh / 2.f, csx + sw / 2.f, csy + sh / 2.f);
+			case ShapeTypes::Triangle:
+			{
+				return std::make_unique<Shape2DTriangle>(dev_res, o_color, f_color,
+					csx - sw / 2.f, csy - sh / 2.f, csx, csy + sh / 2.f, csx + sw / 2.f, csy - sh / 2.f);
+			}
+			case ShapeTypes::Ellipse:
+			default:
+				return std::make_unique<Shape2DEllipse>(dev_res, o_color, f_color,
+					csx, csy, sw, sh);
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -9,14 +9,11 @@
 #include <memory>
 #include "./../globals.hpp"
 #include "./../ih_math.hpp"
+#include "./draw_list.hpp"
 #include "./graphics_DX.hpp"
 
 namespace hoffman_isaiah {
 	namespace graphics::shapes {
-		enum class ShapeTypes {
-			Ellipse, Triangle, Rectangle, Diamond, Star
-		};
-
 		// NOTE: If I try allowing resizing, I will need to recreate the geometries
 		// to account for the new dimensions.
 		/// <summary>Abstract base class for all shapes.</summary>
@@ -51,6 +48,10 @@ namespace hoffman_isaiah {
 			bool intersect(const Shape2DBase* other_shape) const noexcept {
 				return this->intersect(*other_shape);
 			}
+			/// <returns>The shape's geometry after its transformations are applied.</returns>
+			ID2D1Geometry* getGeometry() const noexcept {
+				return this->transformed_geometry.get();
+			}
 			// Transformation Setters
 			/// <param name="dsx">The change in the horizontal translation.</param>
 			/// <param name="dsy">The change in the vertical translation.</param>
@@ -228,5 +229,14 @@ namespace hoffman_isaiah {
 			}
 			this->recreateGeometry();
 		}
+
+		/// <summary>Creates the geometry of a shape.</summary>
+		/// <param name="st">The kind of shape to create.</param>
+		/// <param name="csx">The screen x-coordinate of the center of the shape.</param>
+		/// <param name="csy">The screen y-coordinate of the center of the shape.</param>
+		/// <param name="sw">The width of the shape in screen coordinates.</param>
+		/// <param name="sh">The height of the shape in screen coordinates.</param>
+		std::unique_ptr<Shape2DBase> createShape(graphics::DX::DeviceResources2D* dev_res, ShapeTypes st,
+			Color o_color, Color f_color, float csx, float csy, float sw, float sh);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "./draw_list.hpp"
+#include "./spatial_index.hpp"
+
+namespace hoffman_isaiah {
+	namespace graphics {
+		void SpatialIndex::reset(DrawRect new_area, float new_cell_sw, float new_cell_sh) {
+			this->area = new_area;
+			this->cell_sw = new_cell_sw > 0.f ? new_cell_sw : 1.f;
+			this->cell_sh = new_cell_sh > 0.f ? new_cell_sh : 1.f;
+			this->columns = std::max(static_cast<int>(std::ceil((new_area.right - new_area.left) / this->cell_sw)), 1);
+			this->rows = std::max(static_cast<int>(std::ceil((new_area.bottom - new_area.top) / this->cell_sh)), 1);
+			this->max_half_width = 0.f;
+			this->max_half_height = 0.f;
+			this->item_cells.clear();
+			this->cell_starts.clear();
+			this->cell_items.clear();
+		}
+
+		void SpatialIndex::add(DrawRect bounds) {
+			const int cx = this->getCellX((bounds.left + bounds.right) / 2.f);
+			const int cy = this->getCellY((bounds.top + bounds.bottom) / 2.f);
+			this->item_cells.emplace_back(static_cast<std::uint32_t>(cy * this->columns + cx));
+			this->max_half_width = std::max(this->max_half_width, (bounds.right - bounds.left) / 2.f);
+			this->max_half_height = std::max(this->max_half_height, (bounds.bottom - bounds.top) / 2.f);
+		}
+
+		void SpatialIndex::build() {
+			// Counting sort: count the items in each cell, turn the counts into starting
+			// positions, and then drop each item into place.
+			const auto cell_count = static_cast<std::size_t>(this->columns) * this->rows;
+			this->cell_starts.assign(cell_count + 1, 0);
+			for (const auto cell : this->item_cells) {
+				++this->cell_starts[cell + 1];
+			}
+			for (std::size_t i = 1; i <= cell_count; ++i) {
+				this->cell_starts[i] += this->cell_starts[i - 1];
+			}
+			this->cell_ends.assign(this->cell_starts.cbegin(), this->cell_starts.cend() - 1);
+			this->cell_items.resize(this->item_cells.size());
+			for (std::size_t i = 0; i < this->item_cells.size(); ++i) {
+				this->cell_items[this->cell_ends[this->item_cells[i]]++] = static_cast<std::uint32_t>(i);
+			}
+		}
+	}
+}
\ No newline at end of file
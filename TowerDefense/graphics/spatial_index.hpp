@@ -0,0 +1,89 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "./draw_list.hpp"
+
+namespace hoffman_isaiah {
+	namespace graphics {
+		/// <summary>Buckets items by where they are on the screen so that only the items near a
+		/// rectangle (such as the visible part of the map) need to be looked at. Items are
+		/// bucketed by their centers into a uniform grid of cells; the cells are stored one after
+		/// another in a single array, so the index can be rebuilt often without allocating.</summary>
+		class SpatialIndex {
+		public:
+			/// <summary>Removes every item and sets up the cells.</summary>
+			/// <param name="new_area">The area that the cells cover. (Items outside of the area
+			/// are put into the nearest cell.)</param>
+			/// <param name="new_cell_sw">The width of each cell.</param>
+			/// <param name="new_cell_sh">The height of each cell.</param>
+			void reset(DrawRect new_area, float new_cell_sw, float new_cell_sh);
+			/// <summary>Adds an item. Items are numbered in the order that they are added.</summary>
+			/// <param name="bounds">The area covered by the item.</param>
+			void add(DrawRect bounds);
+			/// <summary>Sorts the items into their cells. This must be called after adding items
+			/// and before querying them.</summary>
+			void build();
+			/// <summary>Calls a function with the number of each item that might overlap a
+			/// rectangle. (Every item that does overlap it is included.)</summary>
+			/// <param name="rect">The rectangle to look for items in.</param>
+			/// <param name="func">The function to call with each item's number.</param>
+			template <typename Func>
+			void query(DrawRect rect, Func&& func) const {
+				if (this->cell_items.empty()) {
+					return;
+				}
+				// An item is bucketed by its center, so its center is within its largest
+				// half-size of the rectangle if it overlaps the rectangle.
+				const int min_cx = this->getCellX(rect.left - this->max_half_width);
+				const int max_cx = this->getCellX(rect.right + this->max_half_width);
+				const int min_cy = this->getCellY(rect.top - this->max_half_height);
+				const int max_cy = this->getCellY(rect.bottom + this->max_half_height);
+				for (int cy = min_cy; cy <= max_cy; ++cy) {
+					for (int cx = min_cx; cx <= max_cx; ++cx) {
+						const auto cell = static_cast<std::size_t>(cy) * this->columns + cx;
+						for (auto i = this->cell_starts[cell]; i < this->cell_starts[cell + 1]; ++i) {
+							func(this->cell_items[i]);
+						}
+					}
+				}
+			}
+			/// <returns>The number of items in the index.</returns>
+			std::size_t size() const noexcept {
+				return this->item_cells.size();
+			}
+		protected:
+			/// <returns>The column of the cell that contains an x-coordinate.</returns>
+			int getCellX(float sx) const noexcept {
+				return std::clamp(static_cast<int>((sx - this->area.left) / this->cell_sw), 0, this->columns - 1);
+			}
+			/// <returns>The row of the cell that contains a y-coordinate.</returns>
+			int getCellY(float sy) const noexcept {
+				return std::clamp(static_cast<int>((sy - this->area.top) / this->cell_sh), 0, this->rows - 1);
+			}
+		private:
+			/// <summary>The area that the cells cover.</summary>
+			DrawRect area {};
+			float cell_sw {1.f};
+			float cell_sh {1.f};
+			int columns {1};
+			int rows {1};
+			/// <summary>Half of the width of the widest item.</summary>
+			float max_half_width {0.f};
+			/// <summary>Half of the height of the tallest item.</summary>
+			float max_half_height {0.f};
+			/// <summary>The cell of each item in the order that they were added.</summary>
+			std::vector<std::uint32_t> item_cells {};
+			/// <summary>Where each cell's items start in the list of items. (The last entry is
+			/// the total number of items.)</summary>
+			std::vector<std::uint32_t> cell_starts {};
+			/// <summary>The items of every cell, sorted by cell.</summary>
+			std::vector<std::uint32_t> cell_items {};
+			/// <summary>Scratch space used while building the index.</summary>
+			std::vector<std::uint32_t> cell_ends {};
+		};
+	}
+}
\ No newline at end of file
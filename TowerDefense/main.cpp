@@ -5,25 +5,37 @@
 #include <Windowsx.h>
 #include "./resource.h"
 #include <commctrl.h>
+#include <cstdint>
 #include <process.h>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <strsafe.h>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include "./globals.hpp"
 #include "./ih_math.hpp"
 #include "./file_util.hpp"
 #include "./main.hpp"
+#include "./profiler.hpp"
+#include "./resource_pack.hpp"
+#include "./task_graph.hpp"
 #include "./audio/audio.hpp"
 #include "./graphics/graphics_DX.hpp"
 #include "./graphics/graphics.hpp"
 #include "./graphics/info_dialogs.hpp"
 #include "./graphics/other_dialogs.hpp"
 #include "./pathfinding/grid.hpp"
+#include "./game/balance_runner.hpp"
 #include "./game/enemy.hpp"
 #include "./game/enemy_type.hpp"
+#include "./game/layout_optimizer.hpp"
 #include "./game/my_game.hpp"
+#include "./game/render_snapshot.hpp"
+#include "./game/simulation_thread.hpp"
 #include "./game/tower.hpp"
 #include "./terrain/editor.hpp"
 
@@ -39,7 +51,96 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 	_In_ LPWSTR lpCmdLine, _In_ int nCmdShow) {
 #pragma warning(pop)
 	UNREFERENCED_PARAMETER(hPrevInstance);
-	UNREFERENCED_PARAMETER(lpCmdLine);
+	IH_PROFILE_THREAD_NAME("Main");
+	// Compile the type database without starting the game.
+	if (lpCmdLine != nullptr && std::wstring {lpCmdLine}.find(L"/compile_data") != std::wstring::npos) {
+		try {
+			auto my_game = std::make_unique<ih::game::MyGame>(nullptr);
+			my_game->load_config_data();
+			my_game->compile_type_database();
+		}
+		catch (const ih::util::file::DataFileException& e) {
+			MessageBox(nullptr, (L"Error: Data compilation failed:\n"s + e.what()).c_str(),
+				L"Data Compile Failed", MB_OK | MB_ICONERROR);
+			return 1;
+		}
+		catch (const std::exception&) {
+			MessageBox(nullptr, L"Error: Could not write the type database.", L"Data Compile Failed",
+				MB_OK | MB_ICONERROR);
+			return 1;
+		}
+		return 0;
+	}
+	// Pack the resources folder into a single resource pack without starting the game.
+	if (lpCmdLine != nullptr && std::wstring {lpCmdLine}.find(L"/build_pack") != std::wstring::npos) {
+		try {
+			ih::util::file::ResourcePack::buildPack(L"./resources/"s, ih::game::resource_pack_file_name);
+		}
+		catch (const ih::util::file::DataFileException& e) {
+			MessageBox(nullptr, (L"Error: Resource packing failed:\n"s + e.what()).c_str(),
+				L"Resource Pack Failed", MB_OK | MB_ICONERROR);
+			return 1;
+		}
+		return 0;
+	}
+	// Time the level generator on levels 100 to 1000 without starting the game.
+	if (lpCmdLine != nullptr && std::wstring {lpCmdLine}.find(L"/benchmark_levels") != std::wstring::npos) {
+		try {
+			auto my_game = std::make_unique<ih::game::MyGame>(nullptr);
+			my_game->load_config_data();
+			my_game->load_type_data();
+			std::wofstream report {my_game->getUserDataPath() + L"level_benchmark.txt"s};
+			my_game->benchmarkLevelGenerator(report, 100, 1000, 100);
+		}
+		catch (const ih::util::file::DataFileException& e) {
+			MessageBox(nullptr, (L"Error: The level generator could not be loaded:\n"s + e.what()).c_str(),
+				L"Benchmark Failed", MB_OK | MB_ICONERROR);
+			return 1;
+		}
+		return 0;
+	}
+	// Play a balance sweep without starting the game. (The games are played by several
+	// sessions at once, which share the type data loaded here.)
+	if (lpCmdLine != nullptr && std::wstring {lpCmdLine}.find(L"/balance_sweep") != std::wstring::npos) {
+		try {
+			// Game objects need the Direct2D factory for their geometry even though nothing is drawn.
+			auto my_resources = std::make_unique<ih::graphics::DX::DeviceResources2D>();
+			my_resources->createDeviceIndependentResources();
+			auto my_game = std::make_unique<ih::game::MyGame>(my_resources.get());
+			my_game->setHeadless(true);
+			my_game->load_config_data();
+			my_game->load_type_data();
+			my_game->load_level_templates();
+			ih::game::BalanceRunner my_runner {*my_game};
+			return my_runner.runSweep() ? 0 : 1;
+		}
+		catch (const ih::util::file::DataFileException& e) {
+			MessageBox(nullptr, (L"Error: The balance sweep could not be loaded:\n"s + e.what()).c_str(),
+				L"Balance Sweep Failed", MB_OK | MB_ICONERROR);
+			return 1;
+		}
+	}
+	// Search for strong tower layouts without starting the game. (Candidate layouts are played
+	// by several sessions at once, which share the type data loaded here.)
+	if (lpCmdLine != nullptr && std::wstring {lpCmdLine}.find(L"/optimize_layouts") != std::wstring::npos) {
+		try {
+			// Candidates are checked against the map here, so the whole game has to be loaded.
+			auto my_resources = std::make_unique<ih::graphics::DX::DeviceResources2D>();
+			my_resources->createDeviceIndependentResources();
+			auto my_game = std::make_unique<ih::game::MyGame>(my_resources.get());
+			my_game->setHeadless(true);
+			my_game->load_config_data();
+			my_game->load_type_data();
+			my_game->load_level_templates();
+			ih::game::LayoutOptimizer my_optimizer {*my_game};
+			return my_optimizer.optimize() ? 0 : 1;
+		}
+		catch (const ih::util::file::DataFileException& e) {
+			MessageBox(nullptr, (L"Error: The layout optimizer could not be loaded:\n"s + e.what()).c_str(),
+				L"Layout Optimizer Failed", MB_OK | MB_ICONERROR);
+			return 1;
+		}
+	}
 	INITCOMMONCONTROLSEX icc {};
 	icc.dwSize = sizeof(INITCOMMONCONTROLSEX);
 	icc.dwICC = ICC_STANDARD_CLASSES | ICC_UPDOWN_CLASS;
@@ -103,6 +204,7 @@ namespace hoffman_isaiah {
 
 		MainWindow::MainWindow(HINSTANCE h_inst) :
 			h_instance {h_inst} {
+			QueryPerformanceCounter(&this->launch_time);
 			// Register window class
 			[[gsl::suppress(26490)]] { // C26490 => Do not use reinterpret_cast.
 			WNDCLASSEX wnd_class {
@@ -132,6 +234,19 @@ namespace hoffman_isaiah {
 			QueryPerformanceFrequency(&MainWindow::qpc_frequency);
 		}
 
+		void MainWindow::reportStartupTimes(const game::MyGame& my_game, const util::TaskGraph& startup_tasks) const {
+			const auto time_to_first_frame = MainWindow::getElapsedTime(this->launch_time).second;
+			std::wostringstream report {};
+			report << L"Startup tasks:\n" << startup_tasks.getReport();
+			report << std::fixed << std::setprecision(2) << L"Time to first frame: "
+				<< time_to_first_frame.QuadPart / 1000.0 << L" ms\n";
+			OutputDebugString(report.str().c_str());
+			std::wofstream report_file {my_game.getUserDataPath() + L"startup_times.txt"};
+			if (!report_file.bad() && !report_file.fail()) {
+				report_file << report.str();
+			}
+		}
+
 		void MainWindow::run(int n_cmd_show) {
 			// Create resource manager
 			auto my_resources = std::make_unique<graphics::DX::DeviceResources2D>();
@@ -150,18 +265,6 @@ namespace hoffman_isaiah {
 			// Show window
 			ShowWindow(this->hwnd, n_cmd_show);
 			UpdateWindow(this->hwnd);
-			// Initialize audio.
-			try {
-				audio::g_my_audio = std::make_unique<audio::AudioResources>();
-				audio::g_my_audio->loadSong(game::g_my_game->getResourcesPath() + L"music/Music_100.wav");
-				audio::g_my_audio->loadSong(game::g_my_game->getResourcesPath() + L"music/Music_110.wav");
-				audio::g_my_audio->loadSong(game::g_my_game->getResourcesPath() + L"music/Music_114.wav");
-				audio::g_my_audio->loadSong(game::g_my_game->getResourcesPath() + L"music/Music_115.wav");
-				audio::g_my_audio->loadSong(game::g_my_game->getResourcesPath() + L"music/Music_124.wav");
-			}
-			catch (...) {
-				MessageBox(this->hwnd, L"Failed to load audio.", L"Audio Load Fail", MB_OK | MB_ICONERROR);
-			}
 			// Disable loading custom maps for now.
 			winapi::disableMenuItem(hwnd, id_mm_file_offset, ID_MM_FILE_START_CUSTOM_GAME);
 #if !defined(DEBUG) && !defined(_DEBUG)
@@ -170,33 +273,77 @@ namespace hoffman_isaiah {
 			// Note: Try to refer to this variable within the method.
 			// It's shorter and also doesn't directly refer to global data.
 			auto* my_game = game::g_my_game.get();
-			my_game->load_config_data();
-			my_game->init_enemy_types();
-			my_game->init_shot_types();
-			my_game->init_tower_types();
-			my_game->load_tower_upgrades_data();
-			my_game->load_global_level_data();
-			my_game->load_global_misc_data();
-			// Load save data.
-			std::wifstream default_save_file {my_game->getUserDataPath() + game::default_save_file_name};
-			if (!default_save_file.bad() && !default_save_file.fail()) {
+			// Load everything that does not need the user's input. Everything depends on the
+			// configuration (which determines where the files are), but otherwise only the save
+			// file and the levels need the type data and only the global save data needs the audio.
+			// (Message boxes and dialogs are left to this thread once the tasks finish.)
+			bool audio_failed = false;
+			bool has_save_file = false;
+			bool save_file_failed = false;
+			bool global_data_failed = false;
+			util::TaskGraph startup_tasks {};
+			const int config_task = startup_tasks.addTask(L"Configuration", [my_game]() {
+				my_game->load_config_data();
+			});
+			const int audio_task = startup_tasks.addTask(L"Audio", [my_game, &audio_failed]() {
 				try {
-					my_game->loadGame(default_save_file);
+					audio::g_my_audio = std::make_unique<audio::AudioResources>();
+					for (const auto song_name : {L"Music_100.wav", L"Music_110.wav", L"Music_114.wav",
+						L"Music_115.wav", L"Music_124.wav"}) {
+						// (Songs are streamed while they play rather than loaded all at once.)
+						std::wstring song_file_name {};
+						std::uint64_t song_offset {0};
+						std::uint64_t song_size {0};
+						if (!my_game->getResources().getResourceLocation(L"music/"s + song_name,
+							song_file_name, song_offset, song_size)) {
+							throw std::runtime_error {"Could not open file."};
+						}
+						audio::g_my_audio->loadSong(std::make_unique<audio::WavStream>(song_file_name, song_offset, song_size));
+					}
 				}
 				catch (...) {
-					MessageBox(nullptr, L"Error: Corrupted or old save file detected. Save files made in"
-						L" version 3.3.1 or earlier are no longer supported.", L"Corrupted Save",
-						MB_OK | MB_ICONERROR);
-					// Reset state and save over the corrupted file...
-					const std::wstring map_name = my_game->getDefaultMapName(ID_CHALLENGE_LEVEL_NORMAL);
-					my_game->resetState(ID_CHALLENGE_LEVEL_NORMAL - ID_CHALLENGE_LEVEL_EASY, map_name);
-					std::wofstream save_file {my_game->getUserDataPath() + game::default_save_file_name};
-					if (!save_file.bad() && !save_file.fail()) {
-						my_game->saveGame(save_file);
-					}
+					// (Nothing else may use audio that is only partly loaded.)
+					audio::g_my_audio = nullptr;
+					audio_failed = true;
 				}
+			}, {config_task});
+			const int types_task = startup_tasks.addTask(L"Type data", [my_game]() {
+				my_game->load_type_data();
+			}, {config_task});
+			startup_tasks.addTask(L"Level templates", [my_game]() {
+				my_game->load_level_templates();
+			}, {types_task});
+			startup_tasks.addTask(L"Save file", [my_game, &has_save_file, &save_file_failed]() {
+				try {
+					has_save_file = my_game->loadGameFile(my_game->getUserDataPath() + game::default_save_file_name);
+				}
+				catch (...) {
+					has_save_file = true;
+					save_file_failed = true;
+				}
+			}, {types_task});
+			startup_tasks.addTask(L"Global save data", [my_game, &global_data_failed]() {
+				try {
+					my_game->loadGlobalData();
+				}
+				catch (const util::file::DataFileException&) {
+					global_data_failed = true;
+				}
+			}, {audio_task});
+			startup_tasks.run();
+			if (audio_failed) {
+				MessageBox(this->hwnd, L"Failed to load audio.", L"Audio Load Fail", MB_OK | MB_ICONERROR);
 			}
-			else {
+			if (save_file_failed) {
+				MessageBox(nullptr, L"Error: Corrupted or old save file detected. Save files made in"
+					L" version 3.3.1 or earlier are no longer supported.", L"Corrupted Save",
+					MB_OK | MB_ICONERROR);
+				// Reset state and save over the corrupted file...
+				const std::wstring map_name = my_game->getDefaultMapName(ID_CHALLENGE_LEVEL_NORMAL);
+				my_game->resetState(ID_CHALLENGE_LEVEL_NORMAL - ID_CHALLENGE_LEVEL_EASY, map_name);
+				my_game->saveGameFile(my_game->getUserDataPath() + game::default_save_file_name);
+			}
+			else if (!has_save_file) {
 				// Do difficulty selection.
 				const auto my_clevel_dialog = winapi::ChallengeLevelDialog {hwnd, this->h_instance};
 				const std::wstring map_name
@@ -210,10 +357,7 @@ namespace hoffman_isaiah {
 			my_renderer->createShotMenu(hwnd, my_game->getAllShotTypes());
 			my_renderer->createEnemyMenu(hwnd, my_game->getAllEnemyTypes(),
 				my_game->getSeenEnemies());
-			try {
-				my_game->loadGlobalData();
-			}
-			catch (const util::file::DataFileException&) {
+			if (global_data_failed) {
 				MessageBox(nullptr, L"Error: Corrupted global save file. Overwriting with default values.",
 					L"Corrupted Save", MB_OK | MB_ICONERROR);
 				my_game->saveGlobalData();
@@ -227,15 +371,23 @@ namespace hoffman_isaiah {
 			if (my_game->canStartCustomGames()) {
 				winapi::enableMenuItem(hwnd, 0, ID_MM_FILE_START_CUSTOM_GAME);
 			}
-			audio::g_my_audio->playSong(audio::town_index);
+			if (audio::g_my_audio) {
+				audio::g_my_audio->playSong(audio::town_index);
+			}
+			// From here on, logic ticks run on their own thread, so this thread must lock the game
+			// before touching it (and only draws the snapshots that the simulation publishes).
+			this->my_simulation = std::make_unique<game::SimulationThread>(*my_game);
+			this->my_simulation->start();
 			// Message Loop
 #pragma warning(push)
 #pragma warning(disable: 26494) // Code Analysis: type.5 --> Always initialize.
 			MSG msg;
 #pragma warning(pop)
 			bool keep_looping = true;
+			bool first_frame_reported = false;
 			while (keep_looping) {
 				if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+					const auto game_lock = this->my_simulation->lockGame();
 					TranslateMessage(&msg);
 					DispatchMessage(&msg);
 					switch (msg.message) {
@@ -283,7 +435,7 @@ namespace hoffman_isaiah {
 								my_game->togglePause();
 							}
 							const game::EnemyType* my_enemy {my_game->getEnemyType(selected_enemy)};
-							if (my_game->getSeenEnemies().at(my_enemy->getName())) {
+							if (my_game->isEnemyTypeSeen(my_enemy->getTypeId())) {
 								const EnemyInfoDialog my_dialog {hwnd, this->h_instance,
 									*my_enemy};
 							}
@@ -326,19 +478,26 @@ namespace hoffman_isaiah {
 						case VK_OEM_PLUS:
 							PostMessage(this->hwnd, WM_COMMAND, ID_MM_ACTIONS_CHANGE_SPEED, 0);
 							break;
+						case 'M':
+							PostMessage(this->hwnd, WM_COMMAND, ID_MM_ACTIONS_MAX_SPEED, 0);
+							break;
 						default:
 							break;
 						}
 						break;
 					}
+					case WM_KEYDOWN:
+					case WM_MOUSEWHEEL:
+						graphics::handleCameraInput(my_renderer->getCamera(), this->hwnd, msg);
+						break;
 					case WM_LBUTTONDBLCLK:
 					{
 						// Display info about placed towers.
 						if (!my_game->isInLevel()) {
 							const auto gx = static_cast<int>(my_game->getMap()
-								.convertToGameX(GET_X_LPARAM(msg.lParam)));
+								.convertToGameX(my_renderer->getCamera().toMapX(static_cast<float>(GET_X_LPARAM(msg.lParam)))));
 							const auto gy = static_cast<int>(my_game->getMap()
-								.convertToGameY(GET_Y_LPARAM(msg.lParam)));
+								.convertToGameY(my_renderer->getCamera().toMapY(static_cast<float>(GET_Y_LPARAM(msg.lParam)))));
 							const bool pause_state = my_game->isPaused();
 							if (!pause_state) {
 								my_game->togglePause();
@@ -361,9 +520,9 @@ namespace hoffman_isaiah {
 					{
 						// Obtain start coordinates
 						const auto gx = static_cast<int>(my_game->getMap()
-							.convertToGameX(GET_X_LPARAM(msg.lParam)));
+							.convertToGameX(my_renderer->getCamera().toMapX(static_cast<float>(GET_X_LPARAM(msg.lParam)))));
 						const auto gy = static_cast<int>(my_game->getMap()
-							.convertToGameY(GET_Y_LPARAM(msg.lParam)));
+							.convertToGameY(my_renderer->getCamera().toMapY(static_cast<float>(GET_Y_LPARAM(msg.lParam)))));
 						if (my_game->getMap().getTerrainGraph(false).verifyCoordinates(gx, gy)) {
 							this->start_gx = gx;
 							this->start_gy = gy;
@@ -374,9 +533,9 @@ namespace hoffman_isaiah {
 					{
 						// Update end coordinates
 						const auto gx = static_cast<int>(my_game->getMap()
-							.convertToGameX(GET_X_LPARAM(msg.lParam)));
+							.convertToGameX(my_renderer->getCamera().toMapX(static_cast<float>(GET_X_LPARAM(msg.lParam)))));
 						const auto gy = static_cast<int>(my_game->getMap()
-							.convertToGameY(GET_Y_LPARAM(msg.lParam)));
+							.convertToGameY(my_renderer->getCamera().toMapY(static_cast<float>(GET_Y_LPARAM(msg.lParam)))));
 						if (my_game->getMap().getTerrainGraph(false).verifyCoordinates(gx, gy)) {
 							this->end_gx = gx;
 							this->end_gy = gy;
@@ -390,8 +549,9 @@ namespace hoffman_isaiah {
 					case WM_LBUTTONUP:
 					{
 						// Update end coordinates
-						const auto end_sx = static_cast<float>(GET_X_LPARAM(msg.lParam));
-						const auto end_sy = static_cast<float>(GET_Y_LPARAM(msg.lParam));
+						// (These are in map coordinates so that they can be checked against the enemies.)
+						const auto end_sx = my_renderer->getCamera().toMapX(static_cast<float>(GET_X_LPARAM(msg.lParam)));
+						const auto end_sy = my_renderer->getCamera().toMapY(static_cast<float>(GET_Y_LPARAM(msg.lParam)));
 						const auto new_gx = static_cast<int>(my_game->getMap().convertToGameX(end_sx));
 						const auto new_gy = static_cast<int>(my_game->getMap().convertToGameY(end_sy));
 						this->end_gx = math::get_max(new_gx, this->start_gx);
@@ -407,8 +567,7 @@ namespace hoffman_isaiah {
 								// Mark tiles
 								for (int gx = this->start_gx; gx <= this->end_gx; ++gx) {
 									for (int gy = this->start_gy; gy <= this->end_gy; ++gy) {
-										my_game->getMap().getHighlightGraph()
-											.getNode(gx, gy).setBlockage(true);
+										my_game->getMap().getHighlightGraph().setBlockage(gx, gy, true);
 									}
 								}
 							}
@@ -417,8 +576,7 @@ namespace hoffman_isaiah {
 								// Unmark tiles
 								for (int gx = this->start_gx; gx <= this->end_gx; ++gx) {
 									for (int gy = this->start_gy; gy <= this->end_gy; ++gy) {
-										my_game->getMap().getHighlightGraph()
-											.getNode(gx, gy).setBlockage(false);
+										my_game->getMap().getHighlightGraph().setBlockage(gx, gy, false);
 									}
 								}
 							}
@@ -437,7 +595,8 @@ namespace hoffman_isaiah {
 								// Wall...
 								for (int gx = this->start_gx; gx <= this->end_gx; ++gx) {
 									for (int gy = this->start_gy; gy <= this->end_gy; ++gy) {
-										my_game->buyTower(gx, gy);
+										this->my_simulation->postCommand(game::GameCommand {
+											game::GameCommandTypes::Buy_Tower, gx, gy});
 									}
 								}
 							}
@@ -474,9 +633,9 @@ namespace hoffman_isaiah {
 					{
 						// Get coordinates
 						const auto my_gx = static_cast<int>(my_game->getMap()
-							.convertToGameX(GET_X_LPARAM(msg.lParam)));
+							.convertToGameX(my_renderer->getCamera().toMapX(static_cast<float>(GET_X_LPARAM(msg.lParam)))));
 						const auto my_gy = static_cast<int>(my_game->getMap()
-							.convertToGameY(GET_Y_LPARAM(msg.lParam)));
+							.convertToGameY(my_renderer->getCamera().toMapY(static_cast<float>(GET_Y_LPARAM(msg.lParam)))));
 						if (my_gx == start_gx && my_gy == start_gy) {
 							const auto my_new_lparam = MAKELPARAM(my_gx, my_gy);
 							handle_update_wm_command(my_game, ID_MM_TOWERS_SELL_TOWER, my_new_lparam);
@@ -496,33 +655,77 @@ namespace hoffman_isaiah {
 					}
 				}
 				else {
+					LARGE_INTEGER frame_start_time {};
+					QueryPerformanceCounter(&frame_start_time);
+					const auto& my_snapshot = this->my_simulation->getLatestSnapshot();
+					const bool is_max_speed = my_snapshot.is_max_speed && my_snapshot.in_level && !my_snapshot.is_paused;
 					// Render scene
-					const HRESULT hr = my_renderer->render(my_game, this->start_gx, this->start_gy,
-						this->end_gx, this->end_gy);
-					if (!my_game->isInLevel()) {
+					// (At maximum speed, most frames are skipped so that the time goes to the simulation.)
+					static LARGE_INTEGER last_render_time = LARGE_INTEGER {0};
+					HRESULT hr = S_OK;
+					if (!is_max_speed || last_render_time.QuadPart == 0
+						|| winapi::MainWindow::getElapsedTime(last_render_time).second.QuadPart
+						>= math::getMicrosecondsInSecond() / game::max_speed_graphics_framerate) {
+						last_render_time = frame_start_time;
+						hr = my_renderer->render(my_game, my_snapshot, this->start_gx, this->start_gy,
+							this->end_gx, this->end_gy);
+					}
+					else {
+						Sleep(1);
+					}
+					if (!first_frame_reported) {
+						first_frame_reported = true;
+						const auto game_lock = this->my_simulation->lockGame();
+						this->reportStartupTimes(*my_game, startup_tasks);
+					}
+					if (!my_snapshot.in_level) {
+						const auto game_lock = this->my_simulation->lockGame();
 						my_renderer->createEnemyMenu(hwnd, my_game->getAllEnemyTypes(),
 							my_game->getSeenEnemies());
 						if (my_game->canStartCustomGames()) {
 							winapi::enableMenuItem(hwnd, 0, ID_MM_FILE_START_CUSTOM_GAME);
 						}
 					}
+					// Report any saves that failed in the background since the last frame.
+					const auto failed_saves = my_game->takeFailedSaves();
+					if (!failed_saves.empty()) {
+						std::wstring failed_message {L"The following files could not be saved:"};
+						for (const auto& failed_save : failed_saves) {
+							failed_message += L"\n"s + failed_save;
+						}
+						MessageBox(hwnd, failed_message.c_str(), L"Save failed!", MB_ICONEXCLAMATION | MB_OK);
+					}
+					// Report a level that could not be loaded. (The message box is shown after the
+					// lock is released so that the simulation can keep running.)
+					std::wstring level_load_error {};
+					{
+						const auto game_lock = this->my_simulation->lockGame();
+						level_load_error = my_game->takeLevelLoadError();
+					}
+					if (!level_load_error.empty()) {
+						MessageBox(hwnd, level_load_error.c_str(), L"Level Loading Error", MB_OK);
+					}
 					if (hr == D2DERR_RECREATE_TARGET) {
 						my_resources->discardDeviceResources();
 						my_resources->createDeviceResources(this->hwnd);
 					}
-					// Update scene.
-					// Check time before updating...
-					static LARGE_INTEGER last_update_time = LARGE_INTEGER {0};
-					if (last_update_time.QuadPart == 0) {
-						QueryPerformanceCounter(&last_update_time);
-					}
-					const auto my_times = winapi::MainWindow::getElapsedTime(last_update_time);
-					if (my_times.second.QuadPart >= math::getMicrosecondsInSecond() / game::logic_framerate) {
-						last_update_time = my_times.first;
-						my_game->update();
+					// Save a trace of any unusually slow frame so that the cause can be found later.
+					static LARGE_INTEGER last_trace_time = LARGE_INTEGER {0};
+					const auto frame_times = winapi::MainWindow::getElapsedTime(frame_start_time);
+					if (frame_times.second.QuadPart / 1000.0 >= game::slow_frame_threshold_ms
+						&& (last_trace_time.QuadPart == 0 || winapi::MainWindow::getElapsedTime(last_trace_time).second.QuadPart
+							/ 1000.0 >= game::slow_frame_trace_interval_ms)) {
+						last_trace_time = frame_times.first;
+						my_game->saveProfileTrace(game::slow_frame_trace_file_name);
 					}
 				}
 			}
+			// Stop the simulation before the game goes away.
+			this->my_simulation->stop();
+			// Make sure that any saves still being written reach the disk before exiting.
+			if (!my_game->flushSaves()) {
+				MessageBox(nullptr, L"Some files could not be saved.", L"Save failed!", MB_ICONEXCLAMATION | MB_OK);
+			}
 		}
 
 		void MainWindow::handle_wm_command(game::MyGame* my_game,
@@ -595,6 +798,12 @@ namespace hoffman_isaiah {
 				my_renderer->updateSpeedOption(hwnd, my_game->getNextUpdateSpeed());
 				break;
 			}
+			case ID_MM_ACTIONS_MAX_SPEED:
+			{
+				my_game->toggleMaxSpeed();
+				my_renderer->updateMaxSpeedOption(hwnd, my_game->isMaxSpeed());
+				break;
+			}
 			case ID_MM_ACTIONS_TOGGLE_ALL_RADII:
 			{
 				handle_update_wm_command(my_game, wparam, lparam);
@@ -648,6 +857,11 @@ namespace hoffman_isaiah {
 				my_game->toggleShowPaths();
 				break;
 			}
+			case ID_MM_DEVELOP_SAVE_PROFILE_TRACE:
+			{
+				my_game->saveProfileTrace(game::profile_trace_file_name);
+				break;
+			}
 			default:
 				break;
 			}
@@ -670,17 +884,13 @@ namespace hoffman_isaiah {
 			}
 			case ID_MM_FILE_SAVE_GAME:
 			{
-				std::wofstream save_file {my_game->getUserDataPath() + game::default_save_file_name};
-				if (save_file.fail() || save_file.bad()) {
+				if (!my_game->saveGameFile(my_game->getUserDataPath() + game::default_save_file_name)) {
 					MessageBox(nullptr, L"Could not save game.", L"Save failed!", MB_ICONEXCLAMATION | MB_OK);
 				}
-				else {
-					my_game->saveGame(save_file);
-				}
 				break;
 			}
 			case ID_MM_ACTIONS_NEXT_WAVE:
-				my_game->startWave();
+				this->my_simulation->postCommand(game::GameCommand {game::GameCommandTypes::Start_Wave});
 				break;
 			case ID_MM_ACTIONS_PREVIEW_WAVE:
 				try {
@@ -699,7 +909,7 @@ namespace hoffman_isaiah {
 				for (int i = 0; i < my_game->getMap().getRows(); ++i) {
 					for (int j = 0; j < my_game->getMap().getColumns(); ++j) {
 						// ith row, jth column becomes (j, i) in Cartesian coordinates.
-						my_game->getMap().getHighlightGraph().getNode(j, i).setBlockage(false);
+						my_game->getMap().getHighlightGraph().setBlockage(j, i, false);
 					}
 				}
 				break;
@@ -708,14 +918,14 @@ namespace hoffman_isaiah {
 			{
 				const auto my_gx = static_cast<int>(GET_X_LPARAM(lparam));
 				const auto my_gy = static_cast<int>(GET_Y_LPARAM(lparam));
-				my_game->buyTower(my_gx, my_gy);
+				this->my_simulation->postCommand(game::GameCommand {game::GameCommandTypes::Buy_Tower, my_gx, my_gy});
 				break;
 			}
 			case ID_MM_TOWERS_SELL_TOWER:
 			{
 				const auto my_gx = static_cast<int>(GET_X_LPARAM(lparam));
 				const auto my_gy = static_cast<int>(GET_Y_LPARAM(lparam));
-				my_game->sellTower(my_gx, my_gy);
+				this->my_simulation->postCommand(game::GameCommand {game::GameCommandTypes::Sell_Tower, my_gx, my_gy});
 				break;
 			}
 			default:
@@ -3,12 +3,18 @@
 // File Created: March 19, 2018
 #include "./targetver.hpp"
 #include <Windows.h>
+#include <memory>
 #include <string>
 #include <utility>
 
 namespace hoffman_isaiah {
 	namespace game {
 		class MyGame;
+		class SimulationThread;
+	}
+
+	namespace util {
+		class TaskGraph;
 	}
 
 	namespace winapi {
@@ -64,7 +70,16 @@ namespace hoffman_isaiah {
  				elapsed_microseconds.QuadPart /= MainWindow::qpc_frequency.QuadPart;
 				return {current_time, elapsed_microseconds};
 			}
+		protected:
+			/// <summary>Reports how long each startup task took as well as the time from launch until
+			/// the first frame was drawn. The report is written to the debugger's output and to
+			/// startup_times.txt in the user data folder.</summary>
+			/// <param name="my_game">The current game state.</param>
+			/// <param name="startup_tasks">The tasks that were run during startup.</param>
+			void reportStartupTimes(const game::MyGame& my_game, const util::TaskGraph& startup_tasks) const;
 		private:
+			/// <summary>The value of the performance counter when the window was created.</summary>
+			LARGE_INTEGER launch_time {};
 			/// <summary>The handle to the application instance.</summary>
 			HINSTANCE h_instance;
 			/// <summary>The handle to the window.</summary>
@@ -81,6 +96,8 @@ namespace hoffman_isaiah {
 			int end_gx {-1};
 			/// <summary>Stores the ending game y-position of the mouse.</summary>
 			int end_gy {-1};
+			/// <summary>Runs the game's logic ticks once the game has started.</summary>
+			std::unique_ptr<game::SimulationThread> my_simulation {nullptr};
 			// The class name
 			static constexpr const wchar_t* class_name {L"my_game"};
 			static constexpr const wchar_t* window_name {L"A Shaping War"};
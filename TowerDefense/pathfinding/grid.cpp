@@ -1,10 +1,21 @@
 // File Author: Isaiah Hoffman
 // File Created: March 24, 2018
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <stdexcept>
 #include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+#include "./../async_file_writer.hpp"
+#include "./../file_util.hpp"
 #include "./../globals.hpp"
+#include "./../resource_pack.hpp"
+#include "./../graphics/draw_list.hpp"
 #include "./../graphics/graphics.hpp"
 #include "./../terrain/editor.hpp"
 #include "./graph_node.hpp"
@@ -16,6 +27,7 @@ namespace hoffman_isaiah {
 		std::wistream& operator>>(std::wistream& is, Grid& graph) {
 			// It is important to clear any nodes that may already be
 			// in the graph!
+			graph.markAllTilesChanged();
 			graph.nodes.clear();
 			graph.start_node = nullptr;
 			graph.goal_node = nullptr;
@@ -73,6 +85,66 @@ namespace hoffman_isaiah {
 				<< graph.getGoalNode()->getGameY() << L"\n";
 		}
 
+		void writeGrid(util::file::BinaryWriter& writer, const Grid& graph) {
+			writer.writeVarint(static_cast<std::uint64_t>(graph.getRows()));
+			writer.writeVarint(static_cast<std::uint64_t>(graph.getColumns()));
+			// (Runs are allowed to continue onto the next row.)
+			const int node_count = graph.getRows() * graph.getColumns();
+			int i = 0;
+			while (i < node_count) {
+				const int weight = graph.getNode(i % graph.getColumns(), i / graph.getColumns()).getWeight();
+				int run_length = 1;
+				while (i + run_length < node_count && graph.getNode((i + run_length) % graph.getColumns(),
+					(i + run_length) / graph.getColumns()).getWeight() == weight) {
+					++run_length;
+				}
+				writer.writeVarint(static_cast<std::uint64_t>(run_length));
+				writer.writeSignedVarint(weight);
+				i += run_length;
+			}
+			// Start and goal nodes (or -1 if there are none)
+			const auto* start_node = graph.getStartNode();
+			const auto* goal_node = graph.getGoalNode();
+			writer.writeSignedVarint(start_node ? start_node->getGameX() : -1);
+			writer.writeSignedVarint(start_node ? start_node->getGameY() : -1);
+			writer.writeSignedVarint(goal_node ? goal_node->getGameX() : -1);
+			writer.writeSignedVarint(goal_node ? goal_node->getGameY() : -1);
+		}
+
+		void readGrid(util::file::BinaryReader& reader, Grid& graph) {
+			const auto grid_rows = reader.readVarint();
+			const auto grid_cols = reader.readVarint();
+			if (grid_rows == 0 || grid_cols == 0 || grid_rows > 1000 || grid_cols > 1000) {
+				throw util::file::DataFileException {L"Invalid grid dimensions in binary data.", 0};
+			}
+			const int rows = static_cast<int>(grid_rows);
+			const int cols = static_cast<int>(grid_cols);
+			graph.clearGrid(rows, cols, 0);
+			const int node_count = rows * cols;
+			int i = 0;
+			while (i < node_count) {
+				const auto run_length = reader.readVarint();
+				const auto weight = static_cast<int>(reader.readSignedVarint());
+				if (run_length == 0 || run_length > static_cast<std::uint64_t>(node_count - i)) {
+					throw util::file::DataFileException {L"Invalid run length in binary grid data.", 0};
+				}
+				for (const int run_end = i + static_cast<int>(run_length); i < run_end; ++i) {
+					graph.getNode(i % cols, i / cols) = GraphNode {i % cols, i / cols, weight};
+				}
+			}
+			const auto sx = static_cast<int>(reader.readSignedVarint());
+			const auto sy = static_cast<int>(reader.readSignedVarint());
+			const auto gx = static_cast<int>(reader.readSignedVarint());
+			const auto gy = static_cast<int>(reader.readSignedVarint());
+			if (sx > -1 && sy > -1) {
+				if (!graph.verifyCoordinates(sx, sy) || !graph.verifyCoordinates(gx, gy)) {
+					throw util::file::DataFileException {L"Invalid start or goal node in binary grid data.", 0};
+				}
+				graph.setStartNode(sx, sy);
+				graph.setGoalNode(gx, gy);
+			}
+		}
+
 		std::vector<const GraphNode*> Grid::getNeighbors(int gx, int gy, const Grid& filter_graph, bool include_diag) const {
 #if defined(DEBUG) || defined(_DEBUG)
 			// Worthwhile check but may be a bit costly considering
@@ -113,10 +185,71 @@ namespace hoffman_isaiah {
 	}
 
 	namespace game {
+		namespace {
+			/// <summary>The magic number that begins every binary map file ("TDMP").</summary>
+			constexpr const std::uint32_t map_file_magic = 0x504D4454U;
+			/// <summary>The current format version of binary map files.</summary>
+			constexpr const std::uint32_t map_file_version = 1U;
+
+			/// <summary>Identifies each section of a binary map file. Sections that the loader
+			/// does not recognize are skipped, so precomputed data can be added later.</summary>
+			enum class MapSections : std::uint32_t {
+				Ground_Terrain = 1, Air_Terrain = 2
+			};
+		}
+
+		std::wstring getMapResourceName(const std::wstring& map_name) {
+			return L"graphs/" + map_name + L".tdmap";
+		}
+
+		std::shared_ptr<GameMap> loadMapFile(const util::file::ResourcePack& resources, const std::wstring& map_name) {
+			util::file::ResourceView map_file {};
+			if (resources.getResource(getMapResourceName(map_name), map_file)) {
+				// (The terrain is decoded directly from the resource without copying it first.)
+				auto sections = util::file::readSectionedFile(map_file.data(), map_file.size(),
+					map_file_magic, map_file_version);
+				const auto ground_section = sections.find(static_cast<std::uint32_t>(MapSections::Ground_Terrain));
+				const auto air_section = sections.find(static_cast<std::uint32_t>(MapSections::Air_Terrain));
+				if (ground_section == sections.end() || air_section == sections.end()) {
+					throw util::file::DataFileException {L"The map file is missing a terrain graph.", 0};
+				}
+				auto ground_terrain = std::make_unique<pathfinding::Grid>();
+				auto air_terrain = std::make_unique<pathfinding::Grid>();
+				pathfinding::readGrid(ground_section->second, *ground_terrain);
+				pathfinding::readGrid(air_section->second, *air_terrain);
+				if (ground_terrain->getRows() != air_terrain->getRows()
+					|| ground_terrain->getColumns() != air_terrain->getColumns()) {
+					throw util::file::DataFileException {L"The terrain graphs in the map file differ in size.", 0};
+				}
+				return std::make_shared<GameMap>(std::move(ground_terrain), std::move(air_terrain));
+			}
+			// Maps made before the binary map format existed are stored as text.
+			util::file::ResourceView ground_terrain_resource {};
+			util::file::ResourceView air_terrain_resource {};
+			if (!resources.getResource(L"graphs/ground_graph_" + map_name + L".txt", ground_terrain_resource)
+				|| !resources.getResource(L"graphs/air_graph_" + map_name + L".txt", air_terrain_resource)) {
+				return nullptr;
+			}
+			std::wistringstream ground_terrain_file {ground_terrain_resource.toWideString()};
+			std::wistringstream air_terrain_file {air_terrain_resource.toWideString()};
+			return std::make_shared<GameMap>(ground_terrain_file, air_terrain_file);
+		}
+
+		bool saveMapFile(const GameMap& map, const std::wstring& resources_path, const std::wstring& map_name) {
+			std::vector<std::pair<std::uint32_t, util::file::BinaryWriter>> sections {};
+			util::file::BinaryWriter ground_terrain {};
+			pathfinding::writeGrid(ground_terrain, map.getTerrainGraph(false));
+			sections.emplace_back(static_cast<std::uint32_t>(MapSections::Ground_Terrain), std::move(ground_terrain));
+			util::file::BinaryWriter air_terrain {};
+			pathfinding::writeGrid(air_terrain, map.getTerrainGraph(true));
+			sections.emplace_back(static_cast<std::uint32_t>(MapSections::Air_Terrain), std::move(air_terrain));
+			return util::file::writeFileAtomically(resources_path + getMapResourceName(map_name),
+				util::file::buildSectionedFile(map_file_magic, map_file_version, sections));
+		}
+
 		void GameMap::draw(const graphics::Renderer2D& renderer) const noexcept {
-			this->drawTerrain(renderer);
+			renderer.drawMapLayer(*this);
 			this->drawStartGoal(renderer);
-			this->drawMarkedTiles(renderer);
 		}
 
 		void GameMap::draw(const graphics::Renderer2D& renderer,
@@ -126,13 +259,15 @@ namespace hoffman_isaiah {
 				constexpr const graphics::Color my_color = graphics::Color {1.f, 1.f, 1.f, 0.75f};
 				const auto ground_active = my_editor->areGroundWeightsActive();
 				const auto air_active = my_editor->areAirWeightsActive();
-				if (!ground_active && !air_active) {
+				// (The weights cannot be read unless the squares are drawn in full.)
+				if ((!ground_active && !air_active) || renderer.getCamera().getDetailBlockSize() > 1) {
 					return;
 				}
 				const auto node_width = this->getGameSquareWidth<float>();
 				const auto node_height = this->getGameSquareHeight<float>();
-				for (int gx = 0; gx < this->getWidth(); ++gx) {
-					for (int gy = 0; gy < this->getHeight(); ++gy) {
+				const auto visible_tiles = renderer.getCamera().getVisibleTiles();
+				for (int gx = visible_tiles.min_gx; gx < visible_tiles.end_gx; ++gx) {
+					for (int gy = visible_tiles.min_gy; gy < visible_tiles.end_gy; ++gy) {
 						const auto& gnode = this->getTerrainGraph(false).getNode(gx, gy);
 						const auto& anode = this->getTerrainGraph(true).getNode(gx, gy);
 						if (gnode.isBlocked() || anode.isBlocked()) {
@@ -161,47 +296,6 @@ namespace hoffman_isaiah {
 			}
 		}
 
-		void GameMap::drawTerrain(const graphics::Renderer2D& renderer) const noexcept {
-			constexpr const graphics::Color outline_color = graphics::Color {0.10f, 0.10f, 0.10f, 1.0f};
-			constexpr const graphics::Color grass_color = graphics::Color {0.f, 0.75f, 0.f, 1.0f};
-			constexpr const graphics::Color forest_color = graphics::Color {0.15f, 0.50f, 0.f, 1.0f};
-			constexpr const graphics::Color ocean_color = graphics::Color {0.f, 0.25f, 0.60f, 1.0f};
-			constexpr const graphics::Color mountain_color = graphics::Color {0.85f, 0.85f, 0.f, 1.0f};
-			constexpr const graphics::Color swamp_color = graphics::Color {0.f, 0.50f, 0.40f, 1.0f};
-			constexpr const graphics::Color cave_color = graphics::Color {0.65f, 0.20f, 0.80f, 1.0f};
-			for (int gx = 0; gx < this->getWidth(); ++gx) {
-				for (int gy = 0; gy < this->getHeight(); ++gy) {
-					const auto& gnode = this->getTerrainGraph(false).getNode(gx, gy);;
-					const auto& anode = this->getTerrainGraph(true).getNode(gx, gy);
-					const auto weight_diff = gnode.getWeight() - anode.getWeight();
-					if (gnode.isBlocked() && anode.isBlocked()) {
-						// Mountains: Blocked to all
-						renderer.paintSquare(*this, gx, gy, outline_color, mountain_color);
-					}
-					else if (gnode.isBlocked()) {
-						// Ocean: Blocked to ground
-						renderer.paintSquare(*this, gx, gy, outline_color, ocean_color);
-					}
-					else if (anode.isBlocked()) {
-						// Cave: Blocked to air
-						renderer.paintSquare(*this, gx, gy, outline_color, cave_color);
-					}
-					else if (weight_diff > 0) {
-						// Swamp: More difficult for ground troops
-						renderer.paintSquare(*this, gx, gy, outline_color, swamp_color);
-					}
-					else if (weight_diff < 0) {
-						// Forest: More difficult for air troops
-						renderer.paintSquare(*this, gx, gy, outline_color, forest_color);
-					}
-					else {
-						// Grass: Equal weights
-						renderer.paintSquare(*this, gx, gy, outline_color, grass_color);
-					}
-				} // End inner for
-			} // End outer for
-		}
-
 		void GameMap::drawStartGoal(const graphics::Renderer2D& renderer) const noexcept {
 			constexpr const graphics::Color transparent_color = graphics::Color {0.f, 0.f, 0.f, 0.f};
 			constexpr const graphics::Color ground_start_color = graphics::Color {0.40f, 0.f, 0.f, 0.65f};
@@ -242,13 +336,124 @@ namespace hoffman_isaiah {
 			}
 		}
 
-		void GameMap::drawMarkedTiles(const graphics::Renderer2D& renderer) const noexcept {
-			constexpr const graphics::Color o_color {0.f, 0.f, 1.f, 0.9f};
-			constexpr const graphics::Color f_color {0.8f, 0.8f, 0.8f, 0.2f};
-			for (int gx = 0; gx < this->getWidth(); ++gx) {
-				for (int gy = 0; gy < this->getHeight(); ++gy) {
-					if (this->getHighlightGraph().getNode(gx, gy).isBlocked()) {
-						renderer.paintSquare(*this, gx, gy, o_color, f_color);
+		namespace {
+			// Terrain colors
+			constexpr const graphics::DrawColor terrain_outline_color = graphics::DrawColor {0.10f, 0.10f, 0.10f, 1.0f};
+			constexpr const std::array<graphics::DrawColor, 6> terrain_colors {
+				// Grass: Equal weights
+				graphics::DrawColor {0.f, 0.75f, 0.f, 1.0f},
+				// Forest: More difficult for air troops
+				graphics::DrawColor {0.15f, 0.50f, 0.f, 1.0f},
+				// Ocean: Blocked to ground
+				graphics::DrawColor {0.f, 0.25f, 0.60f, 1.0f},
+				// Mountains: Blocked to all
+				graphics::DrawColor {0.85f, 0.85f, 0.f, 1.0f},
+				// Swamp: More difficult for ground troops
+				graphics::DrawColor {0.f, 0.50f, 0.40f, 1.0f},
+				// Cave: Blocked to air
+				graphics::DrawColor {0.65f, 0.20f, 0.80f, 1.0f}
+			};
+			constexpr const graphics::DrawColor marked_outline_color {0.f, 0.f, 1.f, 0.9f};
+			constexpr const graphics::DrawColor marked_fill_color {0.8f, 0.8f, 0.8f, 0.2f};
+			// (Marked blocks have no outline, so they are filled with a stronger color.)
+			constexpr const graphics::DrawColor marked_block_color {0.f, 0.f, 1.f, 0.45f};
+
+			/// <returns>The index of a tile's terrain in the list of terrain colors.</returns>
+			std::size_t getTerrainIndex(const pathfinding::GraphNode& gnode, const pathfinding::GraphNode& anode) noexcept {
+				const auto weight_diff = gnode.getWeight() - anode.getWeight();
+				if (gnode.isBlocked() && anode.isBlocked()) {
+					return 3;
+				}
+				else if (gnode.isBlocked()) {
+					return 2;
+				}
+				else if (anode.isBlocked()) {
+					return 5;
+				}
+				else if (weight_diff > 0) {
+					return 4;
+				}
+				else if (weight_diff < 0) {
+					return 1;
+				}
+				return 0;
+			}
+		}
+
+		void GameMap::recordTile(graphics::DrawList& my_list, int gx, int gy) const {
+			const auto& gnode = this->getTerrainGraph(false).getNode(gx, gy);
+			const auto& anode = this->getTerrainGraph(true).getNode(gx, gy);
+			const auto slx = static_cast<float>(this->convertToScreenX(gx));
+			const auto sty = static_cast<float>(this->convertToScreenY(gy));
+			const graphics::DrawRect tile_rect {slx, sty, slx + this->getGameSquareWidth<float>(),
+				sty + this->getGameSquareHeight<float>()};
+			my_list.fillRectangle(graphics::DrawLayers::Terrain, tile_rect, terrain_colors[getTerrainIndex(gnode, anode)]);
+			my_list.outlineRectangle(graphics::DrawLayers::Terrain_Outlines, tile_rect, terrain_outline_color);
+			// Draw a highlight over tiles that the user has selected.
+			if (this->getHighlightGraph().getNode(gx, gy).isBlocked()) {
+				my_list.fillRectangle(graphics::DrawLayers::Marked_Tiles, tile_rect, marked_fill_color);
+				my_list.outlineRectangle(graphics::DrawLayers::Marked_Tile_Outlines, tile_rect, marked_outline_color);
+			}
+		}
+
+		void GameMap::recordTiles(graphics::DrawList& my_list, int min_gx, int min_gy, int end_gx, int end_gy,
+			int block_size) const {
+			if (block_size <= 1) {
+				for (int gx = min_gx; gx < end_gx; ++gx) {
+					for (int gy = min_gy; gy < end_gy; ++gy) {
+						this->recordTile(my_list, gx, gy);
+					}
+				}
+				return;
+			}
+			for (int block_gy = min_gy; block_gy < end_gy; block_gy += block_size) {
+				const int block_end_gy = std::min(block_gy + block_size, end_gy);
+				const auto block_sty = static_cast<float>(this->convertToScreenY(block_gy));
+				const auto block_sby = static_cast<float>(this->convertToScreenY(block_end_gy));
+				// The runs of blocks in this row that share the same terrain (or highlight).
+				std::size_t run_terrain = terrain_colors.size();
+				int run_terrain_gx = min_gx;
+				bool run_marked = false;
+				int run_marked_gx = min_gx;
+				for (int block_gx = min_gx; ; block_gx += block_size) {
+					// (An extra step past the end of the row finishes off the last runs.)
+					const bool is_past_end = block_gx >= end_gx;
+					std::size_t block_terrain = terrain_colors.size();
+					bool block_marked = false;
+					if (!is_past_end) {
+						const int block_end_gx = std::min(block_gx + block_size, end_gx);
+						std::array<int, terrain_colors.size()> terrain_counts {};
+						for (int gy = block_gy; gy < block_end_gy; ++gy) {
+							for (int gx = block_gx; gx < block_end_gx; ++gx) {
+								++terrain_counts[getTerrainIndex(this->getTerrainGraph(false).getNode(gx, gy),
+									this->getTerrainGraph(true).getNode(gx, gy))];
+								block_marked = block_marked || this->getHighlightGraph().getNode(gx, gy).isBlocked();
+							}
+						}
+						block_terrain = static_cast<std::size_t>(std::max_element(terrain_counts.cbegin(),
+							terrain_counts.cend()) - terrain_counts.cbegin());
+					}
+					const int run_end_gx = std::min(block_gx, end_gx);
+					if (block_terrain != run_terrain) {
+						if (run_terrain < terrain_colors.size()) {
+							my_list.fillRectangle(graphics::DrawLayers::Terrain, graphics::DrawRect {
+								static_cast<float>(this->convertToScreenX(run_terrain_gx)), block_sty,
+								static_cast<float>(this->convertToScreenX(run_end_gx)), block_sby}, terrain_colors[run_terrain]);
+						}
+						run_terrain = block_terrain;
+						run_terrain_gx = block_gx;
+					}
+					if (block_marked != run_marked) {
+						if (run_marked) {
+							my_list.fillRectangle(graphics::DrawLayers::Marked_Tiles, graphics::DrawRect {
+								static_cast<float>(this->convertToScreenX(run_marked_gx)), block_sty,
+								static_cast<float>(this->convertToScreenX(run_end_gx)), block_sby}, marked_block_color);
+						}
+						run_marked = block_marked;
+						run_marked_gx = block_gx;
+					}
+					if (is_past_end) {
+						break;
 					}
 				}
 			}
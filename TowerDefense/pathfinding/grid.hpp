@@ -1,17 +1,28 @@
 #pragma once
 // File Author: Isaiah Hoffman
 // File Created: March 24, 2018
+#include <cmath>
 #include <iosfwd>
 #include <vector>
 #include <initializer_list>
 #include <memory>
+#include <string>
 #include "./../globals.hpp"
+#include "./../ih_math.hpp"
 #include "./graph_node.hpp"
 
 namespace hoffman_isaiah {
 	namespace terrain_editor {
 		class TerrainEditor;
 	}
+	namespace graphics {
+		class DrawList;
+	}
+	namespace util::file {
+		class BinaryReader;
+		class BinaryWriter;
+		class ResourcePack;
+	}
 
 	namespace pathfinding {
 		/// <summary>Class representing a rectangular graph of nodes.</summary>
@@ -80,6 +91,7 @@ namespace hoffman_isaiah {
 			/// <param name="new_cols">The new number of columns in the grid.</param>
 			/// <param name="default_weight">The weight to assign to all the nodes.</param>
 			void clearGrid(int new_rows, int new_cols, int default_weight) {
+				this->markAllTilesChanged();
 				this->start_node = nullptr;
 				this->goal_node = nullptr;
 				this->nodes.clear();
@@ -195,6 +207,51 @@ namespace hoffman_isaiah {
 			void setGoalNode(int gx, int gy) noexcept {
 				this->goal_node = &this->getNode(gx, gy);
 			}
+			// Tracked changes
+			// (Changing a node through these methods also records that its tile changed, so that
+			// anything drawn from the grid only needs to redraw the tiles that changed.)
+			/// <summary>Blocks or unblocks a node and records that its tile changed.</summary>
+			/// <param name="block_space">True to block the node or false to unblock it.</param>
+			void setBlockage(int gx, int gy, bool block_space) {
+				this->getNode(gx, gy).setBlockage(block_space);
+				this->markTileChanged(gx, gy);
+			}
+			/// <summary>Changes the weight of a node and records that its tile changed.</summary>
+			void setWeight(int gx, int gy, int new_weight) {
+				this->getNode(gx, gy).setWeight(new_weight);
+				this->markTileChanged(gx, gy);
+			}
+			/// <summary>Records that a node was changed without using the methods above.</summary>
+			void markTileChanged(int gx, int gy) const {
+				if (this->all_tiles_changed) {
+					return;
+				}
+				if (this->changed_tiles.size() >= static_cast<std::size_t>(this->getRows() * this->getColumns())) {
+					// No point in listing more tiles than there are.
+					this->markAllTilesChanged();
+					return;
+				}
+				this->changed_tiles.emplace_back(gy * this->getColumns() + gx);
+			}
+			/// <summary>Records that every node may have changed.</summary>
+			void markAllTilesChanged() const noexcept {
+				this->all_tiles_changed = true;
+				this->changed_tiles.clear();
+			}
+			/// <summary>Adds the index (row * columns + column) of each tile that changed since the
+			/// last call to a list and then forgets those changes. (A tile may be listed more than
+			/// once. Since the changes are forgotten, the grid should only have one such reader.)</summary>
+			/// <param name="tiles">The list to add the changed tiles to.</param>
+			/// <returns>True if every tile may have changed, in which case no tiles are added.</returns>
+			bool takeChangedTiles(std::vector<int>& tiles) const {
+				const bool were_all_changed = this->all_tiles_changed;
+				if (!were_all_changed) {
+					tiles.insert(tiles.end(), this->changed_tiles.cbegin(), this->changed_tiles.cend());
+				}
+				this->all_tiles_changed = false;
+				this->changed_tiles.clear();
+				return were_all_changed;
+			}
 			// Input/Output
 			friend std::wostream& operator<<(std::wostream& os, const Grid& graph);
 			friend std::wistream& operator>>(std::wistream& is, Grid& graph);
@@ -209,7 +266,23 @@ namespace hoffman_isaiah {
 			/// <summary>Pointer to the ending node (for pathfinding) if relevant.
 			/// If this is irrelevant, then this value should be nullptr.</summary>
 			GraphNode* goal_node {nullptr};
+			/// <summary>The index of each tile that changed since the changes were last taken.
+			/// (The record of changes is not part of the grid's contents, so it may be updated
+			/// even when the grid is constant.)</summary>
+			mutable std::vector<int> changed_tiles {};
+			/// <summary>Set when every tile may have changed (such as when the grid is created).</summary>
+			mutable bool all_tiles_changed {true};
 		};
+
+		/// <summary>Writes a grid in a compact binary form. The nodes are stored (in row-major
+		/// order) as runs of nodes that share the same weight, which keeps large uniform areas small.</summary>
+		/// <param name="writer">The buffer to write the grid to.</param>
+		/// <param name="graph">The grid to write.</param>
+		void writeGrid(util::file::BinaryWriter& writer, const Grid& graph);
+		/// <summary>Reads a grid written by writeGrid, replacing the grid's current contents.</summary>
+		/// <param name="reader">The buffer to read the grid from.</param>
+		/// <param name="graph">The grid to store the result in.</param>
+		void readGrid(util::file::BinaryReader& reader, Grid& graph);
 	}
 
 	namespace game {
@@ -250,6 +323,35 @@ namespace hoffman_isaiah {
 			// Slight variation on the above because we need the additional variable.
 			void draw(const graphics::Renderer2D& renderer,
 				const terrain_editor::TerrainEditor* my_editor) const noexcept;
+			/// <summary>Records the terrain of a tile along with its highlight (if it is marked).
+			/// (These only change when the map is edited or tiles are marked, so the renderer
+			/// caches them and only records the tiles that changed.)</summary>
+			/// <param name="my_list">The draw list to add the tile to.</param>
+			void recordTile(graphics::DrawList& my_list, int gx, int gy) const;
+			/// <summary>Records a rectangle of tiles. When the tiles are too small to see one by
+			/// one, they are recorded in square blocks instead: each block takes the most common
+			/// terrain among its tiles, blocks with any marked tiles are highlighted, and neighboring
+			/// blocks in a row that look the same are merged into one rectangle.</summary>
+			/// <param name="my_list">The draw list to add the tiles to.</param>
+			/// <param name="min_gx">The first column to record. (This should be a multiple of the block size.)</param>
+			/// <param name="min_gy">The first row to record. (This should be a multiple of the block size.)</param>
+			/// <param name="end_gx">One past the last column to record.</param>
+			/// <param name="end_gy">One past the last row to record.</param>
+			/// <param name="block_size">The number of tiles along each side of a block. (1 records
+			/// every tile in full.)</param>
+			void recordTiles(graphics::DrawList& my_list, int min_gx, int min_gy, int end_gx, int end_gy,
+				int block_size) const;
+			/// <summary>Adds each tile whose terrain or highlight changed since the last call to a
+			/// list. (See Grid::takeChangedTiles.)</summary>
+			/// <param name="tiles">The list to add the changed tiles to.</param>
+			/// <returns>True if every tile may have changed, in which case no tiles are added.</returns>
+			bool takeChangedTiles(std::vector<int>& tiles) const {
+				// (Every graph's changes must be taken, so the results are not short-circuited.)
+				const bool all_ground_changed = this->getTerrainGraph(false).takeChangedTiles(tiles);
+				const bool all_air_changed = this->getTerrainGraph(true).takeChangedTiles(tiles);
+				const bool all_highlights_changed = this->getHighlightGraph().takeChangedTiles(tiles);
+				return all_ground_changed || all_air_changed || all_highlights_changed;
+			}
 			/// <summary>Sets the influence graphs stored in the map.</summary>
 			/// <param name="ground">The new ground influence graph.</param>
 			/// <param name="air">The new air influence graph.</param>
@@ -306,6 +408,28 @@ namespace hoffman_isaiah {
 			double convertToScreenY(double gy) const noexcept {
 				return this->getTerrainGraph(false).convertToScreenY(gy);
 			}
+			// Tile indexing
+			/// <returns>The total number of tiles in the map.</returns>
+			int getTileCount() const noexcept {
+				return this->getRows() * this->getColumns();
+			}
+			/// <param name="gx">The x-coordinate (column number) of the tile.</param>
+			/// <param name="gy">The y-coordinate (row number) of the tile.</param>
+			/// <returns>The index of the tile when the tiles are stored in row then column order.</returns>
+			int getTileIndex(int gx, int gy) const noexcept {
+				return gy * this->getColumns() + gx;
+			}
+			/// <param name="gx">A game x-coordinate.</param>
+			/// <param name="gy">A game y-coordinate.</param>
+			/// <returns>The index of the tile containing the given point. Points outside of the
+			/// map are clamped to the nearest tile along the edge.</returns>
+			int getTileIndex(double gx, double gy) const noexcept {
+				const int tile_x = math::get_max(0, math::get_min(this->getColumns() - 1,
+					static_cast<int>(std::floor(gx))));
+				const int tile_y = math::get_max(0, math::get_min(this->getRows() - 1,
+					static_cast<int>(std::floor(gy))));
+				return this->getTileIndex(tile_x, tile_y);
+			}
 			// Other getters
 			/// <param name="get_air_graph">Set this true to return the air graph; otherwise,
 			/// the ground graph is returned.</param>
@@ -382,15 +506,9 @@ namespace hoffman_isaiah {
 				this->highlight_graph->clearGrid(new_rows, new_cols, 0);
 			}
 		protected:
-			/// <summary>Draws the terrain map.</summary>
-			/// <param name="renderer">A reference to the rendering device.</param>
-			void drawTerrain(const graphics::Renderer2D& renderer) const noexcept;
 			/// <summary>Draws the start and goal tiles.</summary>
 			/// <param name="renderer">A reference to the rendering device.</param>
 			void drawStartGoal(const graphics::Renderer2D& renderer) const noexcept;
-			/// <summary>Draws a highlight over tiles that the user has selected.</summary>
-			/// <param name="renderer">A reference to the rendering device.</param>
-			void drawMarkedTiles(const graphics::Renderer2D& renderer) const noexcept;
 		private:
 			/// <summary>Graph that contains information about the basic terrain weights
 			/// of each grid square for ground units.</summary>
@@ -413,5 +531,22 @@ namespace hoffman_isaiah {
 			/// <summary>Graph that contains information about areas the user wants highlighted.</summary>
 			std::unique_ptr<pathfinding::Grid> highlight_graph;
 		};
+
+		/// <param name="map_name">The base name of the map.</param>
+		/// <returns>The path (relative to the resources folder) of the binary map file that stores the given map.</returns>
+		std::wstring getMapResourceName(const std::wstring& map_name);
+		/// <summary>Loads a map's terrain. The binary map file is used if it exists; otherwise, the
+		/// map is read from the older pair of text files (one for each terrain graph).</summary>
+		/// <param name="resources">The resources to load the map from.</param>
+		/// <param name="map_name">The base name of the map.</param>
+		/// <returns>The loaded map or nullptr if the map does not exist.</returns>
+		std::shared_ptr<GameMap> loadMapFile(const util::file::ResourcePack& resources, const std::wstring& map_name);
+		/// <summary>Saves both of a map's terrain graphs (including their start and goal nodes)
+		/// to a single binary map file.</summary>
+		/// <param name="map">The map to save.</param>
+		/// <param name="resources_path">The folder to save the map to as if it were the resources folder.</param>
+		/// <param name="map_name">The base name of the map.</param>
+		/// <returns>True if the map was saved successfully.</returns>
+		bool saveMapFile(const GameMap& map, const std::wstring& resources_path, const std::wstring& map_name);
 	}
 }
\ No newline at end of file
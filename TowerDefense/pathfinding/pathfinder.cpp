@@ -1,6 +1,7 @@
 // File Author: Isaiah Hoffman
 // File Created: March 24, 2018
 #include <algorithm>
+#include <cstdint>
 #include <map>
 #include <queue>
 #include <set>
@@ -8,6 +9,8 @@
 #include <utility>
 #include <vector>
 #include "./../globals.hpp"
+#include "./../perf_counters.hpp"
+#include "./../profiler.hpp"
 #include "./graph_node.hpp"
 #include "./grid.hpp"
 #include "./pathfinder.hpp"
@@ -47,6 +50,7 @@ namespace hoffman_isaiah {
 
 		std::queue<GraphNode> Pathfinder::findPath(double j_multiplier, int start_x,
 			int start_y, int goal_x, int goal_y, double h_modifier) {
+			IH_PROFILE_FUNCTION();
 			class PathFinderComparator {
 			public:
 				bool operator()(PathFinderNode a, PathFinderNode b) const {
@@ -80,6 +84,7 @@ namespace hoffman_isaiah {
 				this->heuristic_strategy, 0, j_multiplier, h_modifier};
 			my_set.push(my_goal);
 			previous_costs.at(determine_node_index(my_goal.getGameX(), my_goal.getGameY())) = my_goal.getF();
+			std::int64_t nodes_expanded = 0;
 			while (!my_set.empty()) {
 				auto current_node = std::make_shared<PathFinderNode>(my_set.top());
 				if (current_node->getGameX() == start_node.getGameX() &&
@@ -87,6 +92,7 @@ namespace hoffman_isaiah {
 					break;
 				}
 				my_set.pop();
+				++nodes_expanded;
 				auto my_neighbors = this->terrain_graph.getNeighbors(current_node->getGameX(), current_node->getGameY(),
 					this->filter_graph, this->move_diag);
 				// Look at neighbors
@@ -102,6 +108,10 @@ namespace hoffman_isaiah {
 					}
 				}
 			}
+			if (this->perf_counters) {
+				this->perf_counters->increment(util::PerfCounters::AStar_Searches);
+				this->perf_counters->increment(util::PerfCounters::Nodes_Expanded, nodes_expanded);
+			}
 			if (my_set.empty()) {
 				throw std::runtime_error {"Queue is empty; check that a path exists."};
 			}
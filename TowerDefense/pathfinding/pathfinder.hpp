@@ -7,6 +7,11 @@
 #include "./grid.hpp"
 
 namespace hoffman_isaiah {
+	namespace util {
+		// Forward declaration
+		class PerfCounterRegistry;
+	}
+
 	namespace pathfinding {
 		/// <summary>Class that represents a pathfinder used to find
 		/// paths for enemies.</summary>
@@ -45,6 +50,11 @@ namespace hoffman_isaiah {
 				this->heuristic_strategy = new_strat;
 				this->move_diag = diag_status;
 			}
+			/// <param name="counters">The counters that searches are counted in, or nullptr
+			/// to not count searches.</param>
+			void setPerfCounters(util::PerfCounterRegistry* counters) noexcept {
+				this->perf_counters = counters;
+			}
 			// Getters
 			std::queue<GraphNode> getPath() const noexcept {
 				return this->my_path;
@@ -62,6 +72,9 @@ namespace hoffman_isaiah {
 			HeuristicStrategies heuristic_strategy;
 			/// <summary>Queue that contains the path last found by the pathfinder.</summary>
 			std::queue<GraphNode> my_path;
+			/// <summary>The counters of the game that owns the pathfinder. (This is nullptr for
+			/// pathfinders that do not belong to a game.)</summary>
+			util::PerfCounterRegistry* perf_counters {nullptr};
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./perf_counters.hpp"
+
+namespace hoffman_isaiah {
+	namespace util {
+		namespace {
+			constexpr const int counter_count = static_cast<int>(PerfCounters::Sentinel_DO_NOT_USE);
+			constexpr const int mark_count = static_cast<int>(PerfHighWaterMarks::Sentinel_DO_NOT_USE);
+			/// <summary>The column names of each counter in the same order as PerfCounters.</summary>
+			constexpr const std::array<const wchar_t*, counter_count> counter_names {
+				L"astar_searches", L"nodes_expanded",
+				L"repaths_group_spawn", L"repaths_enemy_spawn", L"repaths_strategy_change", L"repaths_strategy_restore",
+				L"shots_spawned", L"shots_destroyed", L"collision_tests", L"status_effects_applied"
+			};
+			/// <summary>The column names of each high-water mark in the same order as PerfHighWaterMarks.</summary>
+			constexpr const std::array<const wchar_t*, mark_count> mark_names {
+				L"max_enemies", L"max_shots", L"max_towers"
+			};
+
+
+			/// <param name="sorted_times">The tick times in increasing order.</param>
+			/// <param name="percentile">The percentile to find between 0 and 1.</param>
+			/// <returns>The smallest tick time that is at least that fraction of the tick times.</returns>
+			double getPercentile(const std::vector<float>& sorted_times, double percentile) {
+				if (sorted_times.empty()) {
+					return 0.0;
+				}
+				const auto rank = static_cast<std::size_t>(std::ceil(percentile * sorted_times.size()));
+				return sorted_times[std::min(std::max<std::size_t>(rank, 1), sorted_times.size()) - 1];
+			}
+		}
+
+		void PerfCounterRegistry::recordValue(PerfHighWaterMarks mark, std::int64_t value) noexcept {
+			auto& my_mark = this->high_water_marks[static_cast<int>(mark)];
+			std::int64_t old_value = my_mark.load(std::memory_order_relaxed);
+			while (value > old_value && !my_mark.compare_exchange_weak(old_value, value, std::memory_order_relaxed)) {
+			}
+		}
+
+		void PerfCounterRegistry::recordTickTime(double tick_ms) {
+			std::lock_guard<std::mutex> lock {this->tick_mutex};
+			this->tick_times.push_back(static_cast<float>(tick_ms));
+		}
+
+		PerfSample PerfCounterRegistry::takeSample() {
+			PerfSample my_sample {};
+			for (int i = 0; i < counter_count; ++i) {
+				my_sample.counters[i] = this->counters[i].exchange(0, std::memory_order_relaxed);
+			}
+			for (int i = 0; i < mark_count; ++i) {
+				my_sample.high_water_marks[i] = this->high_water_marks[i].exchange(0, std::memory_order_relaxed);
+			}
+			std::vector<float> my_tick_times {};
+			{
+				std::lock_guard<std::mutex> lock {this->tick_mutex};
+				std::swap(my_tick_times, this->tick_times);
+			}
+			std::sort(my_tick_times.begin(), my_tick_times.end());
+			my_sample.tick_count = static_cast<std::int64_t>(my_tick_times.size());
+			my_sample.tick_p50_ms = getPercentile(my_tick_times, 0.50);
+			my_sample.tick_p90_ms = getPercentile(my_tick_times, 0.90);
+			my_sample.tick_p99_ms = getPercentile(my_tick_times, 0.99);
+			my_sample.tick_max_ms = my_tick_times.empty() ? 0.0 : my_tick_times.back();
+			return my_sample;
+		}
+
+		std::wstring PerfCounterRegistry::getCsvHeader() {
+			std::wostringstream header {};
+			header << L"ticks,tick_p50_ms,tick_p90_ms,tick_p99_ms,tick_max_ms";
+			for (const auto* name : counter_names) {
+				header << L"," << name;
+			}
+			for (const auto* name : mark_names) {
+				header << L"," << name;
+			}
+			return header.str();
+		}
+
+		std::wstring PerfCounterRegistry::getCsvColumns(const PerfSample& sample) {
+			std::wostringstream columns {};
+			columns << std::fixed << std::setprecision(3) << sample.tick_count << L"," << sample.tick_p50_ms
+				<< L"," << sample.tick_p90_ms << L"," << sample.tick_p99_ms << L"," << sample.tick_max_ms;
+			for (const auto value : sample.counters) {
+				columns << L"," << value;
+			}
+			for (const auto value : sample.high_water_marks) {
+				columns << L"," << value;
+			}
+			return columns.str();
+		}
+	}
+}
\ No newline at end of file
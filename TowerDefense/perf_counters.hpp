@@ -0,0 +1,80 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hoffman_isaiah {
+	namespace util {
+		/// <summary>Events counted by the engine.</summary>
+		enum class PerfCounters {
+			AStar_Searches, Nodes_Expanded,
+			// The reasons that enemies search for a path.
+			Repaths_Group_Spawn, Repaths_Enemy_Spawn, Repaths_Strategy_Change, Repaths_Strategy_Restore,
+			Shots_Spawned, Shots_Destroyed, Collision_Tests, Status_Effects_Applied,
+			Sentinel_DO_NOT_USE
+		};
+
+		/// <summary>Quantities whose largest value is tracked.</summary>
+		enum class PerfHighWaterMarks {
+			Live_Enemies, Live_Shots, Live_Towers,
+			Sentinel_DO_NOT_USE
+		};
+
+		/// <summary>The counters accumulated since the previous sample.</summary>
+		struct PerfSample {
+			/// <summary>The value of each counter, indexed by PerfCounters.</summary>
+			std::array<std::int64_t, static_cast<int>(PerfCounters::Sentinel_DO_NOT_USE)> counters {};
+			/// <summary>The largest value of each quantity, indexed by PerfHighWaterMarks.</summary>
+			std::array<std::int64_t, static_cast<int>(PerfHighWaterMarks::Sentinel_DO_NOT_USE)> high_water_marks {};
+			/// <summary>The number of logic ticks that were timed.</summary>
+			std::int64_t tick_count {0};
+			// Tick times in milliseconds.
+			double tick_p50_ms {0.0};
+			double tick_p90_ms {0.0};
+			double tick_p99_ms {0.0};
+			double tick_max_ms {0.0};
+		};
+
+		/// <summary>A registry of performance counters. Each game has its own registry so that
+		/// games played at the same time neither share counters nor reset each other's. Counters
+		/// may be incremented from any thread without taking a lock. The registry is sampled (and
+		/// reset) once per level so that slow levels can be told apart.</summary>
+		class PerfCounterRegistry {
+		public:
+			/// <param name="counter">The counter to increment.</param>
+			/// <param name="amount">The amount to add to the counter.</param>
+			void increment(PerfCounters counter, std::int64_t amount = 1) noexcept {
+				this->counters[static_cast<int>(counter)].fetch_add(amount, std::memory_order_relaxed);
+			}
+			/// <param name="mark">The quantity that was measured.</param>
+			/// <param name="value">The current value of the quantity.</param>
+			void recordValue(PerfHighWaterMarks mark, std::int64_t value) noexcept;
+			/// <summary>Records how long a logic tick took. (This should only be called from
+			/// the thread that updates the game.)</summary>
+			/// <param name="tick_ms">The time that the tick took in milliseconds.</param>
+			void recordTickTime(double tick_ms);
+			/// <returns>The counters accumulated since the previous sample. Every counter is
+			/// then reset.</returns>
+			PerfSample takeSample();
+			/// <returns>The CSV header matching the columns written by getCsvColumns.</returns>
+			static std::wstring getCsvHeader();
+			/// <param name="sample">The sample to write.</param>
+			/// <returns>The sample's values separated by commas.</returns>
+			static std::wstring getCsvColumns(const PerfSample& sample);
+		private:
+			/// <summary>The value of each counter, indexed by PerfCounters.</summary>
+			std::array<std::atomic<std::int64_t>, static_cast<int>(PerfCounters::Sentinel_DO_NOT_USE)> counters {};
+			/// <summary>The largest value of each quantity, indexed by PerfHighWaterMarks.</summary>
+			std::array<std::atomic<std::int64_t>, static_cast<int>(PerfHighWaterMarks::Sentinel_DO_NOT_USE)> high_water_marks {};
+			/// <summary>Guards the list of tick times. (Only sampling contends for it.)</summary>
+			std::mutex tick_mutex {};
+			/// <summary>The time of every tick since the previous sample in milliseconds.</summary>
+			std::vector<float> tick_times {};
+		};
+	}
+}
\ No newline at end of file
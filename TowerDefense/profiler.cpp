@@ -0,0 +1,205 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "./profiler.hpp"
+
+namespace hoffman_isaiah {
+	namespace util {
+		namespace {
+			/// <summary>One slot of a thread's ring buffer. (The fields are atomic so that
+			/// readers may copy them while the owning thread writes.)</summary>
+			struct EventSlot {
+				std::atomic<const char*> name;
+				std::atomic<std::int64_t> start_ns;
+				std::atomic<std::int64_t> end_ns;
+			};
+
+			/// <summary>A copy of an event made for exporting.</summary>
+			struct EventCopy {
+				const char* name;
+				std::int64_t start_ns;
+				std::int64_t end_ns;
+			};
+
+			/// <summary>The events recorded by one thread. Only the owning thread writes events,
+			/// so it never has to wait for anyone; readers copy the events and then drop any
+			/// that may have been overwritten while they were copying.</summary>
+			struct ThreadEvents {
+				/// <summary>The ring buffer.</summary>
+				std::unique_ptr<EventSlot[]> slots {std::make_unique<EventSlot[]>(Profiler::events_per_thread)};
+				/// <summary>The number of events recorded since the buffer was assigned to its thread.</summary>
+				std::atomic<std::uint64_t> next_event {0};
+				/// <summary>The identifier of the thread in exported traces.</summary>
+				int thread_id {0};
+				/// <summary>The name of the thread or nullptr if it has not been named.</summary>
+				const char* thread_name {nullptr};
+				/// <summary>False once the owning thread has exited, at which point the buffer
+				/// may be given to a new thread.</summary>
+				bool in_use {true};
+			};
+
+			/// <summary>Every thread's buffer. Buffers outlive their threads so that their
+			/// events can still be exported.</summary>
+			struct ThreadRegistry {
+				/// <summary>Guards the list of buffers and each buffer's thread information.</summary>
+				std::mutex mutex {};
+				std::vector<std::unique_ptr<ThreadEvents>> buffers {};
+				/// <summary>The identifier to give the next thread.</summary>
+				int next_thread_id {1};
+			};
+
+			ThreadRegistry& getRegistry() {
+				// (The registry is created on first use so that static constructors may profile.)
+				static ThreadRegistry registry {};
+				return registry;
+			}
+
+			/// <summary>Releases the calling thread's buffer when the thread exits.</summary>
+			struct ThreadHandle {
+				ThreadEvents* events {nullptr};
+				~ThreadHandle() noexcept {
+					if (this->events) {
+						ThreadRegistry& registry = getRegistry();
+						std::lock_guard<std::mutex> lock {registry.mutex};
+						this->events->in_use = false;
+					}
+				}
+			};
+			thread_local ThreadHandle my_thread {};
+
+			/// <returns>The calling thread's buffer. A thread's first call takes a lock to
+			/// find it a buffer; later calls do not.</returns>
+			ThreadEvents& getThreadEvents() {
+				if (!my_thread.events) {
+					ThreadRegistry& registry = getRegistry();
+					std::lock_guard<std::mutex> lock {registry.mutex};
+					for (auto& buffer : registry.buffers) {
+						if (!buffer->in_use) {
+							// Reuse the buffer of a thread that has exited, so that short-lived
+							// threads do not grow the registry forever.
+							my_thread.events = buffer.get();
+							break;
+						}
+					}
+					if (!my_thread.events) {
+						registry.buffers.emplace_back(std::make_unique<ThreadEvents>());
+						my_thread.events = registry.buffers.back().get();
+					}
+					my_thread.events->next_event.store(0, std::memory_order_relaxed);
+					my_thread.events->thread_id = registry.next_thread_id++;
+					my_thread.events->thread_name = nullptr;
+					my_thread.events->in_use = true;
+				}
+				return *my_thread.events;
+			}
+
+			/// <summary>Copies the events of a buffer that have not been overwritten. (The
+			/// registry must be locked by the caller.)</summary>
+			std::vector<EventCopy> copyEvents(const ThreadEvents& buffer) {
+				constexpr const std::uint64_t capacity = Profiler::events_per_thread;
+				const std::uint64_t end = buffer.next_event.load(std::memory_order_acquire);
+				const std::uint64_t begin = end > capacity ? end - capacity : 0;
+				std::vector<EventCopy> events {};
+				events.reserve(static_cast<std::size_t>(end - begin));
+				for (std::uint64_t i = begin; i < end; ++i) {
+					const EventSlot& slot = buffer.slots[static_cast<std::size_t>(i % capacity)];
+					events.push_back(EventCopy {slot.name.load(std::memory_order_relaxed),
+						slot.start_ns.load(std::memory_order_relaxed), slot.end_ns.load(std::memory_order_relaxed)});
+				}
+				std::atomic_thread_fence(std::memory_order_acquire);
+				// The owner may be partway through writing the slot after its newest event, so
+				// that slot's old event is dropped as well.
+				const std::uint64_t new_end = buffer.next_event.load(std::memory_order_relaxed);
+				const std::uint64_t first_valid = new_end + 1 > capacity ? new_end + 1 - capacity : 0;
+				if (first_valid > begin) {
+					events.erase(events.begin(), events.begin()
+						+ static_cast<std::ptrdiff_t>(std::min(first_valid, end) - begin));
+				}
+				return events;
+			}
+
+			/// <summary>Writes a string as a JSON string literal.</summary>
+			void writeJsonString(std::ostream& os, const char* text) {
+				os << '"';
+				for (const char* c = text; *c; ++c) {
+					if (*c == '"' || *c == '\\') {
+						os << '\\' << *c;
+					}
+					else if (static_cast<unsigned char>(*c) >= 0x20) {
+						os << *c;
+					}
+				}
+				os << '"';
+			}
+		}
+
+		std::int64_t Profiler::now() noexcept {
+			static const auto epoch = std::chrono::steady_clock::now();
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - epoch).count();
+		}
+
+		void Profiler::record(const char* name, std::int64_t start_ns, std::int64_t end_ns) noexcept {
+			ThreadEvents* my_events {nullptr};
+			try {
+				my_events = &getThreadEvents();
+			}
+			catch (...) {
+				// Out of memory; the event is simply lost.
+				return;
+			}
+			const std::uint64_t index = my_events->next_event.load(std::memory_order_relaxed);
+			EventSlot& slot = my_events->slots[static_cast<std::size_t>(index % events_per_thread)];
+			slot.name.store(name, std::memory_order_relaxed);
+			slot.start_ns.store(start_ns, std::memory_order_relaxed);
+			slot.end_ns.store(end_ns, std::memory_order_relaxed);
+			my_events->next_event.store(index + 1, std::memory_order_release);
+		}
+
+		void Profiler::setThreadName(const char* name) {
+			ThreadEvents& my_events = getThreadEvents();
+			ThreadRegistry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock {registry.mutex};
+			my_events.thread_name = name;
+		}
+
+		std::string Profiler::getChromeTrace() {
+			std::ostringstream trace {};
+			trace << std::fixed << std::setprecision(3);
+			trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+			bool is_first = true;
+			ThreadRegistry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock {registry.mutex};
+			for (const auto& buffer : registry.buffers) {
+				if (buffer->thread_name) {
+					trace << (is_first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+						<< buffer->thread_id << ",\"args\":{\"name\":";
+					writeJsonString(trace, buffer->thread_name);
+					trace << "}}";
+					is_first = false;
+				}
+				for (const auto& my_event : copyEvents(*buffer)) {
+					trace << (is_first ? "\n" : ",\n") << "{\"name\":";
+					writeJsonString(trace, my_event.name);
+					// (Chrome traces measure time in microseconds.)
+					trace << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id
+						<< ",\"ts\":" << my_event.start_ns / 1000.0
+						<< ",\"dur\":" << (my_event.end_ns - my_event.start_ns) / 1000.0 << "}";
+					is_first = false;
+				}
+			}
+			trace << "\n]}\n";
+			return trace.str();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Define IH_PROFILING as 0 to compile every profiling macro away.
+#ifndef IH_PROFILING
+#define IH_PROFILING 1
+#endif
+
+#if IH_PROFILING
+#define IH_PROFILE_CONCAT_INNER(a, b) a##b
+#define IH_PROFILE_CONCAT(a, b) IH_PROFILE_CONCAT_INNER(a, b)
+/// <summary>Times the rest of the enclosing scope. The name must be a string literal.</summary>
+#define IH_PROFILE_SCOPE(name) const ::hoffman_isaiah::util::ScopedTimer \
+	IH_PROFILE_CONCAT(ih_profile_timer_, __LINE__) {name}
+/// <summary>Times the rest of the enclosing function.</summary>
+#define IH_PROFILE_FUNCTION() IH_PROFILE_SCOPE(__FUNCTION__)
+/// <summary>Names the calling thread in exported traces. The name must be a string literal.</summary>
+#define IH_PROFILE_THREAD_NAME(name) ::hoffman_isaiah::util::Profiler::setThreadName(name)
+#else
+#define IH_PROFILE_SCOPE(name) ((void)0)
+#define IH_PROFILE_FUNCTION() ((void)0)
+#define IH_PROFILE_THREAD_NAME(name) ((void)0)
+#endif
+
+namespace hoffman_isaiah {
+	namespace util {
+		/// <summary>Records how long sections of code take to run. Each thread records its
+		/// events into its own fixed-size ring buffer, so recording an event never takes a lock
+		/// or allocates memory; once a buffer is full, the oldest events are overwritten. The
+		/// recorded events can be exported in the Chrome trace format, which can be opened with
+		/// chrome://tracing or Perfetto.</summary>
+		/// <remarks>Use the IH_PROFILE_ macros instead of calling these functions directly so
+		/// that profiling can be compiled out.</remarks>
+		class Profiler {
+		public:
+			/// <summary>The number of events that each thread's buffer holds.</summary>
+			static constexpr const std::size_t events_per_thread = 16384;
+
+			/// <returns>The number of nanoseconds since the profiler was first used.</returns>
+			static std::int64_t now() noexcept;
+			/// <summary>Records an event on the calling thread.</summary>
+			/// <param name="name">The name of the event. (This must live for the rest of the
+			/// program, which string literals do.)</param>
+			/// <param name="start_ns">The time that the event started.</param>
+			/// <param name="end_ns">The time that the event ended.</param>
+			static void record(const char* name, std::int64_t start_ns, std::int64_t end_ns) noexcept;
+			/// <param name="name">The name of the calling thread as it should appear in traces.</param>
+			static void setThreadName(const char* name);
+			/// <returns>Every event that has not been overwritten in the Chrome trace (JSON) format.</returns>
+			static std::string getChromeTrace();
+		};
+
+		/// <summary>Records an event covering the lifetime of the timer.</summary>
+		class ScopedTimer {
+		public:
+			/// <param name="event_name">The name of the event. (This must be a string literal.)</param>
+			explicit ScopedTimer(const char* event_name) noexcept :
+				name {event_name},
+				start_ns {Profiler::now()} {
+			}
+			ScopedTimer(const ScopedTimer&) = delete;
+			ScopedTimer& operator=(const ScopedTimer&) = delete;
+			~ScopedTimer() noexcept {
+				Profiler::record(this->name, this->start_ns, Profiler::now());
+			}
+		private:
+			/// <summary>The name of the event.</summary>
+			const char* name;
+			/// <summary>The time that the timer was created.</summary>
+			std::int64_t start_ns;
+		};
+	}
+}
\ No newline at end of file
@@ -150,6 +150,7 @@
 #define ID_MM_ACTIONS_TOGGLE_ALL_RADII          40206
 #define ID_MM_ACTIONS_UNMARK_ALL_TILES          40207
 #define ID_MM_ACTIONS_VIEW_GLOBAL_STATS         40208
+#define ID_MM_ACTIONS_MAX_SPEED                 40209
 #define ID_MM_TOWERS_INFO                       40301
 #define ID_MM_TOWERS_MARK_TILES                 40302
 #define ID_MM_TOWERS_UNMARK_TILES               40303
@@ -161,6 +162,7 @@
 #define ID_MM_HELP_ABOUT                        40601
 #define ID_MM_DEVELOP_TERRAIN_EDITOR            40801
 #define ID_MM_DEVELOP_SHOW_TEST_PATHS           40802
+#define ID_MM_DEVELOP_SAVE_PROFILE_TRACE        40803
 #define ID_TE_FILE_NEW_MAP                      41101
 #define ID_TE_FILE_OPEN_MAP                     41102
 #define ID_TE_FILE_SAVE_MAP                     41103
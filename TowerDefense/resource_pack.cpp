@@ -0,0 +1,282 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include "./targetver.hpp"
+#include <Windows.h>
+#include <algorithm>
+#include <cwchar>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "./file_util.hpp"
+#include "./resource_pack.hpp"
+using namespace std::literals::string_literals;
+
+namespace hoffman_isaiah {
+	namespace util::file {
+		namespace {
+			/// <summary>The magic number that begins every resource pack ("TDPK").</summary>
+			constexpr const std::uint32_t resource_pack_magic = 0x4B504454U;
+			/// <summary>The current format version of resource packs.</summary>
+			constexpr const std::uint32_t resource_pack_version = 1U;
+			/// <summary>The size of the pack header: the magic number, the version, and the
+			/// offset and size of the index.</summary>
+			constexpr const std::size_t resource_pack_header_size = 2 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+			/// <summary>Files that are never packed since the game writes them at runtime.</summary>
+			const std::set<std::wstring> unpacked_files {L"types.tddb"s};
+			/// <summary>The folder containing resources that are streamed instead of loaded.</summary>
+			constexpr const wchar_t* streamed_folder = L"music/";
+
+			/// <param name="path">The path of a resource relative to the resources folder.</param>
+			/// <returns>True if the resource is streamed instead of loaded.</returns>
+			bool isStreamedResource(const std::wstring& path) {
+				return path.compare(0, std::wcslen(streamed_folder), streamed_folder) == 0;
+			}
+		}
+
+		void ResourcePack::open(const std::wstring& pack_file_name, std::wstring new_override_folder, std::wstring new_loose_folder) {
+			this->close();
+			this->override_folder = std::move(new_override_folder);
+			this->loose_folder = std::move(new_loose_folder);
+			this->pack_file_name = pack_file_name;
+			// (Most of the pack is read at once below, so the sequential hint lets Windows read ahead.)
+			HANDLE my_file = CreateFileW(pack_file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+				OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (my_file == INVALID_HANDLE_VALUE) {
+				// No pack; resources come from the override and loose folders alone.
+				return;
+			}
+			this->file_handle = my_file;
+			LARGE_INTEGER file_size {};
+			if (!GetFileSizeEx(my_file, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(resource_pack_header_size)) {
+				this->close();
+				throw DataFileException {L"The resource pack " + pack_file_name + L" is corrupted.", 0};
+			}
+			this->mapping_handle = CreateFileMappingW(my_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!this->mapping_handle) {
+				this->close();
+				throw DataFileException {L"Could not map the resource pack " + pack_file_name + L" into memory.", 0};
+			}
+			this->pack_data = static_cast<const char*>(MapViewOfFile(this->mapping_handle, FILE_MAP_READ, 0, 0, 0));
+			if (!this->pack_data) {
+				this->close();
+				throw DataFileException {L"Could not map the resource pack " + pack_file_name + L" into memory.", 0};
+			}
+			this->pack_size = static_cast<std::size_t>(file_size.QuadPart);
+			std::uint64_t prefetch_size {0};
+			try {
+				BinaryReader header {this->pack_data, resource_pack_header_size};
+				if (header.read<std::uint32_t>() != resource_pack_magic) {
+					throw DataFileException {L"The file " + pack_file_name + L" is not a resource pack.", 0};
+				}
+				if (header.read<std::uint32_t>() > resource_pack_version) {
+					throw DataFileException {L"The resource pack " + pack_file_name
+						+ L" was created by a newer version of the game.", 0};
+				}
+				const auto index_offset = header.read<std::uint64_t>();
+				const auto index_size = header.read<std::uint64_t>();
+				if (index_offset < resource_pack_header_size || index_offset > this->pack_size
+					|| index_size > this->pack_size - index_offset) {
+					throw DataFileException {L"The resource pack " + pack_file_name + L" is corrupted.", 0};
+				}
+				prefetch_size = index_offset;
+				BinaryReader reader {this->pack_data + index_offset, static_cast<std::size_t>(index_size)};
+				const auto entry_count = reader.read<std::uint32_t>();
+				for (std::uint32_t i = 0; i < entry_count; ++i) {
+					std::wstring path = reader.readString();
+					Entry my_entry {};
+					my_entry.offset = reader.read<std::uint64_t>();
+					my_entry.size = reader.read<std::uint64_t>();
+					my_entry.hash = reader.read<std::uint64_t>();
+					if (my_entry.offset > index_offset || my_entry.size > index_offset - my_entry.offset) {
+						throw DataFileException {L"The resource pack " + pack_file_name + L" is corrupted.", 0};
+					}
+					if (isStreamedResource(path)) {
+						prefetch_size = std::min(prefetch_size, my_entry.offset);
+					}
+					this->index.emplace(std::move(path), my_entry);
+				}
+			}
+			catch (...) {
+				this->close();
+				throw;
+			}
+			// Fault in the loaded resources with one large sequential read rather than taking a page
+			// fault (and a small random read) the first time each resource is touched. (Streamed
+			// resources come last, so they are left out without breaking up the read.)
+			WIN32_MEMORY_RANGE_ENTRY my_range {const_cast<char*>(this->pack_data), static_cast<SIZE_T>(prefetch_size)};
+			PrefetchVirtualMemory(GetCurrentProcess(), 1, &my_range, 0);
+		}
+
+		void ResourcePack::close() noexcept {
+			if (this->pack_data) {
+				UnmapViewOfFile(this->pack_data);
+				this->pack_data = nullptr;
+			}
+			if (this->mapping_handle) {
+				CloseHandle(this->mapping_handle);
+				this->mapping_handle = nullptr;
+			}
+			if (this->file_handle) {
+				CloseHandle(this->file_handle);
+				this->file_handle = nullptr;
+			}
+			this->pack_size = 0;
+			this->index.clear();
+		}
+
+		std::wstring ResourcePack::getLooseFilePath(const std::wstring& path) const {
+			std::error_code ec {};
+			if (!this->override_folder.empty() && std::filesystem::is_regular_file(this->getOverridePath(path), ec)) {
+				return this->getOverridePath(path);
+			}
+			if (!this->isPackOpen() && !this->loose_folder.empty()
+				&& std::filesystem::is_regular_file(this->loose_folder + path, ec)) {
+				return this->loose_folder + path;
+			}
+			return L""s;
+		}
+
+		bool ResourcePack::getResource(const std::wstring& path, ResourceView& view) const {
+			const std::wstring loose_path = this->getLooseFilePath(path);
+			if (!loose_path.empty()) {
+				std::vector<char> contents {};
+				if (readWholeFile(loose_path, contents)) {
+					view = ResourceView {std::move(contents)};
+					return true;
+				}
+			}
+			Entry my_entry {};
+			if (!this->getPackedEntry(path, my_entry)) {
+				return false;
+			}
+			view = ResourceView {this->pack_data + my_entry.offset, static_cast<std::size_t>(my_entry.size)};
+			return true;
+		}
+
+		bool ResourcePack::hasResource(const std::wstring& path) const {
+			if (this->index.find(path) != this->index.end()) {
+				return true;
+			}
+			return !this->getLooseFilePath(path).empty();
+		}
+
+		std::vector<std::wstring> ResourcePack::listResources(const std::wstring& folder) const {
+			std::set<std::wstring> names {};
+			// (The index is sorted, so every resource in the folder follows the folder's name.)
+			for (auto it = this->index.lower_bound(folder); it != this->index.end()
+				&& it->first.compare(0, folder.size(), folder) == 0; ++it) {
+				std::wstring name = it->first.substr(folder.size());
+				if (name.find(L'/') == std::wstring::npos) {
+					names.emplace(std::move(name));
+				}
+			}
+			for (const auto& loose_folder_path : {this->override_folder, this->isPackOpen() ? L""s : this->loose_folder}) {
+				if (loose_folder_path.empty()) {
+					continue;
+				}
+				std::error_code ec {};
+				for (const auto& entry : std::filesystem::directory_iterator {loose_folder_path + folder, ec}) {
+					if (entry.is_regular_file(ec)) {
+						names.emplace(entry.path().filename().wstring());
+					}
+				}
+			}
+			return std::vector<std::wstring>(names.begin(), names.end());
+		}
+
+		bool ResourcePack::getResourceLocation(const std::wstring& path, std::wstring& file_name,
+			std::uint64_t& offset, std::uint64_t& size) const {
+			const std::wstring loose_path = this->getLooseFilePath(path);
+			if (!loose_path.empty()) {
+				std::error_code ec {};
+				const auto file_size = std::filesystem::file_size(loose_path, ec);
+				if (!ec) {
+					file_name = loose_path;
+					offset = 0;
+					size = static_cast<std::uint64_t>(file_size);
+					return true;
+				}
+			}
+			Entry my_entry {};
+			if (!this->getPackedEntry(path, my_entry)) {
+				return false;
+			}
+			file_name = this->pack_file_name;
+			offset = my_entry.offset;
+			size = my_entry.size;
+			return true;
+		}
+
+		bool ResourcePack::getPackedEntry(const std::wstring& path, Entry& entry) const {
+			const auto it = this->index.find(path);
+			if (it == this->index.end()) {
+				return false;
+			}
+			entry = it->second;
+			return true;
+		}
+
+		std::size_t ResourcePack::buildPack(const std::wstring& source_folder, const std::wstring& pack_file_name) {
+			std::vector<std::wstring> paths {};
+			std::error_code ec {};
+			for (const auto& entry : std::filesystem::recursive_directory_iterator {source_folder, ec}) {
+				if (!entry.is_regular_file(ec) || unpacked_files.count(entry.path().filename().wstring()) > 0
+					|| entry.path().extension() == L".tmp") {
+					continue;
+				}
+				paths.emplace_back(entry.path().lexically_relative(source_folder).generic_wstring());
+			}
+			if (ec) {
+				throw DataFileException {L"Could not list the files in " + source_folder + L".", 0};
+			}
+			std::sort(paths.begin(), paths.end());
+			// Streamed resources go last so that the rest of the pack can be read in one piece.
+			std::stable_partition(paths.begin(), paths.end(), [](const std::wstring& path) {
+				return !isStreamedResource(path);
+			});
+			const std::wstring temp_file_name {pack_file_name + L".tmp"};
+			std::ofstream pack_file {std::filesystem::path {temp_file_name}, std::ios::binary | std::ios::trunc};
+			if (pack_file.fail() || pack_file.bad()) {
+				throw DataFileException {L"Could not create the resource pack " + pack_file_name + L".", 0};
+			}
+			// The header is rewritten once the index's location is known.
+			const std::vector<char> blank_header(resource_pack_header_size, '\0');
+			pack_file.write(blank_header.data(), static_cast<std::streamsize>(blank_header.size()));
+			BinaryWriter index_writer {};
+			index_writer.write(static_cast<std::uint32_t>(paths.size()));
+			std::uint64_t offset {resource_pack_header_size};
+			// (Files are read one at a time so that the whole pack never needs to be in memory.)
+			std::vector<char> contents {};
+			for (const auto& path : paths) {
+				if (!readWholeFile(source_folder + path, contents)) {
+					throw DataFileException {L"Could not open " + source_folder + path + L" for reading.", 0};
+				}
+				pack_file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+				index_writer.writeString(path);
+				index_writer.write(offset);
+				index_writer.write(static_cast<std::uint64_t>(contents.size()));
+				index_writer.write(hashBytes(contents.data(), contents.size()));
+				offset += contents.size();
+			}
+			pack_file.write(index_writer.getData().data(), static_cast<std::streamsize>(index_writer.getData().size()));
+			BinaryWriter header_writer {};
+			header_writer.write(resource_pack_magic);
+			header_writer.write(resource_pack_version);
+			header_writer.write(offset);
+			header_writer.write(static_cast<std::uint64_t>(index_writer.getData().size()));
+			pack_file.seekp(0);
+			pack_file.write(header_writer.getData().data(), static_cast<std::streamsize>(header_writer.getData().size()));
+			pack_file.close();
+			if (pack_file.fail() || !MoveFileExW(temp_file_name.c_str(), pack_file_name.c_str(),
+				MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+				DeleteFileW(temp_file_name.c_str());
+				throw DataFileException {L"Could not write the resource pack " + pack_file_name + L".", 0};
+			}
+			return paths.size();
+		}
+	}
+}
\ No newline at end of file
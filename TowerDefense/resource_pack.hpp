@@ -0,0 +1,183 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hoffman_isaiah {
+	namespace util::file {
+		/// <summary>A read-only view of the contents of a resource. Resources stored in a pack
+		/// are not copied; the view points directly into the mapped pack, which must outlive the
+		/// view. Resources loaded from loose files are owned by the view instead.</summary>
+		class ResourceView {
+		public:
+			ResourceView() noexcept = default;
+			/// <summary>Creates a view of memory owned by someone else.</summary>
+			/// <param name="buffer">The start of the resource's contents.</param>
+			/// <param name="buffer_size">The size of the resource in bytes.</param>
+			ResourceView(const char* buffer, std::size_t buffer_size) noexcept :
+				view_data {buffer},
+				view_size {buffer_size} {
+			}
+			/// <summary>Creates a view that owns the resource's contents.</summary>
+			/// <param name="contents">The contents of the resource.</param>
+			explicit ResourceView(std::vector<char> contents) noexcept :
+				owned_data {std::move(contents)},
+				view_data {this->owned_data.data()},
+				view_size {this->owned_data.size()} {
+			}
+			// (Copying would either duplicate the data or leave two views sharing one buffer.)
+			ResourceView(const ResourceView&) = delete;
+			ResourceView& operator=(const ResourceView&) = delete;
+			// (Moving a vector keeps its buffer, so the pointer stays valid.)
+			ResourceView(ResourceView&& rhs) noexcept = default;
+			ResourceView& operator=(ResourceView&& rhs) noexcept = default;
+			~ResourceView() noexcept = default;
+			/// <returns>The resource's contents interpreted as single-byte text. (Each byte
+			/// becomes one wide character, which matches what std::wifstream does with the
+			/// default locale.)</returns>
+			std::wstring toWideString() const {
+				std::wstring text(this->view_size, L'\0');
+				for (std::size_t i = 0; i < this->view_size; ++i) {
+					text[i] = static_cast<wchar_t>(static_cast<unsigned char>(this->view_data[i]));
+				}
+				return text;
+			}
+			// Getters
+			const char* data() const noexcept {
+				return this->view_data;
+			}
+			std::size_t size() const noexcept {
+				return this->view_size;
+			}
+		private:
+			/// <summary>The contents of the resource if they did not come from a pack.</summary>
+			std::vector<char> owned_data {};
+			/// <summary>The start of the resource's contents.</summary>
+			const char* view_data {nullptr};
+			/// <summary>The size of the resource in bytes.</summary>
+			std::size_t view_size {0};
+		};
+
+		/// <summary>Provides the game's resources from a single read-only pack file. The pack
+		/// is memory-mapped and read from the disk in one sequential pass when it is opened, so
+		/// individual resources can then be handed out without opening any files. Files in the
+		/// override folder (which is kept apart from the game's own resources) take precedence over
+		/// the packed versions, which lets users (and the terrain editor) replace resources without
+		/// rebuilding the pack. If there is no pack, resources are read from the loose folder instead.
+		/// (Loose files are ignored while a pack is open, so stale copies can never shadow it.)</summary>
+		/// <remarks>A pack begins with a header (magic number, version, and the offset and size of
+		/// the index) followed by the contents of each resource. The index is stored last and
+		/// lists the path, offset, size, and FNV-1a hash of every resource. Streamed resources
+		/// (music) are stored after everything else and are not read when the pack is opened.</remarks>
+		class ResourcePack {
+		public:
+			/// <summary>Records where a resource is stored in the pack.</summary>
+			struct Entry {
+				/// <summary>The offset of the resource from the start of the pack.</summary>
+				std::uint64_t offset {0};
+				/// <summary>The size of the resource in bytes.</summary>
+				std::uint64_t size {0};
+				/// <summary>The 64-bit FNV-1a hash of the resource's contents.</summary>
+				std::uint64_t hash {0};
+			};
+
+			/// <summary>Creates a resource provider without a pack.</summary>
+			/// <param name="new_override_folder">The folder whose files take precedence over every other
+			/// source. (This should end with a slash.)</param>
+			/// <param name="new_loose_folder">The folder to load resources from when there is no pack.
+			/// (This should end with a slash.)</param>
+			explicit ResourcePack(std::wstring new_override_folder = {}, std::wstring new_loose_folder = {}) noexcept :
+				override_folder {std::move(new_override_folder)},
+				loose_folder {std::move(new_loose_folder)} {
+			}
+			ResourcePack(const ResourcePack&) = delete;
+			ResourcePack& operator=(const ResourcePack&) = delete;
+			/// <summary>Unmaps the pack. (Any views into the pack become invalid.)</summary>
+			~ResourcePack() noexcept {
+				this->close();
+			}
+			/// <summary>Maps a pack file into memory and reads its index. If the pack does not
+			/// exist, the override folder and then the loose folder are used. Throws an exception
+			/// if the pack exists but is corrupted.</summary>
+			/// <param name="pack_file_name">The path of the pack file.</param>
+			/// <param name="new_override_folder">The folder whose files take precedence over the pack.
+			/// (This should end with a slash.)</param>
+			/// <param name="new_loose_folder">The folder to load resources from if there is no pack.
+			/// (This should end with a slash.)</param>
+			void open(const std::wstring& pack_file_name, std::wstring new_override_folder, std::wstring new_loose_folder);
+			/// <summary>Unmaps the pack, if one is open.</summary>
+			void close() noexcept;
+			/// <param name="path">The path of the resource relative to the resources folder (using
+			/// forward slashes).</param>
+			/// <param name="view">Receives a view of the resource's contents.</param>
+			/// <returns>False if the resource does not exist.</returns>
+			bool getResource(const std::wstring& path, ResourceView& view) const;
+			/// <param name="path">The path of the resource relative to the resources folder.</param>
+			/// <returns>True if the resource exists.</returns>
+			bool hasResource(const std::wstring& path) const;
+			/// <param name="folder">The folder to list relative to the resources folder, including
+			/// the trailing slash. (Pass an empty string to list the top level.)</param>
+			/// <returns>The names (without the folder) of the resources directly inside the given
+			/// folder, combining every source of resources. The names are sorted.</returns>
+			std::vector<std::wstring> listResources(const std::wstring& folder) const;
+			/// <summary>Finds where a resource is stored on the disk so that it can be streamed
+			/// rather than loaded all at once.</summary>
+			/// <param name="path">The path of the resource relative to the resources folder.</param>
+			/// <param name="file_name">Receives the path of the file containing the resource.</param>
+			/// <param name="offset">Receives the position of the resource within the file.</param>
+			/// <param name="size">Receives the size of the resource in bytes.</param>
+			/// <returns>False if the resource does not exist.</returns>
+			bool getResourceLocation(const std::wstring& path, std::wstring& file_name,
+				std::uint64_t& offset, std::uint64_t& size) const;
+			/// <param name="path">The path of the resource relative to the resources folder.</param>
+			/// <param name="entry">Receives the location, size, and hash of the packed resource.</param>
+			/// <returns>False if the pack does not contain the resource. (Overrides are ignored.)</returns>
+			bool getPackedEntry(const std::wstring& path, Entry& entry) const;
+			/// <param name="path">The path of the resource relative to the resources folder.</param>
+			/// <returns>The path of the loose file that provides the resource (an override, or a file
+			/// in the loose folder if there is no pack) or an empty string if the resource is packed
+			/// or does not exist.</returns>
+			std::wstring getLooseFilePath(const std::wstring& path) const;
+			/// <param name="path">The path of the resource relative to the resources folder.</param>
+			/// <returns>The path that an override of the resource would have.</returns>
+			std::wstring getOverridePath(const std::wstring& path) const {
+				return this->override_folder + path;
+			}
+			/// <returns>True if a pack file is currently mapped.</returns>
+			bool isPackOpen() const noexcept {
+				return this->pack_data != nullptr;
+			}
+
+			/// <summary>Creates a pack containing every file in a folder (and its subfolders). The
+			/// compiled type database is left out since it is rebuilt from the packed data files.</summary>
+			/// <param name="source_folder">The folder containing the resources. (This should end with a slash.)</param>
+			/// <param name="pack_file_name">The path of the pack file to create.</param>
+			/// <returns>The number of resources that were packed. Throws an exception if a
+			/// file could not be read or the pack could not be written.</returns>
+			static std::size_t buildPack(const std::wstring& source_folder, const std::wstring& pack_file_name);
+		private:
+			/// <summary>The folder whose files take precedence over the pack.</summary>
+			std::wstring override_folder {};
+			/// <summary>The folder that resources are loaded from if there is no pack.</summary>
+			std::wstring loose_folder {};
+			/// <summary>The path of the pack file.</summary>
+			std::wstring pack_file_name {};
+			/// <summary>The location of each resource in the pack, keyed by path.</summary>
+			std::map<std::wstring, Entry> index {};
+			/// <summary>The handle of the pack file. (Stored as void* to keep Windows.h out of
+			/// this header.)</summary>
+			void* file_handle {nullptr};
+			/// <summary>The handle of the pack's file mapping.</summary>
+			void* mapping_handle {nullptr};
+			/// <summary>The start of the mapped pack.</summary>
+			const char* pack_data {nullptr};
+			/// <summary>The size of the pack in bytes.</summary>
+			std::size_t pack_size {0};
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace hoffman_isaiah {
+	namespace util {
+		/// <summary>A fixed-size queue that one thread pushes to and one other thread pops from
+		/// without either thread taking a lock.</summary>
+		/// <typeparam name="T">The type of item held by the queue.</typeparam>
+		/// <typeparam name="Capacity">The maximum number of items in the queue. (This must be a
+		/// power of two.)</typeparam>
+		template <typename T, std::size_t Capacity>
+		class SpscQueue {
+			static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two.");
+		public:
+			/// <summary>Adds an item to the back of the queue. (This should only be called by the
+			/// producer.)</summary>
+			/// <param name="item">The item to add.</param>
+			/// <returns>True if the item was added or false if the queue was full.</returns>
+			bool tryPush(const T& item) {
+				const std::size_t my_tail = this->tail.load(std::memory_order_relaxed);
+				if (my_tail - this->head.load(std::memory_order_acquire) == Capacity) {
+					return false;
+				}
+				this->items[my_tail & (Capacity - 1)] = item;
+				this->tail.store(my_tail + 1, std::memory_order_release);
+				return true;
+			}
+			/// <summary>Removes the item at the front of the queue. (This should only be called
+			/// by the consumer.)</summary>
+			/// <param name="item">Receives the removed item.</param>
+			/// <returns>True if an item was removed or false if the queue was empty.</returns>
+			bool tryPop(T& item) {
+				const std::size_t my_head = this->head.load(std::memory_order_relaxed);
+				if (my_head == this->tail.load(std::memory_order_acquire)) {
+					return false;
+				}
+				item = this->items[my_head & (Capacity - 1)];
+				this->head.store(my_head + 1, std::memory_order_release);
+				return true;
+			}
+		private:
+			/// <summary>The ring buffer of items.</summary>
+			std::array<T, Capacity> items {};
+			/// <summary>The number of items ever popped. (Only the consumer writes this.)</summary>
+			alignas(64) std::atomic<std::size_t> head {0};
+			/// <summary>The number of items ever pushed. (Only the producer writes this.)</summary>
+			alignas(64) std::atomic<std::size_t> tail {0};
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "./profiler.hpp"
+#include "./task_graph.hpp"
+
+namespace hoffman_isaiah {
+	namespace util {
+		namespace {
+			/// <returns>The current time in nanoseconds since the steady clock's epoch.</returns>
+			long long getNanoseconds() noexcept {
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count();
+			}
+		}
+
+		int TaskGraph::addTask(std::wstring name, std::function<void()> work, std::vector<int> dependencies) {
+			const int id = static_cast<int>(this->tasks.size());
+			Task my_task {std::move(work)};
+			for (const auto dependency : dependencies) {
+				if (dependency < 0 || dependency >= id) {
+					throw std::out_of_range {"Tasks can only depend on tasks added before them."};
+				}
+				this->tasks.at(dependency).dependents.emplace_back(id);
+				++my_task.remaining_dependencies;
+			}
+			this->tasks.emplace_back(std::move(my_task));
+			TaskTiming my_timing {};
+			my_timing.name = std::move(name);
+			this->timings.emplace_back(std::move(my_timing));
+			return id;
+		}
+
+		void TaskGraph::run(unsigned int max_threads) {
+			this->start_time = getNanoseconds();
+			this->tasks_remaining = static_cast<int>(this->tasks.size());
+			this->first_error = nullptr;
+			for (int i = 0; i < static_cast<int>(this->tasks.size()); ++i) {
+				if (this->tasks[i].remaining_dependencies == 0) {
+					this->ready_tasks.emplace_back(i);
+				}
+			}
+			if (max_threads == 0) {
+				max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+			}
+			const auto num_threads = std::min(max_threads, static_cast<unsigned int>(this->tasks.size()));
+			std::vector<std::thread> workers {};
+			for (unsigned int i = 0; i < num_threads; ++i) {
+				workers.emplace_back(&TaskGraph::workerLoop, this);
+			}
+			for (auto& worker : workers) {
+				worker.join();
+			}
+			this->total_ms = (getNanoseconds() - this->start_time) / 1'000'000.0;
+			if (this->first_error) {
+				std::rethrow_exception(this->first_error);
+			}
+		}
+
+		void TaskGraph::workerLoop() {
+			IH_PROFILE_THREAD_NAME("Task graph");
+			std::unique_lock<std::mutex> lock {this->mutex};
+			while (true) {
+				this->task_ready.wait(lock, [this]() {
+					return !this->ready_tasks.empty() || this->tasks_remaining == 0;
+				});
+				if (this->tasks_remaining == 0) {
+					return;
+				}
+				const int id = this->ready_tasks.front();
+				this->ready_tasks.pop_front();
+				Task& my_task = this->tasks[id];
+				bool succeeded = !my_task.dependency_failed;
+				if (succeeded) {
+					lock.unlock();
+					const auto task_start = getNanoseconds();
+					std::exception_ptr my_error {nullptr};
+					try {
+						my_task.work();
+					}
+					catch (...) {
+						my_error = std::current_exception();
+						succeeded = false;
+					}
+					const auto task_end = getNanoseconds();
+					lock.lock();
+					this->timings[id].start_ms = (task_start - this->start_time) / 1'000'000.0;
+					this->timings[id].duration_ms = (task_end - task_start) / 1'000'000.0;
+					this->timings[id].ran = true;
+					if (my_error && !this->first_error) {
+						this->first_error = my_error;
+					}
+				}
+				for (const auto dependent : my_task.dependents) {
+					if (!succeeded) {
+						this->tasks[dependent].dependency_failed = true;
+					}
+					if (--this->tasks[dependent].remaining_dependencies == 0) {
+						this->ready_tasks.emplace_back(dependent);
+					}
+				}
+				--this->tasks_remaining;
+				this->task_ready.notify_all();
+			}
+		}
+
+		std::wstring TaskGraph::getReport() const {
+			std::wostringstream report {};
+			report << std::fixed << std::setprecision(2);
+			for (const auto& my_timing : this->timings) {
+				report << my_timing.name << L": ";
+				if (my_timing.ran) {
+					report << my_timing.duration_ms << L" ms (started at " << my_timing.start_ms << L" ms)\n";
+				}
+				else {
+					report << L"skipped\n";
+				}
+			}
+			report << L"Total: " << this->total_ms << L" ms\n";
+			return report.str();
+		}
+	}
+}
\ No newline at end of file
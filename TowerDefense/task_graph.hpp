@@ -0,0 +1,91 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hoffman_isaiah {
+	namespace util {
+		/// <summary>Stores how long a task in a task graph took to run.</summary>
+		struct TaskTiming {
+			/// <summary>The name of the task.</summary>
+			std::wstring name;
+			/// <summary>The time (in milliseconds) after the graph started running that the task started.</summary>
+			double start_ms {0.0};
+			/// <summary>The time (in milliseconds) that the task took to run.</summary>
+			double duration_ms {0.0};
+			/// <summary>False if the task was skipped because a task it depends on failed.</summary>
+			bool ran {false};
+		};
+
+		/// <summary>Runs a set of tasks on a small pool of threads. A task only starts once every
+		/// task that it depends on has finished, so tasks without dependencies between them run
+		/// concurrently.</summary>
+		class TaskGraph {
+		public:
+			/// <summary>Adds a task to the graph. Tasks can only depend on tasks that were added
+			/// before them, which guarantees that the graph has no cycles.</summary>
+			/// <param name="name">The name of the task as it should appear in reports.</param>
+			/// <param name="work">The work to perform.</param>
+			/// <param name="dependencies">The identifiers of the tasks that must finish first.</param>
+			/// <returns>The identifier of the new task.</returns>
+			int addTask(std::wstring name, std::function<void()> work, std::vector<int> dependencies = {});
+			/// <summary>Runs every task in the graph and waits for them to finish. If a task throws
+			/// an exception, the tasks that depend on it are skipped, and the first exception thrown
+			/// is rethrown once every other task has finished.</summary>
+			/// <param name="max_threads">The maximum number of threads to use or 0 to use
+			/// as many threads as the hardware supports.</param>
+			void run(unsigned int max_threads = 0);
+			// Getters
+			/// <returns>The timings of each task in the order that the tasks were added.</returns>
+			const std::vector<TaskTiming>& getTimings() const noexcept {
+				return this->timings;
+			}
+			/// <returns>The time (in milliseconds) that the entire graph took to run.</returns>
+			double getTotalTime() const noexcept {
+				return this->total_ms;
+			}
+			/// <returns>A human-readable summary of the task timings.</returns>
+			std::wstring getReport() const;
+		protected:
+			/// <summary>Runs ready tasks until every task has finished.</summary>
+			void workerLoop();
+		private:
+			/// <summary>Stores a task along with its place in the graph.</summary>
+			struct Task {
+				/// <summary>The work to perform.</summary>
+				std::function<void()> work;
+				/// <summary>The identifiers of the tasks that depend on this task.</summary>
+				std::vector<int> dependents {};
+				/// <summary>The number of dependencies that have not finished yet.</summary>
+				int remaining_dependencies {0};
+				/// <summary>Set if a task that this task depends on failed or was skipped.</summary>
+				bool dependency_failed {false};
+			};
+			/// <summary>The tasks in the graph.</summary>
+			std::vector<Task> tasks {};
+			/// <summary>The timings of each task.</summary>
+			std::vector<TaskTiming> timings {};
+			/// <summary>The time (in milliseconds) that the entire graph took to run.</summary>
+			double total_ms {0.0};
+			// Shared state used while the graph is running.
+			/// <summary>Guards the ready queue and the task bookkeeping.</summary>
+			std::mutex mutex {};
+			/// <summary>Signalled whenever a task becomes ready or the last task finishes.</summary>
+			std::condition_variable task_ready {};
+			/// <summary>The identifiers of the tasks whose dependencies have all finished.</summary>
+			std::deque<int> ready_tasks {};
+			/// <summary>The number of tasks that have not finished yet.</summary>
+			int tasks_remaining {0};
+			/// <summary>The first exception thrown by a task.</summary>
+			std::exception_ptr first_error {nullptr};
+			/// <summary>The time (in nanoseconds since the clock's epoch) that the graph started running.</summary>
+			long long start_time {0};
+		};
+	}
+}
\ No newline at end of file
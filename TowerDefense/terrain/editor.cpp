@@ -7,15 +7,16 @@
 #include "./../resource.h"
 #include <process.h>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <system_error>
 #include <utility>
 
 #include "./../globals.hpp"
 #include "./../ih_math.hpp"
 #include "./../main.hpp"
+#include "./../resource_pack.hpp"
 #include "./../graphics/file_dialogs.hpp"
 #include "./../graphics/graphics_DX.hpp"
 #include "./../graphics/graphics.hpp"
@@ -106,15 +107,11 @@ namespace hoffman_isaiah {
 
 		void TerrainEditor::reloadMap() {
 			// Note: Caller is responsible for syncing code.
-			std::wifstream ground_terrain_file {game::g_my_game->getResourcesPath() + L"graphs/ground_graph_"
-				+ this->map_name + L".txt"};
-			std::wifstream air_terrain_file {game::g_my_game->getResourcesPath() + L"graphs/air_graph_"
-				+ this->map_name + L".txt"};
-			if (ground_terrain_file.bad() || ground_terrain_file.fail()
-				|| air_terrain_file.bad() || air_terrain_file.fail()) {
+			auto my_map = game::loadMapFile(game::g_my_game->getResources(), this->map_name);
+			if (!my_map) {
 				throw std::runtime_error {"File not found!"};
 			}
-			this->map = std::make_shared<game::GameMap>(ground_terrain_file, air_terrain_file);
+			this->map = std::move(my_map);
 			// Update the window's title.
 			const std::wstring my_window_name = TerrainEditor::window_name + L" ["s
 				+ this->map_name + L"]";
@@ -122,18 +119,14 @@ namespace hoffman_isaiah {
 		}
 
 		void TerrainEditor::saveMap() {
-			// Open save files
-			std::wofstream ground_save_file {game::g_my_game->getResourcesPath() + L"graphs/ground_graph_"s
-				+ this->map_name + L".txt"};
-			std::wofstream air_save_file {game::g_my_game->getResourcesPath() + L"graphs/air_graph_"s
-				+ this->map_name + L".txt"};
-			if (!ground_save_file.good() || !air_save_file.good()) {
+			// (Saved maps are overrides so that they take precedence over the resource pack.)
+			const std::wstring overrides_path = game::g_my_game->getResourceOverridesPath();
+			std::error_code ec {};
+			std::filesystem::create_directories(overrides_path + L"graphs/", ec);
+			if (!game::saveMapFile(this->getMap(), overrides_path, this->map_name)) {
 				MessageBox(this->getHWND(), L"TE Thread: Could not save map!", this->window_name, MB_OK);
 				return;
 			}
-			// Output maps to save files
-			ground_save_file << this->getTerrainGraph(false);
-			air_save_file << this->getTerrainGraph(true);
 			// Reenable revert to save
 			winapi::enableMenuItem(hwnd, 1, ID_TE_ACTIONS_REVERT_TO_SAVE);
 		}
@@ -228,11 +221,12 @@ namespace hoffman_isaiah {
 						{
 							const winapi::TerrainEditorSaveMapAsDialog my_dialog {this->getHWND(), GetModuleHandle(nullptr), this->map_name};
 							if (my_dialog.isGood()) {
-								const std::wstring ground_filename = game::g_my_game->getResourcesPath() + L"graphs/ground_graph_"s
-									+ my_dialog.getName() + L".txt";
+								const auto& my_resources = game::g_my_game->getResources();
 								bool go_ahead = true;
-								if (my_dialog.showOvewriteConfirmation() && std::filesystem::exists(ground_filename)) {
-									const int my_result = MessageBox(this->hwnd, (ground_filename + L" already exists. Overwrite anyway?").c_str(),
+								if (my_dialog.showOvewriteConfirmation()
+									&& (my_resources.hasResource(game::getMapResourceName(my_dialog.getName()))
+									|| my_resources.hasResource(L"graphs/ground_graph_"s + my_dialog.getName() + L".txt"s))) {
+									const int my_result = MessageBox(this->hwnd, (my_dialog.getName() + L" already exists. Overwrite anyway?").c_str(),
 										L"TE: Save As - Confirm Overwrite", MB_YESNO | MB_ICONWARNING);
 									if (my_result == IDNO) {
 										go_ahead = false;
@@ -298,12 +292,18 @@ namespace hoffman_isaiah {
 						this->updateMenu();
 						break;
 					}
+					case WM_KEYDOWN:
+					case WM_MOUSEWHEEL:
+						graphics::handleCameraInput(my_renderer->getCamera(), this->hwnd, msg);
+						break;
 					case WM_LBUTTONDOWN:
 					case WM_RBUTTONDOWN:
 					{
 						// Obtain start coordinates
-						const auto gx = static_cast<int>(this->getMap().convertToGameX(GET_X_LPARAM(msg.lParam)));
-						const auto gy = static_cast<int>(this->getMap().convertToGameY(GET_Y_LPARAM(msg.lParam)));
+						const auto gx = static_cast<int>(this->getMap().convertToGameX(
+							my_renderer->getCamera().toMapX(static_cast<float>(GET_X_LPARAM(msg.lParam)))));
+						const auto gy = static_cast<int>(this->getMap().convertToGameY(
+							my_renderer->getCamera().toMapY(static_cast<float>(GET_Y_LPARAM(msg.lParam)))));
 						if (this->getMap().getTerrainGraph(false).verifyCoordinates(gx, gy)) {
 							this->start_gx = gx;
 							this->start_gy = gy;
@@ -313,8 +313,10 @@ namespace hoffman_isaiah {
 					case WM_MOUSEMOVE:
 					{
 						// Update end coordinates
-						const auto gx = static_cast<int>(this->getMap().convertToGameX(GET_X_LPARAM(msg.lParam)));
-						const auto gy = static_cast<int>(this->getMap().convertToGameY(GET_Y_LPARAM(msg.lParam)));
+						const auto gx = static_cast<int>(this->getMap().convertToGameX(
+							my_renderer->getCamera().toMapX(static_cast<float>(GET_X_LPARAM(msg.lParam)))));
+						const auto gy = static_cast<int>(this->getMap().convertToGameY(
+							my_renderer->getCamera().toMapY(static_cast<float>(GET_Y_LPARAM(msg.lParam)))));
 						this->end_gx = gx;
 						this->end_gy = gy;
 						break;
@@ -323,8 +325,10 @@ namespace hoffman_isaiah {
 					case WM_RBUTTONUP:
 					{
 						// Update end coordinates
-						const auto new_gx = static_cast<int>(this->getMap().convertToGameX(GET_X_LPARAM(msg.lParam)));
-						const auto new_gy = static_cast<int>(this->getMap().convertToGameY(GET_Y_LPARAM(msg.lParam)));
+						const auto new_gx = static_cast<int>(this->getMap().convertToGameX(
+							my_renderer->getCamera().toMapX(static_cast<float>(GET_X_LPARAM(msg.lParam)))));
+						const auto new_gy = static_cast<int>(this->getMap().convertToGameY(
+							my_renderer->getCamera().toMapY(static_cast<float>(GET_Y_LPARAM(msg.lParam)))));
 						this->end_gx = math::get_max(new_gx, this->start_gx);
 						this->end_gy = math::get_max(new_gy, this->start_gy);
 						this->start_gx = math::get_min(this->start_gx, new_gx);
@@ -379,6 +383,8 @@ namespace hoffman_isaiah {
 									selected_gnode.setWeight(1);
 									selected_anode.setWeight(1);
 								}
+								this->map->getTerrainGraph(false).markTileChanged(gx, gy);
+								this->map->getTerrainGraph(true).markTileChanged(gx, gy);
 							}
 						} // End outer for
 						if (this->terrain_modifier_active && msg.message != WM_RBUTTONUP) {
@@ -387,19 +393,19 @@ namespace hoffman_isaiah {
 							switch (this->selected_terrain_modifier) {
 							case ID_TE_ACTIONS_SET_GROUND_START:
 								this->getTerrainGraph(false).setStartNode(this->start_gx, this->start_gy);
-								this->getTerrainGraph(false).getNode(this->start_gx, this->start_gy).setBlockage(false);
+								this->getTerrainGraph(false).setBlockage(this->start_gx, this->start_gy, false);
 								break;
 							case ID_TE_ACTIONS_SET_AIR_START:
 								this->getTerrainGraph(true).setStartNode(this->start_gx, this->start_gy);
-								this->getTerrainGraph(true).getNode(this->start_gx, this->start_gy).setBlockage(false);
+								this->getTerrainGraph(true).setBlockage(this->start_gx, this->start_gy, false);
 								break;
 							case ID_TE_ACTIONS_SET_GROUND_END:
 								this->getTerrainGraph(false).setGoalNode(this->start_gx, this->start_gy);
-								this->getTerrainGraph(false).getNode(this->start_gx, this->start_gy).setBlockage(false);
+								this->getTerrainGraph(false).setBlockage(this->start_gx, this->start_gy, false);
 								break;
 							case ID_TE_ACTIONS_SET_AIR_END:
 								this->getTerrainGraph(true).setGoalNode(this->start_gx, this->start_gy);
-								this->getTerrainGraph(true).getNode(this->start_gx, this->start_gy).setBlockage(false);
+								this->getTerrainGraph(true).setBlockage(this->start_gx, this->start_gy, false);
 								break;
 							default:
 								break;
@@ -0,0 +1,55 @@
+#pragma once
+// File Author: Isaiah Hoffman
+// File Created: October 19, 2026
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace hoffman_isaiah {
+	namespace util {
+		/// <summary>Passes the latest version of some data from one writing thread to one
+		/// reading thread without either thread ever waiting on the other. The writer always
+		/// has a buffer of its own to fill, the reader always has a complete buffer of its own
+		/// to read, and the third buffer holds whichever complete version is newest.</summary>
+		/// <typeparam name="T">The type of data to pass between the threads.</typeparam>
+		template <typename T>
+		class TripleBuffer {
+		public:
+			/// <returns>The buffer that the writer should fill. (It holds whatever was written
+			/// to it two versions ago, so every part of it must be rewritten.)</returns>
+			T& getWriteBuffer() noexcept {
+				return this->buffers[this->write_index];
+			}
+			/// <summary>Makes the write buffer the newest version and gives the writer a new
+			/// buffer to fill. (This should only be called by the writer.)</summary>
+			void publish() noexcept {
+				const std::uint8_t old_middle = this->middle_index.exchange(
+					static_cast<std::uint8_t>(this->write_index | TripleBuffer::fresh_flag), std::memory_order_acq_rel);
+				this->write_index = old_middle & TripleBuffer::index_mask;
+			}
+			/// <returns>The newest version that has been published. (This should only be called
+			/// by the reader, and the result may only be used until the next call.)</returns>
+			const T& getReadBuffer() noexcept {
+				if (this->middle_index.load(std::memory_order_relaxed) & TripleBuffer::fresh_flag) {
+					const std::uint8_t old_middle = this->middle_index.exchange(this->read_index, std::memory_order_acq_rel);
+					this->read_index = old_middle & TripleBuffer::index_mask;
+				}
+				return this->buffers[this->read_index];
+			}
+		private:
+			/// <summary>Set on the middle index when its buffer has not been read yet.</summary>
+			static constexpr const std::uint8_t fresh_flag = 0x4;
+			/// <summary>Extracts the buffer's index from the middle index.</summary>
+			static constexpr const std::uint8_t index_mask = 0x3;
+
+			/// <summary>The three buffers.</summary>
+			std::array<T, 3> buffers {};
+			/// <summary>The index of the buffer between the writer and the reader.</summary>
+			alignas(64) std::atomic<std::uint8_t> middle_index {1};
+			/// <summary>The index of the writer's buffer. (Only the writer uses this.)</summary>
+			alignas(64) std::uint8_t write_index {0};
+			/// <summary>The index of the reader's buffer. (Only the reader uses this.)</summary>
+			alignas(64) std::uint8_t read_index {2};
+		};
+	}
+}
\ No newline at end of file